@@ -0,0 +1,396 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// Micro-benchmarks for the runtime itself, intended to track regressions
+// over time. Measures on the OMP backend:
+// * empty-kernel submit->complete latency for in-order/out-of-order queues,
+//   USM/buffers and instant/DAG submission,
+// * submission throughput from 1 to N submitting threads,
+// * dag_builder cost versus the number of live data users,
+// * memcpy and fill bandwidth,
+// * JIT cost of the first launch with a cold and with a populated
+//   persistent kernel cache, and of warm launches (generic target only).
+// Results are printed, and written as JSON with --json <file>.
+// Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./acpp-runtime-bench [--json results.json] [--threads N]
+//
+// Instant submission on the OMP backend requires a dedicated in-order
+// executor, which only queues with non-default priority have. Once such a
+// queue exists, kernels are arbitrated by priority, so the instant
+// latency is measured last.
+
+#define HIPSYCL_ALLOW_INSTANT_SUBMISSION 1
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+#include "hipSYCL/runtime/dag_builder.hpp"
+#include "hipSYCL/runtime/data.hpp"
+#include "hipSYCL/runtime/operations.hpp"
+
+using clock_type = std::chrono::steady_clock;
+
+struct result {
+  std::string name;
+  double value;
+  std::string unit;
+};
+
+class result_list {
+public:
+  void add(const std::string& name, double value, const std::string& unit) {
+    std::cout << name << ": " << value << " " << unit << std::endl;
+    _results.push_back(result{name, value, unit});
+  }
+
+  bool write_json(const std::string& filename, const std::string& device) const {
+    std::ofstream file{filename};
+    if(!file.is_open())
+      return false;
+    file << "{\n  \"benchmark\": \"acpp-runtime-bench\",\n"
+         << "  \"device\": \"" << escape(device) << "\",\n"
+         << "  \"results\": [";
+    for(std::size_t i = 0; i < _results.size(); ++i) {
+      file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \""
+           << escape(_results[i].name) << "\", \"value\": "
+           << _results[i].value << ", \"unit\": \""
+           << escape(_results[i].unit) << "\"}";
+    }
+    file << "\n  ]\n}" << std::endl;
+    return static_cast<bool>(file);
+  }
+private:
+  static std::string escape(const std::string& s) {
+    std::string out;
+    for(char c : s) {
+      if(c == '"' || c == '\\')
+        out += '\\';
+      if(static_cast<unsigned char>(c) >= 0x20)
+        out += c;
+    }
+    return out;
+  }
+
+  std::vector<result> _results;
+};
+
+double seconds_since(clock_type::time_point start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+double median(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  return v[v.size() / 2];
+}
+
+// Returns the median submit->complete latency in microseconds
+template<class Submit>
+double measure_latency(sycl::queue& q, Submit submit, std::size_t iterations) {
+  for(std::size_t i = 0; i < iterations / 10 + 1; ++i)
+    submit();
+  q.wait();
+
+  std::vector<double> latencies(iterations);
+  for(std::size_t i = 0; i < iterations; ++i) {
+    auto start = clock_type::now();
+    submit();
+    q.wait();
+    latencies[i] = seconds_since(start) * 1.e6;
+  }
+  return median(latencies);
+}
+
+void run_latency(sycl::queue& q, const std::string& name,
+                 std::size_t iterations, bool use_buffers,
+                 result_list& results) {
+  int* usm = sycl::malloc_device<int>(1, q);
+  sycl::buffer<int> buff{sycl::range<1>{1}};
+
+  double usm_latency = measure_latency(q, [&]() {
+    q.single_task([=]() { *usm = 1; });
+  }, iterations);
+  results.add("latency." + name + ".usm", usm_latency, "us");
+
+  if(use_buffers) {
+      double buffer_latency = measure_latency(q, [&]() {
+      q.submit([&](sycl::handler& cgh) {
+        sycl::accessor acc{buff, cgh, sycl::write_only, sycl::no_init};
+        cgh.single_task([=]() { acc[0] = 1; });
+      });
+    }, iterations);
+    results.add("latency." + name + ".buffer", buffer_latency, "us");
+  }
+
+  sycl::free(usm, q);
+}
+
+void run_submission_throughput(const sycl::device& dev,
+                               std::size_t max_threads,
+                               std::size_t kernels_per_thread,
+                               result_list& results) {
+  sycl::queue q{dev};
+  for(std::size_t num_threads = 1; num_threads <= max_threads;
+      num_threads *= 2) {
+    // Warm up
+    q.single_task([]() {});
+    q.wait();
+
+    auto start = clock_type::now();
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t < num_threads; ++t)
+      threads.emplace_back([&]() {
+        for(std::size_t i = 0; i < kernels_per_thread; ++i)
+          q.single_task([]() {});
+      });
+    for(auto& t : threads)
+      t.join();
+    double submission_time = seconds_since(start);
+    q.wait();
+    double total_time = seconds_since(start);
+
+    std::size_t num_kernels = num_threads * kernels_per_thread;
+    std::string prefix =
+        "submission." + std::to_string(num_threads) + "_threads";
+    results.add(prefix + ".submit_rate", num_kernels / submission_time,
+                "kernels/s");
+    results.add(prefix + ".complete_rate", num_kernels / total_time,
+                "kernels/s");
+  }
+}
+
+class dummy_operation : public hipsycl::rt::operation {
+public:
+  virtual void dump(std::ostream& ostr, int indentation = 0) const override {
+    ostr << std::string(indentation, ' ') << "dummy_operation";
+  }
+
+  virtual hipsycl::rt::result
+  dispatch(hipsycl::rt::operation_dispatcher *,
+           hipsycl::rt::dag_node_ptr) override {
+    return hipsycl::rt::make_success();
+  }
+};
+
+// Measures the cost of adding an operation to the DAG builder when the
+// accessed data region has num_users live users. The users are read
+// accesses of disjoint pages, so none of them replaces another, while
+// each measured write replaces the previous one.
+void run_dag_builder(std::size_t num_users, result_list& results) {
+  namespace rt = hipsycl::rt;
+
+  constexpr std::size_t num_samples = 1000;
+  std::size_t num_pages = num_users + 1;
+  auto region = std::make_shared<rt::buffer_data_region>(
+      rt::range<3>{1, 1, num_pages}, sizeof(int), rt::range<3>{1, 1, 1});
+
+  rt::dag_builder builder{nullptr};
+  auto add = [&](std::size_t page, sycl::access::mode mode) {
+    rt::requirements_list reqs{nullptr};
+    reqs.add_requirement(std::make_unique<rt::buffer_memory_requirement>(
+        region, rt::id<3>{0, 0, page}, rt::range<3>{1, 1, 1}, mode,
+        sycl::access::target::device));
+    builder.add_command_group(std::make_unique<dummy_operation>(), reqs);
+  };
+
+  for(std::size_t i = 0; i < num_users; ++i)
+    add(i, sycl::access::mode::read);
+
+  // Each new user has to be checked against all existing users
+  auto start = clock_type::now();
+  for(std::size_t i = 0; i < num_samples; ++i)
+    add(num_users, sycl::access::mode::read_write);
+  double cost = seconds_since(start) / num_samples;
+
+  results.add("dag_builder." + std::to_string(num_users) + "_users",
+              cost * 1.e9, "ns/op");
+  builder.finish_and_reset();
+}
+
+void run_bandwidth(sycl::queue& q, std::size_t num_bytes,
+                   result_list& results) {
+  constexpr int repetitions = 10;
+  char* src = sycl::malloc_device<char>(num_bytes, q);
+  char* dest = sycl::malloc_device<char>(num_bytes, q);
+  q.memset(src, 1, num_bytes);
+  q.memset(dest, 0, num_bytes);
+  q.wait();
+
+  auto start = clock_type::now();
+  for(int i = 0; i < repetitions; ++i)
+    q.memcpy(dest, src, num_bytes);
+  q.wait();
+  // Reads and writes each byte
+  double memcpy_bw = 2.0 * repetitions * num_bytes / seconds_since(start);
+  results.add("bandwidth.memcpy", memcpy_bw * 1.e-9, "GB/s");
+
+  float* data = reinterpret_cast<float*>(dest);
+  std::size_t num_floats = num_bytes / sizeof(float);
+  start = clock_type::now();
+  for(int i = 0; i < repetitions; ++i)
+    q.fill(data, 1.0f, num_floats);
+  q.wait();
+  double fill_bw = static_cast<double>(repetitions) * num_floats *
+                   sizeof(float) / seconds_since(start);
+  results.add("bandwidth.fill", fill_bw * 1.e-9, "GB/s");
+
+  sycl::free(src, q);
+  sycl::free(dest, q);
+}
+
+// Runs in a child process: Measures the first and the second launch of a
+// kernel after the runtime has been initialized.
+int run_jit_probe() {
+  sycl::queue q{sycl::property::queue::in_order{}};
+  int* data = sycl::malloc_device<int>(1, q);
+  // Initializes the runtime without JIT compilation
+  q.memset(data, 0, sizeof(int)).wait();
+
+  auto probe = [&]() {
+    auto start = clock_type::now();
+    q.single_task([=]() { *data += 1; }).wait();
+    return seconds_since(start) * 1.e6;
+  };
+  double first = probe();
+  double second = probe();
+  std::cout << first << " " << second << std::endl;
+  sycl::free(data, q);
+  return 0;
+}
+
+bool run_jit_child(const std::string& exe, const std::string& appdb_dir,
+                   double& first, double& second) {
+  std::string cmd = "ACPP_APPDB_DIR=\"" + appdb_dir + "\" \"" + exe +
+                    "\" --jit-probe";
+  FILE* pipe = popen(cmd.c_str(), "r");
+  if(!pipe)
+    return false;
+  int num_read = std::fscanf(pipe, "%lf %lf", &first, &second);
+  return pclose(pipe) == 0 && num_read == 2;
+}
+
+void run_jit(const std::string& exe, result_list& results) {
+#ifdef __HIPSYCL_ENABLE_LLVM_SSCP_TARGET__
+  auto appdb_dir =
+      std::filesystem::temp_directory_path() /
+      ("acpp-runtime-bench-appdb-" +
+       std::to_string(clock_type::now().time_since_epoch().count()));
+  double cold_first, cold_second, cached_first, cached_second;
+  // The first child populates the persistent kernel cache, the second one
+  // only looks the kernel up.
+  if (run_jit_child(exe, appdb_dir.string(), cold_first, cold_second) &&
+      run_jit_child(exe, appdb_dir.string(), cached_first, cached_second)) {
+    results.add("jit.cold_first_launch", cold_first, "us");
+    results.add("jit.persistent_cache_first_launch", cached_first, "us");
+    results.add("jit.warm_launch", std::min(cold_second, cached_second), "us");
+  } else {
+    std::cout << "JIT benchmark failed" << std::endl;
+  }
+  std::error_code ec;
+  std::filesystem::remove_all(appdb_dir, ec);
+#else
+  std::cout << "JIT benchmarks skipped: not compiled for the generic target"
+            << std::endl;
+#endif
+}
+
+int main(int argc, char** argv) {
+  std::string json_file;
+  std::size_t max_threads =
+      std::max(1u, std::thread::hardware_concurrency());
+  std::size_t iterations = 1000;
+
+  for(int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if(arg == "--jit-probe") {
+      return run_jit_probe();
+    } else if(arg == "--json" && i + 1 < argc) {
+      json_file = argv[++i];
+    } else if(arg == "--threads" && i + 1 < argc) {
+      max_threads = std::max(1, std::atoi(argv[++i]));
+    } else if(arg == "--iterations" && i + 1 < argc) {
+      iterations = std::max(1, std::atoi(argv[++i]));
+    } else {
+      std::cout << "Usage: " << argv[0]
+                << " [--json <file>] [--threads <n>] [--iterations <n>]"
+                << std::endl;
+      return -1;
+    }
+  }
+
+  sycl::device dev{sycl::cpu_selector_v};
+  std::string device_name = dev.get_info<sycl::info::device::name>();
+  std::cout << "Device: " << device_name << std::endl;
+
+  result_list results;
+  {
+    sycl::queue q{dev, sycl::property::queue::in_order{}};
+    run_latency(q, "in_order.dag", iterations, true, results);
+  }
+  {
+    sycl::queue q{dev};
+    run_latency(q, "out_of_order.dag", iterations, true, results);
+  }
+
+  run_submission_throughput(dev, max_threads, 2000, results);
+
+  for(std::size_t num_users : {16, 256, 4096})
+    run_dag_builder(num_users, results);
+
+  {
+    sycl::queue q{dev, sycl::property::queue::in_order{}};
+    run_bandwidth(q, 64 * 1024 * 1024, results);
+  }
+
+  run_jit(argv[0], results);
+
+  {
+    // Buffers are never submitted instantly
+    sycl::queue q{dev, sycl::property_list{
+                           sycl::property::queue::in_order{},
+                           sycl::property::queue::AdaptiveCpp_priority{-1}}};
+    run_latency(q, "in_order.instant", iterations, false, results);
+  }
+
+  if(!json_file.empty() && !results.write_json(json_file, device_name)) {
+    std::cout << "Could not write results to " << json_file << std::endl;
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// Measures the throughput of many small, independent SYCL 2020 reductions,
+// e.g. norms of different vectors. Reductions on out-of-order queues only
+// depend on their data and may execute concurrently; on in-order queues
+// they may use instant submission. Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./concurrent_reductions [num_reductions] [vector_size]
+
+#define HIPSYCL_ALLOW_INSTANT_SUBMISSION 1
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <sycl/sycl.hpp>
+
+using clock_type = std::chrono::steady_clock;
+
+double run(sycl::queue& q, const float* data, float* results,
+           std::size_t num_reductions, std::size_t vector_size) {
+  auto start = clock_type::now();
+  for(std::size_t r = 0; r < num_reductions; ++r) {
+    const float* v = data + r * vector_size;
+    q.parallel_for(sycl::range<1>{vector_size},
+                   sycl::reduction(
+                       results + r, 0.0f, sycl::plus<float>(),
+                       sycl::property::reduction::initialize_to_identity{}),
+                   [=](sycl::id<1> idx, auto& sum) {
+                     sum += v[idx] * v[idx];
+                   });
+  }
+  q.wait();
+  auto stop = clock_type::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+void benchmark(const std::string& name, sycl::queue& q,
+               std::size_t num_reductions, std::size_t vector_size) {
+  float* data = sycl::malloc_device<float>(num_reductions * vector_size, q);
+  float* results = sycl::malloc_shared<float>(num_reductions, q);
+  q.fill(data, 1.0f, num_reductions * vector_size).wait();
+
+  // Warm up
+  run(q, data, results, num_reductions, vector_size);
+
+  double seconds = run(q, data, results, num_reductions, vector_size);
+  bool is_correct = true;
+  for(std::size_t r = 0; r < num_reductions; ++r)
+    if(results[r] != static_cast<float>(vector_size))
+      is_correct = false;
+
+  std::cout << name << ": " << num_reductions / seconds << " reductions/s"
+            << (is_correct ? "" : " (INCORRECT RESULTS)") << std::endl;
+
+  sycl::free(data, q);
+  sycl::free(results, q);
+}
+
+int main(int argc, char** argv) {
+  std::size_t num_reductions = 256;
+  std::size_t vector_size = 16 * 1024;
+  if(argc > 1)
+    num_reductions = std::atoi(argv[1]);
+  if(argc > 2)
+    vector_size = std::atoi(argv[2]);
+
+  sycl::device dev{sycl::cpu_selector_v};
+  std::cout << "Device: " << dev.get_info<sycl::info::device::name>()
+            << std::endl;
+  std::cout << num_reductions << " reductions of " << vector_size
+            << " elements" << std::endl;
+  {
+    sycl::queue q{dev};
+    benchmark("out-of-order queue", q, num_reductions, vector_size);
+  }
+  {
+    sycl::queue q{dev, sycl::property::queue::in_order{}};
+    benchmark("in-order queue", q, num_reductions, vector_size);
+  }
+  {
+    // On the OMP backend, only queues with non-default priority
+    // use instant submission.
+    sycl::queue q{dev, sycl::property_list{
+                           sycl::property::queue::in_order{},
+                           sycl::property::queue::AdaptiveCpp_priority{-1}}};
+    benchmark("in-order queue, instant submission", q, num_reductions,
+              vector_size);
+  }
+}
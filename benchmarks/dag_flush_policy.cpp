@@ -0,0 +1,137 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Compares the fixed and the adaptive DAG flush policy. Measures
+// (1) the throughput of a burst of small kernels without intermediate
+// waits, and (2) the delay until a kernel starts executing if it is
+// followed by host work instead of a wait. The benchmark is repeated in a
+// child process with ACPP_RT_DAG_FLUSH_POLICY=adaptive. Set
+// ACPP_RT_DUMP_PERF_COUNTERS=1 to see the decisions of the adaptive policy.
+// Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./dag_flush_policy [burst_size] [num_isolated_kernels]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t kernel_size = 4096;
+
+int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             clock_type::now().time_since_epoch())
+      .count();
+}
+
+double run_burst(sycl::queue& q, float* data, std::size_t burst_size) {
+  auto start = clock_type::now();
+  for(std::size_t i = 0; i < burst_size; ++i)
+    q.parallel_for(sycl::range<1>{kernel_size}, [=](sycl::id<1> idx) {
+      data[idx] = data[idx] * 0.5f + 1.0f;
+    });
+  q.wait();
+  auto stop = clock_type::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+// Returns the average delay in microseconds between submission
+// of a kernel and the start of its execution.
+double run_isolated(sycl::queue& q, int64_t* start_times,
+                    std::size_t num_kernels) {
+  std::vector<int64_t> submission_times(num_kernels);
+  for(std::size_t i = 0; i < num_kernels; ++i) {
+    submission_times[i] = now_ns();
+    q.single_task([=]() { start_times[i] = now_ns(); });
+    // Host work that does not wait for the kernel
+    auto host_work_end = clock_type::now() + std::chrono::milliseconds{1};
+    while(clock_type::now() < host_work_end)
+      ;
+  }
+  q.wait();
+
+  double total_delay = 0.0;
+  for(std::size_t i = 0; i < num_kernels; ++i)
+    total_delay += static_cast<double>(start_times[i] - submission_times[i]);
+  return total_delay / num_kernels * 1.e-3;
+}
+
+int main(int argc, char** argv) {
+  std::size_t burst_size = 10000;
+  std::size_t num_isolated_kernels = 200;
+  if(argc > 1)
+    burst_size = std::atoi(argv[1]);
+  if(argc > 2)
+    num_isolated_kernels = std::atoi(argv[2]);
+
+  const char* policy = std::getenv("ACPP_RT_DAG_FLUSH_POLICY");
+  const bool is_child = policy != nullptr;
+
+  {
+    sycl::queue q{sycl::cpu_selector_v, sycl::property::queue::in_order{}};
+    if(!is_child)
+      std::cout << "Device: "
+                << q.get_device().get_info<sycl::info::device::name>()
+                << std::endl;
+
+    float* data = sycl::malloc_shared<float>(kernel_size, q);
+    int64_t* start_times =
+        sycl::malloc_shared<int64_t>(num_isolated_kernels, q);
+    q.fill(data, 1.0f, kernel_size).wait();
+
+    // Warm up
+    run_burst(q, data, 100);
+
+    double burst_seconds = run_burst(q, data, burst_size);
+    double delay_us = run_isolated(q, start_times, num_isolated_kernels);
+
+    std::string name = is_child ? "ACPP_RT_DAG_FLUSH_POLICY=" +
+                                      std::string{policy}
+                                : "fixed flush policy";
+    std::cout << name << ": burst " << burst_size / burst_seconds
+              << " kernels/s, avg. start delay of isolated kernels "
+              << delay_us << " us" << std::endl;
+
+    sycl::free(data, q);
+    sycl::free(start_times, q);
+  }
+
+  if(!is_child) {
+    // Settings are read once per process, so the adaptive policy
+    // is measured in a child process.
+    std::string cmd = "ACPP_RT_DAG_FLUSH_POLICY=adaptive \"" +
+                      std::string{argv[0]} + "\" " +
+                      std::to_string(burst_size) + " " +
+                      std::to_string(num_isolated_kernels);
+    return std::system(cmd.c_str()) == 0 ? 0 : 1;
+  }
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// Compares computing minimum, maximum, sum and sum of squares of an array
+// with four separate transform_reduce calls against a single fused
+// transform_reduce that reads the array only once.
+// Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./fused_transform_reduce [num_elements]
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+#include <hipSYCL/algorithms/numeric.hpp>
+
+namespace algorithms = hipsycl::algorithms;
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int num_repetitions = 5;
+
+template<class F>
+double best_of(F&& f) {
+  double best = 0.0;
+  for(int i = 0; i < num_repetitions + 1; ++i) {
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    // First run is warm-up
+    if(i == 1 || (i > 1 && seconds < best))
+      best = seconds;
+  }
+  return best;
+}
+
+struct results {
+  double min;
+  double max;
+  double sum;
+  double sum_of_squares;
+
+  bool operator==(const results& other) const {
+    return min == other.min && max == other.max && sum == other.sum &&
+           sum_of_squares == other.sum_of_squares;
+  }
+};
+
+void print(const std::string& name, double seconds, std::size_t n,
+           bool is_correct) {
+  std::cout << "  " << std::setw(24) << std::left << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(3)
+            << seconds * 1.e3 << " ms" << std::setw(10)
+            << n * sizeof(double) / seconds * 1.e-9 << " GB/s"
+            << (is_correct ? "" : " (INCORRECT RESULTS)") << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t n = 1 << 25;
+  if(argc > 1)
+    n = std::atol(argv[1]);
+
+  sycl::queue q{sycl::property::queue::in_order{}};
+  std::cout << "Device: "
+            << q.get_device().get_info<sycl::info::device::name>()
+            << std::endl;
+  std::cout << n << " elements" << std::endl;
+
+  algorithms::util::allocation_cache cache{
+      algorithms::util::allocation_type::device};
+
+  // Small integers so that all sums are exact
+  double* data = sycl::malloc_shared<double>(n, q);
+  results expected{std::numeric_limits<double>::max(),
+                   std::numeric_limits<double>::lowest(), 0.0, 0.0};
+  for(std::size_t i = 0; i < n; ++i) {
+    data[i] = static_cast<double>(static_cast<int>(i % 17) - 8);
+    expected.min = std::min(expected.min, data[i]);
+    expected.max = std::max(expected.max, data[i]);
+    expected.sum += data[i];
+    expected.sum_of_squares += data[i] * data[i];
+  }
+
+  results* out = sycl::malloc_shared<results>(1, q);
+  auto identity = [](double x) { return x; };
+  auto square = [](double x) { return x * x; };
+
+  double t = best_of([&]() {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::transform_reduce(q, scratch, data, data + n, &out->min,
+                                 std::numeric_limits<double>::max(),
+                                 sycl::minimum<double>{}, identity);
+    algorithms::transform_reduce(q, scratch, data, data + n, &out->max,
+                                 std::numeric_limits<double>::lowest(),
+                                 sycl::maximum<double>{}, identity);
+    algorithms::transform_reduce(q, scratch, data, data + n, &out->sum, 0.0,
+                                 std::plus<double>{}, identity);
+    algorithms::transform_reduce(q, scratch, data, data + n,
+                                 &out->sum_of_squares, 0.0,
+                                 std::plus<double>{}, square);
+    q.wait();
+  });
+  print("separate reductions", t, n, *out == expected);
+
+  t = best_of([&]() {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::transform_reduce(
+        q, scratch, data, data + n,
+        std::make_tuple(&out->min, &out->max, &out->sum,
+                        &out->sum_of_squares),
+        std::make_tuple(algorithms::make_transform_reduce_descriptor(
+                            std::numeric_limits<double>::max(),
+                            sycl::minimum<double>{}, identity),
+                        algorithms::make_transform_reduce_descriptor(
+                            std::numeric_limits<double>::lowest(),
+                            sycl::maximum<double>{}, identity),
+                        algorithms::make_transform_reduce_descriptor(
+                            0.0, std::plus<double>{}, identity),
+                        algorithms::make_transform_reduce_descriptor(
+                            0.0, std::plus<double>{}, square)));
+    q.wait();
+  });
+  print("fused reduction", t, n, *out == expected);
+
+  sycl::free(out, q);
+  sycl::free(data, q);
+}
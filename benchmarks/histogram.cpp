@@ -0,0 +1,165 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// Compares the strategies of the histogram algorithm of the algorithms
+// library for different numbers of bins, with even-width and custom-edge
+// binning. The automatically selected strategy is marked with *.
+// Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./histogram [num_elements]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+#include <hipSYCL/algorithms/numeric.hpp>
+
+namespace algorithms = hipsycl::algorithms;
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int num_repetitions = 5;
+
+template<class F>
+double best_of(F&& f) {
+  double best = 0.0;
+  for(int i = 0; i < num_repetitions + 1; ++i) {
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    // First run is warm-up
+    if(i == 1 || (i > 1 && seconds < best))
+      best = seconds;
+  }
+  return best;
+}
+
+std::string to_string(algorithms::detail::histogram_strategy strategy) {
+  switch(strategy) {
+  case algorithms::detail::histogram_strategy::private_bins:
+    return "private bins";
+  case algorithms::detail::histogram_strategy::local_memory_bins:
+    return "local memory bins";
+  case algorithms::detail::histogram_strategy::global_atomics:
+  default:
+    return "global atomics";
+  }
+}
+
+template<class Binning>
+void benchmark(sycl::queue& q, algorithms::util::allocation_cache& cache,
+               const std::string& name, const std::vector<float>& host_data,
+               const float* data, Binning binning) {
+  const std::size_t n = host_data.size();
+  const std::size_t num_bins = binning.get_num_bins();
+  std::cout << name << ": " << num_bins << " bins" << std::endl;
+
+  std::vector<unsigned> expected(num_bins, 0);
+  for(float x : host_data) {
+    std::size_t bin;
+    if(binning.get_bin(x, bin))
+      ++expected[bin];
+  }
+
+  unsigned* bins = sycl::malloc_shared<unsigned>(num_bins, q);
+
+  const auto selected =
+      algorithms::detail::select_histogram_strategy(q, n, num_bins);
+  for(auto strategy : {algorithms::detail::histogram_strategy::private_bins,
+                       algorithms::detail::histogram_strategy::local_memory_bins,
+                       algorithms::detail::histogram_strategy::global_atomics}) {
+    double t = best_of([&]() {
+      algorithms::util::allocation_group scratch{&cache, q.get_device()};
+      algorithms::detail::histogram(q, scratch, data, n, binning, bins,
+                                    strategy);
+      q.wait();
+    });
+
+    bool is_correct = true;
+    for(std::size_t b = 0; b < num_bins; ++b)
+      if(bins[b] != expected[b])
+        is_correct = false;
+
+    std::cout << (strategy == selected ? "* " : "  ") << std::setw(20)
+              << std::left << to_string(strategy) << std::right
+              << std::setw(10) << std::fixed << std::setprecision(3)
+              << t * 1.e3 << " ms" << std::setw(10)
+              << n * sizeof(float) / t * 1.e-9 << " GB/s"
+              << (is_correct ? "" : " (INCORRECT RESULTS)") << std::endl;
+  }
+
+  sycl::free(bins, q);
+}
+
+int main(int argc, char** argv) {
+  std::size_t n = 1 << 24;
+  if(argc > 1)
+    n = std::atol(argv[1]);
+
+  sycl::queue q{sycl::property::queue::in_order{}};
+  std::cout << "Device: "
+            << q.get_device().get_info<sycl::info::device::name>()
+            << std::endl;
+  std::cout << n << " elements" << std::endl;
+
+  algorithms::util::allocation_cache cache{
+      algorithms::util::allocation_type::device};
+
+  // Normally distributed, so that the central bins see most updates
+  std::mt19937 gen{123};
+  std::normal_distribution<float> dist{0.5f, 0.15f};
+  std::vector<float> host_data(n);
+  for(std::size_t i = 0; i < n; ++i)
+    host_data[i] = dist(gen);
+
+  float* data = sycl::malloc_shared<float>(n, q);
+  q.copy(host_data.data(), data, n).wait();
+
+  for(std::size_t num_bins : {16, 256, 4096, 65536}) {
+    benchmark(q, cache, "even width", host_data, data,
+              algorithms::even_width_binning<float>{num_bins, 0.0f, 1.0f});
+  }
+
+  // Logarithmically spaced edges
+  const std::size_t num_edges = 257;
+  float* edges = sycl::malloc_shared<float>(num_edges, q);
+  for(std::size_t i = 0; i < num_edges; ++i)
+    edges[i] = std::pow(2.0f, 8.0f * i / (num_edges - 1)) / 256.0f;
+  benchmark(q, cache, "custom edges", host_data, data,
+            algorithms::custom_edge_binning<const float*>{
+                edges, edges + num_edges});
+
+  sycl::free(edges, q);
+  sycl::free(data, q);
+}
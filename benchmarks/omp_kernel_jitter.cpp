@@ -0,0 +1,131 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the latency jitter of back-to-back small kernels on the OMP
+// backend. Each kernel passes through the runtime's helper threads (DAG
+// worker, DAG garbage collector, queue worker thread), which can interfere
+// with the kernel threads unless they are isolated on reserved cores.
+// If a helper core list is passed, the benchmark is run a second time in a
+// child process with ACPP_RT_HELPER_THREAD_CORES set to that list, e.g.
+// ACPP_VISIBILITY_MASK=omp ./omp_kernel_jitter 10000 0
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t kernel_size = 4096;
+
+struct latency_stats {
+  double median_us;
+  double p99_us;
+  double max_us;
+  double stddev_us;
+};
+
+latency_stats run(sycl::queue& q, float* data, std::size_t num_kernels) {
+  auto kernel = [&]() {
+    q.parallel_for(sycl::range<1>{kernel_size}, [=](sycl::id<1> idx) {
+      data[idx] = data[idx] * 0.5f + 1.0f;
+    });
+  };
+
+  // Warm up
+  for(int i = 0; i < 100; ++i)
+    kernel();
+  q.wait();
+
+  std::vector<double> latencies;
+  latencies.reserve(num_kernels);
+  for(std::size_t i = 0; i < num_kernels; ++i) {
+    auto start = clock_type::now();
+    kernel();
+    q.wait();
+    auto stop = clock_type::now();
+    latencies.push_back(
+        std::chrono::duration<double, std::micro>(stop - start).count());
+  }
+
+  double mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+                latencies.size();
+  double variance = 0.0;
+  for(double l : latencies)
+    variance += (l - mean) * (l - mean);
+  variance /= latencies.size();
+
+  std::sort(latencies.begin(), latencies.end());
+  return latency_stats{latencies[latencies.size() / 2],
+                       latencies[latencies.size() * 99 / 100],
+                       latencies.back(), std::sqrt(variance)};
+}
+
+int main(int argc, char** argv) {
+  std::size_t num_kernels = 10000;
+  if(argc > 1)
+    num_kernels = std::atoi(argv[1]);
+
+  const char* helper_cores = std::getenv("ACPP_RT_HELPER_THREAD_CORES");
+  const bool is_isolated_run = helper_cores && *helper_cores;
+
+  {
+    sycl::device dev{sycl::cpu_selector_v};
+    if(!is_isolated_run)
+      std::cout << "Device: " << dev.get_info<sycl::info::device::name>()
+                << std::endl;
+
+    sycl::queue q{dev, sycl::property::queue::in_order{}};
+    float* data = sycl::malloc_device<float>(kernel_size, q);
+    q.fill(data, 1.0f, kernel_size).wait();
+
+    latency_stats s = run(q, data, num_kernels);
+    std::string name = is_isolated_run
+                           ? "helper cores " + std::string{helper_cores}
+                           : "no isolation";
+    std::cout << name << ": median " << s.median_us << " us, p99 "
+              << s.p99_us << " us, max " << s.max_us << " us, stddev "
+              << s.stddev_us << " us" << std::endl;
+
+    sycl::free(data, q);
+  }
+
+  if(!is_isolated_run && argc > 2) {
+    // Settings are read once per process, so the isolated
+    // configuration is measured in a child process.
+    std::string cmd = "ACPP_RT_HELPER_THREAD_CORES=" + std::string{argv[2]} +
+                      " \"" + std::string{argv[0]} + "\" " +
+                      std::to_string(num_kernels);
+    return std::system(cmd.c_str()) == 0 ? 0 : 1;
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the throughput of independent kernels submitted to multiple
+// in-order queues on the OMP backend. By default, kernels execute one after
+// another using all cores; the benchmark is then repeated in a child process
+// with ACPP_RT_OMP_CORE_PARTITIONING=1, where concurrently executing kernels
+// run on disjoint sets of cores. Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./omp_multi_queue_throughput [num_queues] [kernels_per_queue]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t kernel_size = 1024 * 1024;
+
+void kernel(sycl::queue& q, float* data) {
+  q.parallel_for(sycl::range<1>{kernel_size}, [=](sycl::id<1> idx) {
+    float x = data[idx];
+    for(int i = 0; i < 32; ++i)
+      x = x * 0.999f + 0.001f;
+    data[idx] = x;
+  });
+}
+
+double run(std::vector<sycl::queue>& queues, std::vector<float*>& data,
+           std::size_t kernels_per_queue) {
+  // Warm up
+  for(std::size_t i = 0; i < queues.size(); ++i)
+    kernel(queues[i], data[i]);
+  for(auto& q : queues)
+    q.wait();
+
+  auto start = clock_type::now();
+  for(std::size_t k = 0; k < kernels_per_queue; ++k)
+    for(std::size_t i = 0; i < queues.size(); ++i)
+      kernel(queues[i], data[i]);
+  for(auto& q : queues)
+    q.wait();
+  auto stop = clock_type::now();
+
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char** argv) {
+  std::size_t num_queues = 4;
+  std::size_t kernels_per_queue = 50;
+  if(argc > 1)
+    num_queues = std::atoi(argv[1]);
+  if(argc > 2)
+    kernels_per_queue = std::atoi(argv[2]);
+
+  const char* partitioning = std::getenv("ACPP_RT_OMP_CORE_PARTITIONING");
+  const bool is_child = partitioning != nullptr;
+
+  {
+    sycl::device dev{sycl::cpu_selector_v};
+    if(!is_child)
+      std::cout << "Device: " << dev.get_info<sycl::info::device::name>()
+                << ", " << num_queues << " queues" << std::endl;
+
+    std::vector<sycl::queue> queues;
+    std::vector<float*> data;
+    for(std::size_t i = 0; i < num_queues; ++i) {
+      queues.emplace_back(dev, sycl::property::queue::in_order{});
+      data.push_back(sycl::malloc_device<float>(kernel_size, queues.back()));
+      queues.back().fill(data.back(), 1.0f, kernel_size);
+    }
+
+    double seconds = run(queues, data, kernels_per_queue);
+    std::string name = is_child ? "ACPP_RT_OMP_CORE_PARTITIONING=" +
+                                      std::string{partitioning}
+                                : "default";
+    std::cout << name << ": " << seconds << " s, "
+              << num_queues * kernels_per_queue / seconds << " kernels/s"
+              << std::endl;
+
+    for(std::size_t i = 0; i < num_queues; ++i)
+      sycl::free(data[i], queues[i]);
+  }
+
+  if(!is_child) {
+    // Settings are read once per process, so the partitioned
+    // configuration is measured in a child process.
+    std::string cmd = "ACPP_RT_OMP_CORE_PARTITIONING=1 \"" +
+                      std::string{argv[0]} + "\" " +
+                      std::to_string(num_queues) + " " +
+                      std::to_string(kernels_per_queue);
+    return std::system(cmd.c_str()) == 0 ? 0 : 1;
+  }
+}
@@ -0,0 +1,157 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the latency of short, latency-critical kernels on a high-priority
+// queue while a low-priority queue keeps the CPU busy with long batch kernels.
+// The same workload is run once with both queues at default priority, and
+// once with AdaptiveCpp_priority set. Run with the OMP backend, e.g.
+// ACPP_VISIBILITY_MASK=omp ./omp_priority_latency [num_requests]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Latency-critical applications typically rely on instant submission
+#define HIPSYCL_ALLOW_INSTANT_SUBMISSION 1
+#include <sycl/sycl.hpp>
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t batch_size = 16 * 1024 * 1024;
+constexpr std::size_t request_size = 64 * 1024;
+// Time between two requests, during which batch kernels can make progress
+constexpr auto request_interval = std::chrono::milliseconds{5};
+
+sycl::event batch_kernel(sycl::queue& q, float* data) {
+  return q.parallel_for(sycl::range<1>{batch_size}, [=](sycl::id<1> idx) {
+    float x = data[idx];
+    for(int i = 0; i < 64; ++i)
+      x = x * 0.999f + 0.001f;
+    data[idx] = x;
+  });
+}
+
+void request_kernel(sycl::queue& q, float* data) {
+  q.parallel_for(sycl::range<1>{request_size}, [=](sycl::id<1> idx) {
+    data[idx] += 1.0f;
+  });
+}
+
+struct latency_stats {
+  double median_us;
+  double p99_us;
+  double max_us;
+};
+
+latency_stats run(sycl::queue& batch_q, sycl::queue& request_q,
+                  float* batch_data, float* request_data,
+                  std::size_t num_requests) {
+  std::vector<double> latencies;
+  std::vector<sycl::event> pending_batches;
+
+  // Warm up
+  batch_kernel(batch_q, batch_data);
+  request_kernel(request_q, request_data);
+  batch_q.wait();
+  request_q.wait();
+
+  for(std::size_t i = 0; i < num_requests; ++i) {
+    // Keep the batch queue saturated
+    pending_batches.erase(
+        std::remove_if(pending_batches.begin(), pending_batches.end(),
+                       [](const sycl::event &e) {
+                         return e.get_info<
+                                    sycl::info::event::command_execution_status>() ==
+                                sycl::info::event_command_status::complete;
+                       }),
+        pending_batches.end());
+    while(pending_batches.size() < 2)
+      pending_batches.push_back(batch_kernel(batch_q, batch_data));
+
+    std::this_thread::sleep_for(request_interval);
+
+    auto start = clock_type::now();
+    request_kernel(request_q, request_data);
+    request_q.wait();
+    auto stop = clock_type::now();
+    latencies.push_back(
+        std::chrono::duration<double, std::micro>(stop - start).count());
+  }
+  batch_q.wait();
+
+  std::sort(latencies.begin(), latencies.end());
+  return latency_stats{latencies[latencies.size() / 2],
+                       latencies[latencies.size() * 99 / 100],
+                       latencies.back()};
+}
+
+void print(const char* name, const latency_stats& s) {
+  std::cout << name << ": median " << s.median_us << " us, p99 " << s.p99_us
+            << " us, max " << s.max_us << " us" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t num_requests = 100;
+  if(argc > 1)
+    num_requests = std::atoi(argv[1]);
+
+  sycl::device dev{sycl::cpu_selector_v};
+  std::cout << "Device: " << dev.get_info<sycl::info::device::name>()
+            << std::endl;
+
+  sycl::queue alloc_q{dev};
+  float* batch_data = sycl::malloc_device<float>(batch_size, alloc_q);
+  float* request_data = sycl::malloc_device<float>(request_size, alloc_q);
+  alloc_q.fill(batch_data, 1.0f, batch_size);
+  alloc_q.fill(request_data, 0.0f, request_size);
+  alloc_q.wait();
+
+  // Default priorities must be measured first: Once a queue with
+  // non-default priority exists, priority-aware execution stays enabled.
+  {
+    sycl::queue batch_q{dev, sycl::property::queue::in_order{}};
+    sycl::queue request_q{dev, sycl::property::queue::in_order{}};
+    print("default priority ",
+          run(batch_q, request_q, batch_data, request_data, num_requests));
+  }
+  {
+    sycl::queue batch_q{dev, sycl::property_list{
+        sycl::property::queue::in_order{},
+        sycl::property::queue::AdaptiveCpp_priority{1}}};
+    sycl::queue request_q{dev, sycl::property_list{
+        sycl::property::queue::in_order{},
+        sycl::property::queue::AdaptiveCpp_priority{-1}}};
+    print("with priorities  ",
+          run(batch_q, request_q, batch_data, request_data, num_requests));
+  }
+
+  sycl::free(batch_data, alloc_q);
+  sycl::free(request_data, alloc_q);
+}
@@ -0,0 +1,157 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures 2D 5-point and 3D 7-point Jacobi stencils with basic parallel_for
+// on the OMP backend for each host iteration order
+// (see ACPP_EXT_HOST_ITERATION_ORDER). Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./omp_stencil [n2d] [n3d] [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#include <sycl/sycl.hpp>
+
+using clock_type = std::chrono::steady_clock;
+
+struct order_config {
+  const char* name;
+  sycl::host_iteration_order order;
+};
+
+constexpr order_config orders[] = {
+    {"row_major", sycl::host_iteration_order::row_major},
+    {"tiled    ", sycl::host_iteration_order::tiled},
+    {"morton   ", sycl::host_iteration_order::morton},
+    {"hilbert  ", sycl::host_iteration_order::hilbert},
+    {"automatic", sycl::host_iteration_order::automatic}};
+
+template <int Dim, class Kernel>
+double run(sycl::queue &q, sycl::range<Dim> r, sycl::host_iteration_order order,
+           int iterations, float *a, float *b, Kernel k) {
+  sycl::property_list props{
+      sycl::property::command_group::AdaptiveCpp_host_iteration_order{order}};
+  auto sweep = [&]() {
+    q.submit(props, [&](sycl::handler &cgh) {
+      cgh.parallel_for(r, [=](sycl::item<Dim> idx) { k(idx, a, b); });
+    });
+    std::swap(a, b);
+  };
+  // Warm up
+  sweep();
+  q.wait();
+
+  auto start = clock_type::now();
+  for(int i = 0; i < iterations; ++i)
+    sweep();
+  q.wait();
+  auto stop = clock_type::now();
+  return std::chrono::duration<double>(stop - start).count() / iterations;
+}
+
+void print(const char* name, double seconds, std::size_t size) {
+  // Each point reads and writes one float at least once
+  double gb_per_s = 2.0 * sizeof(float) * size / seconds * 1.e-9;
+  std::cout << "  " << name << ": " << seconds * 1.e3 << " ms/sweep, "
+            << gb_per_s << " GB/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  std::size_t n2d = 8192;
+  std::size_t n3d = 384;
+  int iterations = 10;
+  if(argc > 1)
+    n2d = std::atoi(argv[1]);
+  if(argc > 2)
+    n3d = std::atoi(argv[2]);
+  if(argc > 3)
+    iterations = std::atoi(argv[3]);
+
+  sycl::queue q{sycl::cpu_selector_v, sycl::property::queue::in_order{}};
+  std::cout << "Device: " << q.get_device().get_info<sycl::info::device::name>()
+            << std::endl;
+
+  {
+    const sycl::range<2> r{n2d, n2d};
+    float* a = sycl::malloc_device<float>(r.size(), q);
+    float* b = sycl::malloc_device<float>(r.size(), q);
+    q.fill(a, 1.0f, r.size());
+    q.fill(b, 1.0f, r.size());
+    q.wait();
+
+    auto stencil = [=](sycl::item<2> idx, const float* in, float* out) {
+      const std::size_t i = idx[0];
+      const std::size_t j = idx[1];
+      const std::size_t n = n2d;
+      if(i == 0 || j == 0 || i == n - 1 || j == n - 1)
+        return;
+      out[i * n + j] = 0.2f * (in[i * n + j] + in[(i - 1) * n + j] +
+                               in[(i + 1) * n + j] + in[i * n + j - 1] +
+                               in[i * n + j + 1]);
+    };
+
+    std::cout << "2D 5-point stencil, " << n2d << "^2:" << std::endl;
+    for(const auto& o : orders)
+      print(o.name, run(q, r, o.order, iterations, a, b, stencil), r.size());
+
+    sycl::free(a, q);
+    sycl::free(b, q);
+  }
+  {
+    const sycl::range<3> r{n3d, n3d, n3d};
+    float* a = sycl::malloc_device<float>(r.size(), q);
+    float* b = sycl::malloc_device<float>(r.size(), q);
+    q.fill(a, 1.0f, r.size());
+    q.fill(b, 1.0f, r.size());
+    q.wait();
+
+    auto stencil = [=](sycl::item<3> idx, const float* in, float* out) {
+      const std::size_t i = idx[0];
+      const std::size_t j = idx[1];
+      const std::size_t k = idx[2];
+      const std::size_t n = n3d;
+      if(i == 0 || j == 0 || k == 0 || i == n - 1 || j == n - 1 || k == n - 1)
+        return;
+      auto at = [=](std::size_t x, std::size_t y, std::size_t z) {
+        return in[(x * n + y) * n + z];
+      };
+      out[(i * n + j) * n + k] =
+          (1.f / 7.f) * (at(i, j, k) + at(i - 1, j, k) + at(i + 1, j, k) +
+                         at(i, j - 1, k) + at(i, j + 1, k) + at(i, j, k - 1) +
+                         at(i, j, k + 1));
+    };
+
+    std::cout << "3D 7-point stencil, " << n3d << "^3:" << std::endl;
+    for(const auto& o : orders)
+      print(o.name, run(q, r, o.order, iterations, a, b, stencil), r.size());
+
+    sycl::free(a, q);
+    sycl::free(b, q);
+  }
+}
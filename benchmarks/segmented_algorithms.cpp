@@ -0,0 +1,256 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// Compares the segmented algorithms of the algorithms library with
+// ad-hoc kernels that accumulate into per-segment results using global
+// atomics, for uniform and skewed segment length distributions.
+// Run e.g. with
+// ACPP_VISIBILITY_MASK=omp ./segmented_algorithms [num_elements]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sycl/sycl.hpp>
+#include <hipSYCL/algorithms/numeric.hpp>
+
+namespace algorithms = hipsycl::algorithms;
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int num_repetitions = 5;
+
+template<class F>
+double best_of(F&& f) {
+  double best = 0.0;
+  for(int i = 0; i < num_repetitions + 1; ++i) {
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    // First run is warm-up
+    if(i == 1 || (i > 1 && seconds < best))
+      best = seconds;
+  }
+  return best;
+}
+
+std::vector<std::size_t> uniform_segments(std::size_t n,
+                                          std::size_t segment_length) {
+  std::vector<std::size_t> offsets;
+  for(std::size_t i = 0; i < n; i += segment_length)
+    offsets.push_back(i);
+  offsets.push_back(n);
+  return offsets;
+}
+
+// Power-law distributed segment lengths: Most segments are short, while few
+// segments cover a large fraction of the elements.
+std::vector<std::size_t> skewed_segments(std::size_t n) {
+  std::mt19937 gen{123};
+  std::uniform_real_distribution<double> dist{0.0, 1.0};
+  std::vector<std::size_t> offsets;
+  std::size_t current = 0;
+  while(current < n) {
+    offsets.push_back(current);
+    double u = std::max(dist(gen), 1.e-9);
+    std::size_t length = static_cast<std::size_t>(std::pow(u, -1.5));
+    current += std::max(length, std::size_t{1});
+  }
+  offsets.push_back(n);
+  return offsets;
+}
+
+struct results {
+  std::vector<float> segment_sums;
+  std::vector<float> inclusive_scan;
+  std::vector<float> exclusive_scan;
+};
+
+results reference(const std::vector<float>& data,
+                  const std::vector<std::size_t>& offsets) {
+  results r;
+  r.inclusive_scan.resize(data.size());
+  r.exclusive_scan.resize(data.size());
+  for(std::size_t s = 0; s + 1 < offsets.size(); ++s) {
+    float sum = 0.0f;
+    for(std::size_t i = offsets[s]; i < offsets[s+1]; ++i) {
+      r.exclusive_scan[i] = sum;
+      sum += data[i];
+      r.inclusive_scan[i] = sum;
+    }
+    r.segment_sums.push_back(sum);
+  }
+  return r;
+}
+
+template<class T>
+bool equals(const T* result, const std::vector<T>& expected) {
+  for(std::size_t i = 0; i < expected.size(); ++i)
+    if(result[i] != expected[i])
+      return false;
+  return true;
+}
+
+void print(const std::string& name, double seconds, std::size_t n,
+           bool is_correct) {
+  std::cout << "  " << std::setw(28) << std::left << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(3)
+            << seconds * 1.e3 << " ms" << std::setw(10)
+            << n * sizeof(float) / seconds * 1.e-9 << " GB/s"
+            << (is_correct ? "" : " (INCORRECT RESULTS)") << std::endl;
+}
+
+void benchmark(sycl::queue& q, algorithms::util::allocation_cache& cache,
+               const std::string& name, const std::vector<float>& host_data,
+               const std::vector<std::size_t>& host_offsets) {
+  const std::size_t n = host_data.size();
+  const std::size_t num_segments = host_offsets.size() - 1;
+  std::cout << name << ": " << num_segments << " segments, longest "
+            << [&]() {
+                 std::size_t longest = 0;
+                 for (std::size_t s = 0; s < num_segments; ++s)
+                   longest = std::max(longest,
+                                      host_offsets[s + 1] - host_offsets[s]);
+                 return longest;
+               }()
+            << std::endl;
+
+  results expected = reference(host_data, host_offsets);
+
+  float* data = sycl::malloc_shared<float>(n, q);
+  float* out = sycl::malloc_shared<float>(n, q);
+  std::size_t* offsets = sycl::malloc_shared<std::size_t>(num_segments + 1, q);
+  std::size_t* keys = sycl::malloc_shared<std::size_t>(n, q);
+  std::size_t* keys_out = sycl::malloc_shared<std::size_t>(n, q);
+  std::size_t* num_keys = sycl::malloc_shared<std::size_t>(1, q);
+  q.copy(host_data.data(), data, n);
+  q.copy(host_offsets.data(), offsets, num_segments + 1);
+  q.wait();
+  for(std::size_t s = 0; s < num_segments; ++s)
+    for(std::size_t i = host_offsets[s]; i < host_offsets[s+1]; ++i)
+      keys[i] = s;
+  // Keys of empty segments cannot show up in reduce_by_key
+  std::vector<float> expected_by_key;
+  for(std::size_t s = 0; s < num_segments; ++s)
+    if(host_offsets[s + 1] > host_offsets[s])
+      expected_by_key.push_back(expected.segment_sums[s]);
+
+  double t = best_of([&]() {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    q.fill(out, 0.0f, num_segments);
+    q.parallel_for(sycl::range<1>{n}, [=](sycl::id<1> idx) {
+      sycl::atomic_ref<float, sycl::memory_order::relaxed,
+                       sycl::memory_scope::device>
+          result{out[keys[idx]]};
+      result.fetch_add(data[idx]);
+    });
+    q.wait();
+  });
+  // Atomic accumulation order is unspecified, so only verify approximately
+  bool is_correct = true;
+  for(std::size_t s = 0; s < num_segments; ++s)
+    if(std::abs(out[s] - expected.segment_sums[s]) >
+       1.e-3f * std::abs(expected.segment_sums[s]))
+      is_correct = false;
+  print("global atomics", t, n, is_correct);
+
+  t = best_of([&]() {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::segmented_reduce(q, scratch, data, data + n, offsets,
+                                 offsets + num_segments + 1, out, 0.0f);
+    q.wait();
+  });
+  print("segmented_reduce", t, n, equals(out, expected.segment_sums));
+
+  t = best_of([&]() {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::reduce_by_key(q, scratch, keys, keys + n, data, keys_out, out,
+                              num_keys);
+    q.wait();
+  });
+  print("reduce_by_key", t, n,
+        *num_keys == expected_by_key.size() && equals(out, expected_by_key));
+
+  t = best_of([&]() {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::segmented_inclusive_scan(q, scratch, data, data + n, offsets,
+                                         offsets + num_segments + 1, out);
+    q.wait();
+  });
+  print("segmented_inclusive_scan", t, n,
+        equals(out, expected.inclusive_scan));
+
+  t = best_of([&]() {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::segmented_exclusive_scan(q, scratch, data, data + n, offsets,
+                                         offsets + num_segments + 1, out,
+                                         0.0f);
+    q.wait();
+  });
+  print("segmented_exclusive_scan", t, n,
+        equals(out, expected.exclusive_scan));
+
+  sycl::free(data, q);
+  sycl::free(out, q);
+  sycl::free(offsets, q);
+  sycl::free(keys, q);
+  sycl::free(keys_out, q);
+  sycl::free(num_keys, q);
+}
+
+int main(int argc, char** argv) {
+  std::size_t n = 1 << 24;
+  if(argc > 1)
+    n = std::atol(argv[1]);
+
+  sycl::queue q{sycl::property::queue::in_order{}};
+  std::cout << "Device: "
+            << q.get_device().get_info<sycl::info::device::name>()
+            << std::endl;
+  std::cout << n << " elements" << std::endl;
+
+  algorithms::util::allocation_cache cache{
+      algorithms::util::allocation_type::device};
+
+  // Small integers so that all float sums are exact
+  std::vector<float> data(n);
+  for(std::size_t i = 0; i < n; ++i)
+    data[i] = static_cast<float>(i % 4);
+
+  benchmark(q, cache, "uniform, length 16", data, uniform_segments(n, 16));
+  benchmark(q, cache, "uniform, length 4096", data, uniform_segments(n, 4096));
+  benchmark(q, cache, "skewed", data, skewed_segments(n));
+}
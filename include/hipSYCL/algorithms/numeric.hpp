@@ -28,13 +28,18 @@
 #ifndef HIPSYCL_ALGORITHMS_NUMERIC_HPP
 #define HIPSYCL_ALGORITHMS_NUMERIC_HPP
 
+#include <algorithm>
 #include <cstddef>
 #include <iterator>
 #include <functional>
 #include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "../algorithms/util/allocation_cache.hpp"
 #include "../sycl/libkernel/accessor.hpp"
+#include "../sycl/libkernel/atomic_ref.hpp"
 #include "../sycl/libkernel/functional.hpp"
 #include "../sycl/event.hpp"
 #include "../sycl/queue.hpp"
@@ -78,15 +83,12 @@ auto get_reduction_operator_configuration(const BinaryOp& op) {
 }
 
 
-template <class T, class Kernel,
-          class BinaryReductionOp>
+template <class Kernel, typename... ReductionDescriptors>
 sycl::event wg_model_reduction(sycl::queue &q,
                                util::allocation_group &scratch_allocations,
-                               T *output, T init, std::size_t target_num_groups,
                                std::size_t local_size, std::size_t problem_size,
-                               Kernel k, BinaryReductionOp op) {
-  assert(target_num_groups > 0);
-
+                               Kernel k,
+                               const ReductionDescriptors &...descriptors) {
   sycl::event last_event;
   auto ndrange_launcher =
       [&](std::size_t num_groups, std::size_t wg_size, std::size_t global_size,
@@ -101,13 +103,9 @@ sycl::event wg_model_reduction(sycl::queue &q,
         });
       };
 
-  auto operator_config = get_reduction_operator_configuration<T>(op);
-  auto reduction_descriptor = reduction::reduction_descriptor{
-      operator_config, init, output};
-
   using group_reduction_type =
       reduction::wg_model::group_reductions::generic_local_memory<
-          std::decay_t<decltype(reduction_descriptor)>>;
+          ReductionDescriptors...>;
   
   // The reduction engine will update this value with the
   // appropriate amount of local memory for the main kernel.
@@ -122,18 +120,22 @@ sycl::event wg_model_reduction(sycl::queue &q,
 
   const std::size_t dispatched_global_size =
       streamer.get_required_global_size();
-  auto plan = engine.create_plan(dispatched_global_size, local_size,
-                                reduction_descriptor);
+  auto plan =
+      engine.create_plan(dispatched_global_size, local_size, descriptors...);
 
   auto main_kernel = engine.make_main_reducing_kernel(
-      [=](sycl::nd_item<1> idx, auto &reducer) {
+      [=](sycl::nd_item<1> idx, auto &...reducers) {
 
         util::data_streamer::run(problem_size, idx, [&](sycl::id<1> i){
-          k(i, reducer);
+          k(i, reducers...);
         });
       },
       plan);
 
+  engine.initialize_scratch(
+      [&](void *ptr, std::size_t num_bytes) { q.memset(ptr, 0, num_bytes); },
+      plan);
+
   last_event = q.submit([&](sycl::handler &cgh) {
     sycl::local_accessor<char> acc{sycl::range<1>{main_kernel_local_mem}, cgh};
     cgh.parallel_for(sycl::nd_range<1>{dispatched_global_size, local_size},
@@ -146,20 +148,11 @@ sycl::event wg_model_reduction(sycl::queue &q,
   return last_event;
 }
 
-template <class T, class Kernel, class BinaryReductionOp>
-sycl::event
-wg_model_reduction(sycl::queue &q, util::allocation_group &scratch_allocations,
-                   T *output, T init, std::size_t target_num_groups,
-                   std::size_t problem_size, Kernel k, BinaryReductionOp op) {
-  return wg_model_reduction(q, scratch_allocations, output, init,
-                                  target_num_groups, 128, problem_size, k, op);
-}
-
-template <class T, class Kernel, class BinaryReductionOp>
+template <class Kernel, typename... ReductionDescriptors>
 sycl::event threading_model_reduction(sycl::queue &q,
                                   util::allocation_group &scratch_allocations,
-                                  T *output, T init, std::size_t n, Kernel k,
-                                  BinaryReductionOp op) {
+                                  std::size_t n, Kernel k,
+                                  const ReductionDescriptors &...descriptors) {
 
   sycl::event last_event;
   auto single_task_launcher =
@@ -167,14 +160,10 @@ sycl::event threading_model_reduction(sycl::queue &q,
         last_event = q.single_task(kernel);
       };
 
-  auto operator_config = get_reduction_operator_configuration<T>(op);
-  auto reduction_descriptor = reduction::reduction_descriptor{
-      operator_config, init, output};
-  
   reduction::threading_model::omp_thread_info_query thread_info_query;
   reduction::threading_reduction_engine engine{thread_info_query,
                                                &scratch_allocations};
-  auto plan = engine.create_plan(n, reduction_descriptor);
+  auto plan = engine.create_plan(n, descriptors...);
   auto main_kernel = engine.make_main_reducing_kernel(k, plan);
   
   last_event = q.submit([&](sycl::handler &cgh) {
@@ -187,24 +176,672 @@ sycl::event threading_model_reduction(sycl::queue &q,
   return last_event;
 }
 
+/// Invokes k(idx, reducers...) for all idx in [0, n), with one reducer
+/// per reduction descriptor, such that all reductions are computed by
+/// the same kernel.
+template <class Kernel, typename... ReductionDescriptors>
+sycl::event reduction_impl(sycl::queue &q,
+                           util::allocation_group &scratch_allocations,
+                           std::size_t n, Kernel k,
+                           const ReductionDescriptors &...descriptors) {
+  if(q.get_device().is_host()) {
+#ifdef HIPSYCL_ALGORITHMS_TRANSFORM_REDUCE_HOST_THREADING_MODEL
+    return threading_model_reduction(q, scratch_allocations, n, k,
+                                     descriptors...);
+#endif
+  }
+  return wg_model_reduction(q, scratch_allocations, 128, n, k, descriptors...);
+}
+
 template <class T, class Kernel, class BinaryReductionOp>
 sycl::event transform_reduce_impl(sycl::queue &q,
                                   util::allocation_group &scratch_allocations,
                                   T *output, T init, std::size_t n, Kernel k,
                                   BinaryReductionOp op) {
+  auto operator_config = get_reduction_operator_configuration<T>(op);
+  return reduction_impl(
+      q, scratch_allocations, n, k,
+      reduction::reduction_descriptor{operator_config, init, output});
+}
+
+template <class T, class DescriptorTuple, std::size_t... Is,
+          typename... Reducers>
+void combine_transformed(const T &x, const DescriptorTuple &descriptors,
+                         std::index_sequence<Is...>, Reducers &...reducers) {
+  (reducers.combine(std::get<Is>(descriptors).transform(x)), ...);
+}
+
+template <class Kernel, typename... OutputTs, class DescriptorTuple,
+          std::size_t... Is>
+sycl::event fused_transform_reduce_impl(
+    sycl::queue &q, util::allocation_group &scratch_allocations, std::size_t n,
+    Kernel k, const std::tuple<OutputTs *...> &outputs,
+    const DescriptorTuple &descriptors, std::index_sequence<Is...>) {
+  return reduction_impl(
+      q, scratch_allocations, n, k,
+      reduction::reduction_descriptor{
+          get_reduction_operator_configuration<OutputTs>(
+              std::get<Is>(descriptors).reduce),
+          static_cast<OutputTs>(std::get<Is>(descriptors).init),
+          std::get<Is>(outputs)}...);
+}
+
+template<class It>
+auto load(It it, std::size_t i) {
+  std::advance(it, i);
+  return *it;
+}
+
+template<class It, class T>
+void store(It it, std::size_t i, const T& value) {
+  std::advance(it, i);
+  *it = value;
+}
+
+/// Computes floor(a * b / c) for a < c without overflowing.
+inline unsigned long long mul_div_floor(unsigned long long a,
+                                        unsigned long long b,
+                                        unsigned long long c) noexcept {
+  if(b == 0 || a <= std::numeric_limits<unsigned long long>::max() / b)
+    return (a * b) / c;
+  // Binary long multiplication of a and b modulo c, maintaining
+  // a * (processed bits of b) = q * c + r with r < c.
+  unsigned long long q = 0;
+  unsigned long long r = 0;
+  for(int i = std::numeric_limits<unsigned long long>::digits - 1; i >= 0;
+      --i) {
+    q *= 2;
+    if(r >= c - r) {
+      r -= c - r;
+      ++q;
+    } else {
+      r *= 2;
+    }
+    if((b >> i) & 1) {
+      if(r >= c - a) {
+        r -= c - a;
+        ++q;
+      } else {
+        r += a;
+      }
+    }
+  }
+  return q;
+}
+
+/// Segmented algorithms decompose the input into tiles of consecutive
+/// elements, each of which is processed sequentially by one work item.
+/// Segments crossing tile boundaries are stitched together by a
+/// serial pass over all tiles.
+template<class T>
+struct segment_tile {
+  // Reduction of the tile's last segment, if it continues into the next tile
+  T carry;
+  // Reduction of the tile's first segment, if it began in an earlier tile
+  // and ends within this tile
+  T head;
+  // Contribution of all earlier tiles to the tile's first segment.
+  // Set by the serial pass.
+  T incoming;
+  std::size_t head_segment;
+  // reduce_by_key: Number of segments beginning within this tile,
+  // and within all earlier tiles.
+  std::size_t num_heads;
+  std::size_t heads_before;
+  bool has_carry;
+  bool carry_starts_in_tile;
+  bool has_head;
+  bool has_incoming;
+};
+
+struct tile_decomposition {
+  std::size_t problem_size;
+  std::size_t num_tiles;
+  std::size_t tile_size;
+
+  std::size_t get_begin(std::size_t tile) const noexcept {
+    return tile * tile_size;
+  }
+
+  std::size_t get_end(std::size_t tile) const noexcept {
+    return std::min(problem_size, (tile + 1) * tile_size);
+  }
+
+  bool is_last(std::size_t tile) const noexcept {
+    return tile == num_tiles - 1;
+  }
+};
+
+inline tile_decomposition make_tile_decomposition(std::size_t problem_size,
+                                                  std::size_t tile_size) {
+  return tile_decomposition{
+      problem_size, reduction::detail::ceil_division(problem_size, tile_size),
+      tile_size};
+}
+
+inline tile_decomposition decompose_into_tiles(sycl::queue &q,
+                                               std::size_t problem_size) {
+  // On the host, use one tile per thread like the threading reduction model.
+  // On devices, we need enough tiles to fill all compute units, but not so
+  // many that the serial pass over all tiles becomes expensive.
+  std::size_t max_num_tiles = 1;
   if(q.get_device().is_host()) {
-#ifdef HIPSYCL_ALGORITHMS_TRANSFORM_REDUCE_HOST_THREADING_MODEL
-    return threading_model_reduction(q, scratch_allocations, output, init, n, k,
-                                     op);
-#endif
+    reduction::threading_model::omp_thread_info_query thread_info_query;
+    max_num_tiles = thread_info_query.get_max_num_threads();
+  } else {
+    max_num_tiles =
+        q.get_device().get_info<sycl::info::device::max_compute_units>() * 128;
+  }
+  const std::size_t min_tile_size = 16;
+  std::size_t tile_size =
+      std::max(min_tile_size,
+               reduction::detail::ceil_division(
+                   problem_size, std::max(max_num_tiles, std::size_t{1})));
+
+  return make_tile_decomposition(problem_size, tile_size);
+}
+
+/// Invokes f(segment, segment_begin, segment_end) for all segments of
+/// an offset array that the tile [begin, end) contributes to or is
+/// responsible for. Empty segments are processed by the tile containing
+/// their offset.
+template <class OffsetIt, class F>
+void for_each_segment_in_tile(OffsetIt offsets, std::size_t num_segments,
+                              std::size_t begin, std::size_t end,
+                              bool is_last_tile, F &&f) {
+  auto offset = [=](std::size_t i) {
+    return static_cast<std::size_t>(load(offsets, i));
+  };
+  // Binary search for the first segment that does not end before the tile
+  std::size_t low = 0;
+  std::size_t high = num_segments;
+  while(low < high) {
+    std::size_t mid = (low + high) / 2;
+    if(offset(mid + 1) < begin)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  for(std::size_t s = low; s < num_segments; ++s) {
+    std::size_t segment_begin = offset(s);
+    std::size_t segment_end = offset(s + 1);
+    if(segment_begin > end || (segment_begin == end && !is_last_tile))
+      return;
+    // Non-empty segments ending at the tile begin belong to the previous tile
+    if(segment_end == begin && segment_begin < begin)
+      continue;
+    f(s, segment_begin, segment_end);
   }
-  sycl::device dev = q.get_device();
-  std::size_t num_groups =
-      dev.get_info<sycl::info::device::max_compute_units>() * 4;
+}
+
+template<class T, class InputIt, class BinaryOp>
+T reduce_non_empty_range(InputIt first, std::size_t begin, std::size_t end,
+                         BinaryOp op) {
+  T result = load(first, begin);
+  for(std::size_t i = begin + 1; i < end; ++i)
+    result = op(result, load(first, i));
+  return result;
+}
 
-  return wg_model_reduction(q, scratch_allocations, output, init, num_groups,
-                            n, k, op);
+/// Serial pass over all tiles: Stores the contribution of earlier tiles to
+/// each tile's first segment as well as the number of segments beginning
+/// in earlier tiles, and then invokes on_tile(tile_index, tile).
+template <class T, class BinaryOp, class TileHandler>
+sycl::event propagate_tile_carries(sycl::queue &q, segment_tile<T> *tiles,
+                                   std::size_t num_tiles, BinaryOp op,
+                                   TileHandler on_tile) {
+  return q.single_task([=](){
+    bool has_incoming = false;
+    T incoming;
+    std::size_t num_heads = 0;
+    for(std::size_t t = 0; t < num_tiles; ++t) {
+      segment_tile<T>& tile = tiles[t];
+      tile.has_incoming = has_incoming;
+      if(has_incoming)
+        tile.incoming = incoming;
+      tile.heads_before = num_heads;
+      num_heads += tile.num_heads;
 
+      on_tile(t, tile);
+
+      if(tile.has_carry) {
+        if(tile.carry_starts_in_tile || !has_incoming)
+          incoming = tile.carry;
+        else
+          incoming = op(incoming, tile.carry);
+        has_incoming = true;
+      } else {
+        has_incoming = false;
+      }
+    }
+  });
+}
+
+template <class InputIt, class OffsetIt, class OutputIt, class T,
+          class BinaryOp>
+sycl::event segmented_reduce_by_tiles(
+    sycl::queue &q, util::allocation_group &scratch_allocations,
+    const tile_decomposition &tiling, InputIt first, OffsetIt offsets,
+    std::size_t num_segments, OutputIt d_out, T init, BinaryOp op) {
+
+  segment_tile<T> *tiles =
+      scratch_allocations.obtain<segment_tile<T>>(tiling.num_tiles);
+
+  q.parallel_for(sycl::range<1>{tiling.num_tiles}, [=](sycl::id<1> idx) {
+    const std::size_t t = idx[0];
+    const std::size_t begin = tiling.get_begin(t);
+    const std::size_t end = tiling.get_end(t);
+
+    segment_tile<T>& tile = tiles[t];
+    tile.has_carry = false;
+    tile.has_head = false;
+    tile.num_heads = 0;
+
+    for_each_segment_in_tile(
+        offsets, num_segments, begin, end, tiling.is_last(t),
+        [&](std::size_t s, std::size_t segment_begin, std::size_t segment_end) {
+          std::size_t low = std::max(segment_begin, begin);
+          std::size_t high = std::min(segment_end, end);
+          if(segment_end > end) {
+            tile.carry = reduce_non_empty_range<T>(first, low, high, op);
+            tile.has_carry = true;
+            tile.carry_starts_in_tile = segment_begin >= begin;
+          } else if(segment_begin < begin) {
+            tile.head = reduce_non_empty_range<T>(first, low, high, op);
+            tile.has_head = true;
+            tile.head_segment = s;
+          } else {
+            // Segment lies entirely within this tile
+            T result = init;
+            for(std::size_t i = low; i < high; ++i)
+              result = op(result, load(first, i));
+            store(d_out, s, result);
+          }
+        });
+  });
+
+  // Complete the segments that span multiple tiles
+  return propagate_tile_carries(
+      q, tiles, tiling.num_tiles, op,
+      [=](std::size_t t, const segment_tile<T> &tile) {
+        if(tile.has_head)
+          store(d_out, tile.head_segment,
+                op(op(init, tile.incoming), tile.head));
+      });
+}
+
+/// One work group per segment, reduced with the building blocks
+/// of the work group reduction model. Suitable for devices if
+/// segments are long compared to the work group size.
+template <class InputIt, class OffsetIt, class OutputIt, class T,
+          class BinaryOp>
+sycl::event segmented_reduce_by_groups(sycl::queue &q, InputIt first,
+                                       OffsetIt offsets,
+                                       std::size_t num_segments,
+                                       OutputIt d_out, T init, BinaryOp op,
+                                       std::size_t group_size) {
+
+  auto operator_config = get_reduction_operator_configuration<T>(op);
+  auto reduction_descriptor = reduction::reduction_descriptor{
+      operator_config, init, static_cast<T*>(nullptr)};
+
+  using group_reduction_type =
+      reduction::wg_model::group_reductions::generic_local_memory<
+          std::decay_t<decltype(reduction_descriptor)>>;
+
+  std::size_t local_mem = 0;
+  group_reduction_type group_reduction{local_mem, group_size};
+
+  return q.submit([&](sycl::handler &cgh) {
+    // Registers the local memory used by group_reduction, see
+    // wg_model_reduction()
+    sycl::local_accessor<char> acc{sycl::range<1>{local_mem}, cgh};
+    cgh.parallel_for(
+        sycl::nd_range<1>{num_segments * group_size, group_size},
+        [=](sycl::nd_item<1> idx) {
+          const std::size_t s = idx.get_group_linear_id();
+          const std::size_t segment_begin =
+              static_cast<std::size_t>(load(offsets, s));
+          const std::size_t segment_end =
+              static_cast<std::size_t>(load(offsets, s + 1));
+
+          reduction::wg_model::sequential_reducer<decltype(operator_config)>
+              wi_reducer{operator_config};
+          for (std::size_t i = segment_begin + idx.get_local_linear_id();
+               i < segment_end; i += group_size)
+            wi_reducer.combine(load(first, i));
+
+          bool is_leader;
+          bool result_is_initialized;
+          T result = group_reduction(idx, reduction_descriptor, wi_reducer,
+                                     is_leader, result_is_initialized);
+          if (is_leader) {
+            store(d_out, s,
+                  result_is_initialized ? op(init, result) : init);
+          }
+        });
+  });
+}
+
+template <class InputIt, class OffsetIt, class OutputIt, class T,
+          class BinaryOp, bool IsInclusive>
+sycl::event segmented_scan(sycl::queue &q,
+                           util::allocation_group &scratch_allocations,
+                           const tile_decomposition &tiling, InputIt first,
+                           OffsetIt offsets, std::size_t num_segments,
+                           OutputIt d_first, T init, BinaryOp op,
+                           std::integral_constant<bool, IsInclusive>) {
+
+  segment_tile<T> *tiles =
+      scratch_allocations.obtain<segment_tile<T>>(tiling.num_tiles);
+
+  // Scans [begin, end) starting from the given state and returns the final
+  // state. For exclusive scans, the state includes the init value.
+  auto scan_range = [=](std::size_t begin, std::size_t end, T state,
+                        bool has_state) {
+    for(std::size_t i = begin; i < end; ++i) {
+      // Read before writing to support in-place scans
+      T value = load(first, i);
+      if constexpr(IsInclusive) {
+        state = has_state ? op(state, value) : value;
+        has_state = true;
+        store(d_first, i, state);
+      } else {
+        store(d_first, i, state);
+        state = op(state, value);
+      }
+    }
+    return state;
+  };
+
+  q.parallel_for(sycl::range<1>{tiling.num_tiles}, [=](sycl::id<1> idx) {
+    const std::size_t t = idx[0];
+    const std::size_t begin = tiling.get_begin(t);
+    const std::size_t end = tiling.get_end(t);
+
+    segment_tile<T>& tile = tiles[t];
+    tile.has_carry = false;
+    tile.has_head = false;
+    tile.num_heads = 0;
+
+    for_each_segment_in_tile(
+        offsets, num_segments, begin, end, tiling.is_last(t),
+        [&](std::size_t s, std::size_t segment_begin, std::size_t segment_end) {
+          std::size_t low = std::max(segment_begin, begin);
+          std::size_t high = std::min(segment_end, end);
+          if(segment_begin < begin) {
+            // The first segment began in an earlier tile; its results can only
+            // be written once the contributions of earlier tiles are known.
+            tile.has_head = true;
+            tile.head_segment = s;
+            if(segment_end > end) {
+              tile.carry = reduce_non_empty_range<T>(first, low, high, op);
+              tile.has_carry = true;
+              tile.carry_starts_in_tile = false;
+            }
+          } else {
+            T state = scan_range(low, high, init, !IsInclusive);
+            if(segment_end > end) {
+              tile.carry = state;
+              tile.has_carry = true;
+              tile.carry_starts_in_tile = true;
+            }
+          }
+        });
+  });
+
+  propagate_tile_carries(q, tiles, tiling.num_tiles, op,
+                         [](std::size_t, const segment_tile<T> &) {});
+
+  return q.parallel_for(sycl::range<1>{tiling.num_tiles}, [=](sycl::id<1> idx) {
+    const std::size_t t = idx[0];
+    const segment_tile<T>& tile = tiles[t];
+    if(tile.has_head) {
+      const std::size_t begin = tiling.get_begin(t);
+      const std::size_t segment_end =
+          static_cast<std::size_t>(load(offsets, tile.head_segment + 1));
+      const std::size_t end = std::min(tiling.get_end(t), segment_end);
+
+      scan_range(begin, end, tile.incoming, true);
+    }
+  });
+}
+
+/// Strategies to privatize the bins of a histogram, so that concurrent
+/// updates of the same bin do not all have to go through global atomics.
+enum class histogram_strategy {
+  // Each thread counts into its own copy of all bins, and the copies are
+  // merged at the end. Suitable for the host with few threads.
+  private_bins,
+  // Each work group counts into a copy of all bins in local memory, and
+  // flushes it to the output with global atomics.
+  local_memory_bins,
+  // All work items update the output bins directly.
+  global_atomics
+};
+
+inline histogram_strategy select_histogram_strategy(sycl::queue &q,
+                                                    std::size_t problem_size,
+                                                    std::size_t num_bins) {
+  if(q.get_device().is_host()) {
+    // Zeroing and merging the private copies is O(num_bins * num_threads),
+    // which should not dominate the actual binning work.
+    const std::size_t num_tiles =
+        decompose_into_tiles(q, problem_size).num_tiles;
+    const std::size_t max_private_counts =
+        std::max(problem_size, std::size_t{1} << 16);
+    if(num_bins * num_tiles <= max_private_counts)
+      return histogram_strategy::private_bins;
+    return histogram_strategy::global_atomics;
+  }
+  // Only use up to half of the local memory so that multiple work groups
+  // can still be resident per compute unit.
+  const std::size_t local_mem_size =
+      q.get_device().get_info<sycl::info::device::local_mem_size>();
+  if(num_bins * sizeof(unsigned int) <= local_mem_size / 2)
+    return histogram_strategy::local_memory_bins;
+  return histogram_strategy::global_atomics;
+}
+
+template <class KeyIt, class ValueIt, class KeyOutIt, class ValueOutIt,
+          class BinaryPredicate, class BinaryOp>
+sycl::event reduce_by_key_by_tiles(
+    sycl::queue &q, util::allocation_group &scratch_allocations,
+    const tile_decomposition &tiling, KeyIt keys_first, ValueIt values_first,
+    KeyOutIt keys_out, ValueOutIt values_out, std::size_t *num_keys_out,
+    BinaryPredicate equal, BinaryOp op) {
+  using T = typename std::iterator_traits<ValueIt>::value_type;
+  const std::size_t n = tiling.problem_size;
+
+  segment_tile<T> *tiles =
+      scratch_allocations.obtain<segment_tile<T>>(tiling.num_tiles);
+
+  auto is_head = [=](std::size_t i) {
+    return i == 0 || !equal(load(keys_first, i - 1), load(keys_first, i));
+  };
+
+  q.parallel_for(sycl::range<1>{tiling.num_tiles}, [=](sycl::id<1> idx) {
+    const std::size_t t = idx[0];
+    const std::size_t begin = tiling.get_begin(t);
+    const std::size_t end = tiling.get_end(t);
+
+    segment_tile<T>& tile = tiles[t];
+    tile.has_head = false;
+    tile.num_heads = 0;
+
+    std::size_t last_head = begin;
+    for(std::size_t i = begin; i < end; ++i) {
+      if(is_head(i)) {
+        ++tile.num_heads;
+        last_head = i;
+      }
+    }
+
+    tile.has_carry = end < n && !is_head(end);
+    if(tile.has_carry) {
+      tile.carry =
+          reduce_non_empty_range<T>(values_first, last_head, end, op);
+      tile.carry_starts_in_tile = tile.num_heads > 0;
+    }
+  });
+
+  propagate_tile_carries(
+      q, tiles, tiling.num_tiles, op,
+      [=](std::size_t t, const segment_tile<T> &tile) {
+        if(t == tiling.num_tiles - 1)
+          *num_keys_out = tile.heads_before + tile.num_heads;
+      });
+
+  return q.parallel_for(sycl::range<1>{tiling.num_tiles}, [=](sycl::id<1> idx) {
+    const std::size_t t = idx[0];
+    const std::size_t begin = tiling.get_begin(t);
+    const std::size_t end = tiling.get_end(t);
+    const segment_tile<T>& tile = tiles[t];
+
+    // Index of the next segment to begin
+    std::size_t segment = tile.heads_before;
+    T current = tile.has_incoming ? tile.incoming : T{};
+    bool is_current_head = is_head(begin);
+    for(std::size_t i = begin; i < end; ++i) {
+      T value = load(values_first, i);
+      if(is_current_head) {
+        store(keys_out, segment, load(keys_first, i));
+        current = value;
+        ++segment;
+      } else {
+        current = op(current, value);
+      }
+
+      bool is_next_head = (i + 1 == n) || is_head(i + 1);
+      if(is_next_head)
+        store(values_out, segment - 1, current);
+      is_current_head = is_next_head;
+    }
+  });
+}
+
+template <class InputIt, class Binning, class CountT>
+sycl::event histogram_by_private_bins(sycl::queue &q,
+                                      util::allocation_group &scratch_allocations,
+                                      InputIt first, std::size_t problem_size,
+                                      Binning binning, CountT *bins) {
+  const std::size_t num_bins = binning.get_num_bins();
+  tile_decomposition tiling = decompose_into_tiles(q, problem_size);
+
+  // Pad each private copy to whole cache lines to avoid false sharing
+  const std::size_t counts_per_cache_line = std::max(
+      std::size_t{1},
+      reduction::threading_model::cache_line_size / sizeof(CountT));
+  const std::size_t row_size =
+      reduction::detail::ceil_division(num_bins, counts_per_cache_line) *
+      counts_per_cache_line;
+  CountT *private_bins =
+      scratch_allocations.obtain<CountT>(tiling.num_tiles * row_size);
+
+  q.parallel_for(sycl::range<1>{tiling.num_tiles}, [=](sycl::id<1> idx) {
+    const std::size_t t = idx[0];
+    CountT *tile_bins = private_bins + t * row_size;
+    for(std::size_t b = 0; b < num_bins; ++b)
+      tile_bins[b] = CountT{0};
+
+    for(std::size_t i = tiling.get_begin(t); i < tiling.get_end(t); ++i) {
+      std::size_t bin;
+      if(binning.get_bin(load(first, i), bin))
+        ++tile_bins[bin];
+    }
+  });
+
+  return q.parallel_for(sycl::range<1>{num_bins}, [=](sycl::id<1> idx) {
+    const std::size_t b = idx[0];
+    CountT count = CountT{0};
+    for(std::size_t t = 0; t < tiling.num_tiles; ++t)
+      count += private_bins[t * row_size + b];
+    bins[b] = count;
+  });
+}
+
+template <class InputIt, class Binning, class CountT>
+sycl::event histogram_by_local_memory_bins(sycl::queue &q, InputIt first,
+                                           std::size_t problem_size,
+                                           Binning binning, CountT *bins) {
+  const std::size_t num_bins = binning.get_num_bins();
+  const std::size_t group_size = 256;
+  util::data_streamer streamer{q.get_device(), problem_size, group_size};
+  const std::size_t dispatched_global_size =
+      streamer.get_required_global_size();
+
+  q.memset(bins, 0, num_bins * sizeof(CountT));
+  return q.submit([&](sycl::handler &cgh) {
+    sycl::local_accessor<unsigned int> group_bins{sycl::range<1>{num_bins},
+                                                  cgh};
+    cgh.parallel_for(
+        sycl::nd_range<1>{dispatched_global_size, group_size},
+        [=](sycl::nd_item<1> idx) {
+          const std::size_t lid = idx.get_local_linear_id();
+          for(std::size_t b = lid; b < num_bins; b += group_size)
+            group_bins[b] = 0;
+          sycl::group_barrier(idx.get_group());
+
+          util::data_streamer::run(problem_size, idx, [&](sycl::id<1> i) {
+            std::size_t bin;
+            if(binning.get_bin(load(first, i[0]), bin)) {
+              sycl::atomic_ref<unsigned int, sycl::memory_order::relaxed,
+                               sycl::memory_scope::work_group,
+                               sycl::access::address_space::local_space>{
+                  group_bins[bin]}
+                  .fetch_add(1u);
+            }
+          });
+          sycl::group_barrier(idx.get_group());
+
+          for(std::size_t b = lid; b < num_bins; b += group_size) {
+            const unsigned int count = group_bins[b];
+            if(count > 0) {
+              sycl::atomic_ref<CountT, sycl::memory_order::relaxed,
+                               sycl::memory_scope::device,
+                               sycl::access::address_space::global_space>{
+                  bins[b]}
+                  .fetch_add(static_cast<CountT>(count));
+            }
+          }
+        });
+  });
+}
+
+template <class InputIt, class Binning, class CountT>
+sycl::event histogram_by_global_atomics(sycl::queue &q, InputIt first,
+                                        std::size_t problem_size,
+                                        Binning binning, CountT *bins) {
+  q.memset(bins, 0, binning.get_num_bins() * sizeof(CountT));
+  return q.parallel_for(sycl::range<1>{problem_size}, [=](sycl::id<1> idx) {
+    std::size_t bin;
+    if(binning.get_bin(load(first, idx[0]), bin)) {
+      sycl::atomic_ref<CountT, sycl::memory_order::relaxed,
+                       sycl::memory_scope::device,
+                       sycl::access::address_space::global_space>{bins[bin]}
+          .fetch_add(CountT{1});
+    }
+  });
+}
+
+template <class InputIt, class Binning, class CountT>
+sycl::event histogram(sycl::queue &q,
+                      util::allocation_group &scratch_allocations,
+                      InputIt first, std::size_t problem_size,
+                      Binning binning, CountT *bins,
+                      histogram_strategy strategy) {
+  switch(strategy) {
+  case histogram_strategy::private_bins:
+    return histogram_by_private_bins(q, scratch_allocations, first,
+                                     problem_size, binning, bins);
+  case histogram_strategy::local_memory_bins:
+    return histogram_by_local_memory_bins(q, first, problem_size, binning,
+                                          bins);
+  case histogram_strategy::global_atomics:
+  default:
+    return histogram_by_global_atomics(q, first, problem_size, binning, bins);
+  }
 }
 
 }
@@ -257,6 +894,53 @@ transform_reduce(sycl::queue &q, util::allocation_group &scratch_allocations,
                                        kernel, reduce);
 }
 
+/// Describes one result of a fused transform_reduce: The reduction of
+/// transform(x) over all elements x using reduce, starting from init.
+template <class T, class BinaryReductionOp, class UnaryTransformOp>
+struct transform_reduce_descriptor {
+  T init;
+  BinaryReductionOp reduce;
+  UnaryTransformOp transform;
+};
+
+template <class T, class BinaryReductionOp, class UnaryTransformOp>
+transform_reduce_descriptor<T, BinaryReductionOp, UnaryTransformOp>
+make_transform_reduce_descriptor(T init, BinaryReductionOp reduce,
+                                 UnaryTransformOp transform) {
+  return transform_reduce_descriptor<T, BinaryReductionOp, UnaryTransformOp>{
+      init, reduce, transform};
+}
+
+/// Fused transform_reduce: Computes the reductions of all descriptors
+/// in a single pass over [first, last), and stores the i-th result in
+/// *std::get<i>(outputs). For example, min, max and sum of an array
+/// can be obtained while only reading the array once.
+/// Otherwise behaves like the single-output variants.
+template <class ForwardIt, typename... OutputTs, typename... Descriptors>
+sycl::event
+transform_reduce(sycl::queue &q, util::allocation_group &scratch_allocations,
+                 ForwardIt first, ForwardIt last,
+                 const std::tuple<OutputTs *...> &outputs,
+                 const std::tuple<Descriptors...> &descriptors) {
+  static_assert(sizeof...(OutputTs) == sizeof...(Descriptors),
+                "Number of outputs and descriptors must match");
+  if(first == last)
+    return sycl::event{};
+
+  std::size_t n = std::distance(first, last);
+  auto kernel = [=](sycl::id<1> idx, auto&... reducers) {
+    auto input = first;
+    std::advance(input, idx[0]);
+    detail::combine_transformed(*input, descriptors,
+                                std::index_sequence_for<Descriptors...>{},
+                                reducers...);
+  };
+
+  return detail::fused_transform_reduce_impl(
+      q, scratch_allocations, n, kernel, outputs, descriptors,
+      std::index_sequence_for<Descriptors...>{});
+}
+
 template <class ForwardIt1, class ForwardIt2, class T>
 sycl::event transform_reduce(sycl::queue &q,
                              util::allocation_group &scratch_allocations,
@@ -289,6 +973,281 @@ sycl::event reduce(sycl::queue &q, util::allocation_group &scratch_allocations,
                 typename std::iterator_traits<ForwardIt>::value_type{});
 }
 
+// Segmented algorithms operate on segments described by an offset array
+// [offsets_first, offsets_last) with one entry more than there are segments,
+// as in the CSR format: Segment i consists of the elements
+// [first + offsets[i], first + offsets[i+1]). The offsets must be
+// non-decreasing, with offsets[0] == 0 and the last offset equal to
+// std::distance(first, last). Empty segments are allowed.
+// As for transform_reduce, if first==last, the returned event is complete
+// and outputs remain untouched. All segmented algorithms assume
+// in-order queues.
+
+/// Stores the reduction of each segment, starting from init, in
+/// d_out[segment].
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3, class T,
+          class BinaryOp>
+sycl::event
+segmented_reduce(sycl::queue &q, util::allocation_group &scratch_allocations,
+                 ForwardIt1 first, ForwardIt1 last, ForwardIt2 offsets_first,
+                 ForwardIt2 offsets_last, ForwardIt3 d_out, T init,
+                 BinaryOp op) {
+  if(first == last || offsets_first == offsets_last)
+    return sycl::event{};
+
+  const std::size_t n = std::distance(first, last);
+  const std::size_t num_segments = std::distance(offsets_first, offsets_last) - 1;
+  if(num_segments == 0)
+    return sycl::event{};
+
+  // On devices, processing each segment with a work group is more efficient
+  // than processing tiles within work items, as long as the segments are long
+  // enough to keep the work groups busy.
+  const std::size_t group_size = 128;
+  if(!q.get_device().is_host() && n / num_segments >= group_size)
+    return detail::segmented_reduce_by_groups(
+        q, first, offsets_first, num_segments, d_out, init, op, group_size);
+
+  return detail::segmented_reduce_by_tiles(
+      q, scratch_allocations, detail::decompose_into_tiles(q, n), first,
+      offsets_first, num_segments, d_out, init, op);
+}
+
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3, class T>
+sycl::event
+segmented_reduce(sycl::queue &q, util::allocation_group &scratch_allocations,
+                 ForwardIt1 first, ForwardIt1 last, ForwardIt2 offsets_first,
+                 ForwardIt2 offsets_last, ForwardIt3 d_out, T init) {
+  return segmented_reduce(q, scratch_allocations, first, last, offsets_first,
+                          offsets_last, d_out, init, std::plus<T>{});
+}
+
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3,
+          class BinaryOp>
+sycl::event segmented_inclusive_scan(
+    sycl::queue &q, util::allocation_group &scratch_allocations,
+    ForwardIt1 first, ForwardIt1 last, ForwardIt2 offsets_first,
+    ForwardIt2 offsets_last, ForwardIt3 d_first, BinaryOp op) {
+  if(first == last || offsets_first == offsets_last)
+    return sycl::event{};
+
+  using T = typename std::iterator_traits<ForwardIt1>::value_type;
+  return detail::segmented_scan(
+      q, scratch_allocations,
+      detail::decompose_into_tiles(q, std::distance(first, last)), first,
+      offsets_first, std::distance(offsets_first, offsets_last) - 1, d_first,
+      T{}, op, std::true_type{});
+}
+
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3>
+sycl::event segmented_inclusive_scan(
+    sycl::queue &q, util::allocation_group &scratch_allocations,
+    ForwardIt1 first, ForwardIt1 last, ForwardIt2 offsets_first,
+    ForwardIt2 offsets_last, ForwardIt3 d_first) {
+  using T = typename std::iterator_traits<ForwardIt1>::value_type;
+  return segmented_inclusive_scan(q, scratch_allocations, first, last,
+                                  offsets_first, offsets_last, d_first,
+                                  std::plus<T>{});
+}
+
+/// Like std::exclusive_scan, but the scan restarts from init
+/// at the beginning of each segment.
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3, class T,
+          class BinaryOp>
+sycl::event segmented_exclusive_scan(
+    sycl::queue &q, util::allocation_group &scratch_allocations,
+    ForwardIt1 first, ForwardIt1 last, ForwardIt2 offsets_first,
+    ForwardIt2 offsets_last, ForwardIt3 d_first, T init, BinaryOp op) {
+  if(first == last || offsets_first == offsets_last)
+    return sycl::event{};
+
+  return detail::segmented_scan(
+      q, scratch_allocations,
+      detail::decompose_into_tiles(q, std::distance(first, last)), first,
+      offsets_first, std::distance(offsets_first, offsets_last) - 1, d_first,
+      init, op, std::false_type{});
+}
+
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3, class T>
+sycl::event segmented_exclusive_scan(
+    sycl::queue &q, util::allocation_group &scratch_allocations,
+    ForwardIt1 first, ForwardIt1 last, ForwardIt2 offsets_first,
+    ForwardIt2 offsets_last, ForwardIt3 d_first, T init) {
+  return segmented_exclusive_scan(q, scratch_allocations, first, last,
+                                  offsets_first, offsets_last, d_first, init,
+                                  std::plus<T>{});
+}
+
+/// For each group of consecutive equal keys in [keys_first, keys_last),
+/// stores the key in keys_out and the reduction of the corresponding values
+/// in values_out. The number of groups is stored in *num_keys_out.
+/// If keys_first==keys_last, the returned event is complete and
+/// *num_keys_out remains untouched.
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3,
+          class ForwardIt4, class BinaryPredicate, class BinaryOp>
+sycl::event
+reduce_by_key(sycl::queue &q, util::allocation_group &scratch_allocations,
+              ForwardIt1 keys_first, ForwardIt1 keys_last,
+              ForwardIt2 values_first, ForwardIt3 keys_out,
+              ForwardIt4 values_out, std::size_t *num_keys_out,
+              BinaryPredicate equal, BinaryOp op) {
+  if(keys_first == keys_last)
+    return sycl::event{};
+
+  return detail::reduce_by_key_by_tiles(
+      q, scratch_allocations,
+      detail::decompose_into_tiles(q, std::distance(keys_first, keys_last)),
+      keys_first, values_first, keys_out, values_out, num_keys_out, equal, op);
+}
+
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3,
+          class ForwardIt4>
+sycl::event
+reduce_by_key(sycl::queue &q, util::allocation_group &scratch_allocations,
+              ForwardIt1 keys_first, ForwardIt1 keys_last,
+              ForwardIt2 values_first, ForwardIt3 keys_out,
+              ForwardIt4 values_out, std::size_t *num_keys_out) {
+  using key_type = typename std::iterator_traits<ForwardIt1>::value_type;
+  using value_type = typename std::iterator_traits<ForwardIt2>::value_type;
+  return reduce_by_key(q, scratch_allocations, keys_first, keys_last,
+                       values_first, keys_out, values_out, num_keys_out,
+                       std::equal_to<key_type>{}, std::plus<value_type>{});
+}
+
+
+// Binnings map values to histogram bins. They must be trivially copyable
+// so that they can be passed to kernels, and provide
+// * std::size_t get_num_bins() const, and
+// * bool get_bin(const U& x, std::size_t& bin) const, which returns false
+//   if x does not fall into any bin.
+
+/// Divides [lower, upper) into num_bins bins of equal width.
+template<class T>
+class even_width_binning {
+public:
+  even_width_binning(std::size_t num_bins, T lower, T upper)
+      : _num_bins{num_bins}, _lower{lower}, _upper{upper} {}
+
+  std::size_t get_num_bins() const noexcept {
+    return _num_bins;
+  }
+
+  template<class U>
+  bool get_bin(const U& x, std::size_t& bin) const noexcept {
+    // Also rejects NaNs
+    if(!(x >= _lower && x < _upper))
+      return false;
+
+    if constexpr(std::is_integral_v<T>) {
+      // Differences are computed in unsigned arithmetic, where they
+      // cannot overflow even if the range spans all values of T.
+      const unsigned long long offset =
+          static_cast<unsigned long long>(static_cast<T>(x)) -
+          static_cast<unsigned long long>(_lower);
+      const unsigned long long width =
+          static_cast<unsigned long long>(_upper) -
+          static_cast<unsigned long long>(_lower);
+      bin = static_cast<std::size_t>(
+          detail::mul_div_floor(offset, _num_bins, width));
+    } else {
+      bin = static_cast<std::size_t>(
+          (x - _lower) * static_cast<T>(_num_bins) / (_upper - _lower));
+    }
+    // Guard against rounding up at the upper end of the range
+    bin = std::min(bin, _num_bins - 1);
+    return true;
+  }
+private:
+  std::size_t _num_bins;
+  T _lower;
+  T _upper;
+};
+
+/// Bins values according to num_bins + 1 increasing edges, where bin i
+/// covers [edges[i], edges[i+1]). The edges must be accessible from the
+/// device, and remain valid until the histogram has completed.
+template<class EdgeIt>
+class custom_edge_binning {
+public:
+  custom_edge_binning(EdgeIt edges_first, EdgeIt edges_last)
+      : _edges{edges_first}, _num_edges{static_cast<std::size_t>(
+                                 std::distance(edges_first, edges_last))} {}
+
+  std::size_t get_num_bins() const noexcept {
+    return _num_edges > 0 ? _num_edges - 1 : 0;
+  }
+
+  template<class U>
+  bool get_bin(const U& x, std::size_t& bin) const noexcept {
+    if(_num_edges < 2 || !(x >= detail::load(_edges, 0) &&
+                           x < detail::load(_edges, _num_edges - 1)))
+      return false;
+
+    // Find the last edge <= x
+    std::size_t begin = 0;
+    std::size_t end = _num_edges - 1;
+    while(end - begin > 1) {
+      std::size_t mid = begin + (end - begin) / 2;
+      if(x < detail::load(_edges, mid))
+        end = mid;
+      else
+        begin = mid;
+    }
+    bin = begin;
+    return true;
+  }
+private:
+  EdgeIt _edges;
+  std::size_t _num_edges;
+};
+
+/// Counts the elements of [first, last) falling into each bin of binning
+/// and overwrites bins[0, binning.get_num_bins()) with the counts.
+/// Elements outside of all bins are ignored. CountT must be supported
+/// by sycl::atomic_ref.
+/// Depending on the device and the number of bins, the bins are privatized
+/// per thread, per work group in local memory, or updated with global
+/// atomics. Unlike other algorithms, the bins are zeroed even if
+/// first==last. Assumes an in-order queue.
+template <class ForwardIt, class Binning, class CountT>
+sycl::event histogram(sycl::queue &q,
+                      util::allocation_group &scratch_allocations,
+                      ForwardIt first, ForwardIt last, Binning binning,
+                      CountT *bins) {
+  const std::size_t num_bins = binning.get_num_bins();
+  if(num_bins == 0)
+    return sycl::event{};
+
+  const std::size_t n = std::distance(first, last);
+  if(n == 0)
+    return q.memset(bins, 0, num_bins * sizeof(CountT));
+
+  return detail::histogram(q, scratch_allocations, first, n, binning, bins,
+                           detail::select_histogram_strategy(q, n, num_bins));
+}
+
+/// Histogram with num_bins bins of equal width covering [lower, upper).
+template <class ForwardIt, class T, class CountT>
+sycl::event histogram(sycl::queue &q,
+                      util::allocation_group &scratch_allocations,
+                      ForwardIt first, ForwardIt last, std::size_t num_bins,
+                      T lower, T upper, CountT *bins) {
+  return histogram(q, scratch_allocations, first, last,
+                   even_width_binning<T>{num_bins, lower, upper}, bins);
+}
+
+/// Histogram with bins given by the edges [edges_first, edges_last).
+template <class ForwardIt1, class ForwardIt2, class CountT>
+sycl::event histogram(sycl::queue &q,
+                      util::allocation_group &scratch_allocations,
+                      ForwardIt1 first, ForwardIt1 last,
+                      ForwardIt2 edges_first, ForwardIt2 edges_last,
+                      CountT *bins) {
+  return histogram(q, scratch_allocations, first, last,
+                   custom_edge_binning<ForwardIt2>{edges_first, edges_last},
+                   bins);
+}
+
 }
 
 #endif
@@ -86,7 +86,8 @@ auto configure_descriptor(
       data_plan.is_output_initialized,
       static_cast<value_type*>(data_plan.stage_input),
       static_cast<value_type*>(data_plan.stage_output),
-      global_size};
+      global_size,
+      data_plan.completion_counter};
 }
 
 template <class ReductionDescriptor>
@@ -137,6 +138,12 @@ class wg_hierarchical_reduction_engine {
 
   using reduction_stage_type = wg_model::reduction_stage<GroupHorizontalReducer>;
 
+  // Maximum number of group results per work item that the last group
+  // combines in single-pass reductions. Beyond this, the serial
+  // combine in the last group becomes more expensive than launching
+  // additional reduction kernels.
+  static constexpr std::size_t max_single_pass_results_per_work_item = 16;
+
   static void determine_stages(
       std::size_t global_size, std::size_t wg_size,
       common::auto_small_vector<reduction_stage_type> &stages_out) {
@@ -287,8 +294,13 @@ public:
     common::auto_small_vector<reduction_stage_type> additional_plan;
     
     std::size_t num_groups = detail::ceil_division(global_size, wg_size);
+    // If the last group of the main kernel can combine the results of all
+    // groups, we can avoid additional kernels entirely.
+    const bool is_single_pass =
+        num_groups > 1 &&
+        num_groups <= wg_size * max_single_pass_results_per_work_item;
     // if we only have a single group, we are already done.
-    if(num_groups > 1)
+    if(num_groups > 1 && !is_single_pass)
       determine_stages(num_groups, reduction_wg_size, additional_plan);
   
 
@@ -306,11 +318,38 @@ public:
         stage.data_plan[reduction].is_output_initialized = nullptr;
         stage.data_plan[reduction].stage_input = nullptr;
         stage.data_plan[reduction].stage_output = nullptr;
+        stage.data_plan[reduction].completion_counter = nullptr;
       }
     }
     
+    if(is_single_pass) {
+      detail::enumerate_pack(
+          [&](std::size_t reduction_index, const auto &descriptor) {
+            using value_type =
+                typename std::decay_t<decltype(descriptor)>::value_type;
+
+            auto &data = result_plan[0].data_plan[reduction_index];
+            data.stage_output =
+                _scratch_allocations->obtain<value_type>(num_groups);
+            if (!descriptor.has_known_identity())
+              data.is_output_initialized =
+                  _scratch_allocations->obtain<initialization_flag_t>(
+                      num_groups);
+
+            // The counter is reset by the last group, so it only needs
+            // explicit initialization when it is freshly allocated.
+            bool requires_initialization = false;
+            data.completion_counter =
+                _scratch_allocations->obtain_zeroed<unsigned int>(
+                    1, requires_initialization);
+            if (requires_initialization)
+              result_plan.add_scratch_initialization(data.completion_counter,
+                                                     sizeof(unsigned int));
+          },
+          descriptors...);
+    }
     // If we only need the main kernel for the reduction, no scratch is needed.
-    if(result_plan.size() > 1) {
+    else if(result_plan.size() > 1) {
       detail::enumerate_pack(
           [&](std::size_t reduction_index, const auto &descriptor) {
             bool has_known_identity = descriptor.has_known_identity();
@@ -379,6 +418,16 @@ public:
     return result_plan;
   }
 
+  /// Zeroes scratch memory that needs initialization before the main kernel
+  /// runs. Needs to be invoked before submitting the main kernel, which
+  /// must then depend on the operations submitted by memset_launcher.
+  template <class MemsetLauncher, class PlanType>
+  void initialize_scratch(MemsetLauncher memset_launcher,
+                          const PlanType &reduction_plan) {
+    for(const auto& init : reduction_plan.get_scratch_initializations())
+      memset_launcher(init.ptr, init.num_bytes);
+  }
+
   template <class Kernel, class PlanType, typename... ReductionDescriptors>
   auto make_main_reducing_kernel(Kernel main_kernel,
                                  const PlanType &reduction_plan) {
@@ -514,8 +563,13 @@ class threading_reduction_engine {
                                                              scratch[i].value);
             } else {
               if (init_stage[i].value) {
-                current = configured_descriptor.get_operator()(
-                    current, scratch[i].value);
+                // current does not hold a valid value before the first
+                // initialized entry
+                if (is_initialized)
+                  current = configured_descriptor.get_operator()(
+                      current, scratch[i].value);
+                else
+                  current = scratch[i].value;
                 is_initialized = true;
               }
             }
@@ -34,6 +34,12 @@
 
 namespace hipsycl::algorithms::reduction {
 
+/// Scratch memory that needs to be zeroed before the main kernel runs
+struct scratch_initialization {
+  void *ptr;
+  std::size_t num_bytes;
+};
+
 template<class ReductionStage, typename... ReductionDescriptors>
 class reduction_plan {
 public:
@@ -77,8 +83,18 @@ public:
     return _descriptors;
   }
 
+  void add_scratch_initialization(void *ptr, std::size_t num_bytes) {
+    _scratch_initializations.push_back(scratch_initialization{ptr, num_bytes});
+  }
+
+  const common::auto_small_vector<scratch_initialization> &
+  get_scratch_initializations() const {
+    return _scratch_initializations;
+  }
+
 private:
   common::auto_small_vector<ReductionStage> _stages;
+  common::auto_small_vector<scratch_initialization> _scratch_initializations;
   std::tuple<ReductionDescriptors...> _descriptors;
 };
 
@@ -58,12 +58,15 @@ public:
       // Output of the stage. If nullptr, assumes final stage & overall
       // reduction output
       typename ReductionDescriptor::value_type *stage_output,
-      std::size_t problem_size)
+      std::size_t problem_size,
+      // Zero-initialized group completion counter for single-pass
+      // reductions. nullptr for multi-stage reductions.
+      unsigned int *completion_counter = nullptr)
       : ReductionDescriptor{basic_descriptor},
         _is_input_initialized{is_input_initialized},
         _is_output_initialized{is_output_initialized},
         _stage_input{stage_input}, _stage_output{stage_output},
-        _problem_size{problem_size} {}
+        _problem_size{problem_size}, _completion_counter{completion_counter} {}
 
   bool is_final_stage() const noexcept {
     return !_stage_output;
@@ -89,12 +92,17 @@ public:
 
   std::size_t get_problem_size() const noexcept { return _problem_size; }
 
+  unsigned int *get_completion_counter() const noexcept {
+    return _completion_counter;
+  }
+
 private:
   initialization_flag_t *_is_input_initialized;
   initialization_flag_t *_is_output_initialized;
   typename ReductionDescriptor::value_type *_stage_input;
   typename ReductionDescriptor::value_type *_stage_output;
   std::size_t _problem_size;
+  unsigned int *_completion_counter;
 };
 
 }
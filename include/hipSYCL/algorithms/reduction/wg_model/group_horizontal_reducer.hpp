@@ -31,6 +31,8 @@
 
 #include <vector>
 
+#include "../../../sycl/libkernel/atomic_ref.hpp"
+#include "../../../sycl/libkernel/group_functions.hpp"
 #include "../reduction_descriptor.hpp"
 #include "wi_reducer.hpp"
 #include "wg_model_queries.hpp"
@@ -41,6 +43,19 @@
 
 namespace hipsycl::algorithms::reduction::wg_model {
 
+namespace detail {
+
+template<int Dim>
+bool broadcast_from_leader(sycl::nd_item<Dim> idx, bool x) {
+  return sycl::group_broadcast(idx.get_group(), static_cast<int>(x)) != 0;
+}
+
+template<int Dim>
+bool broadcast_from_leader(sycl::group<Dim> grp, bool x) {
+  return sycl::group_broadcast(grp, static_cast<int>(x)) != 0;
+}
+
+}
 
 /// Horizontal reducer for models where work groups exist
 template<class GroupReductionAlgorithm>
@@ -95,9 +110,58 @@ public:
         }
       }
     }
+
+    if(descriptor.get_completion_counter())
+      combine_if_last_group(wi, descriptor);
   }
 
 private:
+  // Single-pass reductions: Once a group has written its result, its leader
+  // increments the completion counter. The group that observes all other groups
+  // as complete combines the group results into the final result, and
+  // resets the counter for the next user.
+  template <class WiIndex, class ConfiguredReductionDescriptor>
+  void combine_if_last_group(const WiIndex &wi,
+                             const ConfiguredReductionDescriptor &descriptor) const {
+    using value_type = typename ConfiguredReductionDescriptor::value_type;
+
+    const std::size_t num_groups = get_num_groups(wi);
+    const std::size_t my_lid = get_local_linear_id(wi);
+
+    sycl::atomic_ref<unsigned int, sycl::memory_order::acq_rel,
+                     sycl::memory_scope::device,
+                     sycl::access::address_space::global_space>
+        counter{*descriptor.get_completion_counter()};
+
+    bool is_last_group = false;
+    if(my_lid == 0)
+      is_last_group = (counter.fetch_add(1u) == num_groups - 1);
+    is_last_group = detail::broadcast_from_leader(wi, is_last_group);
+
+    if(is_last_group) {
+      const value_type* group_results = descriptor.get_stage_output();
+      const initialization_flag_t* is_initialized =
+          descriptor.get_output_initialization_state();
+
+      auto wi_reducer = generate_wi_reducer(descriptor);
+      for(std::size_t i = my_lid; i < num_groups; i += get_local_size(wi)) {
+        if (descriptor.has_known_identity() || is_initialized[i])
+          wi_reducer.combine(group_results[i]);
+      }
+
+      bool is_leader;
+      bool result_is_initialized;
+      value_type result = _group_reduction(
+          wi, descriptor, wi_reducer, is_leader, result_is_initialized);
+
+      if(is_leader) {
+        reduction::detail::set_reduction_result(descriptor, result,
+                                                result_is_initialized);
+        counter.store(0u, sycl::memory_order::relaxed);
+      }
+    }
+  }
+
   GroupReductionAlgorithm _group_reduction;
 };
 
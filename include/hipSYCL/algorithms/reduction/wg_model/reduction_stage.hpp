@@ -40,6 +40,10 @@ struct reduction_stage_data {
   initialization_flag_t *is_output_initialized;
   void *stage_input;
   void *stage_output;
+  // If set, the stage is a single-pass reduction: Groups write their results
+  // to stage_output, and the last group to increment the counter
+  // combines them into the final result.
+  unsigned int *completion_counter;
 };
 
 template<class HorizontalReducer>
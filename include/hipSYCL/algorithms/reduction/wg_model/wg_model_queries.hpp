@@ -89,6 +89,36 @@ std::size_t get_local_linear_id(sycl::group<Dim> idx) {
   return idx.get_local_linear_id();
 }
 
+template<int Dim>
+std::size_t get_num_groups(sycl::id<Dim> idx) {
+  return sycl::detail::get_grid_size<Dim>().size();
+}
+
+template<int Dim>
+std::size_t get_num_groups(sycl::nd_item<Dim> idx) {
+  return idx.get_group_range().size();
+}
+
+template<int Dim>
+std::size_t get_num_groups(sycl::group<Dim> grp) {
+  return grp.get_group_range().size();
+}
+
+template<int Dim>
+std::size_t get_local_size(sycl::id<Dim> idx) {
+  return sycl::detail::get_local_size<Dim>().size();
+}
+
+template<int Dim>
+std::size_t get_local_size(sycl::nd_item<Dim> idx) {
+  return idx.get_local_range().size();
+}
+
+template<int Dim>
+std::size_t get_local_size(sycl::group<Dim> grp) {
+  return grp.get_local_range().size();
+}
+
 }
 
 #endif
@@ -34,6 +34,7 @@
 #include <mutex>
 
 #include "../../common/small_vector.hpp"
+#include "../../runtime/dag_node.hpp"
 #include "../../runtime/device_id.hpp"
 #include "../../runtime/runtime.hpp"
 #include "../../runtime/application.hpp"
@@ -71,11 +72,16 @@ public:
   void purge() {
     std::lock_guard<std::mutex> lock{_mutex};
     
-    for(auto& allocation : _allocations) {
+    for(auto& entry : _allocations) {
+      if(entry.pending_user && !entry.pending_user->is_cancelled()) {
+        if(!entry.pending_user->is_submitted())
+          _rt.get()->dag().flush_sync();
+        entry.pending_user->wait();
+      }
       _rt.get()->backends()
-          .get(allocation.dev.get_backend())
-          ->get_allocator(allocation.dev)
-          ->free(allocation.ptr);
+          .get(entry.alloc.dev.get_backend())
+          ->get_allocator(entry.alloc.dev)
+          ->free(entry.alloc.ptr);
     }
     _allocations.clear();
   }
@@ -83,8 +89,17 @@ private:
   
   allocation find_or_alloc(std::size_t min_size, std::size_t min_alignment,
                            rt::device_id dev) {
+    bool is_zeroed;
+    return find_or_alloc(min_size, min_alignment, dev, false, is_zeroed);
+  }
+
+  allocation find_or_alloc(std::size_t min_size, std::size_t min_alignment,
+                           rt::device_id dev, bool prefer_zeroed,
+                           bool &is_zeroed) {
     allocation result;
-    if(!find_allocation(min_size, min_alignment, dev, result)){  
+    is_zeroed = false;
+    if(!find_allocation(min_size, min_alignment, dev, prefer_zeroed, result,
+                        is_zeroed)){
       result.dev = dev;
       result.size = min_size;
 
@@ -104,22 +119,45 @@ private:
   }
 
   bool find_allocation(std::size_t min_size, std::size_t min_alignment,
-                       rt::device_id dev, allocation &out) {
+                       rt::device_id dev, bool prefer_zeroed, allocation &out,
+                       bool &is_zeroed) {
     std::lock_guard<std::mutex> lock{_mutex};
 
     bool found = false;
     std::size_t found_index = 0;
     for (std::size_t i = 0; i < _allocations.size(); ++i) {
-      const auto& allocation = _allocations[i];
+      auto& entry = _allocations[i];
+      const auto& allocation = entry.alloc;
       if (allocation.dev == dev) {
+        if(entry.pending_user) {
+          // Still in use by an operation that has not yet completed
+          if (!entry.pending_user->is_complete() &&
+              !entry.pending_user->is_cancelled())
+            continue;
+          // If the user never ran, it cannot have restored the zero state
+          if (entry.pending_user->is_cancelled())
+            entry.is_zeroed = false;
+          entry.pending_user = nullptr;
+        }
         if (allocation.size >= min_size &&
             reinterpret_cast<std::size_t>(allocation.ptr) % min_alignment ==
                 0) {
-          // If we already have found a candidate: We want the smallest
+          // If we already have found a candidate: Prefer allocations
+          // whose zero state matches the request, and then the smallest
           // allocation that has the required size so that larger allocations
           // remain available for larger requests.
-          if (!found || allocation.size < out.size) {
+          bool is_better_match = !found;
+          if (found) {
+            bool matches = (entry.is_zeroed == prefer_zeroed);
+            bool out_matches = (is_zeroed == prefer_zeroed);
+            if (matches != out_matches)
+              is_better_match = matches;
+            else
+              is_better_match = allocation.size < out.size;
+          }
+          if (is_better_match) {
             out = allocation;
+            is_zeroed = entry.is_zeroed;
             found_index = i;
           }
           found = true;
@@ -134,13 +172,24 @@ private:
     return found;
   }
 
-  void return_allocation(const allocation& alloc) {
+  void return_allocation(const allocation& alloc,
+                         rt::dag_node_ptr pending_user = nullptr,
+                         bool is_zeroed = false) {
     std::lock_guard<std::mutex> lock{_mutex};
-    _allocations.push_back(alloc);
+    _allocations.push_back(
+        cached_allocation{alloc, std::move(pending_user), is_zeroed});
   }
 
+  struct cached_allocation {
+    allocation alloc;
+    // If set, the allocation may only be reused once this node has completed
+    rt::dag_node_ptr pending_user;
+    // Whether the allocation is known to contain only zero bytes
+    bool is_zeroed;
+  };
+
   rt::runtime_keep_alive_token _rt;
-  common::auto_small_vector<allocation> _allocations;
+  common::auto_small_vector<cached_allocation> _allocations;
   std::mutex _mutex;
   allocation_type _alloc_type;
 };
@@ -179,7 +228,26 @@ public:
     for(const auto& allocation : _managed_allocations) {
       _parent->return_allocation(allocation);
     }
+    for(const auto& allocation : _zeroed_allocations) {
+      _parent->return_allocation(allocation, nullptr, true);
+    }
+    _managed_allocations.clear();
+    _zeroed_allocations.clear();
+  }
+
+  /// Returns the managed allocations to the parent cache, which will only
+  /// hand them out again once \c last_user has completed. This allows
+  /// releasing the group without synchronizing with the operations that
+  /// use its allocations, as long as they all complete before \c last_user.
+  void release_after(const rt::dag_node_ptr& last_user) {
+    for(const auto& allocation : _managed_allocations) {
+      _parent->return_allocation(allocation, last_user);
+    }
+    for(const auto& allocation : _zeroed_allocations) {
+      _parent->return_allocation(allocation, last_user, true);
+    }
     _managed_allocations.clear();
+    _zeroed_allocations.clear();
   }
 
   template<class T>
@@ -190,6 +258,22 @@ public:
     return static_cast<T*>(alloc.ptr);
   }
 
+  /// Obtains an allocation that is meant to hold zero bytes whenever it is
+  /// not in use, such as counters that are reset by their last user.
+  /// If \c requires_initialization is set, the allocation could not be
+  /// served from a zeroed allocation, and the caller must zero it before use.
+  /// In any case, the caller must ensure that the allocation contains only zero
+  /// bytes again by the time the group is released.
+  template<class T>
+  T* obtain_zeroed(std::size_t count, bool& requires_initialization) {
+    bool is_zeroed = false;
+    allocation alloc = _parent->find_or_alloc(count * sizeof(T), alignof(T),
+                                              _dev, true, is_zeroed);
+    requires_initialization = !is_zeroed;
+    _zeroed_allocations.push_back(alloc);
+    return static_cast<T*>(alloc.ptr);
+  }
+
   rt::device_id get_device() const {
     return _dev;
   }
@@ -197,6 +281,7 @@ private:
   allocation_cache* _parent;
   rt::device_id _dev;
   common::auto_small_vector<allocation> _managed_allocations;
+  common::auto_small_vector<allocation> _zeroed_allocations;
 };
 
 
@@ -29,9 +29,11 @@
 #define HIPSYCL_HCF_CONTAINER_HPP
 
 #include "debug.hpp"
+#include "lz_compression.hpp"
 #include <cstddef>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <sstream>
@@ -156,6 +158,24 @@ public:
     parse(parseable_data);
   }
 
+  // Parses the container without copying the binary appendix. The data
+  // must outlive the container and all copies of it, e.g. because it is
+  // embedded in the executable. This way, binary content is not
+  // touched unless it is actually retrieved.
+  hcf_container(const char* data, std::size_t size) {
+    std::string_view container{data, size};
+    std::size_t appendix_begin = container.find(_binary_appendix_id);
+
+    if(appendix_begin != std::string_view::npos) {
+      std::size_t offset =
+          appendix_begin + std::string_view{_binary_appendix_id}.size();
+      _external_appendix = data + offset;
+      _external_appendix_size = size - offset;
+    }
+
+    parse(std::string{container.substr(0, appendix_begin)});
+  }
+
   const node* root_node() const {
     return &_root_node;
   }
@@ -200,29 +220,73 @@ public:
     start = std::stoull(*start_entry);
     size = std::stoull(*size_entry);
 
-    if(start + size > _binary_appendix.size()) {
+    if(start + size > get_appendix_size()) {
       HIPSYCL_DEBUG_ERROR << "hcf: Binary content address is out-of-bounds\n";
       return false;
     }
 
-    out = _binary_appendix.substr(start, size);
+    const char* content = get_appendix_data() + start;
+
+    if(const std::string* compression = descriptor_node->get_value("compression")) {
+      const std::string* uncompressed_size_entry =
+          descriptor_node->get_value("uncompressed-size");
+      if(*compression != _lz_compression || !uncompressed_size_entry) {
+        HIPSYCL_DEBUG_ERROR << "hcf: Unsupported binary content compression "
+                            << *compression << "\n";
+        return false;
+      }
+      if (!lz::decompress(content, size,
+                          std::stoull(*uncompressed_size_entry), out)) {
+        HIPSYCL_DEBUG_ERROR << "hcf: Decompression of binary content failed\n";
+        return false;
+      }
+      return true;
+    }
+
+    out = std::string{content, size};
 
     return true;
   }
 
-  bool attach_binary_content(node* n, const std::string& binary_content) {
+  // If compress is true, the binary content is stored compressed if this
+  // reduces its size. It is then transparently decompressed by
+  // get_binary_attachment().
+  bool attach_binary_content(node *n, const std::string &binary_content,
+                             bool compress = false) {
     
     node* binary_node = n->add_subnode(_binary_marker);
     if(!binary_node)
       return false;
 
+    if(_external_appendix) {
+      _binary_appendix.assign(_external_appendix, _external_appendix_size);
+      _external_appendix = nullptr;
+      _external_appendix_size = 0;
+    }
+
     std::size_t start = _binary_appendix.size();
     std::size_t length = binary_content.size();
 
-    _binary_appendix += binary_content;
+    std::string compressed;
+    if(compress) {
+      compressed = lz::compress(binary_content);
+      compress = compressed.size() < binary_content.size();
+    }
+
+    if(compress) {
+      _binary_appendix += compressed;
+      length = compressed.size();
+    } else {
+      _binary_appendix += binary_content;
+    }
 
     binary_node->set("start", std::to_string(start));
     binary_node->set("size", std::to_string(length));
+    if(compress) {
+      binary_node->set("compression", _lz_compression);
+      binary_node->set("uncompressed-size",
+                       std::to_string(binary_content.size()));
+    }
 
     return true;
   }
@@ -232,9 +296,21 @@ public:
     serialize_node(_root_node, sstr);
     sstr << _binary_appendix_id;
 
-    return sstr.str() + _binary_appendix;
+    return sstr.str() +
+           std::string{get_appendix_data(), get_appendix_size()};
   }
 private:
+  const char* get_appendix_data() const {
+    if(_external_appendix)
+      return _external_appendix;
+    return _binary_appendix.data();
+  }
+
+  std::size_t get_appendix_size() const {
+    if(_external_appendix)
+      return _external_appendix_size;
+    return _binary_appendix.size();
+  }
 
   void serialize_node(const node& n, std::ostream& out) const {
     for(const auto& p : n.key_value_pairs){
@@ -365,9 +441,13 @@ private:
   static constexpr char _node_start_id [] = "{.";
   static constexpr char _node_end_id [] = "}.";
   static constexpr char _binary_marker [] = "__binary";
+  static constexpr char _lz_compression [] = "lz";
 
   node _root_node;
   std::string _binary_appendix;
+  // If set, the binary appendix is not owned by the container.
+  const char* _external_appendix = nullptr;
+  std::size_t _external_appendix_size = 0;
 };
 
 }
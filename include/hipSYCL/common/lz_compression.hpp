@@ -0,0 +1,206 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_LZ_COMPRESSION_HPP
+#define HIPSYCL_LZ_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace hipsycl {
+namespace common {
+namespace lz {
+
+// A small, dependency-free LZ77 codec for embedded device images.
+// The compressed data is a sequence of
+//   token | [literal length bytes] | literals | offset (2 bytes, LE) |
+//   [match length bytes]
+// where the high nibble of the token is the number of literals and the low
+// nibble the match length minus min_match. Nibbles of 15 are continued by
+// length bytes, where 255 means that another length byte follows.
+// The last sequence only consists of literals.
+
+namespace detail {
+
+constexpr std::size_t min_match = 4;
+constexpr std::size_t max_offset = 65535;
+constexpr int hash_bits = 16;
+
+inline uint32_t read32(const unsigned char* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t hash(uint32_t v) {
+  return (v * 2654435761u) >> (32 - hash_bits);
+}
+
+inline void write_length(std::string& out, std::size_t len) {
+  while(len >= 255) {
+    out.push_back(static_cast<char>(255));
+    len -= 255;
+  }
+  out.push_back(static_cast<char>(len));
+}
+
+inline void write_sequence(std::string &out, const unsigned char *literals,
+                           std::size_t num_literals, std::size_t offset,
+                           std::size_t match_length) {
+  std::size_t lit_nibble = num_literals < 15 ? num_literals : 15;
+  std::size_t match_nibble = 0;
+  if(match_length > 0) {
+    std::size_t ml = match_length - min_match;
+    match_nibble = ml < 15 ? ml : 15;
+  }
+  out.push_back(static_cast<char>((lit_nibble << 4) | match_nibble));
+  if(lit_nibble == 15)
+    write_length(out, num_literals - 15);
+  out.append(reinterpret_cast<const char*>(literals), num_literals);
+
+  if(match_length > 0) {
+    out.push_back(static_cast<char>(offset & 0xff));
+    out.push_back(static_cast<char>((offset >> 8) & 0xff));
+    if(match_nibble == 15)
+      write_length(out, match_length - min_match - 15);
+  }
+}
+
+inline bool read_length(const unsigned char *&in, const unsigned char *end,
+                        std::size_t &len) {
+  unsigned char b;
+  do {
+    if(in == end)
+      return false;
+    b = *in++;
+    len += b;
+  } while(b == 255);
+  return true;
+}
+
+}
+
+inline std::string compress(const char* data, std::size_t size) {
+  using namespace detail;
+  const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+
+  std::string out;
+  out.reserve(size / 2 + 16);
+
+  std::vector<uint32_t> table(std::size_t{1} << hash_bits, 0);
+  std::size_t anchor = 0;
+  std::size_t pos = 0;
+
+  if(size >= min_match) {
+    const std::size_t last_match_pos = size - min_match;
+    while(pos <= last_match_pos) {
+      uint32_t v = read32(in + pos);
+      uint32_t h = hash(v);
+      // Positions are stored +1, so that 0 means "empty"
+      std::size_t candidate = table[h];
+      table[h] = static_cast<uint32_t>(pos + 1);
+
+      if (candidate > 0 && pos - (candidate - 1) <= max_offset &&
+          read32(in + candidate - 1) == v) {
+        std::size_t match_start = candidate - 1;
+        std::size_t len = min_match;
+        while(pos + len < size && in[match_start + len] == in[pos + len])
+          ++len;
+
+        write_sequence(out, in + anchor, pos - anchor, pos - match_start, len);
+        pos += len;
+        anchor = pos;
+      } else {
+        ++pos;
+      }
+    }
+  }
+  write_sequence(out, in + anchor, size - anchor, 0, 0);
+  return out;
+}
+
+inline std::string compress(const std::string& data) {
+  return compress(data.data(), data.size());
+}
+
+// Returns false if the input is corrupted or does not decompress to
+// exactly uncompressed_size bytes.
+inline bool decompress(const char *data, std::size_t size,
+                       std::size_t uncompressed_size, std::string &out) {
+  using namespace detail;
+  const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+  const unsigned char* end = in + size;
+
+  out.resize(uncompressed_size);
+  char* result = out.data();
+  std::size_t out_pos = 0;
+
+  while(in < end) {
+    unsigned char token = *in++;
+
+    std::size_t num_literals = token >> 4;
+    if(num_literals == 15 && !read_length(in, end, num_literals))
+      return false;
+    if (num_literals > static_cast<std::size_t>(end - in) ||
+        num_literals > uncompressed_size - out_pos)
+      return false;
+    std::memcpy(result + out_pos, in, num_literals);
+    in += num_literals;
+    out_pos += num_literals;
+
+    if(in == end)
+      break;
+
+    if(end - in < 2)
+      return false;
+    std::size_t offset = in[0] | (static_cast<std::size_t>(in[1]) << 8);
+    in += 2;
+    std::size_t match_length = token & 0xf;
+    if(match_length == 15 && !read_length(in, end, match_length))
+      return false;
+    match_length += min_match;
+
+    if (offset == 0 || offset > out_pos ||
+        match_length > uncompressed_size - out_pos)
+      return false;
+    // Matches may overlap with the output they produce
+    const char* match = result + out_pos - offset;
+    for(std::size_t i = 0; i < match_length; ++i)
+      result[out_pos + i] = match[i];
+    out_pos += match_length;
+  }
+  return out_pos == uncompressed_size;
+}
+
+}
+}
+}
+
+#endif
@@ -88,6 +88,27 @@ public:
   llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &AM);
 };
 
+/// Computes per-function summaries for the synchronization elision: Function definitions
+/// that provably only access their own stack memory and only call functions for which the
+/// same holds are marked with the "hipsycl-stdpar-no-sync" function attribute.
+/// SyncElisionPass does not need to synchronize before calls to such functions.
+/// Because the attribute is stored in the IR, it remains available when translation units
+/// are merged during LTO, where SyncElisionLTOPass can exploit it across translation units.
+class SyncElisionSummaryPass : public llvm::PassInfoMixin<SyncElisionSummaryPass> {
+public:
+  llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &AM);
+};
+
+/// Runs during LTO. SyncElisionPass marks synchronization that it had to insert before
+/// calls to functions that could not be analyzed (e.g. because they are defined in a
+/// different translation unit). If the definition of the called function is available
+/// after merging the translation units and carries a summary from SyncElisionSummaryPass,
+/// the synchronization is moved further down the control flow as in SyncElisionPass.
+class SyncElisionLTOPass : public llvm::PassInfoMixin<SyncElisionLTOPass> {
+public:
+  llvm::PreservedAnalyses run(llvm::Module &M, llvm::ModuleAnalysisManager &AM);
+};
+
 /// This pass causes callers of stdpar algorithms to be inlined. This is a simplistic heuristic
 /// to combine more stdpar calls in one function, assuming that often stdpar usage happens from only
 /// a few root functions. Having as many of the stdpar calls as possible in one function is important
@@ -28,7 +28,10 @@
 #ifndef HIPSYCL_ITERATE_RANGE_HPP
 #define HIPSYCL_ITERATE_RANGE_HPP
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "../../../sycl/libkernel/range.hpp"
 #include "../../../sycl/libkernel/id.hpp"
@@ -166,6 +169,182 @@ void iterate_range(const sycl::id<Dim> offset,
   }
 }
 
+/// Order in which the tiles of a tiled iteration are visited
+enum class tile_order {
+  row_major,
+  morton,
+  hilbert
+};
+
+/// The default tile size for tiled iteration of r. Tiles keep the fastest
+/// dimension long, and are chosen such that stencil neighborhoods of a tile
+/// fit into the L1/L2 caches.
+/// If tile_edge is not 0, tiles instead span tile_edge indices in
+/// every dimension.
+template <int Dim>
+sycl::range<Dim> get_tile_size(const sycl::range<Dim> r,
+                               std::size_t tile_edge = 0) noexcept {
+  sycl::range<Dim> tile_size;
+  if(tile_edge != 0) {
+    for(int i = 0; i < Dim; ++i)
+      tile_size[i] = tile_edge;
+  } else if constexpr (Dim == 1) {
+    tile_size = sycl::range<Dim>{32 * 1024};
+  } else if constexpr (Dim == 2) {
+    tile_size = sycl::range<Dim>{64, 512};
+  } else {
+    tile_size = sycl::range<Dim>{16, 16, 128};
+  }
+  for(int i = 0; i < Dim; ++i)
+    tile_size[i] = std::max(std::size_t{1}, std::min(tile_size[i], r[i]));
+  return tile_size;
+}
+
+template <int Dim>
+sycl::range<Dim> get_num_tiles(const sycl::range<Dim> r,
+                               const sycl::range<Dim> tile_size) noexcept {
+  sycl::range<Dim> num_tiles;
+  for(int i = 0; i < Dim; ++i)
+    num_tiles[i] = (r[i] + tile_size[i] - 1) / tile_size[i];
+  return num_tiles;
+}
+
+/// Iterates in row-major order over the part of r that is covered by
+/// the tile with the given tile id.
+template <int Dim, class Function>
+void iterate_tile(const sycl::range<Dim> r, const sycl::range<Dim> tile_size,
+                  const sycl::id<Dim> tile_id, Function f) noexcept {
+  sycl::id<Dim> begin;
+  sycl::range<Dim> extent;
+  for(int i = 0; i < Dim; ++i) {
+    begin[i] = tile_id[i] * tile_size[i];
+    extent[i] = std::min(tile_size[i], r[i] - begin[i]);
+  }
+  iterate_range(begin, extent, f);
+}
+
+namespace detail {
+
+/// Converts coordinates to the index along the Hilbert curve in the
+/// transposed representation of J. Skilling, "Programming the Hilbert curve"
+/// (AIP Conf. Proc. 707, 2004), in place.
+template <int Dim>
+void hilbert_axes_to_transpose(std::uint32_t (&x)[Dim],
+                               int num_bits) noexcept {
+  const std::uint32_t m = std::uint32_t{1} << (num_bits - 1);
+  // Inverse undo
+  for(std::uint32_t q = m; q > 1; q >>= 1) {
+    const std::uint32_t p = q - 1;
+    for(int i = 0; i < Dim; ++i) {
+      if(x[i] & q) {
+        x[0] ^= p;
+      } else {
+        const std::uint32_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  // Gray encode
+  for(int i = 1; i < Dim; ++i)
+    x[i] ^= x[i - 1];
+  std::uint32_t t = 0;
+  for(std::uint32_t q = m; q > 1; q >>= 1)
+    if(x[Dim - 1] & q)
+      t ^= q - 1;
+  for(int i = 0; i < Dim; ++i)
+    x[i] ^= t;
+}
+
+template <int Dim>
+void build_tile_order(const sycl::range<Dim> num_tiles, tile_order order,
+                      std::vector<sycl::id<Dim>> &out) {
+  out.clear();
+  out.reserve(num_tiles.size());
+
+  // Space-filling curves are defined on cubes with power-of-two edges.
+  // Only the tiles inside num_tiles are assigned their position on the
+  // curve, since the enclosing cube of an elongated grid can be
+  // arbitrarily larger than the grid itself.
+  int num_bits = 1;
+  for(int i = 0; i < Dim; ++i)
+    while((std::size_t{1} << num_bits) < num_tiles[i])
+      ++num_bits;
+
+  if(order == tile_order::row_major || Dim == 1 || num_bits * Dim > 64) {
+    iterate_range(num_tiles, [&](sycl::id<Dim> tile) { out.push_back(tile); });
+    return;
+  }
+
+  std::vector<std::pair<std::uint64_t, sycl::id<Dim>>> keyed_tiles;
+  keyed_tiles.reserve(num_tiles.size());
+  iterate_range(num_tiles, [&](sycl::id<Dim> tile) {
+    std::uint32_t x[Dim];
+    for(int d = 0; d < Dim; ++d)
+      x[d] = static_cast<std::uint32_t>(tile[d]);
+    // For the Hilbert curve, this yields the transposed index
+    if(order == tile_order::hilbert)
+      hilbert_axes_to_transpose<Dim>(x, num_bits);
+
+    // Bit level l of dimension d is bit l * Dim + (Dim - 1 - d) of
+    // the position on the curve.
+    std::uint64_t key = 0;
+    for(int l = 0; l < num_bits; ++l)
+      for(int d = 0; d < Dim; ++d)
+        key |= static_cast<std::uint64_t>((x[d] >> l) & 1)
+               << (l * Dim + (Dim - 1 - d));
+    keyed_tiles.emplace_back(key, tile);
+  });
+
+  std::sort(keyed_tiles.begin(), keyed_tiles.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  for(const auto &keyed_tile : keyed_tiles)
+    out.push_back(keyed_tile.second);
+}
+
+}
+
+/// Returns the tile ids of a grid of num_tiles in the given order.
+/// The result is cached per thread, so that repeated launches over
+/// the same grid do not rebuild it.
+template <int Dim>
+const std::vector<sycl::id<Dim>> &get_tile_order(const sycl::range<Dim> num_tiles,
+                                                 tile_order order) {
+  struct cache_entry {
+    sycl::range<Dim> num_tiles;
+    tile_order order = tile_order::row_major;
+    std::vector<sycl::id<Dim>> tiles;
+  };
+  static thread_local cache_entry cache;
+
+  if(cache.tiles.empty() || cache.num_tiles != num_tiles ||
+     cache.order != order) {
+    detail::build_tile_order(num_tiles, order, cache.tiles);
+    cache.num_tiles = num_tiles;
+    cache.order = order;
+  }
+  return cache.tiles;
+}
+
+/// Heuristic whether tiled iteration is likely to improve cache reuse over
+/// row-major iteration of r: Stencil-like kernels reuse data from
+/// neighboring rows (2D) or planes (3D). Once a few of those no longer fit
+/// into the L2 cache, row-major iteration has to reload them from memory.
+template <int Dim>
+bool is_tiling_beneficial(const sycl::range<Dim> r) noexcept {
+  if constexpr (Dim == 1) {
+    return false;
+  } else {
+    constexpr std::size_t assumed_l2_cache_size = 1024 * 1024;
+    // Three rows/planes of two 4-byte arrays (e.g. input and output)
+    constexpr std::size_t assumed_bytes_per_index = 3 * 2 * 4;
+
+    const std::size_t slab_size = r.size() / r[0];
+    return slab_size * assumed_bytes_per_index > assumed_l2_cache_size &&
+           r[0] > 2;
+  }
+}
+
 template <int Dim, class Function>
 void iterate_partial_range(const sycl::range<Dim> whole_range,
                            const sycl::id<Dim> begin,
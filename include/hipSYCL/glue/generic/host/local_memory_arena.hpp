@@ -0,0 +1,120 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_HOST_LOCAL_MEMORY_ARENA_HPP
+#define HIPSYCL_HOST_LOCAL_MEMORY_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace hipsycl {
+namespace glue {
+namespace host {
+
+/// Memory for local memory and group algorithm scratch of host kernels,
+/// one arena per thread.
+///
+/// The arena is allocated by the thread that uses it, so first-touch
+/// places it on the NUMA node of that thread. It is page-aligned, reused
+/// across kernel launches without being cleared, and only grows if a
+/// kernel requires more memory than any previous kernel. Pages that a
+/// kernel never touches are never committed by the OS.
+class local_memory_arena {
+public:
+  struct region {
+    void* local_memory;
+    void* group_scratch;
+  };
+
+  // Alignment of the group scratch area within the arena
+  static constexpr std::size_t scratch_alignment = sizeof(double) * 16;
+
+  static local_memory_arena& get() {
+    static thread_local local_memory_arena arena;
+    return arena;
+  }
+
+  /// Returns num_local_mem_bytes of local memory, followed by
+  /// num_scratch_bytes of scratch memory for group algorithms.
+  /// The contents of the memory are unspecified.
+  region acquire(std::size_t num_local_mem_bytes,
+                 std::size_t num_scratch_bytes) {
+    const std::size_t scratch_offset =
+        round_up(num_local_mem_bytes, scratch_alignment);
+    const std::size_t num_bytes = scratch_offset + num_scratch_bytes;
+
+    if(num_bytes > _capacity) {
+      free();
+      _capacity = round_up(num_bytes, get_page_size());
+      _data = static_cast<char*>(
+          ::operator new(_capacity, std::align_val_t{get_page_size()}));
+    }
+    return region{_data, _data + scratch_offset};
+  }
+
+  ~local_memory_arena() { free(); }
+
+  static std::size_t get_page_size() {
+#ifndef _WIN32
+    static const std::size_t page_size =
+        static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+#else
+    return 4096;
+#endif
+  }
+private:
+  local_memory_arena() = default;
+
+  local_memory_arena(const local_memory_arena&) = delete;
+  local_memory_arena& operator=(const local_memory_arena&) = delete;
+
+  static std::size_t round_up(std::size_t x, std::size_t multiple) {
+    return (x + multiple - 1) / multiple * multiple;
+  }
+
+  void free() {
+    if(_data)
+      ::operator delete(_data, std::align_val_t{get_page_size()});
+    _data = nullptr;
+    _capacity = 0;
+  }
+
+  char* _data = nullptr;
+  std::size_t _capacity = 0;
+};
+
+}
+}
+}
+
+#endif
@@ -107,9 +107,25 @@ private:
   std::vector<std::size_t> _mapped_sizes; 
 };
 
+inline bool is_global_llvm_ir_image(const common::hcf_container::node* image_node) {
+  const std::string* format = image_node->get_value("format");
+  const std::string* variant = image_node->get_value("variant");
+  return format && variant && *format == "llvm-ir" &&
+         *variant == "global-module";
+}
+
 class default_llvm_image_selector {
 public:
   std::string operator()(const rt::hcf_kernel_info* kernel_info) const {
+    // Merged HCF objects can contain multiple global LLVM IR images,
+    // so pick the one that provides the kernel.
+    for(const auto& image_name : kernel_info->get_images_containing_kernel()) {
+      const rt::hcf_image_info *image_info = rt::hcf_cache::get().get_image_info(
+          kernel_info->get_hcf_object_id(), image_name);
+      if (image_info && image_info->get_format() == "llvm-ir" &&
+          image_info->get_variant() == "global-module")
+        return image_name;
+    }
     return "llvm-ir.global";
   }
 };
@@ -166,7 +182,7 @@ private:
             const rt::hcf_cache::symbol_resolver_list &images) {
       for (const auto &img : images) {
         // Always attempt to link with global LLVM IR for now
-        if (img.image_node->node_id == "llvm-ir.global") {
+        if (is_global_llvm_ir_image(img.image_node)) {
           _image_node_to_hcf_map[img.image_node] = img.hcf_id;
           ir_modules_to_link.push_back(
               reinterpret_cast<llvm_module_id>(img.image_node));
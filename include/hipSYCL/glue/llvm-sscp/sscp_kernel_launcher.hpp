@@ -85,8 +85,10 @@ namespace glue {
 
 namespace sscp {
 
-static std::string get_local_hcf_object() {
-  return std::string{
+// The HCF object only references the embedded device images, such that they
+// are not paged in unless they are JIT-compiled.
+static common::hcf_container get_local_hcf_object() {
+  return common::hcf_container{
       reinterpret_cast<const char *>(__acpp_local_sscp_hcf_content),
       __acpp_local_sscp_hcf_object_size};
 }
@@ -95,9 +97,8 @@ static std::string get_local_hcf_object() {
 // macro. We cannot use this macro directly because it expects
 // the object id to be constexpr, which it is not for the SSCP case.
 struct static_hcf_registration {
-  static_hcf_registration(const std::string& hcf_data) {
-    this->_hcf_object = rt::hcf_cache::get().register_hcf_object(
-        common::hcf_container{hcf_data});
+  static_hcf_registration(const common::hcf_container& hcf) {
+    this->_hcf_object = rt::hcf_cache::get().register_hcf_object(hcf);
   }
 
   ~static_hcf_registration() {
@@ -231,6 +232,55 @@ private:
   const sycl::id<Dimensions> _offset;
 };
 
+template<class UserKernel, int Dimensions>
+class hierarchical_parallel_for {
+public:
+  hierarchical_parallel_for(const UserKernel& k)
+  : _k{k} {}
+
+  [[clang::annotate("hipsycl_kernel_dimension", Dimensions)]]
+  void operator()() const {
+    sycl::group<Dimensions> this_group{
+        sycl::detail::get_group_id<Dimensions>(),
+        sycl::detail::get_local_size<Dimensions>(),
+        sycl::detail::get_grid_size<Dimensions>()};
+
+    _k(this_group);
+  };
+private:
+  UserKernel _k;
+};
+
+template<class UserKernel, int Dimensions>
+class scoped_parallel_for {
+public:
+  scoped_parallel_for(const UserKernel& k)
+  : _k{k} {}
+
+  [[clang::annotate("hipsycl_kernel_dimension", Dimensions)]]
+  void operator()() const {
+    sycl::group<Dimensions> this_group{
+        sycl::detail::get_group_id<Dimensions>(),
+        sycl::detail::get_local_size<Dimensions>(),
+        sycl::detail::get_grid_size<Dimensions>()};
+
+    _k(sycl::detail::sp_group<group_properties>{this_group});
+  };
+private:
+  // The group size is only known at JIT time, so we cannot multiversion
+  // the kernel for specific sub group sizes like the hiplike backends do.
+  // Work groups therefore decompose directly into scalar groups, which
+  // means that sub group barriers become no-ops. When targeting the host,
+  // the work item loops are then formed by CBS at JIT time.
+  using group_properties = sycl::detail::sp_property_descriptor<
+      Dimensions, 0,
+      sycl::detail::nested_range<
+          sycl::detail::unknown_static_range,
+          sycl::detail::nested_range<sycl::detail::static_range<1>>>>;
+
+  UserKernel _k;
+};
+
 }
 
 class sscp_kernel_launcher : public rt::backend_kernel_launcher
@@ -302,8 +352,16 @@ public:
 
       } else if constexpr (type == rt::kernel_type::hierarchical_parallel_for) {
 
+        launch_kernel(
+            __sscp_dispatch::hierarchical_parallel_for<Kernel, Dim>{k},
+            operation, get_grid_range(), local_range, dynamic_local_memory);
+
       } else if constexpr( type == rt::kernel_type::scoped_parallel_for) {
-        
+
+        launch_kernel(__sscp_dispatch::scoped_parallel_for<Kernel, Dim>{k},
+                      operation, get_grid_range(), local_range,
+                      dynamic_local_memory);
+
       } else if constexpr (type == rt::kernel_type::custom) {
         assert(_params);
         sycl::interop_handle handle{node->get_assigned_device(),
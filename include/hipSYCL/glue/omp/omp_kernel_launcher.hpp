@@ -40,6 +40,9 @@
 #include "../../runtime/dag_node.hpp"
 #include "../../runtime/hints.hpp"
 #include "../../runtime/omp/omp_queue.hpp"
+#include "../../runtime/generic/host_core_partitioner.hpp"
+#include "../../runtime/generic/host_execution_arbiter.hpp"
+#include "../../runtime/generic/thread_affinity.hpp"
 #include "../../sycl/libkernel/backend.hpp"
 #include "../../sycl/exception.hpp"
 #include "../../sycl/interop_handle.hpp"
@@ -58,6 +61,7 @@
 
 #include "../generic/host/collective_execution_engine.hpp"
 #include "../generic/host/iterate_range.hpp"
+#include "../generic/host/local_memory_arena.hpp"
 
 namespace hipsycl {
 namespace glue {
@@ -89,19 +93,67 @@ inline int get_num_threads() {
 
 template <class Function>
 void parallel_invocation(Function kernel) noexcept {
+  // If cores are partitioned between concurrently executing kernels,
+  // the team only spans the cores assigned to this kernel.
+  const rt::host_core_partition* partition = rt::host_core_partition::current();
+  const bool is_partitioned = partition && partition->is_active();
+  const int num_threads =
+      is_partitioned ? partition->get_num_threads() : get_max_num_threads();
 #ifndef _OPENMP
+  (void)num_threads;
   HIPSYCL_DEBUG_WARNING
       << "omp_kernel_launcher: Kernel launcher was built without OpenMP "
          "support, the kernel will execute sequentially!"
       << std::endl;
 #else
-#pragma omp parallel
+#pragma omp parallel num_threads(num_threads)
 #endif
   {
+    if(is_partitioned)
+      rt::thread_affinity::get().pin_kernel_thread_to_core(
+          partition->get_core(get_my_thread_id()));
+    else
+      rt::thread_affinity::get().pin_kernel_thread(get_my_thread_id());
     kernel();
   }
 }
 
+/// Like parallel_invocation(), but if the kernel may be preempted by work
+/// of higher priority or needs to adapt to the cores used by concurrent
+/// kernels, the outermost dimension of r is split into chunks
+/// which are executed in separate parallel regions.
+/// Each thread invokes region with a function that runs its argument for
+/// all indices of the current chunk in an OpenMP for loop.
+template <int Dim, class Region>
+void parallel_invocation_chunked(const sycl::range<Dim> r,
+                                 std::size_t work_per_index,
+                                 Region region) noexcept {
+  const std::size_t num_slices = r.get(0);
+  const std::size_t work_per_slice =
+      num_slices > 0 ? r.size() / num_slices * work_per_index : 0;
+  rt::host_core_partition partition{r.size(), work_per_index};
+
+  rt::for_each_preemptible_chunk(
+      num_slices, work_per_slice, [&](std::size_t begin, std::size_t end) {
+        if (begin == 0 && end == num_slices) {
+          parallel_invocation([&]() {
+            region([&](auto &&f) { host::iterate_range_omp_for(r, f); });
+          });
+        } else {
+          sycl::id<Dim> chunk_offset{};
+          chunk_offset[0] = begin;
+          sycl::range<Dim> chunk_range = r;
+          chunk_range[0] = end - begin;
+
+          parallel_invocation([&]() {
+            region([&](auto &&f) {
+              host::iterate_range_omp_for(chunk_offset, chunk_range, f);
+            });
+          });
+        }
+      });
+}
+
 #ifdef __HIPSYCL_USE_ACCELERATED_CPU__
 extern "C" size_t __acpp_cbs_local_id_x;
 extern "C" size_t __acpp_cbs_local_id_y;
@@ -141,14 +193,65 @@ void single_task_kernel(Function f) noexcept
   f();
 }
 
+/// Iterates over r in tiles if requested by the iteration order hint, or
+/// if the automatic heuristic expects better cache reuse. The tiles are
+/// distributed in contiguous segments of the selected tile order across
+/// threads. Returns false if r should be iterated in row-major order instead.
 template <int Dim, class Function>
-inline void parallel_for_kernel(Function f,
-                                const sycl::range<Dim> execution_range) noexcept
-{
+bool parallel_for_tiled(const sycl::range<Dim> r,
+                        const rt::hints::prefer_host_iteration_order *hint,
+                        Function &&f) noexcept {
+  if constexpr (Dim == 1) {
+    return false;
+  } else {
+    rt::host_iteration_order order =
+        hint ? hint->get_order() : rt::host_iteration_order::automatic;
+    if (order == rt::host_iteration_order::automatic)
+      order = host::is_tiling_beneficial(r) ? rt::host_iteration_order::tiled
+                                            : rt::host_iteration_order::row_major;
+    if (order == rt::host_iteration_order::row_major)
+      return false;
+
+    host::tile_order tile_order = host::tile_order::row_major;
+    if (order == rt::host_iteration_order::morton)
+      tile_order = host::tile_order::morton;
+    else if (order == rt::host_iteration_order::hilbert)
+      tile_order = host::tile_order::hilbert;
+
+    const sycl::range<Dim> tile_size =
+        host::get_tile_size(r, hint ? hint->get_tile_edge() : 0);
+    const std::vector<sycl::id<Dim>> &tiles =
+        host::get_tile_order(host::get_num_tiles(r, tile_size), tile_order);
+
+    parallel_invocation_chunked(
+        sycl::range<1>{tiles.size()}, tile_size.size(),
+        [&](auto &&iterate_tiles) {
+          iterate_tiles([&](sycl::id<1> tile) {
+            host::iterate_tile(r, tile_size, tiles[tile[0]], f);
+          });
+        });
+    return true;
+  }
+}
+
+template <int Dim, class Function>
+inline void parallel_for_kernel(
+    Function f, const sycl::range<Dim> execution_range,
+    const rt::hints::prefer_host_iteration_order *iteration_hint =
+        nullptr) noexcept {
   static_assert(Dim > 0 && Dim <= 3, "Only dimensions 1,2,3 are supported");
 
-  parallel_invocation([=](){
-    host::iterate_range_omp_for(execution_range, [&](sycl::id<Dim> idx) {
+  if (parallel_for_tiled(execution_range, iteration_hint,
+                         [&](sycl::id<Dim> idx) {
+                           auto this_item =
+                             sycl::detail::make_item<Dim>(idx, execution_range);
+
+                           f(this_item);
+                         }))
+    return;
+
+  parallel_invocation_chunked(execution_range, 1, [&](auto &&iterate) {
+    iterate([&](sycl::id<Dim> idx) {
       auto this_item =
         sycl::detail::make_item<Dim>(idx, execution_range);
 
@@ -158,22 +261,36 @@ inline void parallel_for_kernel(Function f,
 }
 
 template <int Dim, class Function>
-inline void parallel_for_kernel_offset(Function f,
-                                       const sycl::range<Dim> execution_range,
-                                       const sycl::id<Dim> offset) noexcept {
+inline void parallel_for_kernel_offset(
+    Function f, const sycl::range<Dim> execution_range,
+    const sycl::id<Dim> offset,
+    const rt::hints::prefer_host_iteration_order *iteration_hint =
+        nullptr) noexcept {
   static_assert(Dim > 0 && Dim <= 3, "Only dimensions 1,2,3 are supported");
 
+  if (parallel_for_tiled(execution_range, iteration_hint,
+                         [&](sycl::id<Dim> idx) {
+                           auto this_item = sycl::detail::make_item<Dim>(
+                               idx + offset, execution_range, offset);
 
-  parallel_invocation([=](){
-    host::iterate_range_omp_for(offset, execution_range, [&](sycl::id<Dim> idx) {
+                           f(this_item);
+                         }))
+    return;
+
+  parallel_invocation_chunked(execution_range, 1, [&](auto &&iterate) {
+    iterate([&](sycl::id<Dim> idx) {
       auto this_item =
-        sycl::detail::make_item<Dim>(idx, execution_range, offset);
+        sycl::detail::make_item<Dim>(idx + offset, execution_range, offset);
 
       f(this_item);
     });
   });
 }
 
+// Scratch memory for group algorithms in nd_range kernels. It is only
+// committed by the OS as far as group algorithms actually touch it.
+constexpr std::size_t group_algorithm_scratch_size = 128 * 1024;
+
 template <int Dim, class Function>
 inline void parallel_for_ndrange_kernel(
     Function f, const sycl::range<Dim> num_groups,
@@ -182,26 +299,42 @@ inline void parallel_for_ndrange_kernel(
 {
   static_assert(Dim > 0 && Dim <= 3, "Only dimensions 1 - 3 are supported.");
 
-  parallel_invocation([=](){
-    if(num_groups.size() == 0 || local_size.size() == 0)
-      return;
-
-    sycl::detail::host_local_memory::request_from_threadprivate_pool(
-        num_local_mem_bytes);
-
-    // 128 kiB as local memory for group algorithms
-    std::aligned_storage_t<128*1024, sizeof(double) * 16> group_shared_memory_ptr{};
 #ifdef __HIPSYCL_USE_ACCELERATED_CPU__
+  if(num_groups.size() == 0 || local_size.size() == 0)
+    return;
+
+  parallel_invocation_chunked(num_groups, local_size.size(),
+                              [&](auto &&iterate_groups) {
+    auto local_memory = host::local_memory_arena::get().acquire(
+        num_local_mem_bytes, group_algorithm_scratch_size);
+    sycl::detail::host_local_memory::request_external(
+        static_cast<char *>(local_memory.local_memory));
     std::function<void()> barrier_impl = [] () noexcept {
       assert(false && "splitting seems to have failed");
       std::terminate();
     };
 
-    host::iterate_range_omp_for(num_groups, [&](sycl::id<Dim> &&group_id) {
+    iterate_groups([&](sycl::id<Dim> &&group_id) {
       iterate_nd_range_omp(f, std::move(group_id), num_groups, local_size, offset,
-        num_local_mem_bytes, &group_shared_memory_ptr, barrier_impl);
+        num_local_mem_bytes, local_memory.group_scratch, barrier_impl);
     });
-#elif defined(HIPSYCL_HAS_FIBERS)
+
+    sycl::detail::host_local_memory::release();
+  });
+#else
+  // The collective execution engine statically distributes all groups
+  // across threads, so fiber-based nd_range kernels are not split
+  // into preemptible chunks.
+  rt::host_core_partition partition{num_groups.size(), local_size.size()};
+  parallel_invocation([=](){
+    if(num_groups.size() == 0 || local_size.size() == 0)
+      return;
+
+    auto local_memory = host::local_memory_arena::get().acquire(
+        num_local_mem_bytes, group_algorithm_scratch_size);
+    sycl::detail::host_local_memory::request_external(
+        static_cast<char *>(local_memory.local_memory));
+#if defined(HIPSYCL_HAS_FIBERS)
     host::static_range_decomposition<Dim> group_decomposition{
         num_groups, get_num_threads()};
 
@@ -222,7 +355,7 @@ inline void parallel_for_ndrange_kernel(
                                     local_size,
                                     num_groups,
                                     &barrier_impl,
-                                    &group_shared_memory_ptr};
+                                    local_memory.group_scratch};
 
       f(this_item);
     });
@@ -230,6 +363,7 @@ inline void parallel_for_ndrange_kernel(
 
     sycl::detail::host_local_memory::release();
   });
+#endif
 }
 
 template <int Dim, class Function>
@@ -240,11 +374,13 @@ inline void parallel_for_workgroup(Function f,
 {
   static_assert(Dim > 0 && Dim <= 3, "Only dimensions 1,2,3 are supported");  
 
-  parallel_invocation([=](){
-    sycl::detail::host_local_memory::request_from_threadprivate_pool(
-        num_local_mem_bytes);
+  parallel_invocation_chunked(num_groups, local_size.size(),
+                              [&](auto &&iterate_groups) {
+    sycl::detail::host_local_memory::request_external(static_cast<char *>(
+        host::local_memory_arena::get().acquire(num_local_mem_bytes, 0)
+            .local_memory));
 
-    host::iterate_range_omp_for(num_groups, [&, f](sycl::id<Dim> group_id) {
+    iterate_groups([&, f](sycl::id<Dim> group_id) {
       sycl::group<Dim> this_group{group_id, local_size, num_groups};
 
       f(this_group);
@@ -264,11 +400,13 @@ inline void parallel_region(Function f,
   static_assert(dimensions > 0 && dimensions <= 3,
                 "Only dimensions 1,2,3 are supported");
 
-  parallel_invocation([=]() {
-    sycl::detail::host_local_memory::request_from_threadprivate_pool(
-        num_local_mem_bytes);
+  parallel_invocation_chunked(num_groups, group_size.size(),
+                              [&](auto &&iterate_groups) {
+    sycl::detail::host_local_memory::request_external(static_cast<char *>(
+        host::local_memory_arena::get().acquire(num_local_mem_bytes, 0)
+            .local_memory));
 
-    host::iterate_range_omp_for(num_groups, [&](sycl::id<dimensions> group_id) {
+    iterate_groups([&](sycl::id<dimensions> group_id) {
       using group_properties =
           sycl::detail::sp_property_descriptor<dimensions, 0,
                                                HierarchicalDecomposition>;
@@ -392,10 +530,14 @@ public:
 
       } else if constexpr (type == rt::kernel_type::basic_parallel_for) {
 
+        const auto *iteration_hint =
+            node->get_execution_hints()
+                .get_hint<rt::hints::prefer_host_iteration_order>();
         if(!is_with_offset) {
-          omp_dispatch::parallel_for_kernel(k, global_range);
+          omp_dispatch::parallel_for_kernel(k, global_range, iteration_hint);
         } else {
-          omp_dispatch::parallel_for_kernel_offset(k, global_range, offset);
+          omp_dispatch::parallel_for_kernel_offset(k, global_range, offset,
+                                                   iteration_hint);
         }
 
       } else if constexpr (type == rt::kernel_type::ndrange_parallel_for) {
@@ -66,6 +66,15 @@ public:
   dag finish_and_reset();
 
   std::size_t get_current_dag_size() const;
+
+  /// Invokes f() while holding the lock that serializes DAG building, such
+  /// that no nodes are added and no data users are registered concurrently.
+  /// f must not add nodes itself.
+  template<class F>
+  auto invoke_locked(F&& f) const {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return f();
+  }
 private:
   bool is_conflicting_access(const memory_requirement *mem_req,
                              const data_user &user) const;
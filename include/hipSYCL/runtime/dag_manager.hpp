@@ -28,7 +28,12 @@
 #ifndef HIPSYCL_DAG_MANAGER_HPP
 #define HIPSYCL_DAG_MANAGER_HPP
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 #include "dag.hpp"
 #include "dag_builder.hpp"
@@ -43,6 +48,55 @@ namespace rt {
 
 class runtime;
 
+/// Implements the adaptive DAG flush policy: Nodes are flushed immediately
+/// if the executors have completed the previous flush, and are otherwise
+/// collected into batches whose size adapts to the submission rate.
+/// A timer thread flushes nodes that have not been flushed for longer than
+/// the maximum latency.
+class adaptive_flush_policy {
+public:
+  /// \param flush Invoked from the timer thread when the maximum latency
+  /// is exceeded. Must invoke \c notify_flush_begin(). If empty, no timer
+  /// thread is started, and the latency is only checked in should_flush().
+  adaptive_flush_policy(std::size_t max_batch_size,
+                        std::chrono::microseconds max_latency,
+                        std::function<void()> flush);
+  ~adaptive_flush_policy();
+
+  adaptive_flush_policy(const adaptive_flush_policy&) = delete;
+  adaptive_flush_policy& operator=(const adaptive_flush_policy&) = delete;
+
+  /// Returns whether the given number of unflushed nodes should be
+  /// flushed now.
+  bool should_flush(std::size_t num_unflushed_nodes);
+  /// Must be called before unflushed nodes are taken from the DAG builder.
+  void notify_flush_begin();
+  /// Must be called with the command groups of each non-empty flush.
+  void notify_flushed(const node_list_t& flushed_nodes);
+
+  std::size_t get_batch_size() const;
+private:
+  // Whether nodes of the last flush have not yet completed.
+  // Must be called with _mutex held.
+  bool is_last_flush_pending() const;
+  void timer_loop();
+
+  std::size_t _max_batch_size;
+  std::chrono::microseconds _max_latency;
+  std::function<void()> _flush;
+
+  mutable std::mutex _mutex;
+  std::size_t _batch_size = 1;
+  // Time at which the oldest unflushed node was submitted, or
+  // the default value if there are no unflushed nodes.
+  std::chrono::steady_clock::time_point _oldest_unflushed_submission;
+  node_list_t _last_flushed_nodes;
+
+  std::condition_variable _timer_cv;
+  bool _is_timer_shutdown = false;
+  std::thread _timer;
+};
+
 class dag_manager
 {
   friend class dag_build_guard;
@@ -77,6 +131,9 @@ private:
   // Should only be used for flush_async()
   std::mutex _flush_mutex;
 
+  // Only set if the adaptive flush policy is used
+  std::unique_ptr<adaptive_flush_policy> _adaptive_flush_policy;
+
   // TODO: This is not used anywhere
   [[maybe_unused]] runtime* _rt;
 };
@@ -0,0 +1,187 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_DAG_TRACE_HPP
+#define HIPSYCL_DAG_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../sycl/access.hpp"
+#include "dag_node.hpp"
+#include "data.hpp"
+#include "hints.hpp"
+#include "instrumentation.hpp"
+#include "operations.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+enum class dag_trace_operation_kind : uint8_t {
+  kernel = 0,
+  memcpy,
+  memset,
+  prefetch,
+  file_io,
+  // Explicit memory requirement, e.g. from update_host()
+  requirement,
+  other
+};
+
+struct dag_trace_access {
+  uint64_t region_id = 0;
+  uint64_t element_size = 0;
+  uint64_t num_elements[3] = {};
+  uint64_t page_size[3] = {};
+  uint64_t offset[3] = {};
+  uint64_t range[3] = {};
+  sycl::access::mode mode = sycl::access::mode::read_write;
+  sycl::access::target target = sycl::access::target::device;
+};
+
+/// One operation as it was submitted to the DAG builder.
+/// Times are in nanoseconds relative to the start of the trace.
+struct dag_trace_record {
+  uint64_t node_id = 0;
+  dag_trace_operation_kind kind = dag_trace_operation_kind::other;
+  // Kernel name for kernels, empty otherwise
+  std::string name;
+  // -1 if the operation is not bound to a device
+  int backend = -1;
+  int device = -1;
+  uint64_t node_group = 0;
+  // -1 if there is no lane preference
+  int64_t preferred_lane = -1;
+  uint64_t submission_time = 0;
+  uint64_t start_time = 0;
+  // 0 if the duration could not be measured
+  uint64_t duration = 0;
+  // Ids of nodes that this operation depends on explicitly, i.e. excluding
+  // dependencies derived from its accesses.
+  std::vector<uint64_t> dependencies;
+  std::vector<dag_trace_access> accesses;
+};
+
+class dag_trace_writer {
+public:
+  explicit dag_trace_writer(const std::string& filename);
+
+  bool is_open() const;
+  void write(const dag_trace_record& record);
+private:
+  uint64_t get_string_id(const std::string& s);
+
+  std::ofstream _file;
+  std::unordered_map<std::string, uint64_t> _string_ids;
+};
+
+class dag_trace_reader {
+public:
+  explicit dag_trace_reader(const std::string& filename);
+
+  // Returns false if the file could not be opened or is not a DAG trace
+  bool is_valid() const;
+  // Returns false at the end of the trace or for malformed entries
+  bool read(dag_trace_record& out);
+private:
+  std::ifstream _file;
+  std::vector<std::string> _strings;
+  bool _is_valid;
+};
+
+/// Captures the operations submitted to the DAG builder into the file
+/// given by ACPP_RT_DAG_TRACE_FILE, for replay with acpp-dag-replay.
+/// Operations are written once they have completed, so that their
+/// execution durations can be included.
+class dag_trace_recorder {
+public:
+  static dag_trace_recorder& get();
+
+  bool is_enabled() const {
+    return _is_enabled;
+  }
+
+  // Requests the instrumentations that are needed to measure durations
+  void prepare_hints(execution_hints& hints) const;
+  void record_submission(const dag_node_ptr &node,
+                         const requirements_list &requirements);
+  // Keeps the timestamps of pending nodes that have been submitted to
+  // their backends, so that they outlive the nodes.
+  void record_executions();
+  // Writes all outstanding records, waiting for their nodes if necessary
+  void flush();
+private:
+  dag_trace_recorder();
+
+  uint64_t assign_node_id(const dag_node_ptr& node);
+  bool find_node_id(const dag_node_ptr& node, uint64_t& id) const;
+  uint64_t get_region_id(const std::shared_ptr<buffer_data_region>& region);
+  void add_access(const buffer_memory_requirement *req,
+                  dag_trace_record &record);
+  void write_completed_records(bool wait);
+
+  // Pending records do not keep their nodes alive. Nodes that are
+  // destroyed before their record is written have completed.
+  struct pending_record {
+    dag_trace_record record;
+    std::weak_ptr<dag_node> node;
+    // Set once the node has been submitted
+    std::shared_ptr<instrumentations::execution_start_timestamp> start;
+    std::shared_ptr<instrumentations::execution_finish_timestamp> finish;
+  };
+
+  static void capture_timestamps(pending_record& p, const dag_node_ptr& node);
+
+  bool _is_enabled;
+  std::unique_ptr<dag_trace_writer> _writer;
+  profiler_clock::time_point _start;
+
+  uint64_t _next_node_id = 1;
+  uint64_t _next_region_id = 1;
+  // Weak pointers detect objects that were destroyed and whose
+  // addresses were then reused.
+  std::unordered_map<const dag_node *,
+                     std::pair<std::weak_ptr<dag_node>, uint64_t>>
+      _node_ids;
+  std::unordered_map<const buffer_data_region *,
+                     std::pair<std::weak_ptr<buffer_data_region>, uint64_t>>
+      _region_ids;
+  std::vector<pending_record> _pending;
+  std::mutex _mutex;
+};
+
+}
+}
+
+#endif
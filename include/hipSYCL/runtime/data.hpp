@@ -29,6 +29,7 @@
 #define HIPSYCL_DATA_HPP
 
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <utility>
@@ -41,6 +42,7 @@
 #include "device_id.hpp"
 #include "util.hpp"
 #include "allocator.hpp"
+#include "perf_counters.hpp"
 
 namespace hipsycl {
 namespace rt {
@@ -263,11 +265,16 @@ public:
                 Predicate replaces_user) {
     std::lock_guard<std::mutex> lock{_lock};
 
-    _users.erase(std::remove_if(_users.begin(), _users.end(), replaces_user), 
-      _users.end());
+    auto coalesced_begin =
+        std::remove_if(_users.begin(), _users.end(), replaces_user);
+    if(coalesced_begin != _users.end())
+      perf_count(perf_counter_id::dag_nodes_coalesced,
+                 std::distance(coalesced_begin, _users.end()));
+    _users.erase(coalesced_begin, _users.end());
 
     _users.push_back(
       data_user{std::weak_ptr<dag_node>(user), mode, target, offset, range});
+    perf_record_max(perf_counter_id::data_users_max, _users.size());
   }
 
 private:
@@ -486,6 +493,14 @@ public:
                                                     allocator);
   }
 
+  /// Keeps \c resource alive for the lifetime of the data region. Since
+  /// operations using the data region keep it alive, this can be used
+  /// for resources that back non-owned allocations, e.g. mapped files.
+  void retain_resource(std::shared_ptr<void> resource) {
+    std::lock_guard<std::mutex> lock{_resource_mutex};
+    _retained_resources.push_back(std::move(resource));
+  }
+
   /// Converts an offset into the data buffer (in element numbers) and the
   /// data length (in element numbers) into an equivalent \c page_range.
   page_range get_page_range(id<3> data_offset, range<3> data_range) const {
@@ -518,6 +533,8 @@ public:
 
     assert(has_allocation(d));
 
+    std::lock_guard<std::mutex> lock{_page_state_mutex};
+
     _allocations.select_and_handle(default_allocation_selector{d},
                                    [&](auto &alloc) {
       alloc.invalid_pages.remove(pr);              
@@ -531,16 +548,35 @@ public:
   {
     page_range pr = get_page_range(data_offset, data_size);
 
-    default_allocation_selector argument_match{d};
+    std::lock_guard<std::mutex> lock{_page_state_mutex};
+    mark_pages_current(d, pr);
+  }
 
-    _allocations.for_each_allocation_while([&](auto &alloc) {
-      if (argument_match(alloc)) {
-        alloc.invalid_pages.remove(pr);
-      } else {
-        alloc.invalid_pages.add(pr);
-      }
-      return true;
-    });
+  /// Atomically checks whether an allocation range on a given device is
+  /// up-to-date and, if \c is_write is true, marks it most recent.
+  /// If \c requires_valid_data is false (e.g. for discard accesses), only
+  /// the latter step is carried out.
+  /// Returns false without modifying the data state if the range is outdated.
+  bool try_mark_range_accessed(const device_id &d, id<3> data_offset,
+                               range<3> data_size, bool requires_valid_data,
+                               bool is_write) {
+    assert(has_allocation(d));
+
+    page_range pr = get_page_range(data_offset, data_size);
+
+    std::lock_guard<std::mutex> lock{_page_state_mutex};
+    if(requires_valid_data) {
+      bool is_valid = false;
+      _allocations.select_and_handle(
+          default_allocation_selector{d}, [&](const auto &alloc) {
+            is_valid = alloc.invalid_pages.entire_range_empty(pr);
+          });
+      if(!is_valid)
+        return false;
+    }
+    if(is_write)
+      mark_pages_current(d, pr);
+    return true;
   }
 
   void get_outdated_regions(const device_id& d,
@@ -556,13 +592,16 @@ public:
     range<3> num_pages = pr.second;
 
     // Find outdated regions among pages
-    [[maybe_unused]] bool was_found = _allocations.select_and_handle(
-        default_allocation_selector{d}, [&](auto &alloc) {
-          alloc.invalid_pages.intersections_with(
-              std::make_pair(first_page, num_pages), out);
-        });
-    
-    assert(was_found);
+    {
+      std::lock_guard<std::mutex> lock{_page_state_mutex};
+      [[maybe_unused]] bool was_found = _allocations.select_and_handle(
+          default_allocation_selector{d}, [&](auto &alloc) {
+            alloc.invalid_pages.intersections_with(
+                std::make_pair(first_page, num_pages), out);
+          });
+
+      assert(was_found);
+    }
     
     // Convert back to num elements
     for(range_store::rect& r : out) {
@@ -593,6 +632,7 @@ public:
 
     page_range pr = get_page_range(data_range.first, data_range.second);
 
+    std::lock_guard<std::mutex> lock{_page_state_mutex};
     default_allocation_selector selector{d};
     _allocations.for_each_allocation_while([&](const auto &alloc) {
       // Find all valid pages that are *not* accessible on the given device
@@ -620,6 +660,8 @@ public:
 
   range<3> get_num_elements() const { return _num_elements; }
 
+  range<3> get_page_size() const { return _page_size; }
+
   Memory_descriptor get_memory(device_id dev) const
   {
     assert(has_allocation(dev));
@@ -681,6 +723,7 @@ public:
 
     bool found_valid_pages = false;
 
+    std::lock_guard<std::mutex> lock{_page_state_mutex};
     _allocations.for_each_allocation_while([&](const auto &alloc) {
       if (!alloc.invalid_pages.entire_range_filled(pr)) {
         found_valid_pages = true;
@@ -702,6 +745,20 @@ private:
     invalid
   };
 
+  // Must be invoked while holding _page_state_mutex
+  void mark_pages_current(const device_id &d, const page_range &pr) {
+    default_allocation_selector argument_match{d};
+
+    _allocations.for_each_allocation_while([&](auto &alloc) {
+      if (argument_match(alloc)) {
+        alloc.invalid_pages.remove(pr);
+      } else {
+        alloc.invalid_pages.add(pr);
+      }
+      return true;
+    });
+  }
+
   template <initial_data_state InitialState>
   void add_allocation(const device_id &d, Memory_descriptor memory_context,
                       bool takes_ownership = true,
@@ -733,6 +790,14 @@ private:
   range<3> _num_elements;
 
   data_user_tracker _user_tracker;
+
+  // Guards the page state (invalid_pages) of all allocations. The scheduler
+  // updates it from the DAG worker, while host accessors may query and update
+  // it from user threads.
+  mutable std::mutex _page_state_mutex;
+
+  std::mutex _resource_mutex;
+  std::vector<std::shared_ptr<void>> _retained_resources;
 };
 
 using buffer_data_region = data_region<void*>;
@@ -0,0 +1,165 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_HOST_CORE_PARTITIONER_HPP
+#define HIPSYCL_HOST_CORE_PARTITIONER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace hipsycl {
+namespace rt {
+
+class host_core_partition;
+
+/// Distributes the available cores among host kernels that execute
+/// concurrently, e.g. because they were submitted to different queues.
+/// Instead of all kernels opening parallel regions across all cores
+/// and thereby oversubscribing the machine, each kernel receives a disjoint
+/// subset of cores whose size depends on the available parallelism of
+/// the kernel and the number of concurrently active kernels.
+///
+/// Partitioning is opt-in (see ACPP_RT_OMP_CORE_PARTITIONING) and only takes
+/// place while at least two kernels execute concurrently; otherwise, kernels
+/// are not affected at all. This class is thread-safe.
+class host_core_partitioner {
+public:
+  static host_core_partitioner& get();
+
+  /// Creates a partitioner for the given cores that is independent of the
+  /// global one and the runtime settings.
+  host_core_partitioner(const std::vector<int>& cores, bool is_enabled);
+
+  bool is_enabled() const noexcept { return _is_enabled; }
+
+  /// Whether cores are currently partitioned between kernels, i.e. whether
+  /// more than one kernel is active.
+  bool is_partitioning() const noexcept {
+    return _is_partitioning.load(std::memory_order_acquire);
+  }
+
+  std::size_t get_num_cores() const noexcept { return _cores.size(); }
+
+  /// The number of kernels that the backend should attempt
+  /// to execute concurrently. This is 1 if partitioning is disabled,
+  /// since concurrent kernels would otherwise oversubscribe the cores.
+  std::size_t get_max_concurrent_kernels() const noexcept;
+private:
+  friend class host_core_partition;
+
+  host_core_partitioner();
+
+  void add(host_core_partition* p);
+  void remove(host_core_partition* p);
+  void update(host_core_partition* p);
+
+  // Recomputes the target number of cores for all active
+  // partitions. Must be called with _mutex locked.
+  void compute_shares();
+  void release_slots(host_core_partition* p, std::size_t num_remaining);
+
+  bool _is_enabled;
+  std::atomic<bool> _is_partitioning;
+  // Incremented whenever the target or the availability of cores changes
+  std::atomic<uint64_t> _generation;
+
+  std::mutex _mutex;
+  std::vector<int> _cores;
+  // Number of partitions that currently use each core
+  std::vector<std::size_t> _core_users;
+  std::vector<host_core_partition*> _active;
+};
+
+/// The share of cores of a kernel executed by the calling thread. Registers
+/// the kernel with the host_core_partitioner for the lifetime of the object.
+class host_core_partition {
+public:
+  /// \param num_work_groups The number of work groups (or work items, for
+  /// kernels without work groups) that can be executed concurrently
+  /// \param work_per_group The number of work items in each group
+  host_core_partition(std::size_t num_work_groups, std::size_t work_per_group);
+  host_core_partition(host_core_partitioner& partitioner,
+                      std::size_t num_work_groups, std::size_t work_per_group);
+  ~host_core_partition();
+
+  host_core_partition(const host_core_partition&) = delete;
+  host_core_partition& operator=(const host_core_partition&) = delete;
+
+  /// Whether the kernel is restricted to a subset of cores. If not,
+  /// the team size and placement of threads should not be modified.
+  bool is_active() const noexcept { return !_core_ids.empty(); }
+
+  int get_num_threads() const noexcept {
+    return static_cast<int>(_core_ids.size());
+  }
+
+  /// The core that the thread with the given id within the kernel team
+  /// should run on.
+  int get_core(int thread_id) const noexcept {
+    return _core_ids[static_cast<std::size_t>(thread_id) % _core_ids.size()];
+  }
+
+  /// Adopts the current share of cores of this kernel. Must only be called
+  /// by the thread that created the partition, outside of parallel regions.
+  void update();
+
+  /// The partition of the kernel that is executed by the calling thread,
+  /// or nullptr.
+  static host_core_partition* current() noexcept;
+
+  /// Whether the kernel executed by the calling thread should be split into
+  /// chunks, between which resize_point() is invoked, such that it can
+  /// adapt to kernels starting or finishing concurrently. This is the case
+  /// for all kernels registered with an enabled partitioner.
+  static bool is_current_kernel_resizable() noexcept;
+
+  /// Adopts the current share of cores of the kernel executed by the
+  /// calling thread.
+  static void resize_point();
+private:
+  friend class host_core_partitioner;
+
+  host_core_partitioner* _partitioner;
+  std::size_t _desired_num_cores;
+  // Target number of cores, protected by the mutex of the partitioner
+  std::size_t _target_num_cores;
+  // Indices of the cores used by this partition within the partitioner
+  std::vector<std::size_t> _slots;
+  // The core ids corresponding to _slots, only accessed by the kernel
+  std::vector<int> _core_ids;
+  uint64_t _generation;
+  bool _is_registered;
+  host_core_partition* _previous;
+};
+
+}
+}
+
+#endif
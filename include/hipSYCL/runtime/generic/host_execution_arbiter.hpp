@@ -0,0 +1,181 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_HOST_EXECUTION_ARBITER_HPP
+#define HIPSYCL_HOST_EXECUTION_ARBITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include "host_core_partitioner.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+/// Arbitrates which host kernels may occupy the CPU cores, such that
+/// kernels submitted with higher priority are executed first. Up to
+/// host_core_partitioner::get_max_concurrent_kernels() kernels may execute
+/// concurrently, regardless of their priorities.
+/// As with CUDA stream priorities, numerically lower values correspond to
+/// higher priorities, and the default priority is 0.
+///
+/// Arbitration only takes place once a queue with a non-default priority
+/// has been created; until then, kernels are not affected at all.
+/// This class is thread-safe.
+class host_execution_arbiter {
+public:
+  static constexpr int default_priority = 0;
+
+  static host_execution_arbiter& get();
+
+  /// Creates an arbiter independent of the global one that admits up to
+  /// the given number of kernels concurrently.
+  explicit host_execution_arbiter(std::size_t max_concurrent_kernels);
+
+  /// Enables arbitration, and notifies the arbiter that kernels
+  /// with the given priority may be submitted.
+  void register_priority(int priority);
+
+  bool is_enabled() const noexcept {
+    return _is_enabled.load(std::memory_order_acquire);
+  }
+
+  /// Blocks until the calling thread may execute a kernel with the
+  /// given priority, i.e. until fewer than the maximum number of kernels
+  /// execute. Among waiting kernels, the kernel with the highest
+  /// priority is admitted first; kernels of the same priority are
+  /// admitted in the order in which they arrived.
+  void acquire(int priority);
+  void release();
+
+  /// Whether a kernel of the given priority currently blocks
+  /// work of higher priority from being admitted.
+  bool should_yield(int priority) const noexcept {
+    return _highest_waiting_priority.load(std::memory_order_relaxed) <
+           priority;
+  }
+
+  /// Whether kernels of the given priority can be preempted by work
+  /// of higher priority.
+  bool is_preemptible(int priority) const noexcept {
+    return is_enabled() &&
+           _highest_registered_priority.load(std::memory_order_relaxed) <
+               priority;
+  }
+private:
+  host_execution_arbiter();
+
+  void update_highest_waiting_priority();
+
+  std::atomic<bool> _is_enabled;
+  std::atomic<int> _highest_registered_priority;
+  std::atomic<int> _highest_waiting_priority;
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::size_t _max_running;
+  std::size_t _num_running;
+  uint64_t _next_ticket;
+  // (priority, ticket) of all waiting kernels, ordered by admission order
+  std::set<std::pair<int, uint64_t>> _waiting;
+};
+
+/// Acquires the host_execution_arbiter for the lifetime of the object
+/// (if arbitration is enabled), and makes the priority of the kernel
+/// known to preemption points reached by the calling thread.
+class host_execution_guard {
+public:
+  host_execution_guard(int priority);
+  ~host_execution_guard();
+
+  host_execution_guard(const host_execution_guard&) = delete;
+  host_execution_guard& operator=(const host_execution_guard&) = delete;
+
+  /// Whether the kernel that is executed by the calling thread may be
+  /// split into chunks, between which preemption_point() is invoked.
+  static bool is_current_kernel_preemptible() noexcept;
+
+  /// Temporarily gives up the CPU if work of higher priority is waiting.
+  /// Must only be called by the thread that created the guard, outside
+  /// of parallel regions.
+  static void preemption_point();
+private:
+  bool _is_acquired;
+  int _priority;
+  host_execution_guard* _previous;
+};
+
+/// Splits [0, num_slices) into consecutive chunks and invokes
+/// f(begin, end) for each of them, with a preemption point and a resize
+/// point of the host_core_partition in between.
+/// The range is only split if the kernel executed by the calling thread is
+/// preemptible or resizable; otherwise f(0, num_slices) is invoked once.
+/// \c work_per_slice is the number of work items in each slice. It is used
+/// to avoid chunks that are too small to amortize the cost of the additional
+/// parallel regions.
+template <class F>
+void for_each_preemptible_chunk(std::size_t num_slices,
+                                std::size_t work_per_slice, F &&f) {
+  constexpr std::size_t max_num_chunks = 32;
+  constexpr std::size_t min_work_per_chunk = 64 * 1024;
+
+  std::size_t num_chunks = 1;
+  if(num_slices > 1 &&
+     (host_execution_guard::is_current_kernel_preemptible() ||
+      host_core_partition::is_current_kernel_resizable())) {
+    num_chunks = std::min(
+        {num_slices, max_num_chunks,
+         std::max(std::size_t{1},
+                  num_slices * work_per_slice / min_work_per_chunk)});
+  }
+
+  if(num_chunks <= 1) {
+    f(std::size_t{0}, num_slices);
+    return;
+  }
+
+  std::size_t chunk_size = (num_slices + num_chunks - 1) / num_chunks;
+  for(std::size_t begin = 0; begin < num_slices; begin += chunk_size) {
+    if(begin > 0) {
+      host_execution_guard::preemption_point();
+      host_core_partition::resize_point();
+    }
+    f(begin, std::min(begin + chunk_size, num_slices));
+  }
+}
+
+}
+}
+
+#endif
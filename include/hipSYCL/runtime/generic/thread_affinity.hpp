@@ -0,0 +1,95 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_THREAD_AFFINITY_HPP
+#define HIPSYCL_THREAD_AFFINITY_HPP
+
+#include <string>
+#include <vector>
+
+namespace hipsycl {
+namespace rt {
+
+/// Controls on which cores runtime threads are executed.
+///
+/// If a set of helper cores is reserved using ACPP_RT_HELPER_THREAD_CORES,
+/// runtime helper threads (e.g. the DAG worker, the DAG garbage collector
+/// and the worker threads of queues) are pinned to these cores, while
+/// threads executing host kernels are pinned to one of the remaining cores
+/// each. Without a reservation, thread placement is left to the OS and
+/// the OpenMP runtime.
+class thread_affinity {
+public:
+  static thread_affinity& get();
+
+  bool is_isolation_enabled() const noexcept {
+    return _is_isolation_enabled;
+  }
+
+  const std::vector<int>& get_helper_cores() const noexcept {
+    return _helper_cores;
+  }
+
+  /// The cores that kernel threads may use, i.e. the cores
+  /// of the process affinity mask that are not reserved for helper threads.
+  const std::vector<int>& get_kernel_cores() const noexcept {
+    return _kernel_cores;
+  }
+
+  /// Pins the calling thread to the helper cores, if isolation is enabled.
+  void pin_helper_thread() const;
+
+  /// Pins the calling kernel thread to the kernel core corresponding to its
+  /// thread id within the kernel team, if isolation is enabled. Otherwise,
+  /// a pin from a previous call to pin_kernel_thread_to_core() is undone.
+  /// Threads that are already pinned to the right core are not touched,
+  /// such that this is cheap to call at the beginning of every kernel.
+  void pin_kernel_thread(int thread_id) const;
+
+  /// Pins the calling kernel thread to the given core, unless it is
+  /// already pinned to it.
+  void pin_kernel_thread_to_core(int core) const;
+
+  /// Restores the affinity that the calling thread had before it was
+  /// pinned to a kernel core, if it is pinned to one.
+  void unpin_kernel_thread() const;
+
+  /// Parses a core list such as "0,2,4-7". Returns false if the
+  /// list is malformed.
+  static bool parse_core_list(const std::string& list, std::vector<int>& out);
+private:
+  thread_affinity();
+
+  bool _is_isolation_enabled;
+  std::vector<int> _helper_cores;
+  std::vector<int> _kernel_cores;
+};
+
+}
+}
+
+#endif
@@ -46,6 +46,15 @@ using dag_node_ptr = std::shared_ptr<dag_node>;
 
 class operation;
 
+/// Order in which host backends iterate over multi-dimensional
+/// basic parallel_for ranges
+enum class host_iteration_order {
+  automatic,
+  row_major,
+  tiled,
+  morton,
+  hilbert
+};
 
 namespace hints {
 
@@ -145,6 +154,27 @@ private:
 
 class instant_execution : public execution_hint {};
 
+class prefer_host_iteration_order : public execution_hint
+{
+public:
+  prefer_host_iteration_order() = default;
+  prefer_host_iteration_order(host_iteration_order order,
+                              std::size_t tile_edge = 0)
+      : _order{order}, _tile_edge{tile_edge} {}
+
+  host_iteration_order get_order() const {
+    return _order;
+  }
+
+  /// Edge length of tiles, or 0 if the backend should decide.
+  std::size_t get_tile_edge() const {
+    return _tile_edge;
+  }
+private:
+  host_iteration_order _order = host_iteration_order::automatic;
+  std::size_t _tile_edge = 0;
+};
+
 class request_instrumentation_submission_timestamp : public execution_hint {};
 class request_instrumentation_start_timestamp : public execution_hint {};
 class request_instrumentation_finish_timestamp : public execution_hint {};
@@ -210,6 +240,8 @@ private:
       _request_instrumentation_finish_timestamp;
 
   hints::instant_execution _instant_execution;
+
+  hints::prefer_host_iteration_order _prefer_host_iteration_order;
 };
 
 #define HIPSYCL_RT_HINTS_MAP_GETTER(name, member)                              \
@@ -236,6 +268,8 @@ HIPSYCL_RT_HINTS_MAP_GETTER(request_instrumentation_finish_timestamp,
                             _request_instrumentation_finish_timestamp);
 HIPSYCL_RT_HINTS_MAP_GETTER(instant_execution,
                             _instant_execution);
+HIPSYCL_RT_HINTS_MAP_GETTER(prefer_host_iteration_order,
+                            _prefer_host_iteration_order);
 }
 }
 
@@ -109,6 +109,20 @@ public:
     return i;
   }
 
+  /// Returns the given instrumentation without waiting for it to make
+  /// results available. Returns nullptr if the given instrumentation was
+  /// not set up or if instrumentations are still being set up.
+  template<typename Instr> std::shared_ptr<Instr> try_get() const {
+    if(!_registration_complete)
+      return nullptr;
+
+    for(const auto& current : _instrs) {
+      if(current.first == typeid(Instr))
+        return std::static_pointer_cast<Instr>(current.second);
+    }
+    return nullptr;
+  }
+
   template<typename Instr>
   void add_instrumentation(std::shared_ptr<Instr> instr) {
     assert(!_registration_complete);
@@ -0,0 +1,94 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_IO_EXECUTOR_HPP
+#define HIPSYCL_IO_EXECUTOR_HPP
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "executor.hpp"
+#include "event.hpp"
+#include "signal_channel.hpp"
+#include "generic/async_worker.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+class io_node_event : public dag_node_event {
+public:
+  io_node_event();
+  ~io_node_event();
+
+  virtual bool is_complete() const override;
+  virtual void wait() override;
+
+  void signal();
+private:
+  signal_channel _signal_channel;
+};
+
+class io_engine;
+
+/// Executes file I/O operations (file_read_operation, file_write_operation)
+/// on a pool of dedicated worker threads, such that I/O can overlap
+/// with kernels and data transfers on all backends.
+/// Each operation waits for its requirements on the worker thread and then
+/// submits its transfers using io_uring if available, or falls back
+/// to pread()/pwrite() otherwise.
+class io_executor : public backend_executor
+{
+public:
+  io_executor();
+  ~io_executor();
+
+  virtual bool is_inorder_queue() const override;
+  virtual bool is_outoforder_queue() const override;
+  virtual bool is_taskgraph() const override;
+
+  virtual void
+  submit_directly(dag_node_ptr node, operation *op,
+                  const node_list_t &reqs) override;
+
+  virtual bool can_execute_on_device(const device_id& dev) const override;
+  virtual bool is_submitted_by_me(dag_node_ptr node) const override;
+
+  std::size_t get_num_threads() const;
+private:
+  std::size_t select_worker() const;
+
+  std::mutex _mutex;
+  std::vector<std::unique_ptr<worker_thread>> _workers;
+  // One I/O engine per worker, since engines are not thread-safe
+  std::vector<std::unique_ptr<io_engine>> _engines;
+};
+
+}
+}
+
+#endif
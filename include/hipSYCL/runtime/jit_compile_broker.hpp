@@ -0,0 +1,105 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_JIT_COMPILE_BROKER_HPP
+#define HIPSYCL_JIT_COMPILE_BROKER_HPP
+
+#include <string>
+#include <utility>
+
+#include "kernel_configuration.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+/// Deduplicates JIT compilation of the same binary across processes
+/// running on the same node, e.g. MPI ranks of the same application.
+///
+/// If ACPP_RT_JIT_BROKER_DIR is set, a process has to hold a lock for the
+/// id of the binary while compiling it. Processes that need the same binary
+/// wait for the lock and then load the result from the persistent kernel
+/// cache instead of compiling it themselves.
+/// Locks are advisory file locks (flock) on files in the broker directory,
+/// which should therefore be on a node-local filesystem such as /tmp or
+/// /dev/shm. Locks are released by the OS if a process terminates while
+/// compiling, so waiting processes never deadlock. The lock file is removed
+/// by the process holding the lock when it releases it.
+class jit_compile_broker {
+public:
+  class compile_lock {
+  public:
+    compile_lock() = default;
+    compile_lock(int fd, const std::string& filename, bool has_waited)
+    : _fd{fd}, _filename{filename}, _has_waited{has_waited} {}
+
+    compile_lock(const compile_lock&) = delete;
+    compile_lock& operator=(const compile_lock&) = delete;
+
+    compile_lock(compile_lock&& other) noexcept
+    : _fd{other._fd}, _filename{std::move(other._filename)},
+      _has_waited{other._has_waited} {
+      other._fd = -1;
+    }
+
+    ~compile_lock();
+
+    bool is_locked() const noexcept { return _fd >= 0; }
+
+    /// Whether another process held the lock when it was requested.
+    /// Note that the binary may have been stored to the persistent kernel
+    /// cache in the meantime even if this is false, so the cache must
+    /// be checked again after obtaining the lock in any case.
+    bool has_waited() const noexcept { return _has_waited; }
+  private:
+    int _fd = -1;
+    std::string _filename;
+    bool _has_waited = false;
+  };
+
+  static jit_compile_broker& get();
+
+  /// Creates a broker using the given lock directory, independently of
+  /// the runtime settings. An empty directory disables the broker.
+  explicit jit_compile_broker(const std::string& lock_dir);
+
+  bool is_enabled() const noexcept { return _is_enabled; }
+
+  /// Blocks until the calling process may compile the binary with the
+  /// given id. If the broker is disabled or the lock cannot be obtained,
+  /// returns a lock object with is_locked() == false immediately.
+  compile_lock lock(const kernel_configuration::id_type& id_of_binary) const;
+private:
+  jit_compile_broker();
+
+  bool _is_enabled;
+  std::string _lock_dir;
+};
+
+}
+}
+
+#endif
@@ -35,6 +35,8 @@
 #include "../runtime/kernel_configuration.hpp"
 #include "../runtime/device_id.hpp"
 #include "../runtime/error.hpp"
+#include "../runtime/perf_counters.hpp"
+#include "../runtime/jit_compile_broker.hpp"
 
 #ifndef HIPSYCL_RT_KERNEL_CACHE_HPP
 #define HIPSYCL_RT_KERNEL_CACHE_HPP
@@ -167,6 +169,10 @@ private:
 // Stores all HCF data, and also extracts information for data
 // in the SSCP format.
 //
+// If ACPP_RT_MERGED_HCF points to a merged HCF object as generated by
+// acpp-hcf-tool --merge, the objects that it was merged from are
+// transparently redirected to the merged object upon registration.
+//
 // This class is thread-safe.
 class hcf_cache {
 public:
@@ -209,10 +215,27 @@ public:
                                        const std::string &image_name) const;
 
 private:
-  hcf_cache() = default;
+  hcf_cache();
+
+  void load_merged_hcf_object(const std::string& filename);
+  void register_exported_symbols(hcf_object_id id,
+                                 const common::hcf_container::node *image_node);
+  void register_kernel_and_image_info(hcf_object_id id,
+                                      const common::hcf_container *obj);
+  // Returns the merged object id for objects that were merged, or id otherwise.
+  hcf_object_id resolve_merged_object(hcf_object_id id) const;
 
   std::unordered_map<hcf_object_id, std::unique_ptr<common::hcf_container>>
       _hcf_objects;
+  // Maps ids of objects that are contained in a merged object to the merged
+  // object id
+  std::unordered_map<hcf_object_id, hcf_object_id> _merged_object_ids;
+  // Images of merged objects, by the id of the object they originate from.
+  // Their symbols are only exported once one of these objects is registered,
+  // so that a stale merged object cannot provide symbols to other objects.
+  std::unordered_map<hcf_object_id,
+                     std::vector<const common::hcf_container::node *>>
+      _merged_images_by_source;
   std::unordered_map<std::string, symbol_resolver_list> _exported_symbol_providers;
 
     
@@ -304,20 +327,32 @@ public:
     std::lock_guard<std::mutex> lock{_mutex};
 
     if(!persistent_cache_lookup(id_of_binary, compiled_binary)){
-      if(!jit_compile(compiled_binary))
-        return nullptr;
-
-      if(_is_first_jit_compilation) {
-        _is_first_jit_compilation = false;
-        HIPSYCL_DEBUG_WARNING
-            << "kernel_cache: This application run has resulted in new "
-               "binaries being JIT-compiled. This indicates that the runtime "
-               "optimization process has not yet reached peak performance. You "
-               "may want to run the application again until this warning no "
-               "longer appears to achieve optimal performance."
-            << std::endl;
+      // If another process on this node is already compiling the same
+      // binary, wait for it and pick up its result from the persistent cache.
+      // The cache is checked again even if we did not wait, since another
+      // process may have finished compiling between the first lookup and
+      // obtaining the lock. The miss has already been counted, so the
+      // recheck does not contribute to the perf counters.
+      auto broker_lock = jit_compile_broker::get().lock(id_of_binary);
+      if (!broker_lock.is_locked() ||
+          !persistent_cache_lookup(id_of_binary, compiled_binary,
+                                   false /*count_lookup*/)) {
+        if(!jit_compile(compiled_binary))
+          return nullptr;
+        perf_count(perf_counter_id::jit_compilations);
+
+        if(_is_first_jit_compilation) {
+          _is_first_jit_compilation = false;
+          HIPSYCL_DEBUG_WARNING
+              << "kernel_cache: This application run has resulted in new "
+                 "binaries being JIT-compiled. This indicates that the runtime "
+                 "optimization process has not yet reached peak performance. "
+                 "You may want to run the application again until this "
+                 "warning no longer appears to achieve optimal performance."
+              << std::endl;
+        }
+        persistent_cache_store(id_of_binary, compiled_binary);
       }
-      persistent_cache_store(id_of_binary, compiled_binary);
     }
     
     const code_object* new_object = c(compiled_binary);
@@ -333,7 +368,8 @@ public:
   // Stitches together the persisten cache path with the id of the binary to a unique path.
   static std::string get_persistent_cache_file(code_object_id id_of_binary);
 private:
-  bool persistent_cache_lookup(code_object_id id_of_binary, std::string& out) const;
+  bool persistent_cache_lookup(code_object_id id_of_binary, std::string &out,
+                               bool count_lookup = true) const;
   void persistent_cache_store(code_object_id id_of_binary, const std::string& data) const;
   
   const code_object* get_code_object_impl(code_object_id id) const;
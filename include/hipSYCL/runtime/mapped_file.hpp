@@ -0,0 +1,94 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_MAPPED_FILE_HPP
+#define HIPSYCL_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "error.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+enum class mapped_file_mode {
+  // Mapping is read-only; writing to it is undefined behavior.
+  read_only,
+  // Writes go to a private copy of the affected pages and are
+  // never written to the file.
+  private_copy_on_write
+};
+
+enum class mapped_file_advice {
+  normal,
+  sequential,
+  random,
+  will_need,
+  dont_need
+};
+
+/// A region of a file that is mapped into the address space of the
+/// process. Pages are only loaded from the file once they are touched.
+class mapped_file {
+public:
+  /// Maps \c size bytes starting at byte \c offset of the file at \c path.
+  /// If \c size is 0, maps everything from \c offset until the end of the file.
+  static result map(const std::string &path, std::size_t offset,
+                    std::size_t size, mapped_file_mode mode,
+                    std::shared_ptr<mapped_file> &out);
+
+  ~mapped_file();
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  void* get_data() const;
+  std::size_t get_size() const;
+  mapped_file_mode get_mode() const;
+
+  /// Passes an access pattern hint for the byte range [offset, offset+size)
+  /// of the mapped region to the operating system.
+  result advise(std::size_t offset, std::size_t size,
+                mapped_file_advice advice) const;
+private:
+  mapped_file(void *mapping_base, std::size_t mapping_size,
+              std::size_t data_offset, std::size_t size,
+              mapped_file_mode mode);
+
+  void* _mapping_base;
+  std::size_t _mapping_size;
+  std::size_t _data_offset;
+  std::size_t _size;
+  mapped_file_mode _mode;
+};
+
+}
+}
+
+#endif
@@ -119,6 +119,16 @@ private:
   std::vector<submission> _last_submissions;
 };
 
+/// Selects the lane within \c lane_range that an operation with the given
+/// hints is submitted to. \c synchronization_cost contains, for each lane of
+/// \c lane_range, the number of unfinished requirements that were submitted
+/// to that lane; \c lane_usage contains the recent usage of all lanes of the
+/// device.
+std::size_t select_execution_lane(const execution_hints &hints,
+                                  const int *synchronization_cost,
+                                  const std::vector<double> &lane_usage,
+                                  backend_execution_lane_range lane_range);
+
 /// An executor that submits tasks by serializing them onto 
 /// to multiple inorder queues (e.g. CUDA streams)
 class multi_queue_executor : public backend_executor
@@ -64,7 +64,7 @@ private:
 class omp_queue : public inorder_queue
 {
 public:
-  omp_queue(backend_id id);
+  omp_queue(backend_id id, int priority = 0);
   virtual ~omp_queue();
 
   /// Inserts an event into the stream
@@ -98,6 +98,7 @@ public:
   worker_thread& get_worker();
 private:
   const backend_id _backend_id;
+  const int _priority;
   worker_thread _worker;
 
   omp_sscp_code_object_invoker _sscp_code_object_invoker;
@@ -48,6 +48,7 @@
 #include <functional>
 #include <memory>
 #include <ostream>
+#include <string>
 
 namespace hipsycl {
 namespace rt {
@@ -66,6 +67,8 @@ class kernel_operation;
 class memcpy_operation;
 class prefetch_operation;
 class memset_operation;
+class file_read_operation;
+class file_write_operation;
 
 using node_list_t = common::small_vector<dag_node_ptr, 8>;
 
@@ -76,6 +79,10 @@ public:
   virtual result dispatch_memcpy(memcpy_operation* op, dag_node_ptr node) = 0;
   virtual result dispatch_prefetch(prefetch_operation *op, dag_node_ptr node) = 0;
   virtual result dispatch_memset(memset_operation* op, dag_node_ptr node) = 0;
+  virtual result dispatch_file_read(file_read_operation *op,
+                                    dag_node_ptr node) = 0;
+  virtual result dispatch_file_write(file_write_operation *op,
+                                     dag_node_ptr node) = 0;
   virtual ~operation_dispatcher(){}
 };
 
@@ -88,6 +95,7 @@ public:
   virtual cost_type get_runtime_costs() { return 1.; }
   virtual bool is_requirement() const { return false; }
   virtual bool is_data_transfer() const { return false; }
+  virtual bool is_file_io() const { return false; }
   virtual void dump(std::ostream&, int = 0) const = 0;
   virtual bool has_preferred_backend(backend_id &preferred_backend,
                                      device_id &preferred_device) const {
@@ -519,6 +527,62 @@ private:
   std::size_t _num_bytes;
 };
 
+/// Reads a contiguous region of a file into memory.
+/// File I/O is carried out by the runtime's io_executor, so the destination
+/// memory must be accessible from the host.
+class file_read_operation : public operation {
+public:
+  file_read_operation(const std::string &path, std::size_t file_offset,
+                      const memory_location &dest, range<3> num_elements);
+
+  result dispatch(operation_dispatcher *dispatcher,
+                  dag_node_ptr node) final override {
+    return dispatcher->dispatch_file_read(this, node);
+  }
+
+  const std::string &get_path() const;
+  std::size_t get_file_offset() const;
+  const memory_location &dest() const;
+
+  std::size_t get_num_transferred_bytes() const;
+  range<3> get_num_transferred_elements() const;
+
+  virtual bool is_file_io() const final override;
+  void dump(std::ostream&, int = 0) const override;
+private:
+  std::string _path;
+  std::size_t _file_offset;
+  memory_location _dest;
+  range<3> _num_elements;
+};
+
+/// Writes memory to a contiguous region of a file. The file is created
+/// if it does not exist; it is never truncated.
+class file_write_operation : public operation {
+public:
+  file_write_operation(const memory_location &source, range<3> num_elements,
+                       const std::string &path, std::size_t file_offset);
+
+  result dispatch(operation_dispatcher *dispatcher,
+                  dag_node_ptr node) final override {
+    return dispatcher->dispatch_file_write(this, node);
+  }
+
+  const std::string &get_path() const;
+  std::size_t get_file_offset() const;
+  const memory_location &source() const;
+
+  std::size_t get_num_transferred_bytes() const;
+  range<3> get_num_transferred_elements() const;
+
+  virtual bool is_file_io() const final override;
+  void dump(std::ostream&, int = 0) const override;
+private:
+  memory_location _source;
+  range<3> _num_elements;
+  std::string _path;
+  std::size_t _file_offset;
+};
 
 class backend_synchronization_operation
 {
@@ -0,0 +1,192 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_RUNTIME_PERF_COUNTERS_HPP
+#define HIPSYCL_RUNTIME_PERF_COUNTERS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hipsycl {
+namespace rt {
+
+enum class perf_counter_kind {
+  // Accumulates all values that are added
+  sum,
+  // Stores the largest value that was recorded
+  high_water_mark
+};
+
+/// Counters that are maintained by the runtime itself. These are always
+/// registered, and can be accessed without lookup.
+enum class perf_counter_id : int {
+  dag_nodes_submitted = 0,
+  dag_nodes_coalesced,
+  dag_requirements_elided,
+  dag_flushes,
+  dag_flushes_idle,
+  dag_flushes_batch_full,
+  dag_flushes_latency_bound,
+  dag_flush_batch_size_max,
+  dag_gc_passes,
+  data_users_max,
+  memcpy_bytes,
+  allocated_bytes,
+  jit_compilations,
+  persistent_cache_hits,
+  persistent_cache_misses,
+  jit_broker_waits,
+  worker_queue_depth_max,
+  usm_hazard_dependencies,
+
+  num_builtin_counters
+};
+
+/// A counter that can be updated concurrently from many threads at low cost.
+/// Updates go to one of several cache-line sized shards, selected by the
+/// calling thread, such that threads rarely contend on the same cache line.
+/// Shards are only aggregated when the counter is read.
+class perf_counter {
+public:
+  static constexpr std::size_t num_shards = 16;
+
+  perf_counter(const std::string &name, const std::string &description,
+               perf_counter_kind kind);
+
+  perf_counter(const perf_counter&) = delete;
+  perf_counter& operator=(const perf_counter&) = delete;
+
+  void add(uint64_t delta = 1) noexcept {
+    get_shard().fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  void record_max(uint64_t value) noexcept {
+    std::atomic<uint64_t>& shard = get_shard();
+    uint64_t current = shard.load(std::memory_order_relaxed);
+    while(current < value &&
+          !shard.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {}
+  }
+
+  uint64_t read() const noexcept;
+  void reset() noexcept;
+
+  const std::string& get_name() const { return _name; }
+  const std::string& get_description() const { return _description; }
+  perf_counter_kind get_kind() const { return _kind; }
+private:
+  struct alignas(64) shard {
+    std::atomic<uint64_t> value{0};
+  };
+
+  std::atomic<uint64_t>& get_shard() noexcept {
+    return _shards[get_thread_shard_index()].value;
+  }
+
+  static std::size_t get_thread_shard_index() noexcept;
+
+  std::string _name;
+  std::string _description;
+  perf_counter_kind _kind;
+  std::array<shard, num_shards> _shards;
+};
+
+struct perf_counter_value {
+  std::string name;
+  std::string description;
+  perf_counter_kind kind;
+  uint64_t value;
+};
+
+/// Process-wide registry of all performance counters. In addition to the
+/// builtin counters, counters can be created dynamically by name, e.g.
+/// for counters that are specific to a pair of devices.
+///
+/// The registry is never destroyed, so counters may be safely updated
+/// during static destruction.
+/// This class is thread-safe.
+class perf_counter_registry {
+public:
+  static perf_counter_registry& get();
+
+  perf_counter& get(perf_counter_id id) noexcept {
+    return *_builtin_counters[static_cast<int>(id)];
+  }
+
+  /// Returns the counter of the given name, creating it if it does not
+  /// exist yet. Returned references remain valid for the lifetime
+  /// of the process.
+  perf_counter& get_or_create(const std::string& name,
+                              const std::string& description,
+                              perf_counter_kind kind);
+
+  /// Reads all registered counters
+  std::vector<perf_counter_value> read_all() const;
+  /// Resets all registered counters to zero
+  void reset_all();
+
+  void dump(std::ostream& ostr) const;
+
+  /// Called when the runtime shuts down. Dumps all counters
+  /// if requested by the user.
+  void on_runtime_shutdown() const;
+private:
+  perf_counter_registry();
+
+  perf_counter &register_counter(const std::string &name,
+                                 const std::string &description,
+                                 perf_counter_kind kind);
+
+  mutable std::mutex _mutex;
+  // deque guarantees stable references on insertion
+  std::deque<perf_counter> _counters;
+  std::unordered_map<std::string, perf_counter*> _counters_by_name;
+  std::array<perf_counter *,
+             static_cast<int>(perf_counter_id::num_builtin_counters)>
+      _builtin_counters;
+};
+
+inline void perf_count(perf_counter_id id, uint64_t delta = 1) noexcept {
+  perf_counter_registry::get().get(id).add(delta);
+}
+
+inline void perf_record_max(perf_counter_id id, uint64_t value) noexcept {
+  perf_counter_registry::get().get(id).record_max(value);
+}
+
+}
+}
+
+#endif
@@ -31,7 +31,9 @@
 
 #include "dag_manager.hpp"
 #include "backend.hpp"
+#include "io_executor.hpp"
 #include "settings.hpp"
+#include "usm_pool.hpp"
 
 #include <memory>
 #include <iostream>
@@ -57,10 +59,23 @@ public:
 
   const backend_manager &backends() const { return _backends; }
 
+  usm_pool_manager &usm_pools() { return _usm_pools; }
+
+  const usm_pool_manager &usm_pools() const { return _usm_pools; }
+
+  io_executor &io() { return _io_executor; }
+
+  const io_executor &io() const { return _io_executor; }
+
 private:
   // !! Attention: order is important, as backends have to be still present,
-  // when the dag_manager is destructed!
+  // when the dag_manager is destructed! The USM pools must be destroyed after
+  // the dag_manager, which waits for all operations that might still use
+  // pooled memory. The same holds for the io_executor, whose workers
+  // might still be processing file I/O operations.
   backend_manager _backends;
+  usm_pool_manager _usm_pools;
+  io_executor _io_executor;
   dag_manager _dag_manager;
 };
 
@@ -43,6 +43,7 @@ namespace rt {
 
 enum class scheduler_type { direct, unbound };
 enum class default_selector_behavior { strict, multigpu, system };
+enum class dag_flush_policy { fixed, adaptive };
 
 struct device_visibility_condition{
   int device_index_equality = -1;
@@ -69,6 +70,7 @@ bool has_device_visibility_mask(const visibility_mask_t& mask, backend_id backen
 std::istream &operator>>(std::istream &istr, scheduler_type &out);
 std::istream &operator>>(std::istream &istr, visibility_mask_t &out);
 std::istream &operator>>(std::istream &istr, default_selector_behavior& out);
+std::istream &operator>>(std::istream &istr, dag_flush_policy& out);
 
 template <class T>
 bool try_get_environment_variable(const std::string& name, T& out) {
@@ -122,6 +124,17 @@ enum class setting {
   ocl_show_all_devices,
   no_jit_cache_population,
   adaptivity_level,
+  usm_pool_max_cached_bytes,
+  io_threads,
+  io_uring,
+  dump_perf_counters,
+  helper_thread_cores,
+  omp_core_partitioning,
+  jit_broker_dir,
+  merged_hcf,
+  dag_flush_policy,
+  dag_flush_max_latency,
+  dag_trace_file,
 };
 
 template <setting S> struct setting_trait {};
@@ -155,6 +168,26 @@ HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::ocl_no_shared_context, "rt_ocl_no_shared_
 HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::ocl_show_all_devices, "rt_ocl_show_all_devices", bool)
 HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::no_jit_cache_population, "rt_no_jit_cache_population", bool)
 HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::adaptivity_level, "adaptivity_level", int)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::usm_pool_max_cached_bytes,
+                              "rt_usm_pool_max_cached_bytes", std::size_t)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::io_threads, "rt_io_threads", std::size_t)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::io_uring, "rt_io_uring", bool)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::dump_perf_counters,
+                              "rt_dump_perf_counters", bool)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::helper_thread_cores,
+                              "rt_helper_thread_cores", std::string)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::omp_core_partitioning,
+                              "rt_omp_core_partitioning", bool)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::jit_broker_dir,
+                              "rt_jit_broker_dir", std::string)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::merged_hcf,
+                              "rt_merged_hcf", std::string)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::dag_flush_policy,
+                              "rt_dag_flush_policy", dag_flush_policy)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::dag_flush_max_latency,
+                              "rt_dag_flush_max_latency", std::size_t)
+HIPSYCL_RT_MAKE_SETTING_TRAIT(setting::dag_trace_file,
+                              "rt_dag_trace_file", std::string)
 
 class settings
 {
@@ -193,6 +226,28 @@ public:
       return _no_jit_cache_population;
     } else if constexpr(S == setting::adaptivity_level) {
       return _adaptivity_level;
+    } else if constexpr(S == setting::usm_pool_max_cached_bytes) {
+      return _usm_pool_max_cached_bytes;
+    } else if constexpr(S == setting::io_threads) {
+      return _io_threads;
+    } else if constexpr(S == setting::io_uring) {
+      return _io_uring;
+    } else if constexpr(S == setting::dump_perf_counters) {
+      return _dump_perf_counters;
+    } else if constexpr(S == setting::helper_thread_cores) {
+      return _helper_thread_cores;
+    } else if constexpr(S == setting::omp_core_partitioning) {
+      return _omp_core_partitioning;
+    } else if constexpr(S == setting::jit_broker_dir) {
+      return _jit_broker_dir;
+    } else if constexpr(S == setting::merged_hcf) {
+      return _merged_hcf;
+    } else if constexpr(S == setting::dag_flush_policy) {
+      return _dag_flush_policy;
+    } else if constexpr(S == setting::dag_flush_max_latency) {
+      return _dag_flush_max_latency;
+    } else if constexpr(S == setting::dag_trace_file) {
+      return _dag_trace_file;
     }
     return typename setting_trait<S>::type{};
   }
@@ -238,6 +293,35 @@ public:
         get_environment_variable_or_default<setting::no_jit_cache_population>(false);
     _adaptivity_level =
         get_environment_variable_or_default<setting::adaptivity_level>(1);
+    _usm_pool_max_cached_bytes = get_environment_variable_or_default<
+        setting::usm_pool_max_cached_bytes>(std::size_t{1024} * 1024 * 1024);
+    _io_threads =
+        get_environment_variable_or_default<setting::io_threads>(2);
+    _io_uring =
+        get_environment_variable_or_default<setting::io_uring>(true);
+    _dump_perf_counters =
+        get_environment_variable_or_default<setting::dump_perf_counters>(false);
+    _helper_thread_cores =
+        get_environment_variable_or_default<setting::helper_thread_cores>(
+            std::string{});
+    _omp_core_partitioning =
+        get_environment_variable_or_default<setting::omp_core_partitioning>(
+            false);
+    _jit_broker_dir =
+        get_environment_variable_or_default<setting::jit_broker_dir>(
+            std::string{});
+    _merged_hcf =
+        get_environment_variable_or_default<setting::merged_hcf>(
+            std::string{});
+    _dag_flush_policy =
+        get_environment_variable_or_default<setting::dag_flush_policy>(
+            dag_flush_policy::fixed);
+    _dag_flush_max_latency =
+        get_environment_variable_or_default<setting::dag_flush_max_latency>(
+            500);
+    _dag_trace_file =
+        get_environment_variable_or_default<setting::dag_trace_file>(
+            std::string{});
   }
 
 private:
@@ -266,6 +350,17 @@ private:
   bool _ocl_show_all_devices;
   bool _no_jit_cache_population;
   int _adaptivity_level;
+  std::size_t _usm_pool_max_cached_bytes;
+  std::size_t _io_threads;
+  bool _io_uring;
+  bool _dump_perf_counters;
+  std::string _helper_thread_cores;
+  bool _omp_core_partitioning;
+  std::string _jit_broker_dir;
+  std::string _merged_hcf;
+  dag_flush_policy _dag_flush_policy;
+  std::size_t _dag_flush_max_latency;
+  std::string _dag_trace_file;
 };
 
 }
@@ -0,0 +1,143 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_USM_HAZARD_TRACKER_HPP
+#define HIPSYCL_USM_HAZARD_TRACKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../sycl/access.hpp"
+#include "dag_node.hpp"
+#include "operations.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+/// Process-wide registry of the extents of USM allocations that were
+/// made through the SYCL USM allocation functions. This allows resolving
+/// pointers into the middle of an allocation to the allocation itself.
+///
+/// Allocations are only recorded once the registry has been enabled, which
+/// happens when the first queue with USM hazard tracking is constructed.
+class usm_allocation_registry {
+public:
+  static usm_allocation_registry& get();
+
+  void enable();
+  bool is_enabled() const {
+    return _is_enabled.load(std::memory_order_relaxed);
+  }
+
+  // No-ops unless the registry is enabled
+  void register_allocation(const void* ptr, std::size_t num_bytes);
+  void unregister_allocation(const void* ptr);
+
+  // Returns false if ptr does not point into a registered allocation.
+  bool find_allocation(const void *ptr, uint64_t &base,
+                       std::size_t &num_bytes) const;
+private:
+  usm_allocation_registry() = default;
+
+  std::atomic<bool> _is_enabled = false;
+  std::map<uint64_t, std::size_t> _allocations;
+  mutable std::mutex _mutex;
+};
+
+struct usm_access {
+  const void* ptr;
+  // 0 if the access covers the entire allocation that ptr points into
+  std::size_t num_bytes;
+  sycl::access::mode mode;
+  // Introspected accesses are superseded by explicitly declared accesses
+  // to the same allocation. Introspected pointers that do not point into
+  // a registered allocation are treated as accessing all memory.
+  bool is_introspected = false;
+};
+
+/// Derives dependencies between operations from the USM memory they
+/// access, similarly to what the data_user_tracker does for buffers.
+/// Accesses whose allocation cannot be determined are treated
+/// as accessing all memory.
+class usm_hazard_tracker {
+public:
+  // Creates the node of an operation by invoking create_node with reqs and
+  // additional node requirements for all tracked operations with
+  // conflicting accesses, i.e. at least one of the two writes. The node is
+  // then registered as the most recent user of the accessed memory.
+  // Deriving the dependencies and registering the node happens in a single
+  // critical section, so that concurrently submitted operations cannot miss
+  // each other.
+  template<class NodeFactory>
+  dag_node_ptr track_operation(const std::vector<usm_access> &accesses,
+                               const requirements_list &reqs,
+                               NodeFactory &&create_node) {
+    std::vector<usm_user> new_users;
+    resolve_accesses(accesses, new_users);
+
+    requirements_list hazard_reqs = reqs;
+    std::lock_guard<std::mutex> lock{_mutex};
+    add_hazard_dependencies(new_users, hazard_reqs);
+    dag_node_ptr node = create_node(hazard_reqs);
+    register_users(new_users, node);
+    return node;
+  }
+
+  std::size_t get_num_tracked_users() const;
+private:
+  struct usm_user {
+    std::weak_ptr<dag_node> user;
+    bool is_write;
+    // Accessed address range [begin, end)
+    uint64_t begin;
+    uint64_t end;
+  };
+
+  // Resolves accesses to address ranges. Introspected accesses that are
+  // covered by declared accesses are dropped.
+  static void resolve_accesses(const std::vector<usm_access> &accesses,
+                               std::vector<usm_user> &out);
+  // The following functions require _mutex to be locked
+  void add_hazard_dependencies(const std::vector<usm_user> &new_users,
+                               requirements_list &reqs);
+  void register_users(std::vector<usm_user> &new_users,
+                      const dag_node_ptr &node);
+  void release_dead_users();
+
+  std::vector<usm_user> _users;
+  mutable std::mutex _mutex;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_USM_POOL_HPP
+#define HIPSYCL_USM_POOL_HPP
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "allocator.hpp"
+#include "dag_node.hpp"
+#include "device_id.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+class runtime;
+
+enum class usm_pool_memory_kind {
+  device,
+  shared,
+  host
+};
+
+struct usm_pool_statistics {
+  // Total number of allocation requests served by the pool
+  std::size_t num_allocations = 0;
+  // Number of allocation requests served by reusing a cached block
+  std::size_t num_reused_allocations = 0;
+  // Number of allocation requests forwarded to the backend allocator
+  std::size_t num_backend_allocations = 0;
+  // Number of times cached blocks were released to the backend
+  std::size_t num_trims = 0;
+  // Number of bytes currently handed out to the user
+  std::size_t bytes_in_use = 0;
+  // Number of bytes currently held by the pool for reuse
+  std::size_t bytes_cached = 0;
+  // Maximum of bytes_in_use + bytes_cached over the lifetime of the pool
+  std::size_t peak_bytes_reserved = 0;
+};
+
+/// A memory pool for stream-ordered allocations. Freed blocks are not
+/// returned to the backend, but kept together with the operations that
+/// might still access them. A block becomes available for reuse once
+/// all of these operations have completed - or immediately, if it is
+/// requested again from the same in-order stream that freed it.
+class usm_pool {
+public:
+  static constexpr std::size_t no_stream =
+      std::numeric_limits<std::size_t>::max();
+
+  usm_pool(runtime *rt, backend_allocator *allocator,
+           usm_pool_memory_kind kind, std::size_t max_cached_bytes);
+  ~usm_pool();
+
+  usm_pool(const usm_pool&) = delete;
+  usm_pool& operator=(const usm_pool&) = delete;
+
+  /// Allocates at least \c bytes bytes. \c stream identifies the in-order
+  /// stream on which the allocation will be used, or is \c no_stream.
+  /// Returns nullptr if the allocation failed even after releasing
+  /// all cached memory.
+  void* allocate(std::size_t bytes, std::size_t stream);
+  /// Returns \c ptr to the pool. It will not be handed out again until all
+  /// \c dependencies have completed, except for requests from \c stream.
+  /// Returns false if \c ptr was not allocated from this pool.
+  bool free(void *ptr, const std::vector<dag_node_ptr> &dependencies,
+            std::size_t stream);
+  /// Whether \c ptr is an allocation from this pool that is currently in use.
+  bool owns(const void* ptr) const;
+
+  /// Returns cached blocks to the backend allocator. If \c wait is true,
+  /// waits for blocks with outstanding dependencies, otherwise they remain
+  /// cached. Returns the number of released bytes.
+  std::size_t trim(bool wait = false);
+
+  usm_pool_statistics get_statistics() const;
+  usm_pool_memory_kind get_memory_kind() const;
+private:
+  struct cached_block {
+    void* ptr;
+    std::vector<dag_node_ptr> dependencies;
+    std::size_t stream;
+  };
+
+  static std::size_t get_block_size(std::size_t bytes);
+
+  void* allocate_from_backend(std::size_t block_size);
+  bool is_reusable(const cached_block& block, std::size_t stream) const;
+  void update_peak();
+
+  runtime* _rt;
+  backend_allocator* _allocator;
+  usm_pool_memory_kind _kind;
+  std::size_t _max_cached_bytes;
+
+  // Cached blocks, ordered by block size
+  std::multimap<std::size_t, cached_block> _cached_blocks;
+  // Block sizes of allocations currently in use
+  std::unordered_map<const void*, std::size_t> _allocations_in_use;
+  usm_pool_statistics _stats;
+  mutable std::mutex _mutex;
+};
+
+/// Owns the usm_pool objects of all devices and contexts. Pools are
+/// created lazily on first use.
+class usm_pool_manager {
+public:
+  usm_pool_manager(runtime* rt);
+
+  /// Returns the pool for allocations of the given kind on dev. Memory
+  /// is not shared between pools of different contexts, which are
+  /// identified by the opaque \c context id.
+  usm_pool *get_pool(backend_allocator *allocator, device_id dev,
+                     usm_pool_memory_kind kind, std::size_t context);
+  /// Returns the pool from which \c ptr was allocated, or nullptr.
+  usm_pool* find_owning_pool(const void* ptr) const;
+  /// Returns all pools of the given device
+  std::vector<usm_pool*> get_pools(device_id dev) const;
+
+  /// Trims all pools
+  std::size_t trim(bool wait = false);
+private:
+  struct pool_entry {
+    device_id dev;
+    usm_pool_memory_kind kind;
+    std::size_t context;
+    std::unique_ptr<usm_pool> pool;
+  };
+
+  runtime* _rt;
+  std::vector<pool_entry> _pools;
+  mutable std::mutex _mutex;
+};
+
+}
+}
+
+#endif
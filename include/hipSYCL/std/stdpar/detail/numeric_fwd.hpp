@@ -31,7 +31,9 @@
 
 #include "execution_fwd.hpp"
 #include "stdpar_defs.hpp"
+#include <cstddef>
 #include <iterator>
+#include <tuple>
 
 namespace std {
 
@@ -68,4 +70,34 @@ HIPSYCL_STDPAR_ENTRYPOINT T reduce(hipsycl::stdpar::par_unseq, ForwardIt first,
                                    ForwardIt last, T init, BinaryOp binary_op);
 }
 
+namespace hipsycl::stdpar {
+
+// Non-standard extensions
+
+/// Counts the elements of [first, last) falling into each of num_bins
+/// equally wide bins covering [lower, upper), and overwrites
+/// [bins_first, bins_first + num_bins) with the counts.
+/// Returns the end of the output range.
+template <class ForwardIt1, class T, class ForwardIt2>
+HIPSYCL_STDPAR_ENTRYPOINT ForwardIt2
+histogram(par_unseq, ForwardIt1 first, ForwardIt1 last, std::size_t num_bins,
+          T lower, T upper, ForwardIt2 bins_first);
+
+/// Like above, but with bins given by the increasing edges
+/// [edges_first, edges_last).
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3>
+HIPSYCL_STDPAR_ENTRYPOINT ForwardIt3
+histogram(par_unseq, ForwardIt1 first, ForwardIt1 last, ForwardIt2 edges_first,
+          ForwardIt2 edges_last, ForwardIt3 bins_first);
+
+/// Computes the reductions of all descriptors, created with
+/// hipsycl::algorithms::make_transform_reduce_descriptor(), in a single
+/// pass over [first, last). Returns a tuple with one result per descriptor.
+template <class ForwardIt, typename... Descriptors>
+HIPSYCL_STDPAR_ENTRYPOINT std::tuple<decltype(Descriptors::init)...>
+transform_reduce(par_unseq, ForwardIt first, ForwardIt last,
+                 const std::tuple<Descriptors...> &descriptors);
+
+}
+
 #endif
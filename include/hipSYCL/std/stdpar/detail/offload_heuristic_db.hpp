@@ -70,6 +70,7 @@ struct none_of {};
 
 struct transform_reduce {};
 struct reduce {};
+struct histogram {};
 } // namespace algorithm_type
 
 
@@ -36,8 +36,14 @@
 #include "../detail/offload.hpp"
 #include "../../../algorithms/util/allocation_cache.hpp"
 #include "../../../algorithms/numeric.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
+#include <memory>
 #include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace std {
 
@@ -298,4 +304,155 @@ T reduce(hipsycl::stdpar::par_unseq, ForwardIt first,
 
 }
 
+namespace hipsycl::stdpar {
+
+namespace detail {
+
+template <class ForwardIt1, class Binning, class ForwardIt2>
+ForwardIt2 histogram_host_fallback(ForwardIt1 first, ForwardIt1 last,
+                                   const Binning &binning,
+                                   ForwardIt2 bins_first) {
+  using count_type = typename std::iterator_traits<ForwardIt2>::value_type;
+
+  ForwardIt2 bins_last = bins_first;
+  std::advance(bins_last, binning.get_num_bins());
+  std::fill(par_unseq_host_fallback, bins_first, bins_last, count_type{0});
+  std::for_each(first, last, [&](const auto &x) {
+    std::size_t bin;
+    if(binning.get_bin(x, bin))
+      ++(*std::next(bins_first, bin));
+  });
+  return bins_last;
+}
+
+template <class ForwardIt1, class Binning, class ForwardIt2>
+ForwardIt2 histogram_offload(sycl::queue &queue, ForwardIt1 first,
+                             ForwardIt1 last, const Binning &binning,
+                             ForwardIt2 bins_first) {
+  // Kernels still using the scratch memory after the group is released
+  // are safe, because later users of the same allocation cache are
+  // submitted to the same thread-local in-order queue.
+  auto scratch_group =
+      stdpar_tls_runtime::get()
+          .make_scratch_group<
+              hipsycl::algorithms::util::allocation_type::device>();
+
+  hipsycl::algorithms::histogram(queue, scratch_group, first, last, binning,
+                                 std::addressof(*bins_first));
+  ForwardIt2 bins_last = bins_first;
+  std::advance(bins_last, binning.get_num_bins());
+  return bins_last;
+}
+
+template <class ForwardIt, class DescriptorTuple, std::size_t... Is>
+auto fused_transform_reduce_host_fallback(ForwardIt first, ForwardIt last,
+                                          const DescriptorTuple &descriptors,
+                                          std::index_sequence<Is...>) {
+  return std::make_tuple(std::transform_reduce(
+      par_unseq_host_fallback, first, last, std::get<Is>(descriptors).init,
+      std::get<Is>(descriptors).reduce,
+      std::get<Is>(descriptors).transform)...);
+}
+
+template <class ForwardIt, class DescriptorTuple, std::size_t... Is>
+auto fused_transform_reduce_offload(sycl::queue &queue, ForwardIt first,
+                                    ForwardIt last,
+                                    const DescriptorTuple &descriptors,
+                                    std::index_sequence<Is...>) {
+  using result_type =
+      std::tuple<std::decay_t<decltype(std::get<Is>(descriptors).init)>...>;
+
+  // See transform_reduce() regarding the lifetime of the scratch groups
+  auto output_scratch_group =
+      stdpar_tls_runtime::get()
+          .make_scratch_group<
+              hipsycl::algorithms::util::allocation_type::host>();
+  auto reduction_scratch_group =
+      stdpar_tls_runtime::get()
+          .make_scratch_group<
+              hipsycl::algorithms::util::allocation_type::device>();
+
+  auto outputs = std::make_tuple(
+      output_scratch_group
+          .obtain<std::tuple_element_t<Is, result_type>>(1)...);
+  hipsycl::algorithms::transform_reduce(queue, reduction_scratch_group, first,
+                                        last, outputs, descriptors);
+  // We need to wait in any case here, so cannot elide synchronization
+  queue.wait();
+
+  if(first == last)
+    return result_type{std::get<Is>(descriptors).init...};
+  else
+    return result_type{*std::get<Is>(outputs)...};
+}
+
+}
+
+template <class ForwardIt1, class T, class ForwardIt2>
+HIPSYCL_STDPAR_ENTRYPOINT ForwardIt2
+histogram(par_unseq, ForwardIt1 first, ForwardIt1 last, std::size_t num_bins,
+          T lower, T upper, ForwardIt2 bins_first) {
+  hipsycl::algorithms::even_width_binning<T> binning{num_bins, lower, upper};
+
+  auto offloader = [&](auto& queue) {
+    return detail::histogram_offload(queue, first, last, binning, bins_first);
+  };
+
+  auto fallback = [&]() {
+    return detail::histogram_host_fallback(first, last, binning, bins_first);
+  };
+
+  HIPSYCL_STDPAR_OFFLOAD(algorithm_type::histogram{},
+                         std::distance(first, last), ForwardIt2, offloader,
+                         fallback, first, HIPSYCL_STDPAR_NO_PTR_VALIDATION(last),
+                         num_bins, lower, upper, bins_first);
+}
+
+template <class ForwardIt1, class ForwardIt2, class ForwardIt3>
+HIPSYCL_STDPAR_ENTRYPOINT ForwardIt3
+histogram(par_unseq, ForwardIt1 first, ForwardIt1 last, ForwardIt2 edges_first,
+          ForwardIt2 edges_last, ForwardIt3 bins_first) {
+  hipsycl::algorithms::custom_edge_binning<ForwardIt2> binning{edges_first,
+                                                               edges_last};
+
+  auto offloader = [&](auto& queue) {
+    return detail::histogram_offload(queue, first, last, binning, bins_first);
+  };
+
+  auto fallback = [&]() {
+    return detail::histogram_host_fallback(first, last, binning, bins_first);
+  };
+
+  HIPSYCL_STDPAR_OFFLOAD(algorithm_type::histogram{},
+                         std::distance(first, last), ForwardIt3, offloader,
+                         fallback, first, HIPSYCL_STDPAR_NO_PTR_VALIDATION(last),
+                         edges_first, HIPSYCL_STDPAR_NO_PTR_VALIDATION(edges_last),
+                         bins_first);
+}
+
+template <class ForwardIt, typename... Descriptors>
+HIPSYCL_STDPAR_ENTRYPOINT std::tuple<decltype(Descriptors::init)...>
+transform_reduce(par_unseq, ForwardIt first, ForwardIt last,
+                 const std::tuple<Descriptors...> &descriptors) {
+  using result_type = std::tuple<decltype(Descriptors::init)...>;
+
+  auto offloader = [&](auto& queue) {
+    return detail::fused_transform_reduce_offload(
+        queue, first, last, descriptors,
+        std::index_sequence_for<Descriptors...>{});
+  };
+
+  auto fallback = [&]() {
+    return detail::fused_transform_reduce_host_fallback(
+        first, last, descriptors, std::index_sequence_for<Descriptors...>{});
+  };
+
+  HIPSYCL_STDPAR_BLOCKING_OFFLOAD(
+      algorithm_type::transform_reduce{}, std::distance(first, last),
+      result_type, offloader, fallback, first,
+      HIPSYCL_STDPAR_NO_PTR_VALIDATION(last), descriptors);
+}
+
+}
+
 #endif
@@ -35,6 +35,7 @@
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <type_traits>
 #include <algorithm>
 #include <utility>
@@ -45,12 +46,14 @@
 #include "../runtime/data.hpp"
 #include "../runtime/device_id.hpp"
 #include "../runtime/hints.hpp"
+#include "../runtime/mapped_file.hpp"
 #include "../runtime/operations.hpp"
 #include "../runtime/util.hpp"
 #include "../sycl/access.hpp"
 #include "../sycl/device.hpp"
 #include "../sycl/exception.hpp"
 #include "../sycl/extensions.hpp"
+#include "../glue/error.hpp"
 #include "property.hpp"
 #include "types.hpp"
 #include "context.hpp"
@@ -159,6 +162,41 @@ private:
   std::size_t _node_group;
 };
 
+/// Backs the buffer with a file that is mapped into memory instead of
+/// allocating and initializing host memory. File contents are only loaded
+/// once the corresponding pages are accessed.
+class AdaptiveCpp_mapped_file : public detail::buffer_property
+{
+public:
+  enum class mode {
+    // The buffer must only be accessed with access_mode::read.
+    read_only,
+    // Modifications are visible through the buffer but are never
+    // written to the file.
+    copy_on_write
+  };
+
+  AdaptiveCpp_mapped_file(const std::string &path, std::size_t offset = 0,
+                          mode m = mode::read_only)
+  : _path{path}, _offset{offset}, _mode{m} {}
+
+  const std::string& get_path() const {
+    return _path;
+  }
+
+  std::size_t get_offset() const {
+    return _offset;
+  }
+
+  mode get_mode() const {
+    return _mode;
+  }
+private:
+  std::string _path;
+  std::size_t _offset;
+  mode _mode;
+};
+
 using AdaptiveCpp_buffer_uses_external_storage =
     detail::buffer_policy::use_external_storage;
 using AdaptiveCpp_buffer_writes_back =
@@ -188,6 +226,13 @@ template <class BufferT>
 std::shared_ptr<rt::buffer_data_region>
 extract_buffer_data_region(const BufferT &buff);
 
+template <class BufferT>
+void validate_buffer_access(const BufferT &buff, access_mode mode);
+
+template <class BufferT, int AccessDim>
+void advise_buffer_access(const BufferT &buff, sycl::id<AccessDim> offset,
+                          sycl::range<AccessDim> access_range);
+
 struct buffer_impl
 {
   rt::runtime_keep_alive_token requires_runtime;
@@ -199,6 +244,9 @@ struct buffer_impl
   void* writeback_ptr;
   // Only used if a shared_ptr is passed to the buffer constructor
   std::shared_ptr<void> shared_host_data;
+  // Only used if the buffer was constructed with the
+  // AdaptiveCpp_mapped_file property
+  std::shared_ptr<rt::mapped_file> mapped_file;
   
   std::size_t write_back_node_group;
 
@@ -415,6 +463,15 @@ public:
   friend std::shared_ptr<rt::buffer_data_region>
   detail::extract_buffer_data_region(const BufferT &buff);
 
+  template <class BufferT>
+  friend void detail::validate_buffer_access(const BufferT &buff,
+                                             access_mode mode);
+
+  template <class BufferT, int AccessDim>
+  friend void detail::advise_buffer_access(const BufferT &buff,
+                                           sycl::id<AccessDim> offset,
+                                           sycl::range<AccessDim> access_range);
+
   using value_type = T;
   using reference = value_type &;
   using const_reference = const value_type &;
@@ -480,9 +537,13 @@ public:
     
     init_policies_from_properties_or_default(dpol);
 
-    this->init(bufferRange);
+    if(this->has_property<property::buffer::AdaptiveCpp_mapped_file>()) {
+      this->init_mapped_file(bufferRange);
+    } else {
+      this->init(bufferRange);
+    }
 
-    if(_impl->use_external_storage) {
+    if(_impl->use_external_storage && !_impl->mapped_file) {
       HIPSYCL_DEBUG_WARNING
           << "buffer: was constructed with use_external_storage but no host "
              "pointer was supplied. Cannot initialize this buffer with "
@@ -1230,6 +1291,102 @@ private:
     _impl->writeback_ptr = host_memory;
   }
 
+  void init_mapped_file(const range<dimensions>& range)
+  {
+    auto prop = this->get_property<property::buffer::AdaptiveCpp_mapped_file>();
+
+    if(range.size() == 0)
+      throw exception{make_error_code(errc::invalid),
+                      "buffer: Cannot map file into buffer of size 0"};
+
+    if(_impl->writes_back) {
+      HIPSYCL_DEBUG_WARNING
+          << "buffer: Buffers backed by a mapped file do not support "
+             "writeback to the mapped file, disabling writeback."
+          << std::endl;
+      _impl->writes_back = false;
+    }
+
+    rt::mapped_file_mode mode =
+        prop.get_mode() ==
+                property::buffer::AdaptiveCpp_mapped_file::mode::read_only
+            ? rt::mapped_file_mode::read_only
+            : rt::mapped_file_mode::private_copy_on_write;
+
+    std::shared_ptr<rt::mapped_file> file;
+    rt::result res =
+        rt::mapped_file::map(prop.get_path(), prop.get_offset(),
+                             range.size() * sizeof(T), mode, file);
+    if(!res.is_success())
+      std::rethrow_exception(glue::throw_result(res));
+
+    this->init_data_backend(range);
+
+    rt::device_id host_device = detail::get_host_device();
+    // The mapping is up-to-date by definition, so no transfer from other
+    // memory is required. Pages are only read from the file when touched.
+    _impl->data->add_nonempty_allocation(host_device, file->get_data(),
+                                         _impl->requires_runtime.get()
+                                             ->backends()
+                                             .get(host_device.get_backend())
+                                             ->get_allocator(host_device),
+                                         false /*takes_ownership*/);
+    // Operations may still use the mapping after the buffer has been
+    // destroyed if the destructor does not wait, so the mapping must
+    // live as long as the data region.
+    _impl->data->retain_resource(file);
+    _impl->mapped_file = file;
+  }
+
+  // Throws if an accessor with the given access mode cannot be
+  // constructed for this buffer.
+  void validate_access(access_mode mode) const
+  {
+    const std::shared_ptr<rt::mapped_file>& file = _impl->mapped_file;
+    if (file && file->get_mode() == rt::mapped_file_mode::read_only &&
+        mode != access_mode::read)
+      throw exception{make_error_code(errc::invalid),
+                      "buffer: Buffer is backed by a file mapped in read-only "
+                      "mode, but accessor requests write access"};
+  }
+
+  // Forwards access patterns of host accessors to the operating system if
+  // the buffer is backed by a mapped file, such that it can prefetch
+  // the affected pages.
+  void advise_access(const rt::id<3>& offset,
+                     const rt::range<3>& access_range) const
+  {
+    const std::shared_ptr<rt::mapped_file>& file = _impl->mapped_file;
+    if(!file)
+      return;
+
+    if(access_range.size() == 0)
+      return;
+
+    rt::range<3> shape = rt::embed_in_range3(_range);
+    rt::id<3> last;
+    for(int i = 0; i < 3; ++i)
+      last[i] = offset[i] + access_range[i] - 1;
+
+    auto linear_id = [&](const rt::id<3>& idx) {
+      return idx[2] + shape[2] * (idx[1] + shape[1] * idx[0]);
+    };
+    std::size_t begin = linear_id(offset);
+    std::size_t end = linear_id(last) + 1;
+
+    rt::mapped_file_advice advice = rt::mapped_file_advice::will_need;
+    if(access_range.size() == shape.size())
+      advice = rt::mapped_file_advice::sequential;
+
+    rt::result res = file->advise(begin * sizeof(T), (end - begin) * sizeof(T),
+                                  advice);
+    if(!res.is_success()) {
+      HIPSYCL_DEBUG_WARNING << "buffer: Could not pass access pattern of "
+                               "accessor to mapped file"
+                            << std::endl;
+    }
+  }
+
   void init(const range<dimensions> &range,
             const std::vector<buffer_allocation::tracked_descriptor<T>>
                 &input_allocations) {
@@ -1324,6 +1481,18 @@ extract_buffer_range(const buffer<T, dimensions, AllocatorT> &buff) {
   return buff.get_range();
 }
 
+template <class BufferT>
+void validate_buffer_access(const BufferT &buff, access_mode mode) {
+  buff.validate_access(mode);
+}
+
+template <class BufferT, int AccessDim>
+void advise_buffer_access(const BufferT &buff, sycl::id<AccessDim> offset,
+                          sycl::range<AccessDim> access_range) {
+  buff.advise_access(rt::embed_in_id3(offset),
+                     rt::embed_in_range3(access_range));
+}
+
 }
 
 
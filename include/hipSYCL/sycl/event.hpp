@@ -45,8 +45,15 @@
 namespace hipsycl {
 namespace sycl {
 
+class event;
+
+namespace detail {
+rt::dag_node_ptr extract_rt_node(const event&);
+}
+
 class event {
   friend class handler;
+  friend rt::dag_node_ptr detail::extract_rt_node(const event&);
 public:
   event()
   {}
@@ -256,6 +263,14 @@ HIPSYCL_SPECIALIZE_GET_INFO(event, reference_count)
   return _node.use_count();
 }
 
+namespace detail {
+
+inline rt::dag_node_ptr extract_rt_node(const event& evt) {
+  return evt._node;
+}
+
+}
+
 
 } // namespace sycl
 } // namespace hipsycl
@@ -89,5 +89,11 @@
 #define ACPP_EXT_COARSE_GRAINED_EVENTS
 #define ACPP_EXT_QUEUE_PRIORITY
 #define ACPP_EXT_SPECIALIZED
+#define ACPP_EXT_USM_ASYNC_ALLOCATION
+#define ACPP_EXT_BUFFER_MAPPED_FILE
+#define ACPP_EXT_FILE_IO
+#define ACPP_EXT_PERF_COUNTERS
+#define ACPP_EXT_HOST_ITERATION_ORDER
+#define ACPP_EXT_USM_HAZARD_TRACKING
 
 #endif
@@ -29,7 +29,9 @@
 #ifndef HIPSYCL_HANDLER_HPP
 #define HIPSYCL_HANDLER_HPP
 
+#include <cstring>
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
 
@@ -65,6 +67,7 @@
 #include "../runtime/device_id.hpp"
 #include "../runtime/executor.hpp"
 #include "../runtime/util.hpp"
+#include "../runtime/usm_hazard_tracker.hpp"
 #include "../glue/embedded_pointer.hpp"
 #include "../glue/kernel_launcher_factory.hpp"
 #include "../glue/kernel_names.hpp"
@@ -74,6 +77,13 @@
 #include "../algorithms/util/memory_streaming.hpp"
 #include "../algorithms/util/allocation_cache.hpp"
 
+#if defined(__HIPSYCL_ENABLE_LLVM_SSCP_TARGET__)
+// The generic SSCP compiler always provides the reflection builtins
+// required to introspect kernel arguments.
+#define HIPSYCL_HAS_KERNEL_ARGUMENT_INTROSPECTION
+#include "../glue/reflection.hpp"
+#endif
+
 #ifndef HIPSYCL_ALLOW_INSTANT_SUBMISSION
 #define HIPSYCL_ALLOW_INSTANT_SUBMISSION 0
 #endif
@@ -106,6 +116,8 @@ class handler {
                                     std::shared_ptr<rt::buffer_data_region> mem,
                                     sycl::id<Dim> offset, sycl::range<Dim> range,
                                     bool is_no_init);
+  friend bool
+  detail::accessor::is_bound_to_host_device(const sycl::handler &cgh);
 
   template <class AccessorType, int Dim>
   void require(AccessorType& acc,
@@ -304,6 +316,22 @@ public:
     }
   }
 
+  /// Declares that the next operation of this command group accesses the
+  /// USM allocation that ptr points into. Has no effect unless the queue
+  /// was constructed with property::queue::AdaptiveCpp_usm_hazard_tracking.
+  void AdaptiveCpp_declare_usm_access(
+      const void *ptr, access_mode mode = access_mode::read_write) {
+    AdaptiveCpp_declare_usm_access(ptr, 0, mode);
+  }
+
+  /// Declares that the next operation of this command group accesses
+  /// num_bytes bytes starting at ptr.
+  void AdaptiveCpp_declare_usm_access(const void *ptr, std::size_t num_bytes,
+                                      access_mode mode) {
+    if(_usm_hazard_tracker && ptr)
+      _usm_accesses.push_back(rt::usm_access{ptr, num_bytes, mode});
+  }
+
 
   template <typename KernelName = __acpp_unnamed_kernel, typename KernelType>
   void single_task(KernelType kernelFunc)
@@ -558,6 +586,81 @@ public:
         detail::kernels::fill_kernel{dest, src});
   }
 
+  // ------ File I/O (AdaptiveCpp extension) ------
+
+  /// Reads the elements accessed by dest from the file at path, starting at
+  /// byte file_offset. The I/O is executed asynchronously and respects
+  /// dependencies like any other operation.
+  template <typename T, int dim, access::mode mode, access::target tgt,
+            accessor_variant variant>
+  void AdaptiveCpp_read_from_file(const std::string &path,
+                                  std::size_t file_offset,
+                                  accessor<T, dim, mode, tgt, variant> dest) {
+    validate_copy_dest_accessor(dest);
+
+    std::shared_ptr<rt::buffer_data_region> data_dest = get_memory_region(dest);
+
+    if (sizeof(T) != data_dest->get_element_size())
+      assert(false && "Accessors with different element size than original "
+                      "buffer are not yet supported");
+
+    // File I/O always operates on the host copy of the buffer
+    rt::memory_location dest_location{detail::get_host_device(),
+                                      rt::embed_in_id3(get_offset(dest)),
+                                      data_dest};
+    submit_file_io(rt::make_operation<rt::file_read_operation>(
+        path, file_offset, dest_location, rt::embed_in_range3(get_range(dest))));
+  }
+
+  /// Writes the elements accessed by src to the file at path, starting at
+  /// byte file_offset. The file is created if it does not exist.
+  template <typename T, int dim, access::mode mode, access::target tgt,
+            accessor_variant variant>
+  void AdaptiveCpp_write_to_file(accessor<T, dim, mode, tgt, variant> src,
+                                 const std::string &path,
+                                 std::size_t file_offset = 0) {
+    validate_copy_src_accessor(src);
+
+    std::shared_ptr<rt::buffer_data_region> data_src = get_memory_region(src);
+
+    if (sizeof(T) != data_src->get_element_size())
+      assert(false && "Accessors with different element size than original "
+                      "buffer are not yet supported");
+
+    rt::memory_location source_location{detail::get_host_device(),
+                                        rt::embed_in_id3(get_offset(src)),
+                                        data_src};
+    submit_file_io(rt::make_operation<rt::file_write_operation>(
+        source_location, rt::embed_in_range3(get_range(src)), path,
+        file_offset));
+  }
+
+  /// Reads num_bytes from the file at path into host-accessible USM memory.
+  void AdaptiveCpp_read_from_file(const std::string &path,
+                                  std::size_t file_offset, void *dest,
+                                  std::size_t num_bytes) {
+    AdaptiveCpp_declare_usm_access(dest, num_bytes, access_mode::write);
+    rt::memory_location dest_location{
+        detail::get_host_device(), extract_ptr(get_host_accessible_ptr(dest)),
+        rt::id<3>{}, rt::embed_in_range3(range<1>{num_bytes}), 1};
+    submit_file_io(rt::make_operation<rt::file_read_operation>(
+        path, file_offset, dest_location,
+        rt::embed_in_range3(range<1>{num_bytes})));
+  }
+
+  /// Writes num_bytes of host-accessible USM memory to the file at path.
+  void AdaptiveCpp_write_to_file(const void *src, std::size_t num_bytes,
+                                 const std::string &path,
+                                 std::size_t file_offset = 0) {
+    AdaptiveCpp_declare_usm_access(src, num_bytes, access_mode::read);
+    rt::memory_location source_location{
+        detail::get_host_device(), extract_ptr(get_host_accessible_ptr(src)),
+        rt::id<3>{}, rt::embed_in_range3(range<1>{num_bytes}), 1};
+    submit_file_io(rt::make_operation<rt::file_write_operation>(
+        source_location, rt::embed_in_range3(range<1>{num_bytes}), path,
+        file_offset));
+  }
+
   // ------ USM functions ------
 
   void memcpy(void *dest, const void *src, std::size_t num_bytes) {
@@ -601,6 +704,9 @@ public:
         dest_dev, extract_ptr(dest), rt::id<3>{},
         rt::embed_in_range3(range<1>{num_bytes}), 1};
     
+    AdaptiveCpp_declare_usm_access(src, num_bytes, access_mode::read);
+    AdaptiveCpp_declare_usm_access(dest, num_bytes, access_mode::write);
+
     auto op = rt::make_operation<rt::memcpy_operation>(
         source_location, dest_location, rt::embed_in_range3(range<1>{num_bytes}));
 
@@ -630,6 +736,8 @@ public:
                         "handler: USM fill() is unsupported for queues not "
                         "bound to devices"};
 
+      AdaptiveCpp_declare_usm_access(ptr, count * sizeof(T),
+                                     access_mode::write);
       this->submit_kernel<__acpp_unnamed_kernel,
                           rt::kernel_type::basic_parallel_for>(
           sycl::id<1>{}, sycl::range<1>{count},
@@ -645,6 +753,8 @@ public:
                       "handler: explicit memset() is unsupported for queues "
                       "not bound to devices"};
 
+    AdaptiveCpp_declare_usm_access(ptr, num_bytes, access_mode::write);
+
     auto op = rt::make_operation<rt::memset_operation>(
         ptr, static_cast<unsigned char>(value), num_bytes);
 
@@ -762,6 +872,27 @@ private:
         ->get_device_id();
   }
 
+  template<class T>
+  T* get_host_accessible_ptr(T* ptr) {
+    if(get_pointer_type(ptr, _ctx) == usm::alloc::device)
+      throw exception{make_error_code(errc::invalid),
+                      "handler: File I/O requires host-accessible memory, "
+                      "but pointer refers to a device allocation"};
+    return ptr;
+  }
+
+  void submit_file_io(std::unique_ptr<rt::operation> op) {
+    // File I/O is carried out on the host, independently of the queue's
+    // device. Binding the node to the host device also causes buffer
+    // accesses of this command group to be satisfied on the host.
+    rt::execution_hints hints = _execution_hints;
+    hints.set_hint(rt::hints::bind_to_device{detail::get_host_device()});
+
+    rt::dag_node_ptr node = create_task(std::move(op), hints);
+
+    _command_group_nodes.push_back(node);
+  }
+
   template <typename T, int dim, access::mode mode, access::target tgt,
             accessor_variant variant>
   void update_dev(rt::device_id dev, accessor<T, dim, mode, tgt, variant> acc) {
@@ -875,13 +1006,16 @@ private:
         },
         plan);
 
-    // (For non-inorder queue) main kernel needs dependency
-    // on most recent preceding reduction last event
-    if(_most_recent_reduction_kernel) {
-      if(auto node = _most_recent_reduction_kernel->lock()) {
-        _requirements.add_node_requirement(node);
-      }
-    }
+    engine.initialize_scratch(
+        [&](void *ptr, std::size_t num_bytes) {
+          auto op = rt::make_operation<rt::memset_operation>(
+              ptr, static_cast<unsigned char>(0), num_bytes);
+          rt::dag_node_ptr node = create_task_impl(
+              std::move(op), _execution_hints, rt::requirements_list{_rt});
+          _requirements.add_node_requirement(node);
+        },
+        plan);
+
     previous_event =
         this->submit_kernel_impl<__acpp_unnamed_kernel,
                                  rt::kernel_type::ndrange_parallel_for>(
@@ -890,6 +1024,11 @@ private:
 
     engine.run_additional_kernels(ndrange_launcher, plan);
 
+    // All kernels of this reduction are chained, so the scratch memory can
+    // be reused once the last one has completed. Reductions therefore do
+    // not need to depend on each other.
+    scratch_allocations.release_after(previous_event);
+
     return previous_event;
   }
 
@@ -903,8 +1042,34 @@ private:
                   "Overload resolution should never pick this overload without "
                   "reductions");
 
-    this->_operation_uses_reductions = true;
+    this->introspect_usm_accesses(f);
+    if(!_usm_hazard_tracker || _usm_accesses.empty()) {
+      submit_reduction_kernels<KernelName, KernelType>(
+          offset, global_range, local_range, f, reductions...);
+      return;
+    }
 
+    // The main kernel must depend on conflicting operations, but results
+    // are only complete once the last reduction kernel is. Track all
+    // kernels of the reduction as one operation.
+    std::vector<rt::usm_access> usm_accesses;
+    std::swap(usm_accesses, _usm_accesses);
+    _usm_hazard_tracker->track_operation(
+        usm_accesses, _requirements,
+        [&](const rt::requirements_list &hazard_requirements) {
+          _requirements = hazard_requirements;
+          submit_reduction_kernels<KernelName, KernelType>(
+              offset, global_range, local_range, f, reductions...);
+          return _command_group_nodes.back();
+        });
+  }
+
+  template <class KernelName, rt::kernel_type KernelType, class KernelFuncType,
+            int Dim, typename... Reductions>
+  void submit_reduction_kernels(sycl::id<Dim> offset,
+                                sycl::range<Dim> global_range,
+                                sycl::range<Dim> local_range, KernelFuncType f,
+                                Reductions... reductions) {
     if constexpr(KernelType == rt::kernel_type::ndrange_parallel_for) {
       _command_group_nodes.push_back(
           submit_ndrange_reduction_kernel<KernelName>(global_range, local_range,
@@ -979,6 +1144,7 @@ private:
   void submit_kernel(sycl::id<Dim> offset, sycl::range<Dim> global_range,
                      sycl::range<Dim> local_range, KernelFuncType f) {
 
+    this->introspect_usm_accesses(f);
     std::size_t local_mem_size = _local_mem_allocator.get_allocation_size();
     rt::dag_node_ptr node = submit_kernel_impl<KernelName, KernelType>(
         offset, global_range, local_range, f, local_mem_size, _requirements);
@@ -1122,13 +1288,39 @@ private:
   handler(const context &ctx, async_handler handler,
           const rt::execution_hints &hints, rt::runtime* rt,
           algorithms::util::allocation_cache* cache,
-          std::weak_ptr<rt::dag_node>* most_recent_reduction_kernel)
+          rt::usm_hazard_tracker* hazard_tracker = nullptr,
+          bool introspect_usm_accesses = false)
       : _ctx{ctx}, _handler{handler}, _execution_hints{hints},
         _preferred_group_size1d{}, _preferred_group_size2d{},
         _preferred_group_size3d{}, _rt{rt}, _requirements{rt},
         _kernel_cache{rt::kernel_cache::get()},
         _allocation_cache{cache},
-        _most_recent_reduction_kernel{most_recent_reduction_kernel}{}
+        _usm_hazard_tracker{hazard_tracker},
+        _introspect_usm_accesses{introspect_usm_accesses} {}
+
+  template<class KernelFuncType>
+  void introspect_usm_accesses(const KernelFuncType& f) {
+#ifdef HIPSYCL_HAS_KERNEL_ARGUMENT_INTROSPECTION
+    if(!_usm_hazard_tracker || !_introspect_usm_accesses)
+      return;
+    // We cannot know whether the kernel reads or writes the memory
+    // behind a captured pointer, so assume both.
+    glue::reflection::introspect_flattened_struct introspection{f};
+    for(int i = 0; i < introspection.get_num_members(); ++i) {
+      if (introspection.get_member_kind(i) ==
+          glue::reflection::type_kind::pointer) {
+        void* ptr = nullptr;
+        std::memcpy(&ptr,
+                    reinterpret_cast<const char *>(&f) +
+                        introspection.get_member_offset(i),
+                    sizeof(void *));
+        if(ptr)
+          _usm_accesses.push_back(
+              rt::usm_access{ptr, 0, access_mode::read_write, true});
+      }
+    }
+#endif
+  }
 
   template<int Dim>
   range<Dim>& get_preferred_group_size() {
@@ -1161,6 +1353,23 @@ private:
   rt::dag_node_ptr create_task(std::unique_ptr<rt::operation> op,
                                rt::execution_hints &hints,
                                const rt::requirements_list& requirements) {
+    if(!_usm_hazard_tracker || _usm_accesses.empty())
+      return create_task_impl(std::move(op), hints, requirements);
+
+    rt::dag_node_ptr node = _usm_hazard_tracker->track_operation(
+        _usm_accesses, requirements,
+        [&](const rt::requirements_list &hazard_requirements) {
+          return create_task_impl(std::move(op), hints, hazard_requirements);
+        });
+    // Declarations only apply to the next operation
+    _usm_accesses.clear();
+
+    return node;
+  }
+
+  rt::dag_node_ptr create_task_impl(std::unique_ptr<rt::operation> op,
+                                    rt::execution_hints &hints,
+                                    const rt::requirements_list& requirements) {
 
     bool uses_buffers = false;
     bool has_non_instant_dependency = false;
@@ -1185,8 +1394,8 @@ private:
 
     if (!HIPSYCL_ALLOW_INSTANT_SUBMISSION || uses_buffers ||
         has_non_instant_dependency || is_unbound ||
-        !is_dedicated_in_order_queue || _operation_uses_reductions ||
-        op->is_requirement()) {
+        !is_dedicated_in_order_queue || op->is_requirement() ||
+        op->is_file_io()) {
       // traditional submission
       rt::dag_build_guard build{_rt->dag()};
       return build.builder()->add_command_group(std::move(op), requirements, hints);
@@ -1225,12 +1434,13 @@ private:
 
   rt::runtime* _rt;
 
-  bool _operation_uses_reductions = false;
-
   std::shared_ptr<rt::kernel_cache> _kernel_cache;
   algorithms::util::allocation_cache* _allocation_cache;
 
-  std::weak_ptr<rt::dag_node>* _most_recent_reduction_kernel;
+
+  rt::usm_hazard_tracker* _usm_hazard_tracker;
+  bool _introspect_usm_accesses;
+  std::vector<rt::usm_access> _usm_accesses;
 };
 
 namespace detail::handler {
@@ -1260,6 +1470,12 @@ void bind_to_handler(AccessorType& acc, sycl::handler& cgh,
   cgh.require(acc, detail::accessor_data<Dim>{mem, offset, range, is_no_init});
 }
 
+inline bool is_bound_to_host_device(const sycl::handler &cgh) {
+  const auto *dev =
+      cgh._execution_hints.get_hint<rt::hints::bind_to_device>();
+  return dev && dev->get_device_id().is_host();
+}
+
 }
 
 } // namespace sycl
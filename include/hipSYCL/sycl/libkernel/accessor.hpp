@@ -124,6 +124,13 @@ template <class T, int dimensions, class AllocatorT>
 sycl::range<dimensions>
 extract_buffer_range(const buffer<T, dimensions, AllocatorT> &buff);
 
+template <class BufferT>
+void validate_buffer_access(const BufferT &buff, access_mode mode);
+
+template <class BufferT, int AccessDim>
+void advise_buffer_access(const BufferT &buff, sycl::id<AccessDim> offset,
+                          sycl::range<AccessDim> access_range);
+
 template <typename T, int Dimensions,
           typename Accessor>
 class accessor_iterator {
@@ -426,6 +433,8 @@ void bind_to_handler(AccessorType &acc, sycl::handler &cgh,
                      sycl::id<Dim> offset, sycl::range<Dim> range,
                      bool is_no_init);
 
+inline bool is_bound_to_host_device(const sycl::handler &cgh);
+
 
 template<class AccessorType>
 glue::unique_id get_unique_id(const AccessorType& acc);
@@ -1298,6 +1307,16 @@ private:
     detail::accessor::bind_to_handler(*this, cgh,
                                       detail::extract_buffer_data_region(buff),
                                       offset, access_range, is_no_init_access);
+
+    // Kernels on the host device (e.g. the OMP backend) read the host
+    // allocation directly, so their accesses benefit from the hint as well.
+    if constexpr (accessTarget != access::target::host_buffer &&
+                  accessTarget != access::target::host_task) {
+      __acpp_if_target_host(
+        if (detail::accessor::is_bound_to_host_device(cgh))
+          detail::advise_buffer_access(buff, offset, access_range);
+      );
+    }
   }
 
   template <class BufferT>
@@ -1349,6 +1368,12 @@ private:
       this->detail::accessor::
           conditional_buffer_pointer_storage<has_buffer_pointer>::attempt_set(
               detail::mobile_shared_ptr{buffer_region});
+      detail::validate_buffer_access(buff, accessmode);
+      // Host accessors access the host allocation directly. Accessors
+      // of kernels running on the host device are handled in init().
+      if constexpr (accessTarget == access::target::host_buffer ||
+                    accessTarget == access::target::host_task)
+        detail::advise_buffer_access(buff, accessOffset, accessRange);
     );
 
     this->detail::accessor::conditional_access_range_storage<
@@ -1371,35 +1396,52 @@ private:
     auto data = data_mobile_ptr.get_shared_ptr();
     assert(data);
 
+    // get_offset and get_range are only defined for dimensions > 0
+    id<adj_dimensions> acc_offset;
+    if constexpr (dimensions == 0)
+      acc_offset = id<1>{0};
+    else
+      acc_offset = get_offset();
+
+    range<adj_dimensions> acc_range;
+    if constexpr (dimensions == 0)
+      acc_range = range<1>{1};
+    else
+      acc_range = get_range();
+
+    const rt::range<adj_dimensions> buffer_shape = rt::make_range(get_buffer_shape());
+    const rt::id<3> effective_offset =
+        detail::get_effective_offset<dataT, adj_dimensions>(
+            data, rt::make_id(acc_offset), buffer_shape, has_access_range);
+    const rt::range<3> effective_range =
+        detail::get_effective_range<dataT, adj_dimensions>(
+            data, rt::make_range(acc_range), buffer_shape, has_access_range);
+    const access_mode effective_mode =
+        detail::get_effective_access_mode(accessmode, is_no_init);
+
+    std::vector<rt::dag_node_ptr> pending_host_users;
+    {
+      // Other threads may submit operations using the same data region
+      // concurrently, so the up-to-date check and marking the range as
+      // current must happen atomically with respect to DAG building.
+      rt::dag_build_guard build{rt->dag()};
+      if (build.builder()->invoke_locked([&]() {
+            return try_init_host_buffer_without_dag(
+                data, effective_offset, effective_range, effective_mode,
+                pending_host_users);
+          }))
+        return;
+    }
+
     rt::dag_node_ptr node;
     {
       rt::dag_build_guard build{rt->dag()};
 
-      // get_offset and get_range are only defined for dimensions > 0
-      id<adj_dimensions> acc_offset;
-      if constexpr (dimensions == 0)
-        acc_offset = id<1>{0};
-      else
-        acc_offset = get_offset();
-
-      range<adj_dimensions> acc_range;
-      if constexpr (dimensions == 0)
-        acc_range = range<1>{1};
-      else
-        acc_range = get_range();
-      
-      const rt::range<adj_dimensions> buffer_shape = rt::make_range(get_buffer_shape());
       auto explicit_requirement = rt::make_operation<rt::buffer_memory_requirement>(
         data,
-        detail::get_effective_offset<dataT, adj_dimensions>(data,
-                                                           rt::make_id(acc_offset),
-                                                           buffer_shape,
-                                                           has_access_range),
-        detail::get_effective_range<dataT, adj_dimensions>(data,
-                                                          rt::make_range(acc_range),
-                                                          buffer_shape,
-                                                          has_access_range),
-        detail::get_effective_access_mode(accessmode, is_no_init),
+        effective_offset,
+        effective_range,
+        effective_mode,
         accessTarget
       );
 
@@ -1410,9 +1452,15 @@ private:
       enforce_bind_to_host.set_hint(
           rt::hints::bind_to_device{detail::get_host_device()});
 
+      // Read accesses do not depend on each other in the DAG, so we
+      // need to explicitly wait for pending host users that might
+      // still be transferring data to the host.
+      rt::requirements_list reqs{rt};
+      for(const auto& user : pending_host_users)
+        reqs.add_node_requirement(user);
+
       node = build.builder()->add_explicit_mem_requirement(
-          std::move(explicit_requirement), rt::requirements_list{rt},
-          enforce_bind_to_host);
+          std::move(explicit_requirement), reqs, enforce_bind_to_host);
       
       HIPSYCL_DEBUG_INFO << "accessor [host]: forcing DAG flush for host access..." << std::endl;
       rt->dag().flush_sync();
@@ -1448,6 +1496,81 @@ private:
     // TODO Need to lock execution of DAG
   }
 
+  // Host accesses are frequently created for data that is already current
+  // on the host, in particular on the OpenMP backend. In this case, we can
+  // initialize the accessor directly instead of submitting a requirement to the
+  // DAG, flushing it and waiting for its completion. This is only possible if
+  // no operation accessing the range is still pending on the host.
+  //
+  // Note that the data region is marked valid on the host as soon as a
+  // transfer to the host is scheduled, not once it has completed. Pending
+  // host users that overlap the accessed range are therefore returned in
+  // pending_host_users, even for read-read access, so that the DAG path can
+  // wait for them.
+  // Must be invoked while holding the lock of the dag_builder.
+  bool try_init_host_buffer_without_dag(
+      const std::shared_ptr<rt::buffer_data_region> &data, rt::id<3> offset,
+      rt::range<3> range, access_mode mode,
+      std::vector<rt::dag_node_ptr>& pending_host_users) {
+    const rt::device_id host_device = detail::get_host_device();
+
+    auto page_range = data->get_page_range(offset, range);
+    bool has_pending_conflict = false;
+    data->get_users().for_each_user([&](rt::data_user &user) {
+      auto user_page_range = data->get_page_range(user.offset, user.range);
+      for(int i = 0; i < 3; ++i) {
+        if(page_range.first[i] >= user_page_range.first[i] +
+                                      user_page_range.second[i] ||
+           user_page_range.first[i] >= page_range.first[i] +
+                                           page_range.second[i])
+          return;
+      }
+
+      auto user_node = user.user.lock();
+      if(!user_node || user_node->is_complete())
+        return;
+
+      // Nodes that have not been submitted yet have not been assigned
+      // to a device, so they might still end up on the host.
+      // Explicit host requirements are temporarily assigned to the device
+      // carrying out the transfer during submission, so check the access
+      // target as well.
+      const bool targets_host = user.target == access::target::host_buffer ||
+                                user.target == access::target::host_task ||
+                                !user_node->is_submitted() ||
+                                user_node->get_assigned_device() == host_device;
+      if(targets_host)
+        pending_host_users.push_back(user_node);
+      if(targets_host || mode != access_mode::read ||
+         user.mode != access_mode::read)
+        has_pending_conflict = true;
+    });
+    if(has_pending_conflict)
+      return false;
+
+    if(!data->has_allocation(host_device))
+      return false;
+    // Make sure pending errors are reported by the regular path
+    if(rt::application::errors().num_errors() != 0)
+      return false;
+
+    const bool is_discard = mode == access_mode::discard_write ||
+                            mode == access_mode::discard_read_write;
+    // The scheduler may concurrently update the data state for overlapping
+    // read accesses on other devices, so checking and marking the range
+    // must happen in one step under the lock of the data region.
+    if(!data->try_mark_range_accessed(host_device, offset, range, !is_discard,
+                                      mode != access_mode::read))
+      return false;
+
+    HIPSYCL_DEBUG_INFO << "accessor [host]: Data is current on host, skipping "
+                          "DAG submission for host access"
+                       << std::endl;
+
+    this->_ptr.explicit_init(data->get_memory(host_device));
+    return true;
+  }
+
   constexpr bool is_no_init_accessmode() const {
     if constexpr (accessmode == access_mode::discard_write ||
                   accessmode == access_mode::discard_read_write) {
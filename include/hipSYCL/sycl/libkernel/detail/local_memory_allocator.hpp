@@ -103,7 +103,7 @@ private:
   size_t _num_allocated_bytes;
 };
 
-enum class host_local_memory_origin { hipcpu, custom_threadprivate };
+enum class host_local_memory_origin { hipcpu, custom_threadprivate, external };
 
 
 /// Manages local memory on host device.
@@ -127,6 +127,17 @@ public:
     alloc_threadprivate(num_bytes);
   }
 
+  /// Uses memory that is owned by the caller (e.g. a local memory arena)
+  /// as local memory of the calling thread. Like for case 2), the
+  /// request/release pair must be called inside the #pragma omp parallel block.
+  static void request_external(char* ptr)
+  {
+    release_memory();
+
+    _origin = host_local_memory_origin::external;
+    _local_mem = ptr;
+  }
+
   static void release()
   {
     release_memory();
@@ -141,7 +152,7 @@ private:
 
   static void release_memory() {
     if (_local_mem != nullptr && _local_mem != &(_static_local_mem[0]) &&
-        _origin != host_local_memory_origin::hipcpu)
+        _origin == host_local_memory_origin::custom_threadprivate)
       delete[] _local_mem;
 
     _local_mem = nullptr;
@@ -1285,7 +1285,9 @@ group_barrier(const detail::sp_group<PropertyDescriptor> &g,
     }
     __syncthreads();
   );
-  __acpp_if_target_sscp(/* todo */);
+  __acpp_if_target_sscp(
+    __acpp_sscp_work_group_barrier(fence_scope, memory_order::seq_cst);
+  );
   __acpp_if_target_host(/* todo */);
 }
 
@@ -1305,7 +1307,9 @@ group_barrier(const detail::sp_sub_group<PropertyDescriptor> &g,
   __acpp_if_target_cuda(
     __syncwarp();
   );
-  __acpp_if_target_sscp(/* todo */);
+  __acpp_if_target_sscp(
+    __acpp_sscp_sub_group_barrier(fence_scope, memory_order::seq_cst);
+  );
   __acpp_if_target_host(/* todo */);
 }
 
@@ -0,0 +1,74 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HIPSYCL_SYCL_PERF_COUNTERS_HPP
+#define HIPSYCL_SYCL_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../runtime/perf_counters.hpp"
+
+namespace hipsycl {
+namespace sycl {
+
+struct perf_counter {
+  std::string name;
+  std::string description;
+  // If true, value is the largest value observed instead of a total
+  bool is_high_water_mark;
+  std::uint64_t value;
+};
+
+/// Returns a snapshot of all runtime performance counters
+inline std::vector<perf_counter> get_perf_counters() {
+  std::vector<perf_counter> result;
+  for(const auto &v : rt::perf_counter_registry::get().read_all())
+    result.push_back(perf_counter{
+        v.name, v.description,
+        v.kind == rt::perf_counter_kind::high_water_mark, v.value});
+  return result;
+}
+
+/// Returns the current value of the counter with the given name,
+/// or 0 if no such counter exists.
+inline std::uint64_t get_perf_counter(const std::string& name) {
+  for(const auto &v : rt::perf_counter_registry::get().read_all())
+    if(v.name == name)
+      return v.value;
+  return 0;
+}
+
+inline void reset_perf_counters() {
+  rt::perf_counter_registry::get().reset_all();
+}
+
+}
+}
+
+#endif
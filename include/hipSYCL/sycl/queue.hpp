@@ -73,6 +73,10 @@ using queue_submission_hooks_ptr =
 
 }
 
+/// Order in which host backends iterate over 2D and 3D ranges of
+/// basic parallel_for kernels, see ACPP_EXT_HOST_ITERATION_ORDER
+using host_iteration_order = rt::host_iteration_order;
+
 namespace property::command_group {
 
 template<int Dim>
@@ -99,6 +103,15 @@ struct AdaptiveCpp_prefer_execution_lane : public detail::cg_property{
 
 struct AdaptiveCpp_coarse_grained_events : public detail::cg_property {};
 
+struct AdaptiveCpp_host_iteration_order : public detail::cg_property {
+  AdaptiveCpp_host_iteration_order(host_iteration_order o,
+                                   std::size_t tile_edge_length = 0)
+  : order{o}, tile_edge{tile_edge_length} {}
+
+  const host_iteration_order order;
+  const std::size_t tile_edge;
+};
+
 // backwards compatibility
 template<int Dim>
 using hipSYCL_prefer_group_size = AdaptiveCpp_prefer_group_size<Dim>;
@@ -127,6 +140,13 @@ struct AdaptiveCpp_priority : public detail::queue_property {
   int priority;
 };
 
+struct AdaptiveCpp_usm_hazard_tracking : public detail::queue_property {
+  AdaptiveCpp_usm_hazard_tracking(bool introspect_kernel_arguments = true)
+  : introspect_kernels{introspect_kernel_arguments} {}
+
+  bool introspect_kernels;
+};
+
 // backwards compatibility
 using hipSYCL_coarse_grained_events = AdaptiveCpp_coarse_grained_events;
 using hipSYCL_priority = AdaptiveCpp_priority;
@@ -389,6 +409,13 @@ public:
             property::command_group::AdaptiveCpp_coarse_grained_events>()) {
       hints.set_hint(rt::hints::coarse_grained_synchronization{});
     }
+    if (prop_list.has_property<
+            property::command_group::AdaptiveCpp_host_iteration_order>()) {
+      const auto &prop = prop_list.get_property<
+          property::command_group::AdaptiveCpp_host_iteration_order>();
+      hints.set_hint(
+          rt::hints::prefer_host_iteration_order{prop.order, prop.tile_edge});
+    }
     // Should always have node_group hint from default hints
     assert(hints.has_hint<rt::hints::node_group>());
 
@@ -397,7 +424,8 @@ public:
                 hints,
                 _requires_runtime.get(),
                 _allocation_cache.get(),
-                _most_recent_reduction_kernel.get()};
+                _usm_hazard_tracker.get(),
+                _introspect_usm_accesses};
 
     apply_preferred_group_size<1>(prop_list, cgh);
     apply_preferred_group_size<2>(prop_list, cgh);
@@ -804,6 +832,42 @@ public:
     });
   }
 
+  event AdaptiveCpp_read_from_file(const std::string &path,
+                                   std::size_t file_offset, void *dest,
+                                   std::size_t num_bytes) {
+    return this->submit([&](sycl::handler &cgh) {
+      cgh.AdaptiveCpp_read_from_file(path, file_offset, dest, num_bytes);
+    });
+  }
+
+  event AdaptiveCpp_read_from_file(const std::string &path,
+                                   std::size_t file_offset, void *dest,
+                                   std::size_t num_bytes,
+                                   const std::vector<event> &dependencies) {
+    return this->submit([&](sycl::handler &cgh) {
+      cgh.depends_on(dependencies);
+      cgh.AdaptiveCpp_read_from_file(path, file_offset, dest, num_bytes);
+    });
+  }
+
+  event AdaptiveCpp_write_to_file(const void *src, std::size_t num_bytes,
+                                  const std::string &path,
+                                  std::size_t file_offset = 0) {
+    return this->submit([&](sycl::handler &cgh) {
+      cgh.AdaptiveCpp_write_to_file(src, num_bytes, path, file_offset);
+    });
+  }
+
+  event AdaptiveCpp_write_to_file(const void *src, std::size_t num_bytes,
+                                  const std::string &path,
+                                  std::size_t file_offset,
+                                  const std::vector<event> &dependencies) {
+    return this->submit([&](sycl::handler &cgh) {
+      cgh.depends_on(dependencies);
+      cgh.AdaptiveCpp_write_to_file(src, num_bytes, path, file_offset);
+    });
+  }
+
   event mem_advise(const void *addr, std::size_t num_bytes, int advice) {
     return this->submit([&](sycl::handler &cgh) {
       cgh.mem_advise(addr, num_bytes, advice);
@@ -1062,8 +1126,16 @@ private:
     _previous_submission = std::make_shared<rt::dag_node_ptr>(nullptr);
     _allocation_cache = std::make_shared<algorithms::util::allocation_cache>(
         algorithms::util::allocation_type::device);
-    _most_recent_reduction_kernel =
-        std::make_shared<std::weak_ptr<rt::dag_node>>();
+
+    // In-order queues already serialize all operations
+    if (!_is_in_order &&
+        this->has_property<property::queue::AdaptiveCpp_usm_hazard_tracking>()) {
+      _usm_hazard_tracker = std::make_shared<rt::usm_hazard_tracker>();
+      rt::usm_allocation_registry::get().enable();
+      _introspect_usm_accesses =
+          this->get_property<property::queue::AdaptiveCpp_usm_hazard_tracking>()
+              .introspect_kernels;
+    }
 
     if(_is_in_order && get_devices().size() == 1) {
       int priority = 0;
@@ -1113,7 +1185,10 @@ private:
   // These fields are exclusively hauled around for SYCL 2020 reductions
   // due to the incredible ingenuity of this API...
   std::shared_ptr<algorithms::util::allocation_cache> _allocation_cache;
-  std::shared_ptr<std::weak_ptr<rt::dag_node>> _most_recent_reduction_kernel;
+
+  // Only set if ACPP_EXT_USM_HAZARD_TRACKING is enabled for this queue
+  std::shared_ptr<rt::usm_hazard_tracker> _usm_hazard_tracker;
+  bool _introspect_usm_accesses = false;
 };
 
 HIPSYCL_SPECIALIZE_GET_INFO(queue, context)
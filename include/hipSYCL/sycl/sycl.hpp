@@ -92,6 +92,7 @@
 #include "kernel.hpp"
 #include "buffer.hpp"
 #include "usm.hpp"
+#include "perf_counters.hpp"
 #include "backend.hpp"
 #include "backend_interop.hpp"
 #include "interop_handle.hpp"
@@ -43,16 +43,28 @@
 #include "../runtime/application.hpp"
 #include "../runtime/backend.hpp"
 #include "../runtime/allocator.hpp"
+#include "../runtime/usm_pool.hpp"
+#include "../runtime/usm_hazard_tracker.hpp"
 
 namespace hipsycl {
 namespace sycl {
 
+namespace detail {
+
+// Records allocation extents for ACPP_EXT_USM_HAZARD_TRACKING
+inline void *register_usm_allocation(void *ptr, std::size_t num_bytes) {
+  rt::usm_allocation_registry::get().register_allocation(ptr, num_bytes);
+  return ptr;
+}
+
+}
 
 // Explicit USM
 
 inline void *malloc_device(size_t num_bytes, const device &dev,
                            const context &ctx) {
-  return detail::select_device_allocator(dev)->allocate(0, num_bytes);
+  return detail::register_usm_allocation(
+      detail::select_device_allocator(dev)->allocate(0, num_bytes), num_bytes);
 }
 
 template <typename T>
@@ -72,7 +84,9 @@ T* malloc_device(std::size_t count, const queue &q) {
 
 inline void *aligned_alloc_device(std::size_t alignment, std::size_t num_bytes,
                                   const device &dev, const context &ctx) {
-  return detail::select_device_allocator(dev)->allocate(alignment, num_bytes);
+  return detail::register_usm_allocation(
+      detail::select_device_allocator(dev)->allocate(alignment, num_bytes),
+      num_bytes);
 }
 
 template <typename T>
@@ -96,7 +110,9 @@ T *aligned_alloc_device(std::size_t alignment, std::size_t count,
 // Restricted USM
 
 inline void *malloc_host(std::size_t num_bytes, const context &ctx) {
-  return detail::select_usm_allocator(ctx)->allocate_optimized_host(0, num_bytes);
+  return detail::register_usm_allocation(
+      detail::select_usm_allocator(ctx)->allocate_optimized_host(0, num_bytes),
+      num_bytes);
 }
 
 template <typename T> T *malloc_host(std::size_t count, const context &ctx) {
@@ -113,7 +129,9 @@ template <typename T> T *malloc_host(std::size_t count, const queue &q) {
 
 inline void *malloc_shared(std::size_t num_bytes, const device &dev,
                            const context &ctx) {
-  return detail::select_usm_allocator(ctx, dev)->allocate_usm(num_bytes);
+  return detail::register_usm_allocation(
+      detail::select_usm_allocator(ctx, dev)->allocate_usm(num_bytes),
+      num_bytes);
 }
 
 template <typename T>
@@ -131,8 +149,10 @@ template <typename T> T *malloc_shared(std::size_t count, const queue &q) {
 
 inline void *aligned_alloc_host(std::size_t alignment, std::size_t num_bytes,
                                 const context &ctx) {
-  return detail::select_usm_allocator(ctx)->allocate_optimized_host(alignment,
-                                                                    num_bytes);
+  return detail::register_usm_allocation(
+      detail::select_usm_allocator(ctx)->allocate_optimized_host(alignment,
+                                                                 num_bytes),
+      num_bytes);
 }
 
 template <typename T>
@@ -154,7 +174,9 @@ T *aligned_alloc_host(std::size_t alignment, std::size_t count,
 
 inline void *aligned_alloc_shared(std::size_t alignment, std::size_t num_bytes,
                                   const device &dev, const context &ctx) {
-  return detail::select_usm_allocator(ctx, dev)->allocate_usm(num_bytes);
+  return detail::register_usm_allocation(
+      detail::select_usm_allocator(ctx, dev)->allocate_usm(num_bytes),
+      num_bytes);
 }
 
 template <typename T>
@@ -241,6 +263,7 @@ T *aligned_alloc(std::size_t alignment, std::size_t count, const sycl::queue &q,
 }
 
 inline void free(void *ptr, const sycl::context &ctx) {
+  rt::usm_allocation_registry::get().unregister_allocation(ptr);
   return detail::select_usm_allocator(ctx)->free(ptr);
 }
 
@@ -248,6 +271,105 @@ inline void free(void *ptr, const sycl::queue &q) {
   free(ptr, q.get_context());
 }
 
+// AdaptiveCpp stream-ordered USM allocation extension
+
+namespace detail {
+
+inline rt::usm_pool *select_usm_pool(const device &dev, const context &ctx,
+                                     usm::alloc kind) {
+  rt::backend_allocator *allocator = nullptr;
+  rt::usm_pool_memory_kind pool_kind;
+  if(kind == usm::alloc::device) {
+    allocator = select_device_allocator(dev);
+    pool_kind = rt::usm_pool_memory_kind::device;
+  } else if(kind == usm::alloc::shared) {
+    allocator = select_usm_allocator(ctx, dev);
+    pool_kind = rt::usm_pool_memory_kind::shared;
+  } else if(kind == usm::alloc::host) {
+    allocator = select_usm_allocator(ctx);
+    pool_kind = rt::usm_pool_memory_kind::host;
+  } else {
+    throw exception{make_error_code(errc::invalid),
+                    "USM pool: Invalid allocation kind"};
+  }
+
+  return ctx.AdaptiveCpp_runtime()->usm_pools().get_pool(
+      allocator, extract_rt_device(dev), pool_kind,
+      ctx.AdaptiveCpp_hash_code());
+}
+
+inline std::size_t get_usm_pool_stream(const queue& q) {
+  // The hash code of a queue is its node group id, which is unique
+  // for each queue of the process.
+  return q.is_in_order() ? q.AdaptiveCpp_hash_code() : rt::usm_pool::no_stream;
+}
+
+}
+
+using usm_pool_statistics = rt::usm_pool_statistics;
+
+/// Allocates memory from the USM pool of the queue's device. Memory
+/// previously released with free_async() is reused once all operations
+/// that were submitted to the freeing queue before the free_async() call
+/// have completed. On in-order queues, memory freed on the same queue
+/// is reused immediately.
+inline void *malloc_async(std::size_t num_bytes, const queue &q,
+                          usm::alloc kind = usm::alloc::device) {
+  return detail::register_usm_allocation(
+      detail::select_usm_pool(q.get_device(), q.get_context(), kind)
+          ->allocate(num_bytes, detail::get_usm_pool_stream(q)),
+      num_bytes);
+}
+
+template <typename T>
+T *malloc_async(std::size_t count, const queue &q,
+                usm::alloc kind = usm::alloc::device) {
+  return static_cast<T *>(malloc_async(count * sizeof(T), q, kind));
+}
+
+/// Returns memory to the USM pool without waiting for the queue. The memory
+/// is only reused once the operations currently submitted to q have
+/// completed. Pointers not allocated by malloc_async() are freed after
+/// waiting for these operations.
+inline void free_async(void *ptr, const queue &q) {
+  if(!ptr)
+    return;
+
+  std::vector<event> wait_list = q.get_wait_list();
+
+  rt::usm_pool *pool =
+      q.get_context().AdaptiveCpp_runtime()->usm_pools().find_owning_pool(ptr);
+  if(pool) {
+    std::vector<rt::dag_node_ptr> dependencies;
+    for(const event& evt : wait_list)
+      if(auto node = detail::extract_rt_node(evt))
+        dependencies.push_back(node);
+    rt::usm_allocation_registry::get().unregister_allocation(ptr);
+    pool->free(ptr, dependencies, detail::get_usm_pool_stream(q));
+  } else {
+    event::wait(wait_list);
+    free(ptr, q);
+  }
+}
+
+inline usm_pool_statistics
+get_usm_pool_statistics(const queue &q, usm::alloc kind = usm::alloc::device) {
+  return detail::select_usm_pool(q.get_device(), q.get_context(), kind)
+      ->get_statistics();
+}
+
+/// Returns cached memory of all USM pools of the queue's device to the
+/// backend. Memory that might still be in use by outstanding operations
+/// remains in the pool. Returns the number of released bytes.
+inline std::size_t trim_usm_pool(const queue &q) {
+  std::size_t released_bytes = 0;
+  for (rt::usm_pool *pool :
+       q.get_context().AdaptiveCpp_runtime()->usm_pools().get_pools(
+           detail::extract_rt_device(q.get_device())))
+    released_bytes += pool->trim();
+  return released_bytes;
+}
+
 // hipSYCL synchronous mem_advise extension
 inline void mem_advise(const void *ptr, std::size_t num_bytes, int advise,
                        const context &ctx, const device &dev) {
@@ -160,9 +160,37 @@ extern "C" LLVM_ATTRIBUTE_WEAK ::llvm::PassPluginLibraryInfo llvmGetPassPluginIn
             PB.registerOptimizerLastEPCallback([&](llvm::ModulePassManager &MPM, OptLevel Level) {
               MPM.addPass(SyncElisionInliningPass{});
               MPM.addPass(llvm::AlwaysInlinerPass{});
+              MPM.addPass(SyncElisionSummaryPass{});
               MPM.addPass(SyncElisionPass{});
             });
           }
+          // Allows running the synchronization elision passes in isolation using
+          // opt -load-pass-plugin, e.g. to test them on IR.
+          PB.registerPipelineParsingCallback(
+              [](llvm::StringRef Name, llvm::ModulePassManager &MPM,
+                 llvm::ArrayRef<llvm::PassBuilder::PipelineElement>) {
+                if(Name == "acpp-stdpar-sync-elision-summary") {
+                  MPM.addPass(SyncElisionSummaryPass{});
+                  return true;
+                } else if(Name == "acpp-stdpar-sync-elision") {
+                  MPM.addPass(SyncElisionPass{});
+                  return true;
+                } else if(Name == "acpp-stdpar-sync-elision-lto") {
+                  MPM.addPass(SyncElisionLTOPass{});
+                  return true;
+                }
+                return false;
+              });
+#if LLVM_VERSION_MAJOR >= 16
+          // During LTO, the -hipsycl-stdpar flag is typically not available. This is not a
+          // problem since SyncElisionLTOPass only acts on synchronization that was previously
+          // inserted by SyncElisionPass.
+          PB.registerFullLinkTimeOptimizationLastEPCallback(
+              [&](llvm::ModulePassManager &MPM, OptLevel Level) {
+                MPM.addPass(SyncElisionSummaryPass{});
+                MPM.addPass(SyncElisionLTOPass{});
+              });
+#endif
 #endif
 
 #ifdef HIPSYCL_WITH_SSCP_COMPILER
@@ -113,6 +113,10 @@ static llvm::cl::opt<bool> SSCPEmitHcf{
     "hipsycl-sscp-emit-hcf", llvm::cl::init(false),
     llvm::cl::desc{"Emit HCF from hipSYCL LLVM SSCP compilation flow"}};
 
+static llvm::cl::opt<bool> SSCPCompressHcf{
+    "hipsycl-sscp-compress-hcf", llvm::cl::init(false),
+    llvm::cl::desc{"Compress device IR embedded in HCF from hipSYCL LLVM SSCP compilation flow"}};
+
 static llvm::cl::opt<bool> PreoptimizeSSCPKernels{
     "hipsycl-sscp-preoptimize", llvm::cl::init(false),
     llvm::cl::desc{
@@ -352,7 +356,7 @@ generateHCF(llvm::Module &DeviceModule, std::size_t HcfObjectId,
   auto* LLVMIRNode = DeviceImagesNodes->add_subnode("llvm-ir.global");
   LLVMIRNode->set("variant", "global-module");
   LLVMIRNode->set("format", "llvm-ir");
-  HcfObject.attach_binary_content(LLVMIRNode, ModuleContent);
+  HcfObject.attach_binary_content(LLVMIRNode, ModuleContent, SSCPCompressHcf);
 
   for(const auto& ES : ExportedSymbols) {
     HIPSYCL_DEBUG_INFO << "HCF generation: Image exports symbol: " << ES << "\n";
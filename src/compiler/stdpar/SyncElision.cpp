@@ -32,6 +32,7 @@
 
 
 #include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/Analysis/ValueTracking.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Attributes.h>
 #include <llvm/Support/Casting.h>
@@ -40,6 +41,7 @@
 #include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/PassManager.h>
 
 
@@ -149,6 +151,9 @@ bool instructionAccessesMemory(llvm::Instruction* I) {
   return false;
 }
 
+constexpr const char* NoSyncSummaryAttribute = "hipsycl-stdpar-no-sync";
+constexpr const char* SyncBeforeCallMDKind = "hipsycl.stdpar.sync_before_call";
+
 bool functionDoesNotAccessMemory(llvm::Function* F){
   if(!F)
     return true;
@@ -157,9 +162,13 @@ bool functionDoesNotAccessMemory(llvm::Function* F){
       return true;
     }
   }
-  // We could improve this logic massively: E.g. a function which does not have ptr arguments,
-  // does not have gobal variable users, contains no inttoptr instructions, and only calls functions
-  // which satisfy these criteria could be assumed to not access memory.
+  // Summaries are attached by SyncElisionSummaryPass, potentially when compiling
+  // a different TU. They are only visible here if the definition is available,
+  // e.g. in the same TU or during LTO.
+  if(F->hasFnAttribute(NoSyncSummaryAttribute))
+    return true;
+  if(F->doesNotAccessMemory())
+    return true;
   return false;
 }
 
@@ -221,7 +230,7 @@ void forEachReachableInstructionRequiringSync(
   while(Current) {
     if(auto* CB = llvm::dyn_cast<llvm::CallBase>(Current)) {
       llvm::Function* CalledF = CB->getCalledFunction();
-      if(CalledF->getName().equals(BarrierBuiltinName)) {
+      if(CalledF && CalledF->getName().equals(BarrierBuiltinName)) {
         // basic block already contains barrier; nothing to do
         return;
       }
@@ -293,6 +302,105 @@ void forEachReachableInstructionRequiringSync(
     }
   }
 }
+
+// Moves synchronization down the control flow, starting after the call instruction I.
+void insertSynchronizationAfterCall(
+    llvm::Instruction *I, llvm::Function *SyncF,
+    const llvm::SmallPtrSet<llvm::Function *, 16> &StdparFunctions,
+    const InstToInstListMapT &PotentialStoresForStdparArgs) {
+  // For the start of our search, we need be move to the next instruction following
+  // the stdpar call.
+  // If the stdpar call is mapped to an InvokeInst (which is tpyically the case),
+  // it does not have a next instruction.
+  //
+  // It is important to have this logic here, and not e.g. when collecting StdparCallPositions,
+  // because the appropriate start position might be altered by other barrier insertions
+  // in earlier iterations!
+  llvm::SmallVector<llvm::Instruction*, 8> StartPositions;
+  if(I->isTerminator()) {
+    for(int i = 0; i < I->getNumSuccessors(); ++i) {
+      StartPositions.push_back(&*(I->getSuccessor(i)->getFirstInsertionPt()));
+    }
+  } else {
+    StartPositions.push_back(I->getNextNonDebugInstruction());
+  }
+  for(auto* Start : StartPositions) {
+
+    llvm::SmallPtrSet<llvm::BasicBlock*, 16> VisitedBlocks;
+    forEachReachableInstructionRequiringSync(
+        Start, StdparFunctions, PotentialStoresForStdparArgs, VisitedBlocks,
+        [&](llvm::Instruction *InsertSyncBefore) {
+          HIPSYCL_DEBUG_INFO << "[stdpar] SyncElision: Inserting synchronization in function "
+                            << InsertSyncBefore->getParent()->getParent()->getName() << "\n";
+          auto *Sync =
+              llvm::CallInst::Create(SyncF->getFunctionType(), SyncF, "", InsertSyncBefore);
+          // Remember that this synchronization was only inserted because of a call.
+          // If we learn later (e.g. during LTO) that the called function does not
+          // require synchronization, we can continue moving it down.
+          if(llvm::isa<llvm::CallBase>(InsertSyncBefore)) {
+            Sync->setMetadata(SyncBeforeCallMDKind,
+                              llvm::MDNode::get(InsertSyncBefore->getContext(), {}));
+          }
+        });
+  }
+}
+
+bool pointsToStackMemory(const llvm::Value *Ptr) {
+  return Ptr && llvm::isa<llvm::AllocaInst>(llvm::getUnderlyingObject(Ptr));
+}
+
+// Returns whether the intrinsic call I at most touches stack memory of the
+// calling function. This covers intrinsics that are commonly emitted for any
+// function with local variables, such as lifetime markers, debug info and
+// mem intrinsics used to initialize or copy locals.
+bool isStackOnlyIntrinsic(llvm::Instruction *I) {
+  if(llvm::isa<llvm::DbgInfoIntrinsic>(I))
+    return true;
+  if(auto *II = llvm::dyn_cast<llvm::IntrinsicInst>(I)) {
+    if(II->getIntrinsicID() == llvm::Intrinsic::lifetime_start ||
+       II->getIntrinsicID() == llvm::Intrinsic::lifetime_end)
+      return true;
+  }
+  if(auto *MI = llvm::dyn_cast<llvm::MemIntrinsic>(I)) {
+    if(!pointsToStackMemory(MI->getRawDest()))
+      return false;
+    if(auto *MT = llvm::dyn_cast<llvm::MemTransferInst>(MI))
+      return pointsToStackMemory(MT->getRawSource());
+    return true;
+  }
+  return false;
+}
+
+// Returns whether F can be proven not to access memory that may be used by
+// offloaded stdpar operations, and not to synchronize. This is the case if F only
+// accesses its own stack memory, and only calls functions for which the same holds.
+bool functionRequiresNoSync(llvm::Function *F,
+                            const llvm::SmallPtrSet<llvm::Function *, 16> &Candidates) {
+  for(auto& BB : *F) {
+    for(auto& I : BB) {
+      if(isStackOnlyIntrinsic(&I))
+        continue;
+      if(auto* CB = llvm::dyn_cast<llvm::CallBase>(&I)) {
+        llvm::Function* CalledF = CB->getCalledFunction();
+        if(!CalledF || CB->isInlineAsm())
+          return false;
+        if(!Candidates.contains(CalledF) && !functionDoesNotAccessMemory(CalledF))
+          return false;
+      } else if(llvm::isa<llvm::FenceInst>(&I)) {
+        return false;
+      } else if(instructionAccessesMemory(&I)) {
+        const llvm::Value *Ptr = llvm::getLoadStorePointerOperand(&I);
+        if(auto *RMW = llvm::dyn_cast<llvm::AtomicRMWInst>(&I))
+          Ptr = RMW->getPointerOperand();
+        else if(auto *CmpXchg = llvm::dyn_cast<llvm::AtomicCmpXchgInst>(&I))
+          Ptr = CmpXchg->getPointerOperand();
+        if(!pointsToStackMemory(Ptr))
+          return false;
+      }
+    }
+  }
+  return true;
+}
 }
 
 
@@ -379,36 +487,94 @@ llvm::PreservedAnalyses SyncElisionPass::run(llvm::Module &M, llvm::ModuleAnalys
         StdparCallPositions, StdparFunctions, InstructionsPotentiallyForStdparArgHandling);
 
     for(auto* I : StdparCallPositions) {
-      // For the start of our search, we need be move to the next instruction following
-      // the stdpar call.
-      // If the stdpar call is mapped to an InvokeInst (which is tpyically the case),
-      // it does not have a next instruction.
-      //
-      // It is important to have this logic here, and not e.g. when collecting StdparCallPositions,
-      // because the appropriate start position might be altered by other barrier insertions
-      // in earlier iterations!
-      llvm::SmallVector<llvm::Instruction*, 8> StartPositions;
-      if(I->isTerminator()) {
-        for(int i = 0; i < I->getNumSuccessors(); ++i) {
-          StartPositions.push_back(&*(I->getSuccessor(i)->getFirstInsertionPt()));
-        }
-      } else {
-        StartPositions.push_back(I->getNextNonDebugInstruction());
-      }
-      for(auto* Start : StartPositions) {
-
-        llvm::SmallPtrSet<llvm::BasicBlock*, 16> VisitedBlocks;
-        forEachReachableInstructionRequiringSync(
-            Start, StdparFunctions, InstructionsPotentiallyForStdparArgHandling, VisitedBlocks,
-            [&](llvm::Instruction *InsertSyncBefore) {
-              HIPSYCL_DEBUG_INFO << "[stdpar] SyncElision: Inserting synchronization in function "
-                                << InsertSyncBefore->getParent()->getParent()->getName() << "\n";
-              llvm::CallInst::Create(SyncF->getFunctionType(), SyncF, "", InsertSyncBefore);
-            });
+      insertSynchronizationAfterCall(I, SyncF, StdparFunctions,
+                                     InstructionsPotentiallyForStdparArgHandling);
+    }
+  }
+
+  return llvm::PreservedAnalyses::none();
+}
+
+llvm::PreservedAnalyses SyncElisionSummaryPass::run(llvm::Module &M,
+                                                    llvm::ModuleAnalysisManager &AM) {
+  llvm::SmallPtrSet<llvm::Function*, 16> StdparFunctions;
+  forEachStdparFunction(M, [&](llvm::Function *F) {
+    StdparFunctions.insert(F);
+  });
+
+  llvm::SmallPtrSet<llvm::Function*, 16> Candidates;
+  for(auto& F : M) {
+    if(!F.isDeclaration() && !F.isInterposable() && !StdparFunctions.contains(&F) &&
+       !F.getName().equals(BarrierBuiltinName))
+      Candidates.insert(&F);
+  }
+
+  // Optimistically assume all candidates do not require synchronization, and
+  // iteratively remove those that violate the assumption until we reach a fixpoint.
+  // This also handles recursion.
+  bool Changed = true;
+  while(Changed) {
+    Changed = false;
+    llvm::SmallVector<llvm::Function*, 16> Invalid;
+    for(auto* F : Candidates) {
+      if(!functionRequiresNoSync(F, Candidates))
+        Invalid.push_back(F);
+    }
+    for(auto* F : Invalid) {
+      Candidates.erase(F);
+      Changed = true;
+    }
+  }
+
+  for(auto* F : Candidates) {
+    HIPSYCL_DEBUG_INFO << "[stdpar] SyncElision: Function " << F->getName()
+                       << " does not require synchronization\n";
+    F->addFnAttr(NoSyncSummaryAttribute);
+  }
+
+  return Candidates.empty() ? llvm::PreservedAnalyses::all()
+                            : llvm::PreservedAnalyses::none();
+}
+
+llvm::PreservedAnalyses SyncElisionLTOPass::run(llvm::Module &M, llvm::ModuleAnalysisManager &AM) {
+  auto* SyncF = M.getFunction(BarrierBuiltinName);
+  if(!SyncF)
+    return llvm::PreservedAnalyses::all();
+
+  llvm::SmallPtrSet<llvm::Function*, 16> StdparFunctions;
+  forEachStdparFunction(M, [&](llvm::Function *F) {
+    StdparFunctions.insert(F);
+  });
+
+  // Collect synchronization that was inserted at compile time only because
+  // a call to a function was encountered whose definition is available now.
+  llvm::SmallVector<llvm::CallBase*, 16> SyncCallsToMove;
+  for(auto* U : SyncF->users()) {
+    if(auto* CB = llvm::dyn_cast<llvm::CallBase>(U)) {
+      if(!CB->getMetadata(SyncBeforeCallMDKind))
+        continue;
+      if(auto* Next = llvm::dyn_cast_or_null<llvm::CallBase>(CB->getNextNonDebugInstruction())) {
+        llvm::Function* CalledF = Next->getCalledFunction();
+        if(CalledF && !CalledF->isDeclaration() &&
+           CalledF->hasFnAttribute(NoSyncSummaryAttribute))
+          SyncCallsToMove.push_back(CB);
       }
     }
   }
 
+  if(SyncCallsToMove.empty())
+    return llvm::PreservedAnalyses::all();
+
+  InstToInstListMapT NoPotentialStoresForStdparArgs;
+  for(auto* CB : SyncCallsToMove) {
+    auto* Call = CB->getNextNonDebugInstruction();
+    HIPSYCL_DEBUG_INFO << "[stdpar] SyncElision: Moving synchronization beyond call to "
+                       << llvm::cast<llvm::CallBase>(Call)->getCalledFunction()->getName()
+                       << " in function " << CB->getParent()->getParent()->getName() << "\n";
+    CB->eraseFromParent();
+    insertSynchronizationAfterCall(Call, SyncF, StdparFunctions, NoPotentialStoresForStdparArgs);
+  }
+
   return llvm::PreservedAnalyses::none();
 }
 }
@@ -31,6 +31,7 @@
 #include "hipSYCL/runtime/dag_manager.hpp"
 #include "hipSYCL/runtime/runtime.hpp"
 #include "hipSYCL/runtime/hw_model/hw_model.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
 #include "hipSYCL/runtime/settings.hpp"
 #include <memory>
 #include <mutex>
@@ -56,7 +57,12 @@ std::shared_ptr<runtime> application::get_runtime_pointer() {
 
   std::shared_ptr<runtime> rt_ptr = rt.lock();
   if(!rt_ptr) {
-    rt_ptr = std::make_shared<runtime>();
+    // Counters are only final once the runtime has been destroyed
+    // entirely, including all pending work in its worker threads.
+    rt_ptr = std::shared_ptr<runtime>(new runtime{}, [](runtime *r) {
+      delete r;
+      perf_counter_registry::get().on_runtime_shutdown();
+    });
     rt = rt_ptr;
   }
   assert(rt_ptr);
@@ -630,7 +630,8 @@ result cuda_queue::submit_sscp_kernel_from_code_object(
       kernel_base_config_parameter::compilation_flow,
       compilation_flow::sscp);
   config.append_base_configuration(
-      kernel_base_config_parameter::hcf_object_id, hcf_object);
+      kernel_base_config_parameter::hcf_object_id,
+      kernel_info->get_hcf_object_id());
   
   for(const auto& flag : kernel_info->get_compilation_flags())
     config.set_build_flag(flag);
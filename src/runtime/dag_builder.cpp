@@ -31,6 +31,7 @@
 #include "hipSYCL/runtime/util.hpp"
 #include "hipSYCL/runtime/operations.hpp"
 #include "hipSYCL/runtime/dag_builder.hpp"
+#include "hipSYCL/runtime/dag_trace.hpp"
 #include "hipSYCL/runtime/serialization/serialization.hpp"
 #include "hipSYCL/sycl/access.hpp"
 
@@ -241,6 +242,13 @@ dag_builder::add_command_group(std::unique_ptr<operation> op,
   auto node = this->build_node(std::move(op), requirements, hints);
   _current_dag.add_command_group(node);
 
+  dag_trace_recorder& trace = dag_trace_recorder::get();
+  if(trace.is_enabled()) {
+    // Instrumentation hints are only evaluated once the node is executed
+    trace.prepare_hints(node->get_execution_hints());
+    trace.record_submission(node, requirements);
+  }
+
   return node;
 }
 
@@ -27,14 +27,18 @@
 
 
 #include <algorithm>
+#include <sstream>
+#include <vector>
 
 #include "hipSYCL/runtime/device_id.hpp"
 #include "hipSYCL/runtime/hints.hpp"
 #include "hipSYCL/runtime/operations.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
 #include "hipSYCL/runtime/runtime.hpp"
 #include "hipSYCL/runtime/dag_direct_scheduler.hpp"
 #include "hipSYCL/runtime/error.hpp"
 #include "hipSYCL/runtime/executor.hpp"
+#include "hipSYCL/runtime/io_executor.hpp"
 #include "hipSYCL/runtime/util.hpp"
 #include "hipSYCL/runtime/dag_manager.hpp"
 #include "hipSYCL/runtime/generic/multi_event.hpp"
@@ -107,6 +111,7 @@ result ensure_allocation_exists(runtime *rt,
     // TODO: A better solution might be to select a custom alignment
     // best on sizeof(T). This requires querying backend alignment capabilities.
     void *ptr = allocator->allocate(0, num_bytes);
+    perf_count(perf_counter_id::allocated_bytes, num_bytes);
 
     if(!ptr)
       return register_error(
@@ -180,6 +185,10 @@ select_executor(runtime *rt, dag_node_ptr node, operation *op) {
 
   assert(!op->is_requirement());
 
+  // File I/O is always carried out by the dedicated I/O executor
+  if(op->is_file_io())
+    return std::make_pair(&rt->io(), dev);
+
   // If we have been requested to run on a particular executor, do this.
   backend_executor* user_preferred_executor = nullptr;
   if(node->get_execution_hints().has_hint<hints::prefer_executor>()){
@@ -212,8 +221,39 @@ select_executor(runtime *rt, dag_node_ptr node, operation *op) {
   }
 }
 
+perf_counter &get_device_pair_counter(device_id src, device_id dest) {
+  struct device_pair_counter {
+    device_id src;
+    device_id dest;
+    perf_counter* counter;
+  };
+  // Counters are never destroyed, so each thread can cache them without
+  // going through the locked registry lookup on every transfer.
+  thread_local std::vector<device_pair_counter> cached_counters;
+  for(const auto& entry : cached_counters)
+    if(entry.src == src && entry.dest == dest)
+      return *entry.counter;
+
+  std::stringstream name;
+  name << "memcpy.bytes[" << src << "->" << dest << "]";
+  perf_counter &counter = perf_counter_registry::get().get_or_create(
+      name.str(), "Bytes transferred between a pair of devices",
+      perf_counter_kind::sum);
+  cached_counters.push_back(device_pair_counter{src, dest, &counter});
+  return counter;
+}
+
+void count_transferred_bytes(memcpy_operation* op) {
+  std::size_t num_bytes = op->get_num_transferred_bytes();
+  perf_count(perf_counter_id::memcpy_bytes, num_bytes);
+  get_device_pair_counter(op->source().get_device(), op->dest().get_device())
+      .add(num_bytes);
+}
+
 void submit(backend_executor *executor, dag_node_ptr node, operation *op) {
-  
+  if(op->is_data_transfer())
+    count_transferred_bytes(cast<memcpy_operation>(op));
+
   node_list_t reqs;
   node->for_each_nonvirtual_requirement([&](dag_node_ptr req) {
     if(std::find(reqs.begin(), reqs.end(), req) == reqs.end())
@@ -327,6 +367,7 @@ result submit_requirement(runtime* rt, dag_node_ptr req) {
   if (!req->get_event()) {
     // create dummy event
     req->mark_virtually_submitted();
+    perf_count(perf_counter_id::dag_requirements_elided);
   }
   // This must be executed even if the requirement did
   // not result in actual operations in order to make sure
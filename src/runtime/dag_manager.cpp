@@ -25,6 +25,7 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 
@@ -33,8 +34,11 @@
 #include "hipSYCL/runtime/dag_direct_scheduler.hpp"
 #include "hipSYCL/runtime/dag_manager.hpp"
 #include "hipSYCL/runtime/dag_node.hpp"
+#include "hipSYCL/runtime/dag_trace.hpp"
 #include "hipSYCL/runtime/dag_unbound_scheduler.hpp"
+#include "hipSYCL/runtime/generic/thread_affinity.hpp"
 #include "hipSYCL/runtime/operations.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
 #include "hipSYCL/runtime/settings.hpp"
 #include "hipSYCL/runtime/util.hpp"
 #include "hipSYCL/runtime/runtime.hpp"
@@ -48,18 +52,146 @@ dag_build_guard::~dag_build_guard()
   _mgr->trigger_flush_opportunity();
 }
 
+adaptive_flush_policy::adaptive_flush_policy(
+    std::size_t max_batch_size, std::chrono::microseconds max_latency,
+    std::function<void()> flush)
+    : _max_batch_size{std::max<std::size_t>(max_batch_size, 1)},
+      _max_latency{max_latency}, _flush{std::move(flush)} {
+  if(_flush)
+    _timer = std::thread{[this]() { timer_loop(); }};
+}
+
+adaptive_flush_policy::~adaptive_flush_policy() {
+  if(!_timer.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _is_timer_shutdown = true;
+  }
+  _timer_cv.notify_all();
+  _timer.join();
+}
+
+bool adaptive_flush_policy::should_flush(std::size_t num_unflushed_nodes) {
+  if(num_unflushed_nodes == 0)
+    return false;
+
+  auto now = std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> lock{_mutex};
+  if(_oldest_unflushed_submission ==
+     std::chrono::steady_clock::time_point{}) {
+    _oldest_unflushed_submission = now;
+    _timer_cv.notify_one();
+  }
+
+  if(!is_last_flush_pending()) {
+    // Executors have run out of work, so we should not wait for more nodes.
+    _batch_size = std::max<std::size_t>(_batch_size / 2, 1);
+    perf_count(perf_counter_id::dag_flushes_idle);
+    HIPSYCL_DEBUG_INFO << "dag_manager: Previous flush has completed, flushing "
+                       << num_unflushed_nodes << " nodes" << std::endl;
+    return true;
+  }
+  if(num_unflushed_nodes >= _batch_size) {
+    // Executors are still busy with the previous batch, so we can afford
+    // to collect larger batches.
+    _batch_size = std::min(2 * _batch_size, _max_batch_size);
+    perf_count(perf_counter_id::dag_flushes_batch_full);
+    perf_record_max(perf_counter_id::dag_flush_batch_size_max, _batch_size);
+    HIPSYCL_DEBUG_INFO << "dag_manager: Batch is full, flushing "
+                       << num_unflushed_nodes << " nodes; new batch size is "
+                       << _batch_size << std::endl;
+    return true;
+  }
+  if(now - _oldest_unflushed_submission >= _max_latency) {
+    perf_count(perf_counter_id::dag_flushes_latency_bound);
+    HIPSYCL_DEBUG_INFO << "dag_manager: Maximum flush latency exceeded, "
+                          "flushing "
+                       << num_unflushed_nodes << " nodes" << std::endl;
+    return true;
+  }
+  return false;
+}
+
+void adaptive_flush_policy::notify_flush_begin() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _oldest_unflushed_submission = {};
+}
+
+void adaptive_flush_policy::notify_flushed(const node_list_t &flushed_nodes) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _last_flushed_nodes = flushed_nodes;
+}
+
+std::size_t adaptive_flush_policy::get_batch_size() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _batch_size;
+}
+
+bool adaptive_flush_policy::is_last_flush_pending() const {
+  // Later nodes are more likely to be incomplete
+  for(auto it = _last_flushed_nodes.rbegin(); it != _last_flushed_nodes.rend();
+      ++it) {
+    if(!(*it)->is_cancelled() && !(*it)->is_complete())
+      return true;
+  }
+  return false;
+}
+
+void adaptive_flush_policy::timer_loop() {
+  thread_affinity::get().pin_helper_thread();
+
+  std::unique_lock<std::mutex> lock{_mutex};
+  while(!_is_timer_shutdown) {
+    if (_oldest_unflushed_submission ==
+        std::chrono::steady_clock::time_point{}) {
+      _timer_cv.wait(lock);
+      continue;
+    }
+
+    auto deadline = _oldest_unflushed_submission + _max_latency;
+    if(std::chrono::steady_clock::now() < deadline) {
+      _timer_cv.wait_until(lock, deadline);
+    } else {
+      lock.unlock();
+      perf_count(perf_counter_id::dag_flushes_latency_bound);
+      HIPSYCL_DEBUG_INFO << "dag_manager: Maximum flush latency exceeded, "
+                            "flushing from timer"
+                         << std::endl;
+      // This resets _oldest_unflushed_submission
+      _flush();
+      lock.lock();
+    }
+  }
+}
+
 dag_manager::dag_manager(runtime *rt)
     : _builder{std::make_unique<dag_builder>(rt)},
       _direct_scheduler{rt}, _unbound_scheduler{rt}, _rt{rt} {
   HIPSYCL_DEBUG_INFO << "dag_manager: DAG manager is alive!" << std::endl;
+
+  if (application::get_settings().get<setting::dag_flush_policy>() ==
+      dag_flush_policy::adaptive) {
+    std::size_t max_batch_size = std::max<std::size_t>(
+        application::get_settings().get<setting::max_cached_nodes>(), 1);
+    std::chrono::microseconds max_latency{
+        application::get_settings().get<setting::dag_flush_max_latency>()};
+    _adaptive_flush_policy = std::make_unique<adaptive_flush_policy>(
+        max_batch_size, max_latency, [this]() { flush_async(); });
+  }
 }
 
 dag_manager::~dag_manager()
 {
+  // Stops the flush timer
+  _adaptive_flush_policy.reset();
+
   HIPSYCL_DEBUG_INFO << "dag_manager: Waiting for async worker..." << std::endl;
   
   flush_sync();
   wait();
+  dag_trace_recorder::get().flush();
 
   HIPSYCL_DEBUG_INFO << "dag_manager: Shutdown." << std::endl;
 }
@@ -84,10 +216,18 @@ void dag_manager::flush_async()
   //  to other nodes that have not yet been submitted.
   std::lock_guard<std::mutex> lock{_flush_mutex};
 
+  if(_adaptive_flush_policy)
+    _adaptive_flush_policy->notify_flush_begin();
+
   if(_builder->get_current_dag_size() > 0){
     dag new_dag = _builder->finish_and_reset();
 
+    if(_adaptive_flush_policy && !new_dag.get_command_groups().empty())
+      _adaptive_flush_policy->notify_flushed(new_dag.get_command_groups());
+
     if(new_dag.num_nodes() > 0) {
+      perf_count(perf_counter_id::dag_flushes);
+      perf_count(perf_counter_id::dag_nodes_submitted, new_dag.num_nodes());
       _worker([this, new_dag](){
         HIPSYCL_DEBUG_INFO << "dag_manager [async]: Flushing!" << std::endl;
         
@@ -139,6 +279,10 @@ void dag_manager::flush_async()
         for(auto node : new_dag.get_memory_requirements())
           this->register_submitted_ops(node);
 
+        dag_trace_recorder& trace = dag_trace_recorder::get();
+        if(trace.is_enabled())
+          trace.record_executions();
+
         if (this->_submitted_ops.get_num_nodes() >
             application::get_settings().get<setting::gc_trigger_batch_size>())
           this->_submitted_ops.async_wait_and_unregister();
@@ -179,7 +323,10 @@ void dag_manager::trigger_flush_opportunity()
   HIPSYCL_DEBUG_INFO << "dag_manager: Checking DAG flush opportunity..."
                      << std::endl;
 
-  if (application::get_settings().get<setting::scheduler_type>() ==
+  if (_adaptive_flush_policy) {
+    if(_adaptive_flush_policy->should_flush(builder()->get_current_dag_size()))
+      flush_async();
+  } else if (application::get_settings().get<setting::scheduler_type>() ==
       scheduler_type::direct) {
     // Direct scheduler always needs flushing
     flush_async();
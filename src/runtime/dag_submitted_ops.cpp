@@ -30,6 +30,7 @@
 #include "hipSYCL/runtime/dag_submitted_ops.hpp"
 #include "hipSYCL/runtime/dag_node.hpp"
 #include "hipSYCL/runtime/hints.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
 
 namespace hipsycl {
 namespace rt {
@@ -56,6 +57,7 @@ void dag_submitted_ops::copy_node_list(std::vector<dag_node_ptr>& out) const {
 
 void dag_submitted_ops::purge_known_completed() {
   std::lock_guard lock{_lock};
+  perf_count(perf_counter_id::dag_gc_passes);
 
   erase_known_completed_nodes(_ops);
 }
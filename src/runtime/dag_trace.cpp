@@ -0,0 +1,473 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/dag_trace.hpp"
+#include "hipSYCL/runtime/application.hpp"
+#include "hipSYCL/runtime/settings.hpp"
+#include "hipSYCL/common/debug.hpp"
+
+#include <cstring>
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+// File layout: magic, version byte, then a sequence of entries that start
+// with a tag byte. Integers are LEB128-encoded; signed integers are
+// zigzag-encoded first.
+constexpr char trace_magic[8] = {'A', 'C', 'P', 'P', 'D', 'A', 'G', 'T'};
+constexpr uint8_t trace_version = 1;
+
+constexpr uint8_t string_entry_tag = 1;
+constexpr uint8_t record_entry_tag = 2;
+
+void write_uint(std::ostream& ostr, uint64_t x) {
+  do {
+    uint8_t byte = x & 0x7f;
+    x >>= 7;
+    if(x)
+      byte |= 0x80;
+    ostr.put(static_cast<char>(byte));
+  } while(x);
+}
+
+void write_int(std::ostream& ostr, int64_t x) {
+  write_uint(ostr, (static_cast<uint64_t>(x) << 1) ^
+                       static_cast<uint64_t>(x >> 63));
+}
+
+bool read_uint(std::istream& istr, uint64_t& out) {
+  out = 0;
+  for(int shift = 0; shift < 64; shift += 7) {
+    int c = istr.get();
+    if(c == std::char_traits<char>::eof())
+      return false;
+    out |= static_cast<uint64_t>(c & 0x7f) << shift;
+    if(!(c & 0x80))
+      return true;
+  }
+  return false;
+}
+
+bool read_int(std::istream& istr, int64_t& out) {
+  uint64_t x;
+  if(!read_uint(istr, x))
+    return false;
+  out = static_cast<int64_t>(x >> 1) ^ -static_cast<int64_t>(x & 1);
+  return true;
+}
+
+dag_trace_operation_kind get_operation_kind(operation* op) {
+  if(op->is_requirement())
+    return dag_trace_operation_kind::requirement;
+  if(op->is_file_io())
+    return dag_trace_operation_kind::file_io;
+  if(op->is_data_transfer())
+    return dag_trace_operation_kind::memcpy;
+  if(dynamic_cast<kernel_operation*>(op))
+    return dag_trace_operation_kind::kernel;
+  if(dynamic_cast<memset_operation*>(op))
+    return dag_trace_operation_kind::memset;
+  if(dynamic_cast<prefetch_operation*>(op))
+    return dag_trace_operation_kind::prefetch;
+  return dag_trace_operation_kind::other;
+}
+
+}
+
+dag_trace_writer::dag_trace_writer(const std::string& filename)
+: _file{filename, std::ios::binary | std::ios::trunc} {
+  if(_file.is_open()) {
+    _file.write(trace_magic, sizeof(trace_magic));
+    _file.put(static_cast<char>(trace_version));
+  }
+}
+
+bool dag_trace_writer::is_open() const {
+  return _file.is_open();
+}
+
+uint64_t dag_trace_writer::get_string_id(const std::string& s) {
+  // 0 denotes the empty string
+  if(s.empty())
+    return 0;
+
+  auto it = _string_ids.find(s);
+  if(it != _string_ids.end())
+    return it->second;
+
+  uint64_t id = _string_ids.size() + 1;
+  _string_ids[s] = id;
+
+  _file.put(static_cast<char>(string_entry_tag));
+  write_uint(_file, id);
+  write_uint(_file, s.size());
+  _file.write(s.data(), s.size());
+  return id;
+}
+
+void dag_trace_writer::write(const dag_trace_record& record) {
+  uint64_t name_id = get_string_id(record.name);
+
+  _file.put(static_cast<char>(record_entry_tag));
+  write_uint(_file, record.node_id);
+  _file.put(static_cast<char>(record.kind));
+  write_uint(_file, name_id);
+  write_int(_file, record.backend);
+  write_int(_file, record.device);
+  write_uint(_file, record.node_group);
+  write_int(_file, record.preferred_lane);
+  write_uint(_file, record.submission_time);
+  write_uint(_file, record.start_time);
+  write_uint(_file, record.duration);
+
+  write_uint(_file, record.dependencies.size());
+  // Dependencies are always older than the node, so deltas are small
+  // and positive.
+  for(uint64_t dep : record.dependencies)
+    write_uint(_file, record.node_id - dep);
+
+  write_uint(_file, record.accesses.size());
+  for(const auto& access : record.accesses) {
+    write_uint(_file, access.region_id);
+    write_uint(_file, access.element_size);
+    for(int i = 0; i < 3; ++i) {
+      write_uint(_file, access.num_elements[i]);
+      write_uint(_file, access.page_size[i]);
+      write_uint(_file, access.offset[i]);
+      write_uint(_file, access.range[i]);
+    }
+    _file.put(static_cast<char>(access.mode));
+    _file.put(static_cast<char>(access.target));
+  }
+  _file.flush();
+}
+
+dag_trace_reader::dag_trace_reader(const std::string& filename)
+: _file{filename, std::ios::binary}, _is_valid{false} {
+  if(!_file.is_open())
+    return;
+
+  char magic[sizeof(trace_magic)];
+  if(!_file.read(magic, sizeof(magic)))
+    return;
+  if(std::memcmp(magic, trace_magic, sizeof(magic)) != 0)
+    return;
+  int version = _file.get();
+  _is_valid = (version == trace_version);
+}
+
+bool dag_trace_reader::is_valid() const {
+  return _is_valid;
+}
+
+bool dag_trace_reader::read(dag_trace_record& out) {
+  if(!_is_valid)
+    return false;
+
+  int tag = _file.get();
+  while(tag == string_entry_tag) {
+    uint64_t id, size;
+    if(!read_uint(_file, id) || !read_uint(_file, size) || id == 0)
+      return false;
+    std::string s(size, '\0');
+    if(!_file.read(s.data(), size))
+      return false;
+    if(_strings.size() < id)
+      _strings.resize(id);
+    _strings[id - 1] = std::move(s);
+    tag = _file.get();
+  }
+  if(tag != record_entry_tag)
+    return false;
+
+  out = dag_trace_record{};
+  uint64_t name_id, num_deps, num_accesses;
+  int64_t backend, device;
+  if(!read_uint(_file, out.node_id))
+    return false;
+  out.kind = static_cast<dag_trace_operation_kind>(_file.get());
+  if (!read_uint(_file, name_id) || !read_int(_file, backend) ||
+      !read_int(_file, device) || !read_uint(_file, out.node_group) ||
+      !read_int(_file, out.preferred_lane) ||
+      !read_uint(_file, out.submission_time) ||
+      !read_uint(_file, out.start_time) || !read_uint(_file, out.duration))
+    return false;
+
+  if(name_id > _strings.size())
+    return false;
+  if(name_id > 0)
+    out.name = _strings[name_id - 1];
+  out.backend = static_cast<int>(backend);
+  out.device = static_cast<int>(device);
+
+  if(!read_uint(_file, num_deps))
+    return false;
+  for(uint64_t i = 0; i < num_deps; ++i) {
+    uint64_t delta;
+    if(!read_uint(_file, delta) || delta == 0 || delta > out.node_id)
+      return false;
+    out.dependencies.push_back(out.node_id - delta);
+  }
+
+  if(!read_uint(_file, num_accesses))
+    return false;
+  for(uint64_t i = 0; i < num_accesses; ++i) {
+    dag_trace_access access;
+    if (!read_uint(_file, access.region_id) ||
+        !read_uint(_file, access.element_size))
+      return false;
+    for(int j = 0; j < 3; ++j) {
+      if (!read_uint(_file, access.num_elements[j]) ||
+          !read_uint(_file, access.page_size[j]) ||
+          !read_uint(_file, access.offset[j]) ||
+          !read_uint(_file, access.range[j]))
+        return false;
+    }
+    access.mode = static_cast<sycl::access::mode>(_file.get());
+    access.target = static_cast<sycl::access::target>(_file.get());
+    out.accesses.push_back(access);
+  }
+  return static_cast<bool>(_file);
+}
+
+dag_trace_recorder& dag_trace_recorder::get() {
+  // Intentionally leaked, since nodes might complete during
+  // static destruction
+  static dag_trace_recorder* recorder = new dag_trace_recorder{};
+  return *recorder;
+}
+
+dag_trace_recorder::dag_trace_recorder()
+: _is_enabled{false}, _start{profiler_clock::now()} {
+  std::string filename =
+      application::get_settings().get<setting::dag_trace_file>();
+  if(filename.empty())
+    return;
+
+  _writer = std::make_unique<dag_trace_writer>(filename);
+  if(!_writer->is_open()) {
+    HIPSYCL_DEBUG_WARNING << "dag_trace_recorder: Could not open trace file "
+                          << filename << ", DAG tracing is disabled"
+                          << std::endl;
+    return;
+  }
+  HIPSYCL_DEBUG_INFO << "dag_trace_recorder: Writing DAG trace to " << filename
+                     << std::endl;
+  _is_enabled = true;
+}
+
+void dag_trace_recorder::prepare_hints(execution_hints& hints) const {
+  hints.set_hint(hints::request_instrumentation_start_timestamp{});
+  hints.set_hint(hints::request_instrumentation_finish_timestamp{});
+}
+
+uint64_t dag_trace_recorder::assign_node_id(const dag_node_ptr& node) {
+  uint64_t id = _next_node_id++;
+  _node_ids[node.get()] = std::make_pair(std::weak_ptr<dag_node>{node}, id);
+
+  // Occasionally forget destroyed nodes
+  if(_node_ids.size() > 4096 && (id % 4096) == 0) {
+    for(auto it = _node_ids.begin(); it != _node_ids.end();) {
+      if(it->second.first.expired())
+        it = _node_ids.erase(it);
+      else
+        ++it;
+    }
+  }
+  return id;
+}
+
+bool dag_trace_recorder::find_node_id(const dag_node_ptr& node,
+                                      uint64_t& id) const {
+  auto it = _node_ids.find(node.get());
+  if(it == _node_ids.end() || it->second.first.lock() != node)
+    return false;
+  id = it->second.second;
+  return true;
+}
+
+uint64_t dag_trace_recorder::get_region_id(
+    const std::shared_ptr<buffer_data_region> &region) {
+  auto it = _region_ids.find(region.get());
+  if(it != _region_ids.end() && it->second.first.lock() == region)
+    return it->second.second;
+
+  uint64_t id = _next_region_id++;
+  _region_ids[region.get()] =
+      std::make_pair(std::weak_ptr<buffer_data_region>{region}, id);
+  return id;
+}
+
+void dag_trace_recorder::add_access(const buffer_memory_requirement *req,
+                                    dag_trace_record &record) {
+  auto region = req->get_data_region();
+
+  dag_trace_access access;
+  access.region_id = get_region_id(region);
+  access.element_size = region->get_element_size();
+  for(int i = 0; i < 3; ++i) {
+    access.num_elements[i] = region->get_num_elements()[i];
+    access.page_size[i] = region->get_page_size()[i];
+    access.offset[i] = req->get_access_offset3d()[i];
+    access.range[i] = req->get_access_range3d()[i];
+  }
+  access.mode = req->get_access_mode();
+  access.target = req->get_access_target();
+  record.accesses.push_back(access);
+}
+
+void dag_trace_recorder::record_submission(
+    const dag_node_ptr &node, const requirements_list &requirements) {
+  std::lock_guard<std::mutex> lock{_mutex};
+
+  pending_record pending;
+  pending.node = node;
+
+  dag_trace_record& record = pending.record;
+  record.node_id = assign_node_id(node);
+  record.submission_time = profiler_clock::ns_ticks(profiler_clock::now()) -
+                           profiler_clock::ns_ticks(_start);
+
+  operation* op = node->get_operation();
+  record.kind = get_operation_kind(op);
+  if(record.kind == dag_trace_operation_kind::kernel)
+    record.name = cast<kernel_operation>(op)->get_global_kernel_name();
+  else if(record.kind == dag_trace_operation_kind::requirement) {
+    auto* req = cast<requirement>(op);
+    if (req->is_memory_requirement() &&
+        cast<memory_requirement>(req)->is_buffer_requirement())
+      add_access(cast<buffer_memory_requirement>(req), record);
+  }
+
+  const execution_hints& hints = node->get_execution_hints();
+  if(hints.has_hint<hints::bind_to_device>()) {
+    device_id dev = hints.get_hint<hints::bind_to_device>()->get_device_id();
+    record.backend = static_cast<int>(dev.get_backend());
+    record.device = dev.get_id();
+  }
+  if(hints.has_hint<hints::node_group>())
+    record.node_group = hints.get_hint<hints::node_group>()->get_id();
+  if(hints.has_hint<hints::prefer_execution_lane>())
+    record.preferred_lane = static_cast<int64_t>(
+        hints.get_hint<hints::prefer_execution_lane>()->get_lane_id());
+
+  for(const dag_node_ptr& req : requirements.get()) {
+    operation* req_op = req->get_operation();
+    if(req_op->is_requirement()) {
+      auto* mem_req = cast<memory_requirement>(req_op);
+      if(mem_req->is_buffer_requirement())
+        add_access(cast<buffer_memory_requirement>(mem_req), record);
+    } else {
+      uint64_t dep_id;
+      // Dependencies on operations that were not recorded (e.g. instant
+      // submissions) are dropped.
+      if(find_node_id(req, dep_id))
+        record.dependencies.push_back(dep_id);
+    }
+  }
+
+  _pending.push_back(std::move(pending));
+  if(_pending.size() >= 256)
+    write_completed_records(false);
+}
+
+void dag_trace_recorder::record_executions() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  for(pending_record& p : _pending) {
+    if(!p.start) {
+      if(dag_node_ptr node = p.node.lock())
+        capture_timestamps(p, node);
+    }
+  }
+}
+
+void dag_trace_recorder::capture_timestamps(pending_record &p,
+                                            const dag_node_ptr &node) {
+  // Requirements are not executed directly and do not carry
+  // instrumentations.
+  if (!node->is_submitted() || node->is_cancelled() || node->is_virtual() ||
+      node->get_operation()->is_requirement())
+    return;
+  const auto& instr = node->get_operation()->get_instrumentations();
+  p.start = instr.try_get<instrumentations::execution_start_timestamp>();
+  p.finish = instr.try_get<instrumentations::execution_finish_timestamp>();
+}
+
+void dag_trace_recorder::flush() {
+  if(!_is_enabled)
+    return;
+  std::lock_guard<std::mutex> lock{_mutex};
+  write_completed_records(true);
+}
+
+void dag_trace_recorder::write_completed_records(bool wait) {
+  auto write_record = [this, wait](pending_record& p) {
+    // Nodes that have been destroyed have completed
+    if(dag_node_ptr node = p.node.lock()) {
+      if(wait && node->is_submitted() && !node->is_cancelled())
+        node->wait();
+      // When flushing, nodes that were never submitted are written without
+      // timing information.
+      bool has_finished = node->is_complete() || node->is_cancelled();
+      if(!has_finished && !wait)
+        return false;
+      if(!p.start && node->is_complete())
+        capture_timestamps(p, node);
+    }
+
+    if(p.start && p.finish) {
+      p.start->wait();
+      p.finish->wait();
+      uint64_t start_ns = profiler_clock::ns_ticks(p.start->get_time_point());
+      uint64_t finish_ns = profiler_clock::ns_ticks(p.finish->get_time_point());
+      uint64_t trace_start_ns = profiler_clock::ns_ticks(_start);
+      if(start_ns >= trace_start_ns && finish_ns >= start_ns) {
+        p.record.start_time = start_ns - trace_start_ns;
+        p.record.duration = finish_ns - start_ns;
+      }
+    }
+    _writer->write(p.record);
+    return true;
+  };
+
+  // Records are written in submission order as far as possible, so that
+  // dependencies usually precede the nodes that use them.
+  std::size_t num_remaining = 0;
+  for(std::size_t i = 0; i < _pending.size(); ++i) {
+    if(!write_record(_pending[i])) {
+      if(i != num_remaining)
+        _pending[num_remaining] = std::move(_pending[i]);
+      ++num_remaining;
+    }
+  }
+  _pending.resize(num_remaining);
+}
+
+}
+}
@@ -26,6 +26,8 @@
  */
 
 #include "hipSYCL/runtime/generic/async_worker.hpp"
+#include "hipSYCL/runtime/generic/thread_affinity.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
 #include "hipSYCL/common/debug.hpp"
 
 #include <cassert>
@@ -81,6 +83,9 @@ void worker_thread::work()
   // The loop is executed as long as there are enqueued operations,
   // (_is_operation_pending) or we should wait for new operations
   // (_continue).
+  // While idle, the thread sleeps on _condition_wait instead of spinning.
+  thread_affinity::get().pin_helper_thread();
+
   while(_continue || queue_size() > 0)
   {
     {
@@ -129,6 +134,8 @@ void worker_thread::operator()(worker_thread::async_function f)
   std::unique_lock<std::mutex> lock(_mutex);
 
   _enqueued_operations.push(f);
+  perf_record_max(perf_counter_id::worker_queue_depth_max,
+                  _enqueued_operations.size());
 
   lock.unlock();
   _condition_wait.notify_all();
@@ -0,0 +1,229 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/generic/host_core_partitioner.hpp"
+#include "hipSYCL/runtime/generic/thread_affinity.hpp"
+#include "hipSYCL/runtime/application.hpp"
+#include "hipSYCL/runtime/settings.hpp"
+
+#include <algorithm>
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+thread_local host_core_partition* current_partition = nullptr;
+
+// Kernels with less work than this per core do not benefit from
+// additional cores.
+constexpr std::size_t min_work_per_core = 1024;
+constexpr std::size_t max_concurrent_kernels = 4;
+
+}
+
+host_core_partitioner& host_core_partitioner::get() {
+  // Intentionally leaked, since worker threads of queues may still
+  // execute kernels during static destruction.
+  static host_core_partitioner* partitioner = new host_core_partitioner{};
+  return *partitioner;
+}
+
+host_core_partitioner::host_core_partitioner()
+    : host_core_partitioner{
+          thread_affinity::get().get_kernel_cores(),
+          application::get_settings().get<setting::omp_core_partitioning>()} {}
+
+host_core_partitioner::host_core_partitioner(const std::vector<int>& cores,
+                                             bool is_enabled)
+    : _is_enabled{is_enabled && cores.size() > 1}, _is_partitioning{false},
+      _generation{0}, _cores{cores} {
+  _core_users.resize(_cores.size(), 0);
+}
+
+std::size_t host_core_partitioner::get_max_concurrent_kernels() const noexcept {
+  if(!_is_enabled)
+    return 1;
+  return std::max(std::size_t{1},
+                  std::min(max_concurrent_kernels, _cores.size() / 2));
+}
+
+void host_core_partitioner::add(host_core_partition* p) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  _active.push_back(p);
+  if(_active.size() > 1)
+    _is_partitioning.store(true, std::memory_order_release);
+  compute_shares();
+  ++_generation;
+}
+
+void host_core_partitioner::remove(host_core_partition* p) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  release_slots(p, 0);
+  _active.erase(std::remove(_active.begin(), _active.end(), p), _active.end());
+  // A single remaining kernel returns to using all cores at its next
+  // resize point.
+  if(_active.size() <= 1)
+    _is_partitioning.store(false, std::memory_order_release);
+  compute_shares();
+  ++_generation;
+}
+
+void host_core_partitioner::update(host_core_partition* p) {
+  std::lock_guard<std::mutex> lock{_mutex};
+
+  if(!_is_partitioning.load(std::memory_order_relaxed)) {
+    release_slots(p, 0);
+    p->_core_ids.clear();
+    return;
+  }
+
+  const std::size_t target = p->_target_num_cores;
+  bool has_released = false;
+  if(p->_slots.size() > target) {
+    release_slots(p, target);
+    has_released = true;
+  }
+  // Grow into free cores. If other kernels have not yet given up their
+  // cores, we retry at the next resize point.
+  for(std::size_t i = 0; i < _cores.size() && p->_slots.size() < target; ++i) {
+    if(_core_users[i] == 0) {
+      ++_core_users[i];
+      p->_slots.push_back(i);
+    }
+  }
+  if(p->_slots.empty()) {
+    // All cores are in use, so share the least used one.
+    auto least_used = std::min_element(_core_users.begin(), _core_users.end());
+    ++(*least_used);
+    p->_slots.push_back(
+        static_cast<std::size_t>(least_used - _core_users.begin()));
+  }
+
+  if(has_released)
+    ++_generation;
+  p->_generation = _generation.load(std::memory_order_relaxed);
+
+  p->_core_ids.clear();
+  for(std::size_t slot : p->_slots)
+    p->_core_ids.push_back(_cores[slot]);
+}
+
+void host_core_partitioner::compute_shares() {
+  // Max-min fair distribution: Kernels with less parallelism than their
+  // fair share only receive what they can use, and the remaining
+  // cores are distributed among the others.
+  std::vector<host_core_partition*> by_demand = _active;
+  std::sort(by_demand.begin(), by_demand.end(),
+            [](const host_core_partition* a, const host_core_partition* b) {
+              return a->_desired_num_cores < b->_desired_num_cores;
+            });
+
+  std::size_t remaining = _cores.size();
+  for(std::size_t i = 0; i < by_demand.size(); ++i) {
+    const std::size_t num_left = by_demand.size() - i;
+    const std::size_t fair_share = (remaining + num_left - 1) / num_left;
+    const std::size_t target = std::max(
+        std::size_t{1}, std::min(by_demand[i]->_desired_num_cores, fair_share));
+    by_demand[i]->_target_num_cores = target;
+    remaining -= std::min(target, remaining);
+  }
+}
+
+void host_core_partitioner::release_slots(host_core_partition* p,
+                                          std::size_t num_remaining) {
+  while(p->_slots.size() > num_remaining) {
+    --_core_users[p->_slots.back()];
+    p->_slots.pop_back();
+  }
+}
+
+host_core_partition::host_core_partition(std::size_t num_work_groups,
+                                         std::size_t work_per_group)
+    : host_core_partition{host_core_partitioner::get(), num_work_groups,
+                          work_per_group} {}
+
+host_core_partition::host_core_partition(host_core_partitioner& partitioner,
+                                         std::size_t num_work_groups,
+                                         std::size_t work_per_group)
+    : _partitioner{&partitioner}, _desired_num_cores{1}, _target_num_cores{0},
+      _generation{0}, _is_registered{false}, _previous{current_partition} {
+  // Nested kernels execute within the cores of the outer kernel
+  if(!_previous && partitioner.is_enabled()) {
+    const std::size_t total_work = num_work_groups * work_per_group;
+    _desired_num_cores = std::max(
+        std::size_t{1}, std::min({num_work_groups, total_work / min_work_per_core,
+                                  partitioner.get_num_cores()}));
+    partitioner.add(this);
+    _is_registered = true;
+    update();
+  }
+  current_partition = this;
+}
+
+host_core_partition::~host_core_partition() {
+  current_partition = _previous;
+  if(_is_registered) {
+    _partitioner->remove(this);
+    // The calling thread takes part in the kernel team, so it may have
+    // been pinned to one of the cores of this partition.
+    thread_affinity::get().unpin_kernel_thread();
+  }
+}
+
+void host_core_partition::update() {
+  if(!_is_registered)
+    return;
+  host_core_partitioner& partitioner = *_partitioner;
+  if(!partitioner.is_partitioning()) {
+    if(is_active())
+      partitioner.update(this);
+    return;
+  }
+  if(is_active() &&
+     _generation == partitioner._generation.load(std::memory_order_acquire))
+    return;
+  partitioner.update(this);
+}
+
+host_core_partition* host_core_partition::current() noexcept {
+  return current_partition;
+}
+
+bool host_core_partition::is_current_kernel_resizable() noexcept {
+  // Kernels that start on their own need to be resizable as well, so that
+  // they can give up cores once another kernel starts.
+  return current_partition && current_partition->_is_registered;
+}
+
+void host_core_partition::resize_point() {
+  if(current_partition)
+    current_partition->update();
+}
+
+}
+}
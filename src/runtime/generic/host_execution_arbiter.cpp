@@ -0,0 +1,141 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/generic/host_execution_arbiter.hpp"
+#include "hipSYCL/common/debug.hpp"
+
+#include <algorithm>
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+thread_local host_execution_guard* current_guard = nullptr;
+
+}
+
+host_execution_arbiter& host_execution_arbiter::get() {
+  // Intentionally leaked, since worker threads of queues may still
+  // execute kernels during static destruction.
+  static host_execution_arbiter* arbiter = new host_execution_arbiter{};
+  return *arbiter;
+}
+
+host_execution_arbiter::host_execution_arbiter()
+    : host_execution_arbiter{
+          host_core_partitioner::get().get_max_concurrent_kernels()} {}
+
+host_execution_arbiter::host_execution_arbiter(
+    std::size_t max_concurrent_kernels)
+    : _is_enabled{false}, _highest_registered_priority{default_priority},
+      _highest_waiting_priority{INT_MAX},
+      _max_running{std::max(max_concurrent_kernels, std::size_t{1})},
+      _num_running{0}, _next_ticket{0} {}
+
+void host_execution_arbiter::register_priority(int priority) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  if(priority < _highest_registered_priority.load(std::memory_order_relaxed))
+    _highest_registered_priority.store(priority, std::memory_order_relaxed);
+
+  if(!_is_enabled.load(std::memory_order_relaxed)) {
+    HIPSYCL_DEBUG_INFO << "host_execution_arbiter: Enabling priority-aware "
+                          "kernel execution"
+                       << std::endl;
+    _is_enabled.store(true, std::memory_order_release);
+  }
+}
+
+void host_execution_arbiter::acquire(int priority) {
+  std::unique_lock<std::mutex> lock{_mutex};
+  auto entry = std::make_pair(priority, _next_ticket++);
+  _waiting.insert(entry);
+  update_highest_waiting_priority();
+
+  _cv.wait(lock, [&]() {
+    return _num_running < _max_running && *_waiting.begin() == entry;
+  });
+
+  _waiting.erase(_waiting.begin());
+  update_highest_waiting_priority();
+  ++_num_running;
+  const bool can_admit_next = !_waiting.empty() && _num_running < _max_running;
+  lock.unlock();
+  // The next waiting kernel may run concurrently
+  if(can_admit_next)
+    _cv.notify_all();
+}
+
+void host_execution_arbiter::release() {
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    --_num_running;
+  }
+  _cv.notify_all();
+}
+
+void host_execution_arbiter::update_highest_waiting_priority() {
+  int highest = _waiting.empty() ? INT_MAX : _waiting.begin()->first;
+  _highest_waiting_priority.store(highest, std::memory_order_relaxed);
+}
+
+host_execution_guard::host_execution_guard(int priority)
+    : _is_acquired{false}, _priority{priority}, _previous{current_guard} {
+  host_execution_arbiter& arbiter = host_execution_arbiter::get();
+  // Nested guards can occur if a kernel is executed from within another
+  // kernel on the same thread; the outer guard already holds the arbiter.
+  if(!_previous && arbiter.is_enabled()) {
+    arbiter.acquire(priority);
+    _is_acquired = true;
+  }
+  current_guard = this;
+}
+
+host_execution_guard::~host_execution_guard() {
+  current_guard = _previous;
+  if(_is_acquired)
+    host_execution_arbiter::get().release();
+}
+
+bool host_execution_guard::is_current_kernel_preemptible() noexcept {
+  return current_guard && current_guard->_is_acquired &&
+         host_execution_arbiter::get().is_preemptible(current_guard->_priority);
+}
+
+void host_execution_guard::preemption_point() {
+  if(!current_guard || !current_guard->_is_acquired)
+    return;
+
+  host_execution_arbiter& arbiter = host_execution_arbiter::get();
+  if(arbiter.should_yield(current_guard->_priority)) {
+    arbiter.release();
+    arbiter.acquire(current_guard->_priority);
+  }
+}
+
+}
+}
@@ -0,0 +1,234 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/generic/thread_affinity.hpp"
+#include "hipSYCL/runtime/application.hpp"
+#include "hipSYCL/runtime/settings.hpp"
+#include "hipSYCL/common/debug.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+// The core that the current thread has been pinned to as kernel thread,
+// or -1 if it is not pinned to a single kernel core.
+thread_local int current_kernel_core = -1;
+
+#ifdef __linux__
+// The affinity of the current thread before it was pinned to a kernel core
+thread_local cpu_set_t affinity_before_kernel_pin;
+
+bool pin_current_thread(const std::vector<int>& cores) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for(int core : cores)
+    if(core < CPU_SETSIZE)
+      CPU_SET(core, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set) == 0;
+}
+
+std::vector<int> get_process_cores() {
+  std::vector<int> result;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if(sched_getaffinity(0, sizeof(cpu_set_t), &set) == 0) {
+    for(int i = 0; i < CPU_SETSIZE; ++i)
+      if(CPU_ISSET(i, &set))
+        result.push_back(i);
+  }
+  return result;
+}
+#endif
+
+std::string format_core_list(const std::vector<int>& cores) {
+  std::stringstream sstr;
+  for(std::size_t i = 0; i < cores.size(); ++i) {
+    if(i > 0)
+      sstr << ",";
+    sstr << cores[i];
+  }
+  return sstr.str();
+}
+
+}
+
+thread_affinity& thread_affinity::get() {
+  // Intentionally leaked, since worker threads may still be
+  // started or execute kernels during static destruction.
+  static thread_affinity* affinity = new thread_affinity{};
+  return *affinity;
+}
+
+thread_affinity::thread_affinity()
+: _is_isolation_enabled{false} {
+#ifdef __linux__
+  std::vector<int> process_cores = get_process_cores();
+#else
+  std::vector<int> process_cores;
+  for(unsigned i = 0; i < std::thread::hardware_concurrency(); ++i)
+    process_cores.push_back(static_cast<int>(i));
+#endif
+  _kernel_cores = process_cores;
+
+  std::string helper_core_list =
+      application::get_settings().get<setting::helper_thread_cores>();
+  if(helper_core_list.empty())
+    return;
+
+  if(!parse_core_list(helper_core_list, _helper_cores)) {
+    HIPSYCL_DEBUG_WARNING << "thread_affinity: Could not parse helper core list '"
+                          << helper_core_list
+                          << "', helper threads will not be isolated."
+                          << std::endl;
+    _helper_cores.clear();
+    return;
+  }
+#ifdef __linux__
+  _kernel_cores.clear();
+  for(int core : process_cores) {
+    if(std::find(_helper_cores.begin(), _helper_cores.end(), core) ==
+       _helper_cores.end())
+      _kernel_cores.push_back(core);
+  }
+  if(_kernel_cores.empty()) {
+    HIPSYCL_DEBUG_WARNING
+        << "thread_affinity: All available cores are reserved for helper "
+           "threads, helper threads will not be isolated."
+        << std::endl;
+    _kernel_cores = process_cores;
+    return;
+  }
+  _is_isolation_enabled = true;
+  HIPSYCL_DEBUG_INFO << "thread_affinity: Pinning helper threads to cores "
+                     << format_core_list(_helper_cores)
+                     << ", kernel threads to cores "
+                     << format_core_list(_kernel_cores) << std::endl;
+#else
+  HIPSYCL_DEBUG_WARNING << "thread_affinity: Isolation of helper threads is "
+                           "not supported on this platform."
+                        << std::endl;
+#endif
+}
+
+void thread_affinity::pin_helper_thread() const {
+  if(!_is_isolation_enabled)
+    return;
+#ifdef __linux__
+  if(!pin_current_thread(_helper_cores)) {
+    HIPSYCL_DEBUG_WARNING
+        << "thread_affinity: Could not pin helper thread to cores "
+        << format_core_list(_helper_cores) << std::endl;
+  }
+  current_kernel_core = -1;
+#endif
+}
+
+void thread_affinity::pin_kernel_thread(int thread_id) const {
+  if(!_is_isolation_enabled) {
+    unpin_kernel_thread();
+    return;
+  }
+  pin_kernel_thread_to_core(_kernel_cores[static_cast<std::size_t>(thread_id) %
+                                          _kernel_cores.size()]);
+}
+
+void thread_affinity::pin_kernel_thread_to_core(int core) const {
+#ifdef __linux__
+  if(core == current_kernel_core)
+    return;
+  if(current_kernel_core == -1 &&
+     pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                            &affinity_before_kernel_pin) != 0)
+    return;
+  if(pin_current_thread({core}))
+    current_kernel_core = core;
+#endif
+}
+
+void thread_affinity::unpin_kernel_thread() const {
+#ifdef __linux__
+  if(current_kernel_core == -1)
+    return;
+  if(pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                            &affinity_before_kernel_pin) == 0)
+    current_kernel_core = -1;
+#endif
+}
+
+bool thread_affinity::parse_core_list(const std::string& list,
+                                      std::vector<int>& out) {
+  out.clear();
+  std::stringstream sstr{list};
+  std::string entry;
+  while(std::getline(sstr, entry, ',')) {
+    entry.erase(std::remove_if(entry.begin(), entry.end(),
+                               [](unsigned char c) { return std::isspace(c); }),
+                entry.end());
+    if(entry.empty())
+      return false;
+    std::size_t dash = entry.find('-');
+    try {
+      std::size_t pos = 0;
+      int first = std::stoi(entry.substr(0, dash), &pos);
+      if(pos != (dash == std::string::npos ? entry.size() : dash))
+        return false;
+      int last = first;
+      if(dash != std::string::npos) {
+        std::string upper = entry.substr(dash + 1);
+        last = std::stoi(upper, &pos);
+        if(pos != upper.size())
+          return false;
+      }
+      if(first < 0 || last < first)
+        return false;
+      for(int core = first; core <= last; ++core)
+        if(std::find(out.begin(), out.end(), core) == out.end())
+          out.push_back(core);
+    } catch(...) {
+      return false;
+    }
+  }
+  // getline() does not report the empty entry after a trailing comma
+  if(!list.empty() && list.back() == ',')
+    return false;
+  std::sort(out.begin(), out.end());
+  return !out.empty();
+}
+
+}
+}
@@ -67,6 +67,22 @@ public:
     return _queue->submit_memset(*op, node);
   }
 
+  virtual result dispatch_file_read(file_read_operation */*op*/,
+                                    dag_node_ptr /*node*/) final override {
+    return make_error(__acpp_here(),
+                      error_info{"inorder_executor: File I/O operations must "
+                                 "be submitted to the io_executor",
+                                 error_type::feature_not_supported});
+  }
+
+  virtual result dispatch_file_write(file_write_operation */*op*/,
+                                     dag_node_ptr /*node*/) final override {
+    return make_error(__acpp_here(),
+                      error_info{"inorder_executor: File I/O operations must "
+                                 "be submitted to the io_executor",
+                                 error_type::feature_not_supported});
+  }
+
 private:
   inorder_queue* _queue;
 };
@@ -131,8 +147,11 @@ void inorder_executor::submit_directly(dag_node_ptr node, operation *op,
     // Nothing to do if we have to synchronize with
     // an operation that is already known to have completed
     if(!req->is_known_complete()) {
+      // Nodes that have not been submitted to an execution lane (e.g. file I/O)
+      // can only be synchronized with as external nodes.
       if (req->get_assigned_device().get_backend() !=
-          _q->get_device().get_backend()) {
+              _q->get_device().get_backend() ||
+          !req->get_assigned_execution_lane()) {
         HIPSYCL_DEBUG_INFO
             << " --> Synchronizes with external node: " << req
             << std::endl;
@@ -0,0 +1,571 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/io_executor.hpp"
+#include "hipSYCL/runtime/application.hpp"
+#include "hipSYCL/runtime/settings.hpp"
+#include "hipSYCL/runtime/serialization/serialization.hpp"
+#include "hipSYCL/common/debug.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ACPP_IO_EXECUTOR_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+// Contiguous part of a transfer between memory and file
+struct io_segment {
+  char* ptr;
+  std::size_t size;
+  std::size_t file_offset;
+};
+
+// Both io_uring and read()/write() may transfer less than 2GiB per request,
+// so split larger transfers into segments of 1GiB
+constexpr std::size_t max_segment_size = std::size_t{1} << 30;
+
+}
+
+class io_engine {
+public:
+  virtual ~io_engine() {}
+  virtual result transfer(int fd, const std::vector<io_segment> &segments,
+                          bool is_write) = 0;
+};
+
+namespace {
+
+#ifndef _WIN32
+// Transfers the remainder of a segment synchronously, starting at
+// byte already_transferred
+result transfer_synchronously(int fd, const io_segment &segment,
+                              std::size_t already_transferred,
+                              bool is_write) {
+  std::size_t pos = already_transferred;
+  while(pos < segment.size) {
+    ssize_t ret = 0;
+    if(is_write)
+      ret = pwrite(fd, segment.ptr + pos, segment.size - pos,
+                   static_cast<off_t>(segment.file_offset + pos));
+    else
+      ret = pread(fd, segment.ptr + pos, segment.size - pos,
+                  static_cast<off_t>(segment.file_offset + pos));
+
+    if(ret < 0) {
+      if(errno == EINTR)
+        continue;
+      return make_error(__acpp_here(),
+                        error_info{"io_executor: File I/O failed",
+                                   error_code{"POSIX", errno}});
+    } else if(ret == 0) {
+      return make_error(
+          __acpp_here(),
+          error_info{"io_executor: Unexpected end of file while reading",
+                     error_type::invalid_parameter_error});
+    }
+    pos += static_cast<std::size_t>(ret);
+  }
+  return make_success();
+}
+
+class posix_io_engine : public io_engine {
+public:
+  virtual result transfer(int fd, const std::vector<io_segment> &segments,
+                          bool is_write) override {
+    for(const auto& segment : segments) {
+      result res = transfer_synchronously(fd, segment, 0, is_write);
+      if(!res.is_success())
+        return res;
+    }
+    return make_success();
+  }
+};
+#endif
+
+#ifdef ACPP_IO_EXECUTOR_IO_URING
+/// Minimal io_uring submission/completion ring. Submits all segments
+/// of a transfer at once, such that the kernel can process them in parallel.
+class io_uring_engine : public io_engine {
+public:
+  static std::unique_ptr<io_uring_engine> create(unsigned entries) {
+    std::unique_ptr<io_uring_engine> engine{new io_uring_engine{}};
+    if(!engine->init(entries))
+      return nullptr;
+    return engine;
+  }
+
+  ~io_uring_engine() {
+    if(_sqes)
+      munmap(_sqes, _sqes_size);
+    if(_cq_ptr && _cq_ptr != _sq_ptr)
+      munmap(_cq_ptr, _cq_size);
+    if(_sq_ptr)
+      munmap(_sq_ptr, _sq_size);
+    if(_ring_fd >= 0)
+      close(_ring_fd);
+  }
+
+  virtual result transfer(int fd, const std::vector<io_segment> &segments,
+                          bool is_write) override {
+    std::size_t num_processed = 0;
+    while(num_processed < segments.size()) {
+      std::size_t batch_size =
+          std::min(static_cast<std::size_t>(_sq_entries),
+                   segments.size() - num_processed);
+
+      unsigned tail = *_sq_tail;
+      for(std::size_t i = 0; i < batch_size; ++i) {
+        const io_segment& segment = segments[num_processed + i];
+        unsigned index = tail & *_sq_mask;
+
+        io_uring_sqe* sqe = &_sqes[index];
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<unsigned long long>(segment.ptr);
+        sqe->len = static_cast<unsigned>(segment.size);
+        sqe->off = segment.file_offset;
+        sqe->user_data = num_processed + i;
+
+        _sq_array[index] = index;
+        ++tail;
+      }
+      __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+
+      std::size_t num_submitted = 0;
+      while(num_submitted < batch_size) {
+        int ret = enter(static_cast<unsigned>(batch_size - num_submitted), 0, 0);
+        if(ret < 0) {
+          if(errno == EINTR || errno == EAGAIN)
+            continue;
+          int err = errno;
+          // Entries that were not consumed by the kernel would otherwise
+          // be submitted with the next batch
+          __atomic_store_n(_sq_tail, tail - static_cast<unsigned>(
+                                                batch_size - num_submitted),
+                           __ATOMIC_RELEASE);
+          reap(fd, num_submitted, segments, is_write);
+          return make_error(__acpp_here(),
+                            error_info{"io_executor: io_uring_enter() failed",
+                                       error_code{"POSIX", err}});
+        }
+        num_submitted += static_cast<std::size_t>(ret);
+      }
+
+      result res = reap(fd, batch_size, segments, is_write);
+      if(!res.is_success())
+        return res;
+
+      num_processed += batch_size;
+    }
+    return make_success();
+  }
+
+private:
+  io_uring_engine() = default;
+
+  bool init(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    _ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if(_ring_fd < 0) {
+      HIPSYCL_DEBUG_INFO << "io_executor: io_uring is unavailable ("
+                         << std::strerror(errno) << ")" << std::endl;
+      return false;
+    }
+
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if(single_mmap)
+      _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+
+    _sq_ptr = map_ring(_sq_size, IORING_OFF_SQ_RING);
+    if(!_sq_ptr)
+      return false;
+    if(single_mmap) {
+      _cq_ptr = _sq_ptr;
+    } else {
+      _cq_ptr = map_ring(_cq_size, IORING_OFF_CQ_RING);
+      if(!_cq_ptr)
+        return false;
+    }
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = static_cast<io_uring_sqe *>(map_ring(_sqes_size, IORING_OFF_SQES));
+    if(!_sqes)
+      return false;
+
+    char* sq = static_cast<char*>(_sq_ptr);
+    char* cq = static_cast<char*>(_cq_ptr);
+    _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    _sq_entries = params.sq_entries;
+
+    return true;
+  }
+
+  void* map_ring(std::size_t size, off_t offset) {
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, _ring_fd, offset);
+    if(ptr == MAP_FAILED)
+      return nullptr;
+    return ptr;
+  }
+
+  int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, _ring_fd, to_submit,
+                                    min_complete, flags, nullptr, 0));
+  }
+
+  // Waits for num_completions completions. Short transfers are completed
+  // synchronously.
+  result reap(int fd, std::size_t num_completions,
+              const std::vector<io_segment> &segments, bool is_write) {
+    result res = make_success();
+    std::size_t num_reaped = 0;
+    while(num_reaped < num_completions) {
+      unsigned head = *_cq_head;
+      unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+      if(head == tail) {
+        int ret = enter(0, 1, IORING_ENTER_GETEVENTS);
+        if(ret < 0 && errno != EINTR && errno != EAGAIN) {
+          return make_error(__acpp_here(),
+                            error_info{"io_executor: io_uring_enter() failed",
+                                       error_code{"POSIX", errno}});
+        }
+        continue;
+      }
+      for(; head != tail; ++head, ++num_reaped) {
+        const io_uring_cqe& cqe = _cqes[head & *_cq_mask];
+        const io_segment& segment = segments[cqe.user_data];
+
+        if(!res.is_success())
+          continue;
+        if(cqe.res < 0) {
+          res = make_error(__acpp_here(),
+                           error_info{"io_executor: File I/O failed",
+                                      error_code{"POSIX", -cqe.res}});
+        } else if(static_cast<std::size_t>(cqe.res) < segment.size) {
+          res = transfer_synchronously(fd, segment,
+                                       static_cast<std::size_t>(cqe.res),
+                                       is_write);
+        }
+      }
+      __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+    }
+    return res;
+  }
+
+  int _ring_fd = -1;
+  unsigned _sq_entries = 0;
+
+  void* _sq_ptr = nullptr;
+  std::size_t _sq_size = 0;
+  void* _cq_ptr = nullptr;
+  std::size_t _cq_size = 0;
+  io_uring_sqe* _sqes = nullptr;
+  std::size_t _sqes_size = 0;
+
+  unsigned* _sq_tail = nullptr;
+  unsigned* _sq_mask = nullptr;
+  unsigned* _sq_array = nullptr;
+  unsigned* _cq_head = nullptr;
+  unsigned* _cq_tail = nullptr;
+  unsigned* _cq_mask = nullptr;
+  io_uring_cqe* _cqes = nullptr;
+};
+#endif
+
+std::unique_ptr<io_engine> create_io_engine() {
+#ifdef ACPP_IO_EXECUTOR_IO_URING
+  if(application::get_settings().get<setting::io_uring>()) {
+    constexpr unsigned num_ring_entries = 64;
+    auto engine = io_uring_engine::create(num_ring_entries);
+    if(engine)
+      return engine;
+  }
+#endif
+#ifndef _WIN32
+  return std::make_unique<posix_io_engine>();
+#else
+  return nullptr;
+#endif
+}
+
+// Splits the accessed region of a memory location into contiguous segments,
+// which are mapped to consecutive bytes in the file.
+std::vector<io_segment> get_segments(const memory_location &location,
+                                     range<3> num_elements,
+                                     std::size_t file_offset) {
+  std::vector<io_segment> segments;
+
+  char* base_ptr = static_cast<char*>(location.get_base_ptr());
+  std::size_t element_size = location.get_element_size();
+  range<3> shape = location.get_allocation_shape();
+  id<3> offset = location.get_access_offset();
+  std::size_t row_size = num_elements[2] * element_size;
+
+  for(std::size_t i = 0; i < num_elements[0]; ++i) {
+    for(std::size_t j = 0; j < num_elements[1]; ++j) {
+      std::size_t linear_index =
+          ((offset[0] + i) * shape[1] + offset[1] + j) * shape[2] + offset[2];
+      char* row_ptr = base_ptr + linear_index * element_size;
+
+      for(std::size_t pos = 0; pos < row_size;) {
+        std::size_t size = std::min(row_size - pos, max_segment_size);
+        if (!segments.empty() &&
+            segments.back().ptr + segments.back().size == row_ptr + pos &&
+            segments.back().size + size <= max_segment_size) {
+          segments.back().size += size;
+        } else {
+          segments.push_back(io_segment{row_ptr + pos, size, file_offset});
+        }
+        pos += size;
+        file_offset += size;
+      }
+    }
+  }
+  return segments;
+}
+
+class io_operation_dispatcher : public operation_dispatcher
+{
+public:
+  io_operation_dispatcher(io_engine* engine)
+  : _engine{engine} {}
+
+  virtual ~io_operation_dispatcher(){}
+
+  virtual result dispatch_kernel(kernel_operation */*op*/,
+                                 dag_node_ptr /*node*/) final override {
+    return unsupported_operation();
+  }
+
+  virtual result dispatch_memcpy(memcpy_operation */*op*/,
+                                 dag_node_ptr /*node*/) final override {
+    return unsupported_operation();
+  }
+
+  virtual result dispatch_prefetch(prefetch_operation */*op*/,
+                                   dag_node_ptr /*node*/) final override {
+    return unsupported_operation();
+  }
+
+  virtual result dispatch_memset(memset_operation */*op*/,
+                                 dag_node_ptr /*node*/) final override {
+    return unsupported_operation();
+  }
+
+  virtual result dispatch_file_read(file_read_operation *op,
+                                    dag_node_ptr /*node*/) final override {
+    return transfer(op->get_path(), op->dest(),
+                    op->get_num_transferred_elements(), op->get_file_offset(),
+                    false);
+  }
+
+  virtual result dispatch_file_write(file_write_operation *op,
+                                     dag_node_ptr /*node*/) final override {
+    return transfer(op->get_path(), op->source(),
+                    op->get_num_transferred_elements(), op->get_file_offset(),
+                    true);
+  }
+
+private:
+  result unsupported_operation() const {
+    return make_error(__acpp_here(),
+                      error_info{"io_executor: Only file I/O operations can be "
+                                 "executed by the io_executor",
+                                 error_type::feature_not_supported});
+  }
+
+  result transfer(const std::string &path, const memory_location &location,
+                  range<3> num_elements, std::size_t file_offset,
+                  bool is_write) {
+#ifndef _WIN32
+    if(!_engine)
+      return unsupported_operation();
+
+    int fd = is_write ? open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644)
+                      : open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+      return make_error(__acpp_here(),
+                        error_info{"io_executor: Could not open file " + path,
+                                   error_code{"POSIX", errno}});
+
+    result res = _engine->transfer(
+        fd, get_segments(location, num_elements, file_offset), is_write);
+    close(fd);
+    return res;
+#else
+    return make_error(__acpp_here(),
+                      error_info{"io_executor: File I/O is not supported on "
+                                 "this platform",
+                                 error_type::feature_not_supported});
+#endif
+  }
+
+  io_engine* _engine;
+};
+
+}
+
+io_node_event::io_node_event() {}
+
+io_node_event::~io_node_event() {}
+
+bool io_node_event::is_complete() const {
+  return _signal_channel.has_signalled();
+}
+
+void io_node_event::wait() {
+  _signal_channel.wait();
+}
+
+void io_node_event::signal() {
+  _signal_channel.signal();
+}
+
+io_executor::io_executor() {}
+
+io_executor::~io_executor() {
+  for(auto& worker : _workers)
+    worker->halt();
+}
+
+bool io_executor::is_inorder_queue() const {
+  return false;
+}
+
+bool io_executor::is_outoforder_queue() const {
+  return true;
+}
+
+bool io_executor::is_taskgraph() const {
+  return false;
+}
+
+void io_executor::submit_directly(dag_node_ptr node, operation *op,
+                                  const node_list_t &reqs) {
+  HIPSYCL_DEBUG_INFO << "io_executor: Processing node " << node.get()
+                     << " with " << reqs.size() << " non-virtual requirement(s)"
+                     << std::endl;
+
+  assert(op->is_file_io());
+
+  if(node->is_submitted())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(_workers.empty()) {
+      std::size_t num_threads = std::max(
+          std::size_t{1}, application::get_settings().get<setting::io_threads>());
+      for(std::size_t i = 0; i < num_threads; ++i) {
+        _workers.emplace_back(std::make_unique<worker_thread>());
+        _engines.emplace_back(create_io_engine());
+      }
+    }
+  }
+
+  std::size_t worker_index = select_worker();
+  io_engine* engine = _engines[worker_index].get();
+  auto evt = std::make_shared<io_node_event>();
+  node->mark_submitted(evt);
+
+  HIPSYCL_DEBUG_INFO << "io_executor: Dispatching to worker " << worker_index
+                     << ": " << dump(op) << std::endl;
+
+  (*_workers[worker_index])([node, op, reqs, evt, engine]() {
+    // I/O must not start before all operations producing or
+    // consuming the data have completed.
+    for(const auto& req : reqs)
+      req->wait();
+
+    io_operation_dispatcher dispatcher{engine};
+    result res = op->dispatch(&dispatcher, node);
+    if(!res.is_success())
+      register_error(res);
+
+    evt->signal();
+  });
+}
+
+bool io_executor::can_execute_on_device(const device_id& dev) const {
+  return dev.get_full_backend_descriptor().hw_platform ==
+         hardware_platform::cpu;
+}
+
+bool io_executor::is_submitted_by_me(dag_node_ptr node) const {
+  if(!node->is_submitted())
+    return false;
+  return node->get_assigned_executor() == this;
+}
+
+std::size_t io_executor::get_num_threads() const {
+  return _workers.size();
+}
+
+std::size_t io_executor::select_worker() const {
+  // Operations may block their worker while waiting for requirements,
+  // so prefer the worker with the least amount of queued work.
+  std::size_t selected = 0;
+  for(std::size_t i = 1; i < _workers.size(); ++i) {
+    if(_workers[i]->queue_size() < _workers[selected]->queue_size())
+      selected = i;
+  }
+  return selected;
+}
+
+}
+}
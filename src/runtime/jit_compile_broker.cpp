@@ -0,0 +1,161 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/jit_compile_broker.hpp"
+#include "hipSYCL/runtime/application.hpp"
+#include "hipSYCL/runtime/settings.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
+#include "hipSYCL/common/debug.hpp"
+#include "hipSYCL/common/filesystem.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+std::string get_lock_dir_from_settings() {
+  std::string lock_dir =
+      application::get_settings().get<setting::jit_broker_dir>();
+  if(!lock_dir.empty() &&
+     application::get_settings().get<setting::no_jit_cache_population>()) {
+    HIPSYCL_DEBUG_WARNING
+        << "jit_compile_broker: Persistent kernel cache population is "
+           "disabled, so results cannot be shared between processes. "
+           "Disabling JIT compile broker."
+        << std::endl;
+    return std::string{};
+  }
+  return lock_dir;
+}
+
+}
+
+jit_compile_broker::compile_lock::~compile_lock() {
+#ifndef _WIN32
+  if(_fd >= 0) {
+    // Remove the lock file while still holding the lock. Processes
+    // that are waiting for the lock on the removed file notice this
+    // once they obtain it, and retry with a new file.
+    unlink(_filename.c_str());
+    flock(_fd, LOCK_UN);
+    close(_fd);
+  }
+#endif
+}
+
+jit_compile_broker& jit_compile_broker::get() {
+  // Intentionally leaked, so that it outlives kernel cache users
+  // during static destruction
+  static jit_compile_broker* broker = new jit_compile_broker{};
+  return *broker;
+}
+
+jit_compile_broker::jit_compile_broker()
+: jit_compile_broker{get_lock_dir_from_settings()} {}
+
+jit_compile_broker::jit_compile_broker(const std::string& lock_dir)
+: _is_enabled{false}, _lock_dir{lock_dir} {
+  if(_lock_dir.empty())
+    return;
+#ifndef _WIN32
+  if(mkdir(_lock_dir.c_str(), 0777) != 0 && errno != EEXIST) {
+    HIPSYCL_DEBUG_WARNING << "jit_compile_broker: Could not create directory "
+                          << _lock_dir << ", disabling JIT compile broker."
+                          << std::endl;
+    return;
+  }
+  _is_enabled = true;
+  HIPSYCL_DEBUG_INFO << "jit_compile_broker: Using lock directory "
+                     << _lock_dir << std::endl;
+#else
+  HIPSYCL_DEBUG_WARNING << "jit_compile_broker: JIT compile broker is not "
+                           "supported on this platform."
+                        << std::endl;
+#endif
+}
+
+jit_compile_broker::compile_lock jit_compile_broker::lock(
+    const kernel_configuration::id_type &id_of_binary) const {
+  if(!_is_enabled)
+    return compile_lock{};
+#ifndef _WIN32
+  std::string filename = common::filesystem::join_path(
+      _lock_dir, kernel_configuration::to_string(id_of_binary) + ".lock");
+
+  bool has_waited = false;
+  for(;;) {
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if(fd < 0) {
+      HIPSYCL_DEBUG_WARNING << "jit_compile_broker: Could not open lock file "
+                            << filename << std::endl;
+      return compile_lock{};
+    }
+
+    if(flock(fd, LOCK_EX | LOCK_NB) != 0) {
+      if(!has_waited) {
+        perf_count(perf_counter_id::jit_broker_waits);
+        HIPSYCL_DEBUG_INFO << "jit_compile_broker: Waiting for other process "
+                              "compiling binary "
+                           << kernel_configuration::to_string(id_of_binary)
+                           << std::endl;
+      }
+      has_waited = true;
+      int ret = 0;
+      while((ret = flock(fd, LOCK_EX)) != 0 && errno == EINTR)
+        ;
+      if(ret != 0) {
+        close(fd);
+        return compile_lock{};
+      }
+    }
+
+    // The previous holder may have removed the file after we opened it,
+    // in which case our lock does not exclude anyone.
+    struct stat locked_file, current_file;
+    if(fstat(fd, &locked_file) == 0 && stat(filename.c_str(), &current_file) == 0 &&
+       locked_file.st_dev == current_file.st_dev &&
+       locked_file.st_ino == current_file.st_ino)
+      return compile_lock{fd, filename, has_waited};
+
+    flock(fd, LOCK_UN);
+    close(fd);
+  }
+#else
+  return compile_lock{};
+#endif
+}
+
+}
+}
@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <fstream>
+#include <iterator>
 #include <memory>
 #include <mutex>
 
@@ -252,6 +253,115 @@ hcf_cache& hcf_cache::get() {
   return c;
 }
 
+hcf_cache::hcf_cache() {
+  std::string merged_hcf =
+      application::get_settings().get<setting::merged_hcf>();
+  if(!merged_hcf.empty())
+    load_merged_hcf_object(merged_hcf);
+}
+
+void hcf_cache::load_merged_hcf_object(const std::string &filename) {
+  std::ifstream file{filename, std::ios::binary};
+  if(!file.is_open()) {
+    HIPSYCL_DEBUG_ERROR << "hcf_cache: Could not open merged HCF object "
+                        << filename << std::endl;
+    return;
+  }
+  std::string data{std::istreambuf_iterator<char>{file},
+                   std::istreambuf_iterator<char>{}};
+
+  common::hcf_container* merged_obj = new common::hcf_container{data};
+  const std::string *id_entry = merged_obj->root_node()->get_value("object-id");
+  if(!id_entry ||
+     !merged_obj->root_node()->has_subnode("merged-object-ids")) {
+    HIPSYCL_DEBUG_ERROR << "hcf_cache: " << filename
+                        << " is not a merged HCF object, ignoring it."
+                        << std::endl;
+    delete merged_obj;
+    return;
+  }
+  hcf_object_id id = std::stoull(*id_entry);
+  HIPSYCL_DEBUG_INFO << "hcf_cache: Loading merged HCF object " << id
+                     << " from " << filename << std::endl;
+
+  _hcf_objects[id] = std::unique_ptr<common::hcf_container>{merged_obj};
+  for(const auto& source_id :
+      merged_obj->root_node()->get_as_list("merged-object-ids"))
+    _merged_object_ids[std::stoull(source_id)] = id;
+
+  for_each_device_image(*merged_obj,
+                        [&](const common::hcf_container::node *image_node) {
+    for(const auto& source_id : image_node->get_as_list("source-object-ids"))
+      _merged_images_by_source[std::stoull(source_id)].push_back(image_node);
+  });
+
+  register_kernel_and_image_info(id, merged_obj);
+}
+
+void hcf_cache::register_exported_symbols(
+    hcf_object_id id, const common::hcf_container::node *image_node) {
+  for (const auto &symbol : image_node->get_as_list("exported-symbols")) {
+    auto& providers = _exported_symbol_providers[symbol];
+    // Images of merged objects may be shared by multiple registered objects
+    auto it = std::find_if(providers.begin(), providers.end(),
+                           [&](const device_image_id &img) {
+                             return img.image_node == image_node;
+                           });
+    if(it != providers.end())
+      continue;
+
+    providers.push_back(device_image_id{id, image_node});
+
+    HIPSYCL_DEBUG_INFO << "hcf_cache: Symbol " << symbol
+                       << " is registered as exported by object " << id
+                       << " and image " << image_node->node_id
+                       << " @" << image_node << std::endl;
+  }
+}
+
+void hcf_cache::register_kernel_and_image_info(
+    hcf_object_id id, const common::hcf_container *obj) {
+  // See if stored object has kernel nodes that we can parse
+  if(auto* kernels_node = obj->root_node()->get_subnode("kernels")) {
+    for(const auto& kernel_name : kernels_node->get_subnodes()) {
+      std::unique_ptr<hcf_kernel_info> kernel_info{
+          new hcf_kernel_info{id, kernels_node->get_subnode(kernel_name)}};
+      if(kernel_info->is_valid()) {
+        HIPSYCL_DEBUG_INFO << "hcf_cache: Registering kernel info for kernel "
+                           << kernel_name << " from HCF object " << id
+                           << std::endl;
+        HIPSYCL_DEBUG_INFO << "  kernel_info: hcf object id = "
+                           << kernel_info->get_hcf_object_id() << std::endl;
+        for(int i = 0; i < kernel_info->get_num_parameters(); ++i) {
+          HIPSYCL_DEBUG_INFO
+              << "  kernel_info: parameter " << i
+              << ": offset = " << kernel_info->get_argument_offset(i)
+              << " size = " << kernel_info->get_argument_size(i)
+              << " original index = "
+              << kernel_info->get_original_argument_index(i) << std::endl;
+        }
+        _hcf_kernel_info[std::make_pair(id, kernel_name)] =
+            std::move(kernel_info);
+      }
+    }
+  }
+  // Same for image nodes
+  if(auto* images_node = obj->root_node()->get_subnode("images")) {
+    for(const auto& image_name : images_node->get_subnodes()) {
+      std::unique_ptr<hcf_image_info> image_info{new hcf_image_info{
+          obj, images_node->get_subnode(image_name)}};
+      
+      if(image_info->is_valid()) {
+        HIPSYCL_DEBUG_INFO << "hcf_cache: Registering image info for image "
+                           << image_name << " from HCF object " << id
+                           << std::endl;
+        _hcf_image_info[std::make_pair(id, image_name)] =
+            std::move(image_info);
+      }
+    }
+  }
+}
+
 hcf_object_id hcf_cache::register_hcf_object(const common::hcf_container &obj) {
 
   std::lock_guard<std::mutex> lock{_mutex};
@@ -274,63 +384,28 @@ hcf_object_id hcf_cache::register_hcf_object(const common::hcf_container &obj) {
   } else {
     common::hcf_container* stored_obj = new common::hcf_container{obj};
     _hcf_objects[id] = std::unique_ptr<common::hcf_container>{stored_obj};
-    // Check if the HCF exports some symbols
-    for_each_exported_symbol_list(
-        // Don't use obj here, since we have copied it into the cache, and need
-        // to ensure that the pointers to image nodes are stable
-        *stored_obj,
-        [&](const common::hcf_container::node *image_node,
-            const std::vector<std::string> &exported_symbols) {
 
-          for (const auto &symbol : exported_symbols) {
-
-            _exported_symbol_providers[symbol].push_back(
-                device_image_id{id, image_node});
-
-            HIPSYCL_DEBUG_INFO << "hcf_cache: Symbol " << symbol
-                               << " is registered as exported by object " << id
-                               << " and image " << image_node->node_id
-                               << " @" << image_node << std::endl;
-          }
-        });
-    // See if stored object has kernel nodes that we can parse
-    if(auto* kernels_node = stored_obj->root_node()->get_subnode("kernels")) {
-      for(const auto& kernel_name : kernels_node->get_subnodes()) {
-        std::unique_ptr<hcf_kernel_info> kernel_info{
-            new hcf_kernel_info{id, kernels_node->get_subnode(kernel_name)}};
-        if(kernel_info->is_valid()) {
-          HIPSYCL_DEBUG_INFO << "hcf_cache: Registering kernel info for kernel "
-                             << kernel_name << " from HCF object " << id
-                             << std::endl;
-          HIPSYCL_DEBUG_INFO << "  kernel_info: hcf object id = "
-                             << kernel_info->get_hcf_object_id() << std::endl;
-          for(int i = 0; i < kernel_info->get_num_parameters(); ++i) {
-            HIPSYCL_DEBUG_INFO
-                << "  kernel_info: parameter " << i
-                << ": offset = " << kernel_info->get_argument_offset(i)
-                << " size = " << kernel_info->get_argument_size(i)
-                << " original index = "
-                << kernel_info->get_original_argument_index(i) << std::endl;
-          }
-          _hcf_kernel_info[std::make_pair(id, kernel_name)] =
-              std::move(kernel_info);
-        }
-      }
-    }
-    // Same for image nodes
-    if(auto* images_node = stored_obj->root_node()->get_subnode("images")) {
-      for(const auto& image_name : images_node->get_subnodes()) {
-        std::unique_ptr<hcf_image_info> image_info{new hcf_image_info{
-            stored_obj, images_node->get_subnode(image_name)}};
-        
-        if(image_info->is_valid()) {
-          HIPSYCL_DEBUG_INFO << "hcf_cache: Registering image info for image "
-                             << image_name << " from HCF object " << id
-                             << std::endl;
-          _hcf_image_info[std::make_pair(id, image_name)] =
-              std::move(image_info);
-        }
+    auto merged_id = _merged_object_ids.find(id);
+    if(merged_id != _merged_object_ids.end()) {
+      // Kernels, images and exported symbols are provided by the merged
+      // object instead.
+      HIPSYCL_DEBUG_INFO << "hcf_cache: HCF object " << id
+                         << " is part of merged HCF object "
+                         << merged_id->second << std::endl;
+      auto merged_images = _merged_images_by_source.find(id);
+      if(merged_images != _merged_images_by_source.end()) {
+        for(const auto* image_node : merged_images->second)
+          register_exported_symbols(merged_id->second, image_node);
       }
+    } else {
+      // Check if the HCF exports some symbols.
+      // Don't use obj here, since we have copied it into the cache, and need
+      // to ensure that the pointers to image nodes are stable
+      for_each_device_image(*stored_obj,
+                            [&](const common::hcf_container::node *image_node) {
+                              register_exported_symbols(id, image_node);
+                            });
+      register_kernel_and_image_info(id, stored_obj);
     }
   }
 
@@ -362,7 +437,12 @@ void hcf_cache::unregister_hcf_object(hcf_object_id id) {
   std::lock_guard<std::mutex> lock{_mutex};
 
   auto it = _hcf_objects.find(id);
-  if(it != _hcf_objects.end()) {
+  if(it != _hcf_objects.end() && _merged_object_ids.count(id)) {
+    // Objects that are part of a merged object have not registered anything
+    // themselves. Images of the merged object remain available since they are
+    // owned by the cache.
+    _hcf_objects.erase(it);
+  } else if(it != _hcf_objects.end()) {
     // First remove the HCF object as a symbol provider for runtime linking and
     // symbol resolution. This ensures that it gets no longer selected
     // for symbol resolution.
@@ -392,10 +472,17 @@ void hcf_cache::unregister_hcf_object(hcf_object_id id) {
   }
 }
 
+hcf_object_id hcf_cache::resolve_merged_object(hcf_object_id id) const {
+  auto it = _merged_object_ids.find(id);
+  if(it == _merged_object_ids.end())
+    return id;
+  return it->second;
+}
+
 const common::hcf_container* hcf_cache::get_hcf(hcf_object_id obj) const {
   std::lock_guard<std::mutex> lock{_mutex};
 
-  auto it = _hcf_objects.find(obj);
+  auto it = _hcf_objects.find(resolve_merged_object(obj));
   if(it == _hcf_objects.end())
     return nullptr;
   return it->second.get();
@@ -405,7 +492,8 @@ const hcf_kernel_info *
 hcf_cache::get_kernel_info(hcf_object_id obj,
                            const std::string &kernel_name) const {
   std::lock_guard<std::mutex> lock{_mutex};
-  auto it = _hcf_kernel_info.find(std::make_pair(obj, kernel_name));
+  auto it = _hcf_kernel_info.find(
+      std::make_pair(resolve_merged_object(obj), kernel_name));
   if(it == _hcf_kernel_info.end())
     return nullptr;
   return it->second.get();
@@ -415,7 +503,8 @@ const hcf_image_info *
 hcf_cache::get_image_info(hcf_object_id obj,
                           const std::string &image_name) const {
   std::lock_guard<std::mutex> lock{_mutex};
-  auto it = _hcf_image_info.find(std::make_pair(obj, image_name));
+  auto it = _hcf_image_info.find(
+      std::make_pair(resolve_merged_object(obj), image_name));
   if(it == _hcf_image_info.end())
     return nullptr;
   return it->second.get();
@@ -456,13 +545,19 @@ std::string kernel_cache::get_persistent_cache_file(code_object_id id_of_binary)
 }
 
 bool kernel_cache::persistent_cache_lookup(code_object_id id_of_binary,
-                                           std::string &out) const {
+                                           std::string &out,
+                                           bool count_lookup) const {
   std::string filename = get_persistent_cache_file(id_of_binary);
   std::ifstream file{filename, std::ios::in | std::ios::binary | std::ios::ate};
   
-  if(!file.is_open())
+  if(!file.is_open()) {
+    if(count_lookup)
+      perf_count(perf_counter_id::persistent_cache_misses);
     return false;
+  }
 
+  if(count_lookup)
+    perf_count(perf_counter_id::persistent_cache_hits);
   HIPSYCL_DEBUG_INFO << "kernel_cache: Persistent cache hit for id "
                      << kernel_configuration::to_string(id_of_binary)
                      << " in file " << filename << std::endl;
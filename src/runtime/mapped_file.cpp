@@ -0,0 +1,188 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/mapped_file.hpp"
+#include "hipSYCL/common/debug.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hipsycl {
+namespace rt {
+
+mapped_file::mapped_file(void *mapping_base, std::size_t mapping_size,
+                         std::size_t data_offset, std::size_t size,
+                         mapped_file_mode mode)
+    : _mapping_base{mapping_base}, _mapping_size{mapping_size},
+      _data_offset{data_offset}, _size{size}, _mode{mode} {}
+
+mapped_file::~mapped_file() {
+#ifndef _WIN32
+  if(_mapping_base && munmap(_mapping_base, _mapping_size) != 0) {
+    HIPSYCL_DEBUG_ERROR << "mapped_file: munmap() failed: "
+                        << std::strerror(errno) << std::endl;
+  }
+#endif
+}
+
+result mapped_file::map(const std::string &path, std::size_t offset,
+                        std::size_t size, mapped_file_mode mode,
+                        std::shared_ptr<mapped_file> &out) {
+#ifndef _WIN32
+  int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    return make_error(__acpp_here(),
+                      error_info{"mapped_file: Could not open file " + path,
+                                 error_code{"POSIX", errno}});
+
+  struct stat file_stat;
+  if(fstat(fd, &file_stat) != 0) {
+    int err = errno;
+    close(fd);
+    return make_error(__acpp_here(),
+                      error_info{"mapped_file: Could not stat file " + path,
+                                 error_code{"POSIX", err}});
+  }
+
+  std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+  if(offset > file_size || (size > 0 && offset + size > file_size)) {
+    close(fd);
+    return make_error(__acpp_here(),
+                      error_info{"mapped_file: Requested region exceeds size "
+                                 "of file " + path,
+                                 error_type::invalid_parameter_error});
+  }
+  if(size == 0)
+    size = file_size - offset;
+  if(size == 0) {
+    close(fd);
+    return make_error(__acpp_here(),
+                      error_info{"mapped_file: Cannot map empty region of " + path,
+                                 error_type::invalid_parameter_error});
+  }
+
+  // mmap() requires the file offset to be a multiple of the page size
+  std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  std::size_t mapping_offset = offset - offset % page_size;
+  std::size_t data_offset = offset - mapping_offset;
+  std::size_t mapping_size = size + data_offset;
+
+  int prot = PROT_READ;
+  int flags = MAP_SHARED;
+  if(mode == mapped_file_mode::private_copy_on_write) {
+    prot |= PROT_WRITE;
+    flags = MAP_PRIVATE;
+  }
+
+  void *mapping = mmap(nullptr, mapping_size, prot, flags, fd,
+                       static_cast<off_t>(mapping_offset));
+  int err = errno;
+  // The mapping remains valid after closing the file descriptor
+  close(fd);
+
+  if(mapping == MAP_FAILED)
+    return make_error(__acpp_here(),
+                      error_info{"mapped_file: mmap() failed for file " + path,
+                                 error_code{"POSIX", err}});
+
+  HIPSYCL_DEBUG_INFO << "mapped_file: Mapped " << size << " bytes of " << path
+                     << " at offset " << offset << std::endl;
+
+  out = std::shared_ptr<mapped_file>{
+      new mapped_file{mapping, mapping_size, data_offset, size, mode}};
+  return make_success();
+#else
+  return make_error(__acpp_here(),
+                    error_info{"mapped_file: Memory-mapped files are not "
+                               "supported on this platform",
+                               error_type::feature_not_supported});
+#endif
+}
+
+void* mapped_file::get_data() const {
+  return static_cast<char*>(_mapping_base) + _data_offset;
+}
+
+std::size_t mapped_file::get_size() const {
+  return _size;
+}
+
+mapped_file_mode mapped_file::get_mode() const {
+  return _mode;
+}
+
+result mapped_file::advise(std::size_t offset, std::size_t size,
+                           mapped_file_advice advice) const {
+#ifndef _WIN32
+  if(offset >= _size)
+    return make_success();
+  size = std::min(size, _size - offset);
+
+  int native_advice = MADV_NORMAL;
+  switch(advice) {
+  case mapped_file_advice::normal:
+    native_advice = MADV_NORMAL;
+    break;
+  case mapped_file_advice::sequential:
+    native_advice = MADV_SEQUENTIAL;
+    break;
+  case mapped_file_advice::random:
+    native_advice = MADV_RANDOM;
+    break;
+  case mapped_file_advice::will_need:
+    native_advice = MADV_WILLNEED;
+    break;
+  case mapped_file_advice::dont_need:
+    native_advice = MADV_DONTNEED;
+    break;
+  }
+
+  // madvise() requires page-aligned addresses
+  std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  std::size_t begin = _data_offset + offset;
+  std::size_t aligned_begin = begin - begin % page_size;
+  std::size_t length = begin + size - aligned_begin;
+
+  if (madvise(static_cast<char *>(_mapping_base) + aligned_begin, length,
+              native_advice) != 0)
+    return make_error(__acpp_here(),
+                      error_info{"mapped_file: madvise() failed",
+                                 error_code{"POSIX", errno}});
+#endif
+  return make_success();
+}
+
+}
+}
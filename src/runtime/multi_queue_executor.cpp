@@ -54,12 +54,10 @@ std::size_t determine_target_lane(dag_node_ptr node,
     return lane_range.begin;
   }
 
-  if(node->get_execution_hints().has_hint<hints::prefer_execution_lane>()) {
-    std::size_t preferred_lane = node->get_execution_hints()
-                                     .get_hint<hints::prefer_execution_lane>()
-                                     ->get_lane_id();
-    return lane_range.begin + preferred_lane % lane_range.num_lanes;
-  }
+  const execution_hints& hints = node->get_execution_hints();
+  if(hints.has_hint<hints::prefer_execution_lane>())
+    // Synchronization cost and usage are irrelevant in this case
+    return select_execution_lane(hints, nullptr, {}, lane_range);
 
   common::small_vector<int, 8> synchronization_cost(lane_range.num_lanes);
 
@@ -80,11 +78,31 @@ std::size_t determine_target_lane(dag_node_ptr node,
       }
     }
   }
+  return select_execution_lane(hints, synchronization_cost.data(),
+                               device_submission_statistics.build_decaying_bins(),
+                               lane_range);
+}
+
+} // anonymous namespace
+
+std::size_t select_execution_lane(const execution_hints &hints,
+                                  const int *synchronization_cost,
+                                  const std::vector<double> &lane_usage,
+                                  backend_execution_lane_range lane_range) {
+  if(lane_range.num_lanes <= 1) {
+    return lane_range.begin;
+  }
+
+  if(hints.has_hint<hints::prefer_execution_lane>()) {
+    std::size_t preferred_lane =
+        hints.get_hint<hints::prefer_execution_lane>()->get_lane_id();
+    return lane_range.begin + preferred_lane % lane_range.num_lanes;
+  }
+
   // Select the lane that would have the *highest* synchronization cost,
   // because by scheduling to this lane all synchronization becomes noops!
   // If there are multiple lanes with same synchronization cost,
   // use the one with lower recent utilization
-  auto lane_usage = device_submission_statistics.build_decaying_bins();
   int max_sync_cost = 0;
   double min_usage = std::numeric_limits<double>::max();
   std::size_t current_best_lane = lane_range.begin;
@@ -95,7 +113,7 @@ std::size_t determine_target_lane(dag_node_ptr node,
     int sync_cost = synchronization_cost[i-lane_range.begin];
 
     if(sync_cost > max_sync_cost) {
-      max_sync_cost = synchronization_cost[i-lane_range.begin];
+      max_sync_cost = sync_cost;
       current_best_lane = i;
       min_usage = lane_usage[i];
     } else if(sync_cost == max_sync_cost) {
@@ -109,10 +127,6 @@ std::size_t determine_target_lane(dag_node_ptr node,
   return current_best_lane;
 }
 
-
-
-} // anonymous namespace
-
 multi_queue_executor::multi_queue_executor(
     const backend &b, queue_factory_function queue_factory)
     : _backend{b.get_unique_backend_id()} {
@@ -32,6 +32,8 @@
 #include "hipSYCL/runtime/application.hpp"
 #include "hipSYCL/runtime/device_id.hpp"
 #include "hipSYCL/runtime/error.hpp"
+#include "hipSYCL/runtime/generic/host_execution_arbiter.hpp"
+#include "hipSYCL/runtime/inorder_executor.hpp"
 #include "hipSYCL/runtime/multi_queue_executor.hpp"
 #include <memory>
 
@@ -119,7 +121,12 @@ std::string omp_backend::get_name() const {
 
 std::unique_ptr<backend_executor>
 omp_backend::create_inorder_executor(device_id dev, int priority){
-  return nullptr;
+  // Queues of default priority are served by the multi_queue_executor.
+  if(priority == host_execution_arbiter::default_priority)
+    return nullptr;
+
+  return std::make_unique<inorder_executor>(
+      std::make_unique<omp_queue>(dev.get_backend(), priority));
 }
 
 }
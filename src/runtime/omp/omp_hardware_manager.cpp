@@ -32,6 +32,7 @@
 #include "hipSYCL/runtime/omp/omp_hardware_manager.hpp"
 #include "hipSYCL/runtime/error.hpp"
 #include "hipSYCL/runtime/device_id.hpp"
+#include "hipSYCL/runtime/generic/host_core_partitioner.hpp"
 
 namespace hipsycl {
 namespace rt {
@@ -46,7 +47,9 @@ bool omp_hardware_context::is_gpu() const {
 }
 
 std::size_t omp_hardware_context::get_max_kernel_concurrency() const {
-  return 1;
+  // Concurrent kernels only make sense if they do not compete
+  // for the same cores.
+  return host_core_partitioner::get().get_max_concurrent_kernels();
 }
   
 // TODO We could actually copy have more memcpy concurrency
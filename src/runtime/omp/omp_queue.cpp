@@ -33,6 +33,9 @@
 #include "hipSYCL/runtime/error.hpp"
 #include "hipSYCL/runtime/event.hpp"
 #include "hipSYCL/runtime/generic/async_worker.hpp"
+#include "hipSYCL/runtime/generic/host_core_partitioner.hpp"
+#include "hipSYCL/runtime/generic/host_execution_arbiter.hpp"
+#include "hipSYCL/runtime/generic/thread_affinity.hpp"
 #include "hipSYCL/runtime/hints.hpp"
 #include "hipSYCL/runtime/inorder_queue.hpp"
 #include "hipSYCL/runtime/instrumentation.hpp"
@@ -47,18 +50,14 @@
 #include "hipSYCL/compiler/llvm-to-backend/host/LLVMToHostFactory.hpp"
 #include "hipSYCL/runtime/kernel_configuration.hpp"
 #include "hipSYCL/glue/llvm-sscp/jit.hpp"
+#include "hipSYCL/glue/generic/host/local_memory_arena.hpp"
 #include "hipSYCL/runtime/adaptivity_engine.hpp"
 #include "hipSYCL/runtime/omp/omp_code_object.hpp"
-
-#ifndef WIN32
-#include <unistd.h>
-#else
-#include <Windows.h>
-#endif
 #endif
 
 #include <omp.h>
 
+#include <algorithm>
 #include <memory>
 
 namespace hipsycl {
@@ -192,16 +191,6 @@ private:
 
 #ifdef HIPSYCL_WITH_SSCP_COMPILER
 
-std::size_t get_page_size() {
-#ifndef WIN32
-  return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
-#else
-  SYSTEM_INFO si;
-  GetSystemInfo(&si);
-  return si.dwPageSize;
-#endif
-}
-
 result
 launch_kernel_from_so(omp_sscp_executable_object::omp_sscp_kernel *kernel,
                       const rt::range<3> &num_groups,
@@ -220,38 +209,68 @@ launch_kernel_from_so(omp_sscp_executable_object::omp_sscp_kernel *kernel,
                         << std::endl;
 #endif
 
+  // If the kernel can be preempted by work of higher priority or needs to
+  // adapt to concurrent kernels, the slowest dimension is split into chunks.
+  const std::size_t work_per_slice =
+      num_groups.get(1) * num_groups.get(0) * local_size.size();
+  host_core_partition partition{num_groups.size(), local_size.size()};
+  for_each_preemptible_chunk(
+      num_groups.get(2), work_per_slice,
+      [&](std::size_t k_begin, std::size_t k_end) {
 #ifdef _OPENMP
-#pragma omp parallel
+    const int num_threads = partition.is_active() ? partition.get_num_threads()
+                                                  : omp_get_max_threads();
+#pragma omp parallel num_threads(num_threads)
 #endif
-  {
-    // get page aligned local memory from heap
-    static thread_local std::vector<char> local_memory;
-
-    const auto page_size = get_page_size();
-    local_memory.resize(shared_memory + page_size);
-    auto aligned_local_memory = reinterpret_cast<void*>(next_multiple_of(reinterpret_cast<std::uint64_t>(local_memory.data()), page_size));
+    {
+#ifdef _OPENMP
+      if(partition.is_active())
+        thread_affinity::get().pin_kernel_thread_to_core(
+            partition.get_core(omp_get_thread_num()));
+      else
+        thread_affinity::get().pin_kernel_thread(omp_get_thread_num());
+#endif
+      // page aligned local memory, reused across launches
+      void *aligned_local_memory =
+          glue::host::local_memory_arena::get().acquire(shared_memory, 0)
+              .local_memory;
 
 #ifdef _OPENMP
 #pragma omp for collapse(3)
 #endif
-    for (std::size_t k = 0; k < num_groups.get(2); ++k) {
-      for (std::size_t j = 0; j < num_groups.get(1); ++j) {
-        for (std::size_t i = 0; i < num_groups.get(0); ++i) {
-          omp_sscp_executable_object::work_group_info info{
-              num_groups, rt::id<3>{i, j, k}, local_size, aligned_local_memory};
-          kernel(&info, kernel_args);
+      for (std::size_t k = k_begin; k < k_end; ++k) {
+        for (std::size_t j = 0; j < num_groups.get(1); ++j) {
+          for (std::size_t i = 0; i < num_groups.get(0); ++i) {
+            omp_sscp_executable_object::work_group_info info{
+                num_groups, rt::id<3>{i, j, k}, local_size, aligned_local_memory};
+            kernel(&info, kernel_args);
+          }
         }
       }
     }
-  }
+  });
   return make_success();
 }
 #endif
 } // namespace
 
-omp_queue::omp_queue(backend_id id)
-    : _backend_id(id), _sscp_code_object_invoker{this},
-      _kernel_cache{kernel_cache::get()} {}
+omp_queue::omp_queue(backend_id id, int priority)
+    : _backend_id(id), _priority{priority}, _sscp_code_object_invoker{this},
+      _kernel_cache{kernel_cache::get()} {
+  if(priority != host_execution_arbiter::default_priority)
+    host_execution_arbiter::get().register_priority(priority);
+#ifdef _OPENMP
+  // If helper threads are isolated, the kernel team must not be
+  // larger than the number of cores that remain for kernels.
+  const thread_affinity& affinity = thread_affinity::get();
+  if(affinity.is_isolation_enabled()) {
+    int num_kernel_cores = static_cast<int>(affinity.get_kernel_cores().size());
+    _worker([num_kernel_cores]() {
+      omp_set_num_threads(std::min(omp_get_max_threads(), num_kernel_cores));
+    });
+  }
+#endif
+}
 
 omp_queue::~omp_queue() { _worker.halt(); }
 
@@ -391,12 +410,24 @@ result omp_queue::submit_kernel(kernel_operation &op, dag_node_ptr node) {
   const kernel_configuration *config =
       &(op.get_launcher().get_kernel_configuration());
 
+  // Custom operations may wait for work on other queues, so they
+  // must not occupy the host_execution_arbiter.
+  bool is_arbitrated = launcher->get_kernel_type() != kernel_type::custom;
+  int priority = _priority;
+
   omp_instrumentation_setup instrumentation_setup{op, node};
-  _worker([=]() {
+  // The launcher and configuration are owned by the node. Instantly
+  // submitted nodes are not kept alive by the DAG, so the task has to.
+  _worker([=, node_owner = node]() {
     auto instrumentation_guard = instrumentation_setup.instrument_task();
 
     HIPSYCL_DEBUG_INFO << "omp_queue [async]: Invoking kernel!" << std::endl;
-    launcher->invoke(node_ptr, *config);
+    if(is_arbitrated) {
+      host_execution_guard execution_guard{priority};
+      launcher->invoke(node_ptr, *config);
+    } else {
+      launcher->invoke(node_ptr, *config);
+    }
   });
 
   return make_success();
@@ -442,7 +473,8 @@ result omp_queue::submit_sscp_kernel_from_code_object(
       kernel_base_config_parameter::compilation_flow,
       compilation_flow::sscp);
   config.append_base_configuration(
-      kernel_base_config_parameter::hcf_object_id, hcf_object);
+      kernel_base_config_parameter::hcf_object_id,
+      kernel_info->get_hcf_object_id());
 
   auto binary_configuration_id =
       adaptivity_engine.finalize_binary_configuration(config);
@@ -176,5 +176,55 @@ const memory_location& memcpy_operation::dest() const { return _dest; }
 
 bool memcpy_operation::is_data_transfer() const { return true; }
 
+file_read_operation::file_read_operation(const std::string &path,
+                                         std::size_t file_offset,
+                                         const memory_location &dest,
+                                         range<3> num_elements)
+    : _path{path}, _file_offset{file_offset}, _dest{dest},
+      _num_elements{num_elements} {}
+
+const std::string &file_read_operation::get_path() const { return _path; }
+
+std::size_t file_read_operation::get_file_offset() const {
+  return _file_offset;
+}
+
+const memory_location &file_read_operation::dest() const { return _dest; }
+
+std::size_t file_read_operation::get_num_transferred_bytes() const {
+  return _dest.get_element_size() * _num_elements.size();
+}
+
+range<3> file_read_operation::get_num_transferred_elements() const {
+  return _num_elements;
+}
+
+bool file_read_operation::is_file_io() const { return true; }
+
+file_write_operation::file_write_operation(const memory_location &source,
+                                           range<3> num_elements,
+                                           const std::string &path,
+                                           std::size_t file_offset)
+    : _source{source}, _num_elements{num_elements}, _path{path},
+      _file_offset{file_offset} {}
+
+const std::string &file_write_operation::get_path() const { return _path; }
+
+std::size_t file_write_operation::get_file_offset() const {
+  return _file_offset;
+}
+
+const memory_location &file_write_operation::source() const { return _source; }
+
+std::size_t file_write_operation::get_num_transferred_bytes() const {
+  return _source.get_element_size() * _num_elements.size();
+}
+
+range<3> file_write_operation::get_num_transferred_elements() const {
+  return _num_elements;
+}
+
+bool file_write_operation::is_file_io() const { return true; }
+
 }
 }
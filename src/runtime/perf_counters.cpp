@@ -0,0 +1,209 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/perf_counters.hpp"
+#include "hipSYCL/runtime/application.hpp"
+#include "hipSYCL/runtime/settings.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+struct builtin_counter_description {
+  perf_counter_id id;
+  const char* name;
+  const char* description;
+  perf_counter_kind kind;
+};
+
+constexpr builtin_counter_description builtin_counters[] = {
+    {perf_counter_id::dag_nodes_submitted, "dag.nodes_submitted",
+     "DAG nodes (operations and requirements) submitted for execution",
+     perf_counter_kind::sum},
+    {perf_counter_id::dag_nodes_coalesced, "dag.nodes_coalesced",
+     "DAG nodes whose data accesses were coalesced into a later node "
+     "that subsumes them",
+     perf_counter_kind::sum},
+    {perf_counter_id::dag_requirements_elided, "dag.requirements_elided",
+     "Memory requirements that were satisfied without any data transfer",
+     perf_counter_kind::sum},
+    {perf_counter_id::dag_flushes, "dag.flushes",
+     "Number of DAG flushes that submitted at least one node",
+     perf_counter_kind::sum},
+    {perf_counter_id::dag_flushes_idle, "dag.flushes_idle",
+     "Adaptive DAG flushes because previously flushed work had completed",
+     perf_counter_kind::sum},
+    {perf_counter_id::dag_flushes_batch_full, "dag.flushes_batch_full",
+     "Adaptive DAG flushes because the current batch size was reached",
+     perf_counter_kind::sum},
+    {perf_counter_id::dag_flushes_latency_bound, "dag.flushes_latency_bound",
+     "Adaptive DAG flushes because nodes exceeded the maximum flush latency",
+     perf_counter_kind::sum},
+    {perf_counter_id::dag_flush_batch_size_max, "dag.flush_batch_size_max",
+     "Largest batch size used by the adaptive DAG flush policy",
+     perf_counter_kind::high_water_mark},
+    {perf_counter_id::dag_gc_passes, "dag.gc_passes",
+     "Garbage collection passes over submitted DAG nodes",
+     perf_counter_kind::sum},
+    {perf_counter_id::data_users_max, "data.users_max",
+     "Largest number of users tracked for a single data region",
+     perf_counter_kind::high_water_mark},
+    {perf_counter_id::memcpy_bytes, "memcpy.bytes",
+     "Total bytes transferred by memcpy operations",
+     perf_counter_kind::sum},
+    {perf_counter_id::allocated_bytes, "allocator.bytes",
+     "Bytes allocated by the runtime for buffers and USM pools",
+     perf_counter_kind::sum},
+    {perf_counter_id::jit_compilations, "kernel_cache.jit_compilations",
+     "Kernels that were JIT-compiled", perf_counter_kind::sum},
+    {perf_counter_id::persistent_cache_hits, "kernel_cache.persistent_hits",
+     "JIT binaries loaded from the persistent kernel cache",
+     perf_counter_kind::sum},
+    {perf_counter_id::persistent_cache_misses,
+     "kernel_cache.persistent_misses",
+     "JIT binaries not found in the persistent kernel cache",
+     perf_counter_kind::sum},
+    {perf_counter_id::jit_broker_waits, "kernel_cache.jit_broker_waits",
+     "JIT compilations that waited for another process compiling the "
+     "same binary",
+     perf_counter_kind::sum},
+    {perf_counter_id::worker_queue_depth_max, "worker.queue_depth_max",
+     "Largest number of pending tasks in a runtime worker thread",
+     perf_counter_kind::high_water_mark},
+    {perf_counter_id::usm_hazard_dependencies, "dag.usm_hazard_dependencies",
+     "Dependencies derived automatically from conflicting USM accesses",
+     perf_counter_kind::sum}};
+
+static_assert(std::size(builtin_counters) ==
+                  static_cast<int>(perf_counter_id::num_builtin_counters),
+              "Not all builtin performance counters are described");
+
+}
+
+perf_counter::perf_counter(const std::string &name,
+                           const std::string &description,
+                           perf_counter_kind kind)
+    : _name{name}, _description{description}, _kind{kind} {}
+
+std::size_t perf_counter::get_thread_shard_index() noexcept {
+  static std::atomic<std::size_t> next_index = 0;
+  thread_local std::size_t index =
+      next_index.fetch_add(1, std::memory_order_relaxed) % num_shards;
+  return index;
+}
+
+uint64_t perf_counter::read() const noexcept {
+  uint64_t result = 0;
+  for(const auto& s : _shards) {
+    uint64_t v = s.value.load(std::memory_order_relaxed);
+    if(_kind == perf_counter_kind::sum)
+      result += v;
+    else
+      result = std::max(result, v);
+  }
+  return result;
+}
+
+void perf_counter::reset() noexcept {
+  for(auto& s : _shards)
+    s.value.store(0, std::memory_order_relaxed);
+}
+
+perf_counter_registry& perf_counter_registry::get() {
+  // Intentionally leaked, so that counters remain usable
+  // regardless of static destruction order.
+  static perf_counter_registry* registry = new perf_counter_registry{};
+  return *registry;
+}
+
+perf_counter_registry::perf_counter_registry() {
+  for(const auto& c : builtin_counters)
+    _builtin_counters[static_cast<int>(c.id)] =
+        &register_counter(c.name, c.description, c.kind);
+}
+
+perf_counter &perf_counter_registry::register_counter(
+    const std::string &name, const std::string &description,
+    perf_counter_kind kind) {
+  perf_counter& c = _counters.emplace_back(name, description, kind);
+  _counters_by_name[name] = &c;
+  return c;
+}
+
+perf_counter &
+perf_counter_registry::get_or_create(const std::string &name,
+                                     const std::string &description,
+                                     perf_counter_kind kind) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto it = _counters_by_name.find(name);
+  if(it != _counters_by_name.end())
+    return *(it->second);
+  return register_counter(name, description, kind);
+}
+
+std::vector<perf_counter_value> perf_counter_registry::read_all() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  std::vector<perf_counter_value> result;
+  result.reserve(_counters.size());
+  for(const auto& c : _counters)
+    result.push_back(perf_counter_value{c.get_name(), c.get_description(),
+                                        c.get_kind(), c.read()});
+  return result;
+}
+
+void perf_counter_registry::reset_all() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  for(auto& c : _counters)
+    c.reset();
+}
+
+void perf_counter_registry::dump(std::ostream& ostr) const {
+  std::vector<perf_counter_value> values = read_all();
+  std::size_t name_width = 0;
+  for(const auto& v : values)
+    name_width = std::max(name_width, v.name.size());
+
+  ostr << "***************** AdaptiveCpp performance counters *****************\n";
+  for(const auto& v : values) {
+    ostr << std::left << std::setw(name_width + 2) << v.name << v.value
+         << "\n";
+  }
+  ostr << std::flush;
+}
+
+void perf_counter_registry::on_runtime_shutdown() const {
+  if(application::get_settings().get<setting::dump_perf_counters>())
+    dump(std::cerr);
+}
+
+}
+}
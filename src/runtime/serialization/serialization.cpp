@@ -156,6 +156,20 @@ void memset_operation::dump(std::ostream &ostr, int indentation) const {
        << static_cast<int>(get_pattern());
 }
 
+void file_read_operation::dump(std::ostream &ostr, int indentation) const {
+  ostr << get_indentation(indentation);
+  ostr << "File read: " << _path << " @" << _file_offset << "-->";
+  _dest.dump(ostr); // Memory location
+  ostr << _num_elements;
+}
+
+void file_write_operation::dump(std::ostream &ostr, int indentation) const {
+  ostr << get_indentation(indentation);
+  ostr << "File write: ";
+  _source.dump(ostr); // Memory location
+  ostr << _num_elements << "-->" << _path << " @" << _file_offset;
+}
+
 void memory_location::dump(std::ostream &ostr) const {
   _dev.dump(ostr);
   ostr << " #" << _element_size << " " << _offset << "+" << _allocation_shape;
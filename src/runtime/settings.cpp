@@ -213,5 +213,17 @@ std::istream &operator>>(std::istream &istr, default_selector_behavior& out) {
   return istr;
 }
 
+std::istream &operator>>(std::istream &istr, dag_flush_policy& out) {
+  std::string str;
+  istr >> str;
+  if (str == "fixed")
+    out = dag_flush_policy::fixed;
+  else if (str == "adaptive")
+    out = dag_flush_policy::adaptive;
+  else
+    istr.setstate(std::ios_base::failbit);
+  return istr;
+}
+
 }
 }
\ No newline at end of file
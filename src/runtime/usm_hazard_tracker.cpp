@@ -0,0 +1,219 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hipSYCL/runtime/usm_hazard_tracker.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
+#include "hipSYCL/common/debug.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace hipsycl {
+namespace rt {
+
+usm_allocation_registry& usm_allocation_registry::get() {
+  // Intentionally leaked, so that USM memory can still be freed
+  // during static destruction
+  static usm_allocation_registry* registry = new usm_allocation_registry{};
+  return *registry;
+}
+
+void usm_allocation_registry::enable() {
+  _is_enabled.store(true, std::memory_order_relaxed);
+}
+
+void usm_allocation_registry::register_allocation(const void *ptr,
+                                                  std::size_t num_bytes) {
+  if(!ptr || !is_enabled())
+    return;
+  std::lock_guard<std::mutex> lock{_mutex};
+  // Addresses might be reused by pools without an intermediate
+  // unregister_allocation(), so overwrite existing entries.
+  _allocations[reinterpret_cast<uint64_t>(ptr)] = num_bytes;
+}
+
+void usm_allocation_registry::unregister_allocation(const void *ptr) {
+  if(!ptr || !is_enabled())
+    return;
+  std::lock_guard<std::mutex> lock{_mutex};
+  _allocations.erase(reinterpret_cast<uint64_t>(ptr));
+}
+
+bool usm_allocation_registry::find_allocation(const void *ptr, uint64_t &base,
+                                              std::size_t &num_bytes) const {
+  uint64_t address = reinterpret_cast<uint64_t>(ptr);
+
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto it = _allocations.upper_bound(address);
+  if(it == _allocations.begin())
+    return false;
+  --it;
+  // Treat zero-sized allocations as containing their base address
+  if(address != it->first && address - it->first >= it->second)
+    return false;
+
+  base = it->first;
+  num_bytes = it->second;
+  return true;
+}
+
+void usm_hazard_tracker::resolve_accesses(
+    const std::vector<usm_access> &accesses, std::vector<usm_user> &out) {
+  auto& registry = usm_allocation_registry::get();
+
+  auto resolve_allocation = [&](const void *ptr, uint64_t &begin,
+                                uint64_t &end) {
+    std::size_t allocation_size = 0;
+    if(!registry.find_allocation(ptr, begin, allocation_size))
+      return false;
+    end = begin + std::max(allocation_size, std::size_t{1});
+    return true;
+  };
+
+  for(const auto& access : accesses) {
+    if(access.is_introspected)
+      continue;
+
+    usm_user u;
+    u.is_write = access.mode != sycl::access::mode::read;
+    if(access.num_bytes > 0) {
+      u.begin = reinterpret_cast<uint64_t>(access.ptr);
+      u.end = u.begin + access.num_bytes;
+    } else if(!resolve_allocation(access.ptr, u.begin, u.end)) {
+      // Unknown extent - conservatively assume that all memory is accessed
+      u.begin = 0;
+      u.end = std::numeric_limits<uint64_t>::max();
+    }
+    out.push_back(u);
+  }
+
+  const std::size_t num_declared = out.size();
+  for(const auto& access : accesses) {
+    if(!access.is_introspected)
+      continue;
+
+    usm_user u;
+    u.is_write = access.mode != sycl::access::mode::read;
+    // The address range that an explicit declaration must overlap
+    // to supersede this access
+    uint64_t declared_begin = 0;
+    uint64_t declared_end = 0;
+    if(resolve_allocation(access.ptr, u.begin, u.end)) {
+      declared_begin = u.begin;
+      declared_end = u.end;
+    } else {
+      // The pointer might point to host data or buffer accessor internals,
+      // but also into a USM allocation that was made before the registry
+      // was enabled. Since we cannot tell, serialize against everything.
+      static std::atomic<bool> was_warned = false;
+      if(!was_warned.exchange(true, std::memory_order_relaxed)) {
+        HIPSYCL_DEBUG_WARNING
+            << "usm_hazard_tracker: Kernel argument " << access.ptr
+            << " does not point into a known USM allocation, assuming that "
+               "all memory is accessed. Allocate memory after constructing "
+               "the queue or declare accesses explicitly to avoid this."
+            << std::endl;
+      }
+      u.begin = 0;
+      u.end = std::numeric_limits<uint64_t>::max();
+      declared_begin = reinterpret_cast<uint64_t>(access.ptr);
+      declared_end = declared_begin + 1;
+    }
+
+    bool is_declared = false;
+    for(std::size_t i = 0; i < num_declared; ++i) {
+      if(out[i].begin < declared_end && declared_begin < out[i].end)
+        is_declared = true;
+    }
+    if(!is_declared)
+      out.push_back(u);
+  }
+}
+
+void usm_hazard_tracker::add_hazard_dependencies(
+    const std::vector<usm_user> &new_users, requirements_list &reqs) {
+  for(const auto& access : new_users) {
+    for(const auto& u : _users) {
+      if(!access.is_write && !u.is_write)
+        continue;
+      if(u.end <= access.begin || access.end <= u.begin)
+        continue;
+
+      dag_node_ptr node = u.user.lock();
+      if(!node || node->is_known_complete())
+        continue;
+
+      const node_list_t& existing_reqs = reqs.get();
+      if (std::find(existing_reqs.begin(), existing_reqs.end(), node) ==
+          existing_reqs.end()) {
+        reqs.add_node_requirement(node);
+        perf_count(perf_counter_id::usm_hazard_dependencies);
+      }
+    }
+  }
+}
+
+void usm_hazard_tracker::register_users(std::vector<usm_user> &new_users,
+                                        const dag_node_ptr &node) {
+  if(!node)
+    return;
+
+  release_dead_users();
+
+  for(auto& new_user : new_users) {
+    new_user.user = node;
+
+    if(new_user.is_write) {
+      // The new node depends on all previous users of the range it writes,
+      // so these users no longer need to be considered individually.
+      _users.erase(std::remove_if(_users.begin(), _users.end(),
+                                  [&](const usm_user &u) {
+                                    return u.begin >= new_user.begin &&
+                                           u.end <= new_user.end;
+                                  }),
+                   _users.end());
+    }
+    _users.push_back(new_user);
+  }
+}
+
+std::size_t usm_hazard_tracker::get_num_tracked_users() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _users.size();
+}
+
+void usm_hazard_tracker::release_dead_users() {
+  _users.erase(std::remove_if(_users.begin(), _users.end(),
+                              [](const usm_user &u) {
+                                dag_node_ptr node = u.user.lock();
+                                return !node || node->is_known_complete();
+                              }),
+               _users.end());
+}
+
+}
+}
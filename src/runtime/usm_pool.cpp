@@ -0,0 +1,279 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "hipSYCL/runtime/usm_pool.hpp"
+#include "hipSYCL/runtime/runtime.hpp"
+#include "hipSYCL/runtime/application.hpp"
+#include "hipSYCL/runtime/settings.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
+#include "hipSYCL/common/debug.hpp"
+
+namespace hipsycl {
+namespace rt {
+
+namespace {
+
+constexpr std::size_t min_block_size = 256;
+// Allocations larger than this are rounded to multiples of it
+// instead of powers of two to limit internal fragmentation.
+constexpr std::size_t large_block_granularity = 2 * 1024 * 1024;
+
+}
+
+usm_pool::usm_pool(runtime *rt, backend_allocator *allocator,
+                   usm_pool_memory_kind kind, std::size_t max_cached_bytes)
+    : _rt{rt}, _allocator{allocator}, _kind{kind},
+      _max_cached_bytes{max_cached_bytes} {}
+
+usm_pool::~usm_pool() {
+  // The runtime waits for all operations before destroying the pools,
+  // so all dependencies have completed at this point.
+  for(auto& entry : _cached_blocks)
+    _allocator->free(entry.second.ptr);
+  if(!_allocations_in_use.empty()) {
+    HIPSYCL_DEBUG_WARNING << "usm_pool: " << _allocations_in_use.size()
+                          << " allocations were never freed" << std::endl;
+  }
+}
+
+std::size_t usm_pool::get_block_size(std::size_t bytes) {
+  if(bytes <= min_block_size)
+    return min_block_size;
+  if(bytes > large_block_granularity)
+    return (bytes + large_block_granularity - 1) / large_block_granularity *
+           large_block_granularity;
+
+  std::size_t block_size = min_block_size;
+  while(block_size < bytes)
+    block_size *= 2;
+  return block_size;
+}
+
+void* usm_pool::allocate_from_backend(std::size_t block_size) {
+  perf_count(perf_counter_id::allocated_bytes, block_size);
+  if(_kind == usm_pool_memory_kind::device)
+    return _allocator->allocate(0, block_size);
+  else if(_kind == usm_pool_memory_kind::shared)
+    return _allocator->allocate_usm(block_size);
+  else
+    return _allocator->allocate_optimized_host(0, block_size);
+}
+
+bool usm_pool::is_reusable(const cached_block &block,
+                           std::size_t stream) const {
+  // Operations on the same in-order stream are ordered after
+  // everything that might still use the block.
+  if(stream != no_stream && block.stream == stream)
+    return true;
+
+  for(const auto& dep : block.dependencies)
+    if(!dep->is_complete())
+      return false;
+  return true;
+}
+
+void* usm_pool::allocate(std::size_t bytes, std::size_t stream) {
+  std::size_t block_size = get_block_size(bytes);
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    ++_stats.num_allocations;
+
+    auto candidates = _cached_blocks.equal_range(block_size);
+    for(auto it = candidates.first; it != candidates.second; ++it) {
+      if(is_reusable(it->second, stream)) {
+        void* ptr = it->second.ptr;
+        _cached_blocks.erase(it);
+
+        _allocations_in_use[ptr] = block_size;
+        _stats.bytes_cached -= block_size;
+        _stats.bytes_in_use += block_size;
+        ++_stats.num_reused_allocations;
+        return ptr;
+      }
+    }
+  }
+
+  void* ptr = allocate_from_backend(block_size);
+  if(!ptr) {
+    HIPSYCL_DEBUG_INFO << "usm_pool: Backend allocation of " << block_size
+                       << " bytes failed, releasing cached memory and retrying"
+                       << std::endl;
+    if(trim(true) > 0)
+      ptr = allocate_from_backend(block_size);
+  }
+  if(!ptr)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock{_mutex};
+  _allocations_in_use[ptr] = block_size;
+  _stats.bytes_in_use += block_size;
+  ++_stats.num_backend_allocations;
+  update_peak();
+  return ptr;
+}
+
+bool usm_pool::free(void *ptr, const std::vector<dag_node_ptr> &dependencies,
+                    std::size_t stream) {
+  bool exceeds_cache_limit = false;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto it = _allocations_in_use.find(ptr);
+    if(it == _allocations_in_use.end())
+      return false;
+
+    std::size_t block_size = it->second;
+    _allocations_in_use.erase(it);
+
+    _cached_blocks.emplace(block_size,
+                           cached_block{ptr, dependencies, stream});
+    _stats.bytes_in_use -= block_size;
+    _stats.bytes_cached += block_size;
+    exceeds_cache_limit = _stats.bytes_cached > _max_cached_bytes;
+  }
+  if(exceeds_cache_limit)
+    trim(false);
+  return true;
+}
+
+bool usm_pool::owns(const void* ptr) const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _allocations_in_use.find(ptr) != _allocations_in_use.end();
+}
+
+std::size_t usm_pool::trim(bool wait) {
+  std::vector<cached_block> blocks_to_release;
+  std::vector<std::size_t> block_sizes;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    for(auto it = _cached_blocks.begin(); it != _cached_blocks.end();) {
+      if(wait || is_reusable(it->second, no_stream)) {
+        block_sizes.push_back(it->first);
+        blocks_to_release.push_back(std::move(it->second));
+        _stats.bytes_cached -= it->first;
+        it = _cached_blocks.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if(!blocks_to_release.empty())
+      ++_stats.num_trims;
+  }
+
+  if(wait) {
+    bool requires_flush = false;
+    for(const auto& block : blocks_to_release)
+      for(const auto& dep : block.dependencies)
+        if(!dep->is_submitted())
+          requires_flush = true;
+    if(requires_flush)
+      _rt->dag().flush_sync();
+    for(const auto& block : blocks_to_release)
+      for(const auto& dep : block.dependencies)
+        dep->wait();
+  }
+
+  std::size_t released_bytes = 0;
+  for(std::size_t i = 0; i < blocks_to_release.size(); ++i) {
+    _allocator->free(blocks_to_release[i].ptr);
+    released_bytes += block_sizes[i];
+  }
+
+  if(released_bytes > 0) {
+    HIPSYCL_DEBUG_INFO << "usm_pool: Released " << released_bytes
+                       << " bytes of cached memory" << std::endl;
+  }
+  return released_bytes;
+}
+
+usm_pool_statistics usm_pool::get_statistics() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _stats;
+}
+
+usm_pool_memory_kind usm_pool::get_memory_kind() const {
+  return _kind;
+}
+
+void usm_pool::update_peak() {
+  _stats.peak_bytes_reserved = std::max(
+      _stats.peak_bytes_reserved, _stats.bytes_in_use + _stats.bytes_cached);
+}
+
+usm_pool_manager::usm_pool_manager(runtime* rt)
+: _rt{rt} {}
+
+usm_pool *usm_pool_manager::get_pool(backend_allocator *allocator,
+                                     device_id dev,
+                                     usm_pool_memory_kind kind,
+                                     std::size_t context) {
+  std::lock_guard<std::mutex> lock{_mutex};
+  for(auto& entry : _pools)
+    if(entry.dev == dev && entry.kind == kind && entry.context == context)
+      return entry.pool.get();
+
+  std::size_t max_cached_bytes =
+      application::get_settings().get<setting::usm_pool_max_cached_bytes>();
+  _pools.push_back(pool_entry{
+      dev, kind, context,
+      std::make_unique<usm_pool>(_rt, allocator, kind, max_cached_bytes)});
+  return _pools.back().pool.get();
+}
+
+usm_pool* usm_pool_manager::find_owning_pool(const void* ptr) const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  for(auto& entry : _pools)
+    if(entry.pool->owns(ptr))
+      return entry.pool.get();
+  return nullptr;
+}
+
+std::vector<usm_pool*> usm_pool_manager::get_pools(device_id dev) const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  std::vector<usm_pool*> result;
+  for(auto& entry : _pools)
+    if(entry.dev == dev)
+      result.push_back(entry.pool.get());
+  return result;
+}
+
+std::size_t usm_pool_manager::trim(bool wait) {
+  std::vector<usm_pool*> pools;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    for(auto& entry : _pools)
+      pools.push_back(entry.pool.get());
+  }
+  std::size_t released_bytes = 0;
+  for(auto* pool : pools)
+    released_bytes += pool->trim(wait);
+  return released_bytes;
+}
+
+}
+}
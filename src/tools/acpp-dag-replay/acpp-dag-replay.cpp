@@ -0,0 +1,585 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hipSYCL/runtime/dag.hpp"
+#include "hipSYCL/runtime/dag_builder.hpp"
+#include "hipSYCL/runtime/dag_node.hpp"
+#include "hipSYCL/runtime/dag_trace.hpp"
+#include "hipSYCL/runtime/data.hpp"
+#include "hipSYCL/runtime/hints.hpp"
+#include "hipSYCL/runtime/multi_queue_executor.hpp"
+#include "hipSYCL/runtime/operations.hpp"
+
+using namespace hipsycl;
+
+void help() {
+  std::cout <<
+  "Usage: acpp-dag-replay [options] <trace-file>\n" <<
+  "Replays a DAG trace recorded with ACPP_RT_DAG_TRACE_FILE through the DAG\n" <<
+  "builder and simulates its execution on mock devices. No devices are required.\n" <<
+  "  --batch-size <n>: Number of operations per DAG flush (default: 100)\n" <<
+  "  --kernel-lanes <n>: Simulated kernel lanes per device (default: 2)\n" <<
+  "  --memcpy-lanes <n>: Simulated memcpy lanes per device (default: 2)\n" <<
+  "  --default-duration <ns>: Duration of operations that were recorded\n" <<
+  "                           without timing information (default: 10000)\n" <<
+  "  --ignore-submission-times: Make all operations available for execution\n" <<
+  "                             immediately instead of at their recorded\n" <<
+  "                             submission time\n" <<
+  "  --top <n>: Number of kernels to list in the report (default: 10)" << std::endl;
+}
+
+struct replay_options {
+  std::size_t batch_size = 100;
+  std::size_t kernel_lanes = 2;
+  std::size_t memcpy_lanes = 2;
+  uint64_t default_duration = 10000;
+  bool ignore_submission_times = false;
+  std::size_t num_top_kernels = 10;
+  std::string filename;
+};
+
+// Stands in for the recorded operation when rebuilding the DAG
+class replay_operation : public rt::operation {
+public:
+  replay_operation(const rt::dag_trace_record& record)
+  : _record{record} {}
+
+  virtual bool is_data_transfer() const override {
+    return _record.kind == rt::dag_trace_operation_kind::memcpy;
+  }
+
+  virtual bool is_file_io() const override {
+    return _record.kind == rt::dag_trace_operation_kind::file_io;
+  }
+
+  virtual void dump(std::ostream& ostr, int indentation = 0) const override {
+    ostr << std::string(indentation, ' ') << "replay_operation #"
+         << _record.node_id;
+  }
+
+  virtual rt::result dispatch(rt::operation_dispatcher *,
+                              rt::dag_node_ptr) override {
+    return rt::make_success();
+  }
+private:
+  const rt::dag_trace_record& _record;
+};
+
+struct sim_node {
+  std::size_t record_index;
+  std::vector<std::size_t> dependencies;
+  uint64_t release = 0;
+  uint64_t start = 0;
+  uint64_t finish = 0;
+  uint64_t duration = 0;
+  // Longest path ending in this node, and its predecessor on that path
+  uint64_t critical_path = 0;
+  std::size_t critical_predecessor = 0;
+  bool has_critical_predecessor = false;
+  std::size_t lane = 0;
+  bool is_on_lane = false;
+};
+
+struct device_lanes {
+  std::vector<uint64_t> available_from;
+  std::vector<uint64_t> busy_time;
+  // Finish times of operations on each lane; lanes execute in order,
+  // so these are sorted.
+  std::vector<std::deque<uint64_t>> pending;
+};
+
+bool parse_size(const std::string& s, uint64_t& out) {
+  char* end = nullptr;
+  unsigned long long x = std::strtoull(s.c_str(), &end, 10);
+  if(s.empty() || *end != '\0')
+    return false;
+  out = x;
+  return true;
+}
+
+bool parse_args(const std::vector<std::string>& args, replay_options& opts) {
+  for(std::size_t i = 0; i < args.size(); ++i) {
+    const std::string& arg = args[i];
+    auto next_size = [&](uint64_t& out) {
+      if(i + 1 >= args.size() || !parse_size(args[i + 1], out)) {
+        std::cout << "Invalid or missing value for " << arg << std::endl;
+        return false;
+      }
+      ++i;
+      return true;
+    };
+    uint64_t value;
+    if(arg == "--batch-size") {
+      if(!next_size(value) || value == 0)
+        return false;
+      opts.batch_size = value;
+    } else if(arg == "--kernel-lanes") {
+      if(!next_size(value) || value == 0)
+        return false;
+      opts.kernel_lanes = value;
+    } else if(arg == "--memcpy-lanes") {
+      if(!next_size(value) || value == 0)
+        return false;
+      opts.memcpy_lanes = value;
+    } else if(arg == "--default-duration") {
+      if(!next_size(value))
+        return false;
+      opts.default_duration = value;
+    } else if(arg == "--ignore-submission-times") {
+      opts.ignore_submission_times = true;
+    } else if(arg == "--top") {
+      if(!next_size(value))
+        return false;
+      opts.num_top_kernels = value;
+    } else if(!arg.empty() && arg[0] == '-') {
+      std::cout << "Unknown option: " << arg << std::endl;
+      return false;
+    } else if(opts.filename.empty()) {
+      opts.filename = arg;
+    } else {
+      std::cout << "Multiple trace files provided" << std::endl;
+      return false;
+    }
+  }
+  return !opts.filename.empty();
+}
+
+const char* get_kind_name(rt::dag_trace_operation_kind kind) {
+  switch(kind) {
+  case rt::dag_trace_operation_kind::kernel: return "kernel";
+  case rt::dag_trace_operation_kind::memcpy: return "memcpy";
+  case rt::dag_trace_operation_kind::memset: return "memset";
+  case rt::dag_trace_operation_kind::prefetch: return "prefetch";
+  case rt::dag_trace_operation_kind::file_io: return "file_io";
+  case rt::dag_trace_operation_kind::requirement: return "requirement";
+  default: return "other";
+  }
+}
+
+std::string get_display_name(const rt::dag_trace_record& record) {
+  if(record.name.empty())
+    return std::string{"<"} + get_kind_name(record.kind) + ">";
+  return record.name;
+}
+
+double to_us(uint64_t ns) {
+  return static_cast<double>(ns) * 1.e-3;
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> args;
+  for(int i = 1; i < argc; ++i) {
+    args.push_back(std::string{argv[i]});
+  }
+
+  if(std::find(args.begin(), args.end(), "--help") != args.end()) {
+    help();
+    return 0;
+  }
+
+  replay_options opts;
+  if(!parse_args(args, opts)) {
+    help();
+    return -1;
+  }
+
+  // Replaying must not overwrite the trace that is being replayed
+  unsetenv("ACPP_RT_DAG_TRACE_FILE");
+
+  rt::dag_trace_reader reader{opts.filename};
+  if(!reader.is_valid()) {
+    std::cout << "Could not read DAG trace: " << opts.filename << std::endl;
+    return -1;
+  }
+
+  std::vector<rt::dag_trace_record> records;
+  rt::dag_trace_record current;
+  while(reader.read(current))
+    records.push_back(std::move(current));
+
+  if(records.empty()) {
+    std::cout << "Trace does not contain any operations." << std::endl;
+    return 0;
+  }
+  // Records are written on completion, so restore submission order
+  std::sort(records.begin(), records.end(),
+            [](const auto &a, const auto &b) { return a.node_id < b.node_id; });
+
+  // Rebuild the DAG
+  rt::dag_builder builder{nullptr};
+  std::unordered_map<uint64_t, std::shared_ptr<rt::buffer_data_region>> regions;
+  std::unordered_map<uint64_t, rt::dag_node_ptr> nodes_by_id;
+  std::unordered_map<const rt::dag_node*, std::size_t> sim_index;
+  // Nodes only reference their requirements weakly, so keep all DAGs alive
+  std::vector<rt::dag> dags;
+  std::vector<sim_node> sim_nodes;
+
+  auto get_region = [&](const rt::dag_trace_access& access) {
+    auto& region = regions[access.region_id];
+    if(!region) {
+      rt::range<3> num_elements, page_size;
+      for(int i = 0; i < 3; ++i) {
+        num_elements[i] = std::max<uint64_t>(access.num_elements[i], 1);
+        page_size[i] = std::max<uint64_t>(access.page_size[i], 1);
+      }
+      region = std::make_shared<rt::buffer_data_region>(
+          num_elements, access.element_size, page_size);
+    }
+    return region;
+  };
+
+  auto make_requirement = [&](const rt::dag_trace_access& access) {
+    rt::id<3> offset;
+    rt::range<3> range;
+    for(int i = 0; i < 3; ++i) {
+      offset[i] = access.offset[i];
+      range[i] = access.range[i];
+    }
+    return std::make_unique<rt::buffer_memory_requirement>(
+        get_region(access), offset, range, access.mode, access.target);
+  };
+
+  // Finds the operations that a node effectively depends on by looking
+  // through implicit requirement nodes
+  auto collect_dependencies = [&](const rt::dag_node_ptr& node,
+                                  std::vector<std::size_t>& out) {
+    std::vector<rt::dag_node_ptr> worklist{node};
+    std::vector<const rt::dag_node*> visited;
+    while(!worklist.empty()) {
+      rt::dag_node_ptr current = worklist.back();
+      worklist.pop_back();
+      for(const auto& weak_req : current->get_requirements()) {
+        rt::dag_node_ptr req = weak_req.lock();
+        if(!req || std::find(visited.begin(), visited.end(), req.get()) !=
+                       visited.end())
+          continue;
+        visited.push_back(req.get());
+
+        auto it = sim_index.find(req.get());
+        if(it != sim_index.end())
+          out.push_back(it->second);
+        else
+          worklist.push_back(req);
+      }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+  };
+
+  std::size_t num_explicit_dependencies = 0;
+  std::size_t num_dropped_dependencies = 0;
+  std::size_t num_flushes = 0;
+  std::size_t batch_begin = 0;
+  double build_time = 0.0;
+
+  auto flush = [&]() {
+    auto t0 = std::chrono::steady_clock::now();
+    dags.push_back(builder.finish_and_reset());
+    auto t1 = std::chrono::steady_clock::now();
+    build_time += std::chrono::duration<double>(t1 - t0).count();
+    ++num_flushes;
+
+    uint64_t release = 0;
+    if(!opts.ignore_submission_times) {
+      for(std::size_t i = batch_begin; i < sim_nodes.size(); ++i)
+        release = std::max(
+            release, records[sim_nodes[i].record_index].submission_time);
+    }
+    for(const auto& node : dags.back().get_command_groups()) {
+      sim_node& s = sim_nodes[sim_index[node.get()]];
+      s.release = release;
+      collect_dependencies(node, s.dependencies);
+    }
+    batch_begin = sim_nodes.size();
+  };
+
+  for(std::size_t i = 0; i < records.size(); ++i) {
+    const rt::dag_trace_record& record = records[i];
+
+    rt::requirements_list reqs{nullptr};
+    std::unique_ptr<rt::operation> op;
+
+    bool is_explicit_requirement =
+        record.kind == rt::dag_trace_operation_kind::requirement &&
+        !record.accesses.empty();
+    for(std::size_t j = 0; j < record.accesses.size(); ++j) {
+      // Explicit requirements carry their own access as operation
+      if(is_explicit_requirement && j == 0)
+        op = make_requirement(record.accesses[j]);
+      else
+        reqs.add_requirement(make_requirement(record.accesses[j]));
+    }
+    for(uint64_t dep : record.dependencies) {
+      ++num_explicit_dependencies;
+      auto it = nodes_by_id.find(dep);
+      if(it != nodes_by_id.end())
+        reqs.add_node_requirement(it->second);
+      else
+        ++num_dropped_dependencies;
+    }
+    if(!op)
+      op = std::make_unique<replay_operation>(record);
+
+    auto t0 = std::chrono::steady_clock::now();
+    rt::dag_node_ptr node;
+    if(is_explicit_requirement)
+      node = builder.add_explicit_mem_requirement(std::move(op), reqs);
+    else
+      node = builder.add_command_group(std::move(op), reqs);
+    auto t1 = std::chrono::steady_clock::now();
+    build_time += std::chrono::duration<double>(t1 - t0).count();
+
+    nodes_by_id[record.node_id] = node;
+    sim_index[node.get()] = sim_nodes.size();
+
+    sim_node s;
+    s.record_index = i;
+    if(record.kind != rt::dag_trace_operation_kind::requirement)
+      s.duration = record.duration ? record.duration : opts.default_duration;
+    sim_nodes.push_back(s);
+
+    if(sim_nodes.size() - batch_begin >= opts.batch_size)
+      flush();
+  }
+  if(batch_begin < sim_nodes.size())
+    flush();
+
+  // Simulate execution. Operations are submitted in order when their batch
+  // is released, and each lane executes its operations in order.
+  std::map<std::pair<int, int>, device_lanes> devices;
+  std::size_t num_lanes = opts.memcpy_lanes + opts.kernel_lanes;
+  rt::backend_execution_lane_range memcpy_range{0, opts.memcpy_lanes};
+  rt::backend_execution_lane_range kernel_range{opts.memcpy_lanes,
+                                                opts.kernel_lanes};
+
+  std::size_t num_derived_dependencies = 0;
+  uint64_t makespan = 0;
+  uint64_t total_work = 0;
+  uint64_t critical_path = 0;
+  std::size_t critical_path_end = 0;
+
+  for(std::size_t i = 0; i < sim_nodes.size(); ++i) {
+    sim_node& s = sim_nodes[i];
+    const rt::dag_trace_record& record = records[s.record_index];
+
+    uint64_t ready = s.release;
+    for(std::size_t dep : s.dependencies) {
+      const sim_node& d = sim_nodes[dep];
+      ready = std::max(ready, d.finish);
+      if(d.critical_path > s.critical_path || !s.has_critical_predecessor) {
+        s.critical_path = d.critical_path;
+        s.critical_predecessor = dep;
+        s.has_critical_predecessor = true;
+      }
+    }
+    num_derived_dependencies += s.dependencies.size();
+    s.critical_path += s.duration;
+
+    if(record.kind == rt::dag_trace_operation_kind::requirement) {
+      s.start = ready;
+    } else {
+      auto dev_key = std::make_pair(record.backend, record.device);
+      device_lanes& lanes = devices[dev_key];
+      if(lanes.available_from.empty()) {
+        lanes.available_from.resize(num_lanes, 0);
+        lanes.busy_time.resize(num_lanes, 0);
+        lanes.pending.resize(num_lanes);
+      }
+
+      std::vector<double> lane_usage(num_lanes, 0.0);
+      for(std::size_t l = 0; l < num_lanes; ++l) {
+        while(!lanes.pending[l].empty() &&
+              lanes.pending[l].front() <= s.release)
+          lanes.pending[l].pop_front();
+        lane_usage[l] = static_cast<double>(lanes.pending[l].size());
+      }
+
+      rt::backend_execution_lane_range range =
+          record.kind == rt::dag_trace_operation_kind::memcpy ? memcpy_range
+                                                              : kernel_range;
+      std::vector<int> sync_cost(range.num_lanes, 0);
+      for(std::size_t dep : s.dependencies) {
+        const sim_node& d = sim_nodes[dep];
+        const rt::dag_trace_record& dep_record = records[d.record_index];
+        if (d.is_on_lane && d.finish > s.release &&
+            dep_record.backend == record.backend &&
+            dep_record.device == record.device && d.lane >= range.begin &&
+            d.lane < range.begin + range.num_lanes)
+          ++sync_cost[d.lane - range.begin];
+      }
+
+      rt::execution_hints hints;
+      if(record.preferred_lane >= 0)
+        hints.set_hint(rt::hints::prefer_execution_lane{
+            static_cast<std::size_t>(record.preferred_lane)});
+
+      s.lane = rt::select_execution_lane(hints, sync_cost.data(), lane_usage,
+                                         range);
+      s.is_on_lane = true;
+      s.start = std::max(ready, lanes.available_from[s.lane]);
+      lanes.available_from[s.lane] = s.start + s.duration;
+      lanes.busy_time[s.lane] += s.duration;
+      lanes.pending[s.lane].push_back(s.start + s.duration);
+    }
+    s.finish = s.start + s.duration;
+
+    makespan = std::max(makespan, s.finish);
+    total_work += s.duration;
+    if(s.critical_path > critical_path) {
+      critical_path = s.critical_path;
+      critical_path_end = i;
+    }
+  }
+
+  uint64_t recorded_begin = std::numeric_limits<uint64_t>::max();
+  uint64_t recorded_end = 0;
+  std::size_t num_timed = 0;
+  for(const auto& record : records) {
+    if(record.duration > 0) {
+      recorded_begin = std::min(recorded_begin, record.start_time);
+      recorded_end = std::max(recorded_end,
+                              record.start_time + record.duration);
+      ++num_timed;
+    }
+  }
+
+  // Aggregate time per operation name, and the share of the critical path
+  struct kernel_stats {
+    std::size_t count = 0;
+    uint64_t total = 0;
+    uint64_t on_critical_path = 0;
+  };
+  std::unordered_map<std::string, kernel_stats> stats;
+  for(const auto& s : sim_nodes) {
+    const auto& record = records[s.record_index];
+    if(record.kind == rt::dag_trace_operation_kind::requirement)
+      continue;
+    auto& entry = stats[get_display_name(record)];
+    ++entry.count;
+    entry.total += s.duration;
+  }
+  std::size_t critical_path_length = 0;
+  if(critical_path > 0) {
+    std::size_t current = critical_path_end;
+    while(true) {
+      const sim_node& s = sim_nodes[current];
+      const auto& record = records[s.record_index];
+      if(record.kind != rt::dag_trace_operation_kind::requirement) {
+        stats[get_display_name(record)].on_critical_path += s.duration;
+        ++critical_path_length;
+      }
+      if(!s.has_critical_predecessor)
+        break;
+      current = s.critical_predecessor;
+    }
+  }
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "Trace: " << opts.filename << std::endl;
+  std::cout << "  Operations: " << records.size() << " (" << num_timed
+            << " with measured duration)" << std::endl;
+  std::cout << "  Explicit dependencies: " << num_explicit_dependencies;
+  if(num_dropped_dependencies > 0)
+    std::cout << " (" << num_dropped_dependencies
+              << " on operations missing from the trace)";
+  std::cout << std::endl;
+  if(num_timed > 0)
+    std::cout << "  Recorded makespan: " << to_us(recorded_end - recorded_begin)
+              << " us" << std::endl;
+
+  std::cout << "Scheduling:" << std::endl;
+  std::cout << "  DAG flushes: " << num_flushes << " (batch size "
+            << opts.batch_size << ")" << std::endl;
+  std::cout << "  Dependency edges after DAG construction: "
+            << num_derived_dependencies << std::endl;
+  std::cout << "  DAG builder time: " << build_time * 1.e6 << " us ("
+            << build_time * 1.e9 / records.size() << " ns per operation)"
+            << std::endl;
+
+  std::cout << "Simulation (" << opts.kernel_lanes << " kernel lanes, "
+            << opts.memcpy_lanes << " memcpy lanes per device):" << std::endl;
+  std::cout << "  Total work: " << to_us(total_work) << " us" << std::endl;
+  std::cout << "  Critical path: " << to_us(critical_path) << " us ("
+            << critical_path_length << " operations)" << std::endl;
+  std::cout << "  Simulated makespan: " << to_us(makespan) << " us" << std::endl;
+  if(makespan > 0)
+    std::cout << "  Achieved concurrency: "
+              << static_cast<double>(total_work) / makespan << std::endl;
+  if(critical_path > 0)
+    std::cout << "  Available concurrency: "
+              << static_cast<double>(total_work) / critical_path << std::endl;
+
+  for(const auto& dev : devices) {
+    std::cout << "  Device (backend " << dev.first.first << ", device "
+              << dev.first.second << ") lane utilization:";
+    for(std::size_t l = 0; l < num_lanes; ++l) {
+      double utilization =
+          makespan > 0
+              ? static_cast<double>(dev.second.busy_time[l]) / makespan
+              : 0.0;
+      std::cout << " " << (l < opts.memcpy_lanes ? "m" : "k") << l << "="
+                << utilization;
+    }
+    std::cout << std::endl;
+  }
+
+  std::vector<std::pair<std::string, kernel_stats>> sorted_stats{
+      stats.begin(), stats.end()};
+  std::sort(sorted_stats.begin(), sorted_stats.end(),
+            [](const auto &a, const auto &b) {
+              return a.second.total > b.second.total;
+            });
+  if(sorted_stats.size() > opts.num_top_kernels)
+    sorted_stats.resize(opts.num_top_kernels);
+  if(!sorted_stats.empty()) {
+    std::cout << "Operations by total time "
+                 "(count, total us, us on critical path):"
+              << std::endl;
+    for(const auto& entry : sorted_stats) {
+      std::cout << "  " << entry.second.count << ", "
+                << to_us(entry.second.total) << ", "
+                << to_us(entry.second.on_critical_path) << ": "
+                << entry.first << std::endl;
+    }
+  }
+
+  return 0;
+}
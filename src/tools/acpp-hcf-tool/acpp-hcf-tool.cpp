@@ -29,14 +29,31 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include "hipSYCL/common/hcf_container.hpp"
+#include "hipSYCL/common/stable_running_hash.hpp"
+
+#ifdef ACPP_HCF_TOOL_WITH_LLVM
+#include "llvm-function-dedup.hpp"
+#endif
 
 void help() {
   std::cout <<
   "Usage: acpp-hcf-tool <hcf-file> <-x|-r <file>|-p> root [subnode] [subsubnode] ...\n" <<
   "  -x: Extract binary attachment and print to stdout\n" <<
   "  -r <file>: Replace binary attachment with file content and print to stdout\n" << 
-  "  -p: Print node content" << std::endl;
+  "  -p: Print node content\n" <<
+  "       acpp-hcf-tool --merge <hcf-file> [<hcf-file> ...]\n" <<
+  "  --merge: Merge HCF objects of one application into a single object with\n" <<
+  "           deduplicated device images, kernels, exported symbols and (if\n" <<
+  "           built with LLVM) functions, and print it to stdout. Fails if\n" <<
+  "           kernels with the same name differ. The result can be used with\n" <<
+  "           ACPP_RT_MERGED_HCF. The application still embeds the original\n" <<
+  "           objects; merging reduces JIT work, not binary size.\n" <<
+  "       acpp-hcf-tool --compress <hcf-file>\n" <<
+  "  --compress: Compress all binary attachments and print to stdout" << std::endl;
 }
 
 enum class mode {
@@ -108,12 +125,452 @@ bool copy_node(const hipsycl::common::hcf_container::node *source,
   return true;
 };
 
+using hcf_node = hipsycl::common::hcf_container::node;
+
+using attachment_replacements =
+    std::unordered_map<const hcf_node *, std::string>;
+
+// Unlike copy_node(), this copies all subnodes, and binary attachments
+// may be located anywhere in the node tree. Attachments of nodes in
+// replacements are substituted by the given content.
+bool deep_copy_node(const hipsycl::common::hcf_container &source_hcf,
+                    const hcf_node *source,
+                    hipsycl::common::hcf_container &target_hcf,
+                    hcf_node *target, bool compress = false,
+                    const attachment_replacements *replacements = nullptr) {
+  for (const auto &kv_pair : source->key_value_pairs) {
+    target->set(kv_pair.first, kv_pair.second);
+  }
+
+  for (const auto &subnode : source->subnodes) {
+    if (subnode.is_binary_content()) {
+      std::string attachment;
+      if(replacements && replacements->count(source))
+        attachment = replacements->at(source);
+      else if(!source_hcf.get_binary_attachment(source, attachment))
+        return false;
+      // Keep compressed content compressed
+      if (!target_hcf.attach_binary_content(
+              target, attachment, compress || subnode.has_key("compression")))
+        return false;
+    } else {
+      auto* new_subnode = target->add_subnode(subnode.node_id);
+      if(!new_subnode)
+        return false;
+      if (!deep_copy_node(source_hcf, &subnode, target_hcf, new_subnode,
+                          compress, replacements))
+        return false;
+    }
+  }
+  return true;
+}
+
+void replace_list(hcf_node *n, const std::string &key,
+                  const std::vector<std::string> &entries) {
+  n->subnodes.erase(std::remove_if(n->subnodes.begin(), n->subnodes.end(),
+                                   [&](const hcf_node &subnode) {
+                                     return subnode.node_id == key;
+                                   }),
+                    n->subnodes.end());
+  n->set_as_list(key, entries);
+}
+
+bool is_same_image(const hipsycl::common::hcf_container &a,
+                   const hcf_node *image_a,
+                   const hipsycl::common::hcf_container &b,
+                   const hcf_node *image_b) {
+  for(const char* key : {"format", "variant"}) {
+    const std::string* value_a = image_a->get_value(key);
+    const std::string* value_b = image_b->get_value(key);
+    if((value_a == nullptr) != (value_b == nullptr))
+      return false;
+    if(value_a && *value_a != *value_b)
+      return false;
+  }
+  std::string content_a, content_b;
+  if(image_a->has_binary_data_attached())
+    a.get_binary_attachment(image_a, content_a);
+  if(image_b->has_binary_data_attached())
+    b.get_binary_attachment(image_b, content_b);
+  return content_a == content_b;
+}
+
+// Compares kernel nodes, except for the images that provide them
+bool is_same_kernel_info(const hcf_node *a, const hcf_node *b) {
+  if(a->key_value_pairs != b->key_value_pairs)
+    return false;
+  auto is_relevant = [](const hcf_node &n) {
+    return n.node_id != "image-providers";
+  };
+  std::vector<const hcf_node *> subnodes_a, subnodes_b;
+  for(const auto &n : a->subnodes)
+    if(is_relevant(n))
+      subnodes_a.push_back(&n);
+  for(const auto &n : b->subnodes)
+    if(is_relevant(n))
+      subnodes_b.push_back(&n);
+  if(subnodes_a.size() != subnodes_b.size())
+    return false;
+  for(std::size_t i = 0; i < subnodes_a.size(); ++i)
+    if(subnodes_a[i]->node_id != subnodes_b[i]->node_id ||
+       !is_same_kernel_info(subnodes_a[i], subnodes_b[i]))
+      return false;
+  return true;
+}
+
+bool is_llvm_ir_image(const hcf_node *image) {
+  const std::string *format = image->get_value("format");
+  const std::string *variant = image->get_value("variant");
+  return format && *format == "llvm-ir" && variant &&
+         *variant == "global-module" && image->has_binary_data_attached();
+}
+
+#ifdef ACPP_HCF_TOOL_WITH_LLVM
+// Caches content hashes of the functions of merged LLVM IR images
+class function_hash_cache {
+public:
+  function_hash_cache(const hipsycl::common::hcf_container &merged)
+      : _merged{merged} {}
+
+  // Returns false if no hash is available for the function
+  bool get(const std::string &image_name, const std::string &function,
+           uint64_t &hash) {
+    auto image_hashes = _hashes.find(image_name);
+    if(image_hashes == _hashes.end()) {
+      image_hashes = _hashes.emplace(image_name, function_hashes{}).first;
+
+      const hcf_node *image =
+          _merged.root_node()->get_subnode("images")->get_subnode(image_name);
+      std::string bitcode, error;
+      if(image && is_llvm_ir_image(image) &&
+         _merged.get_binary_attachment(image, bitcode)) {
+        if(!hipsycl::hcf_tool::hash_functions(bitcode, image_hashes->second,
+                                              error))
+          std::cerr << "Could not hash functions of image " << image_name
+                    << ": " << error << std::endl;
+      }
+    }
+    auto it = image_hashes->second.find(function);
+    if(it == image_hashes->second.end())
+      return false;
+    hash = it->second;
+    return true;
+  }
+
+private:
+  using function_hashes = std::unordered_map<std::string, uint64_t>;
+  const hipsycl::common::hcf_container &_merged;
+  std::unordered_map<std::string, function_hashes> _hashes;
+};
+
+// Moves functions that are defined identically in multiple LLVM IR images
+// into one additional shared image, from which they are linked by the JIT.
+bool deduplicate_functions(hipsycl::common::hcf_container &merged,
+                           const std::vector<std::string> &merged_ids) {
+  hcf_node *images_node = merged.root_node()->get_subnode("images");
+
+  std::vector<const hcf_node *> image_nodes;
+  std::vector<hipsycl::hcf_tool::llvm_ir_image> images;
+  bool is_compressed = false;
+  for(const auto &image : images_node->subnodes) {
+    if(!is_llvm_ir_image(&image))
+      continue;
+    hipsycl::hcf_tool::llvm_ir_image ir_image;
+    ir_image.name = image.node_id;
+    ir_image.imported_symbols = image.get_as_list("imported-symbols");
+    if(!merged.get_binary_attachment(&image, ir_image.bitcode))
+      return false;
+    is_compressed |= image.get_subnode("__binary")->has_key("compression");
+    image_nodes.push_back(&image);
+    images.push_back(std::move(ir_image));
+  }
+
+  hipsycl::hcf_tool::function_dedup_result result;
+  std::string error;
+  if(!hipsycl::hcf_tool::deduplicate_functions(images, result, error)) {
+    std::cerr << "Function deduplication failed, device images are kept "
+                 "unmodified: "
+              << error << std::endl;
+    return true;
+  }
+  if(result.shared_functions.empty())
+    return true;
+
+  attachment_replacements replacements;
+  for(std::size_t i = 0; i < images.size(); ++i)
+    if(images[i].modified)
+      replacements[image_nodes[i]] = images[i].bitcode;
+
+  hipsycl::common::hcf_container rewritten;
+  if(!deep_copy_node(merged, merged.root_node(), rewritten,
+                     rewritten.root_node(), false, &replacements))
+    return false;
+
+  hcf_node *rewritten_images = rewritten.root_node()->get_subnode("images");
+  for(const auto &image : images)
+    if(image.modified)
+      replace_list(rewritten_images->get_subnode(image.name),
+                   "imported-symbols", image.imported_symbols);
+
+  std::string name = "llvm-ir.shared";
+  for(int i = 1; rewritten_images->has_subnode(name); ++i)
+    name = "llvm-ir.shared." + std::to_string(i);
+  hcf_node *shared_image = rewritten_images->add_subnode(name);
+  shared_image->set("variant", "global-module");
+  shared_image->set("format", "llvm-ir");
+  if(!rewritten.attach_binary_content(shared_image, result.shared_bitcode,
+                                      is_compressed))
+    return false;
+  shared_image->set_as_list("exported-symbols", result.shared_functions);
+  shared_image->set_as_list("imported-symbols",
+                            result.shared_imported_symbols);
+  shared_image->set_as_list("source-object-ids", merged_ids);
+
+  std::cerr << "Moved " << result.num_removed_definitions
+            << " definitions of " << result.shared_functions.size()
+            << " functions into shared image " << name << std::endl;
+
+  merged = std::move(rewritten);
+  return true;
+}
+#endif
+
+// Merges the HCF objects of an application into one object:
+// * Byte-identical device images are stored only once.
+// * Kernels that are present in multiple objects (e.g. because they are
+//   instantiated in multiple translation units) are only kept once, and
+//   refer to the image of the first object that contains them. Merging
+//   fails if the definitions of such a kernel differ.
+// * Each symbol is only exported by the first image that exports it, such
+//   that the runtime does not link multiple definitions when resolving it.
+// * If LLVM support is available, ODR functions that are defined identically
+//   in multiple LLVM IR images are moved into one shared image.
+// The merged object lists the ids of the original objects in
+// merged-object-ids, and each image lists the objects it originates from in
+// source-object-ids.
+int merge(const std::vector<std::string>& filenames) {
+  hipsycl::common::hcf_container merged;
+  merged.root_node()->add_subnode("images");
+  merged.root_node()->add_subnode("kernels");
+
+  std::vector<std::string> merged_ids;
+  hipsycl::common::stable_running_hash merged_id_hash;
+  // Hash of image content -> names of merged images with this hash
+  std::unordered_map<uint64_t, std::vector<std::string>> images_by_hash;
+  std::unordered_set<std::string> exported_symbols;
+  std::unordered_set<std::string> kernels;
+#ifdef ACPP_HCF_TOOL_WITH_LLVM
+  function_hash_cache function_hashes{merged};
+#endif
+
+  std::size_t num_images = 0;
+  std::size_t num_duplicate_images = 0;
+  std::size_t num_duplicate_kernels = 0;
+  std::size_t num_duplicate_symbols = 0;
+
+  for(const auto& filename : filenames) {
+    std::string hcf_content;
+    if(!read_file(filename, hcf_content)) {
+      std::cerr << "Could not read file: " << filename << std::endl;
+      return -1;
+    }
+    hipsycl::common::hcf_container input{hcf_content};
+    const hcf_node* input_root = input.root_node();
+
+    const std::string* object_id = input_root->get_value("object-id");
+    if(!object_id) {
+      std::cerr << "Invalid HCF object (missing object id): " << filename
+                << std::endl;
+      return -1;
+    }
+    const hcf_node* input_images = input_root->get_subnode("images");
+    if(!input_images) {
+      std::cerr << "Skipping " << filename
+                << ": HCF object does not contain device images" << std::endl;
+      continue;
+    }
+
+    // Inputs may be merged objects themselves
+    std::vector<std::string> source_ids{*object_id};
+    if(input_root->has_subnode("merged-object-ids"))
+      source_ids = input_root->get_as_list("merged-object-ids");
+    for(const auto& id : source_ids) {
+      merged_ids.push_back(id);
+      merged_id_hash(id.data(), id.size());
+    }
+
+    std::unordered_map<std::string, std::string> merged_image_names;
+    for(const auto& image : input_images->subnodes) {
+      ++num_images;
+
+      std::vector<std::string> image_source_ids = source_ids;
+      if(image.has_subnode("source-object-ids"))
+        image_source_ids = image.get_as_list("source-object-ids");
+
+      std::string content;
+      if(image.has_binary_data_attached())
+        input.get_binary_attachment(&image, content);
+      hipsycl::common::stable_running_hash h;
+      h(content.data(), content.size());
+
+      hcf_node* merged_images = merged.root_node()->get_subnode("images");
+
+      std::string duplicate_of;
+      for(const auto& candidate : images_by_hash[h.get_current_hash()]) {
+        if(is_same_image(input, &image, merged,
+                         merged_images->get_subnode(candidate))) {
+          duplicate_of = candidate;
+          break;
+        }
+      }
+
+      if(!duplicate_of.empty()) {
+        ++num_duplicate_images;
+        hcf_node* merged_image = merged_images->get_subnode(duplicate_of);
+        std::vector<std::string> ids =
+            merged_image->get_as_list("source-object-ids");
+        for(const auto& id : image_source_ids)
+          if(std::find(ids.begin(), ids.end(), id) == ids.end())
+            ids.push_back(id);
+        replace_list(merged_image, "source-object-ids", ids);
+        merged_image_names[image.node_id] = duplicate_of;
+        continue;
+      }
+
+      std::string name = image.node_id;
+      for(int i = 1; merged_images->has_subnode(name); ++i)
+        name = image.node_id + "." + std::to_string(i);
+
+      hcf_node* merged_image = merged_images->add_subnode(name);
+      if(!deep_copy_node(input, &image, merged, merged_image)) {
+        std::cerr << "Could not copy image " << image.node_id << " from "
+                  << filename << std::endl;
+        return -1;
+      }
+
+      std::vector<std::string> exports;
+      for(const auto& symbol : image.get_as_list("exported-symbols")) {
+        if(exported_symbols.insert(symbol).second)
+          exports.push_back(symbol);
+        else
+          ++num_duplicate_symbols;
+      }
+      replace_list(merged_image, "exported-symbols", exports);
+      replace_list(merged_image, "source-object-ids", image_source_ids);
+
+      merged_image_names[image.node_id] = name;
+      images_by_hash[h.get_current_hash()].push_back(name);
+    }
+
+    if(const hcf_node* input_kernels = input_root->get_subnode("kernels")) {
+      for(const auto& kernel : input_kernels->subnodes) {
+        std::vector<std::string> providers;
+        for(const auto& image : kernel.get_as_list("image-providers"))
+          providers.push_back(merged_image_names.count(image)
+                                  ? merged_image_names[image]
+                                  : image);
+
+        if(!kernels.insert(kernel.node_id).second) {
+          const hcf_node* existing =
+              merged.root_node()->get_subnode("kernels")->get_subnode(
+                  kernel.node_id);
+          bool is_conflict = !is_same_kernel_info(existing, &kernel);
+#ifdef ACPP_HCF_TOOL_WITH_LLVM
+          std::vector<std::string> existing_providers =
+              existing->get_as_list("image-providers");
+          if(!is_conflict && !providers.empty() &&
+             !existing_providers.empty() &&
+             providers.front() != existing_providers.front()) {
+            uint64_t hash = 0, existing_hash = 0;
+            if(function_hashes.get(providers.front(), kernel.node_id, hash) &&
+               function_hashes.get(existing_providers.front(), kernel.node_id,
+                                   existing_hash))
+              is_conflict = hash != existing_hash;
+          }
+#endif
+          if(is_conflict) {
+            std::cerr << "Conflicting definitions of kernel " << kernel.node_id
+                      << " in " << filename
+                      << " and a previously merged object" << std::endl;
+            return -1;
+          }
+          ++num_duplicate_kernels;
+          continue;
+        }
+        hcf_node* merged_kernel =
+            merged.root_node()->get_subnode("kernels")->add_subnode(
+                kernel.node_id);
+        if(!deep_copy_node(input, &kernel, merged, merged_kernel)) {
+          std::cerr << "Could not copy kernel " << kernel.node_id << " from "
+                    << filename << std::endl;
+          return -1;
+        }
+        replace_list(merged_kernel, "image-providers", providers);
+      }
+    }
+  }
+
+  if(merged_ids.empty()) {
+    std::cerr << "No HCF objects with device images were provided."
+              << std::endl;
+    return -1;
+  }
+
+#ifdef ACPP_HCF_TOOL_WITH_LLVM
+  if(!deduplicate_functions(merged, merged_ids)) {
+    std::cerr << "Could not deduplicate functions of device images"
+              << std::endl;
+    return -1;
+  }
+#else
+  std::cerr << "Warning: acpp-hcf-tool was built without LLVM, so functions "
+               "shared between device images are not deduplicated. Only "
+               "identical device images, kernels and exported symbols are."
+            << std::endl;
+#endif
+
+  merged.root_node()->set("object-id",
+                          std::to_string(merged_id_hash.get_current_hash()));
+  merged.root_node()->set("generator", "acpp-hcf-tool --merge");
+  merged.root_node()->set_as_list("merged-object-ids", merged_ids);
+
+  std::cerr << "Merged " << merged_ids.size() << " HCF objects: "
+            << num_duplicate_images << " of " << num_images
+            << " device images, " << num_duplicate_kernels
+            << " kernels and " << num_duplicate_symbols
+            << " exported symbols were duplicates" << std::endl;
+
+  std::cout << merged.serialize();
+  return 0;
+}
+
 int main(int argc, char** argv) {
   std::vector<std::string> args;
   for(int i = 1; i < argc; ++i) {
     args.push_back(std::string{argv[i]});
   }
 
+  if(args.size() >= 2 && args[0] == "--merge") {
+    return merge(std::vector<std::string>{args.begin() + 1, args.end()});
+  }
+
+  if(args.size() == 2 && args[0] == "--compress") {
+    std::string hcf_content;
+    if(!read_file(args[1], hcf_content)) {
+      std::cerr << "Could not read file: " << args[1] << std::endl;
+      return -1;
+    }
+    hipsycl::common::hcf_container hcf{hcf_content};
+    hipsycl::common::hcf_container compressed;
+    if (!deep_copy_node(hcf, hcf.root_node(), compressed,
+                        compressed.root_node(), true)) {
+      std::cerr << "Constructing compressed HCF container failed" << std::endl;
+      return -1;
+    }
+    std::cout << compressed.serialize();
+    return 0;
+  }
+
   if(args.size() < 3) {
     help();
     return -1;
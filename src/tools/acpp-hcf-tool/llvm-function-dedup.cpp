@@ -0,0 +1,577 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "llvm-function-dedup.hpp"
+#include "hipSYCL/common/stable_running_hash.hpp"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DebugInfo.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/ModuleSlotTracker.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/IPO/GlobalDCE.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_set>
+
+namespace hipsycl {
+namespace hcf_tool {
+
+namespace {
+
+std::unique_ptr<llvm::Module> parse_bitcode(const std::string &bitcode,
+                                            llvm::LLVMContext &ctx,
+                                            std::string &error) {
+  llvm::MemoryBufferRef buffer{llvm::StringRef{bitcode.data(), bitcode.size()},
+                               "hcf-image"};
+  auto module = llvm::parseBitcodeFile(buffer, ctx);
+  if(!module) {
+    error = "Could not parse bitcode: " + llvm::toString(module.takeError());
+    return nullptr;
+  }
+  return std::move(module.get());
+}
+
+bool write_bitcode(const llvm::Module &M, std::string &out,
+                   std::string &error) {
+  llvm::raw_string_ostream verifier_output{error};
+  if(llvm::verifyModule(M, &verifier_output)) {
+    verifier_output.flush();
+    error = "Invalid module after deduplication: " + error;
+    return false;
+  }
+  out.clear();
+  llvm::raw_string_ostream os{out};
+  llvm::WriteBitcodeToFile(M, os);
+  os.flush();
+  return true;
+}
+
+bool is_odr_definition(const llvm::GlobalValue &GV) {
+  return !GV.isDeclaration() &&
+         (GV.hasLinkOnceODRLinkage() || GV.hasWeakODRLinkage());
+}
+
+void make_declaration(llvm::Function &F) {
+  F.deleteBody();
+  F.setComdat(nullptr);
+  F.clearMetadata();
+}
+
+void run_global_dce(llvm::Module &M) {
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+  llvm::PassBuilder PB;
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  llvm::ModulePassManager MPM;
+  MPM.addPass(llvm::GlobalDCEPass{});
+  MPM.run(M, MAM);
+}
+
+// Computes content hashes of the functions and variables of a module.
+// The module is modified (debug info, metadata and value names are removed,
+// internal globals are renamed after their hash), so it must be a copy that
+// is only used for hashing.
+class content_hasher {
+public:
+  struct global_info {
+    bool is_valid = false;
+    uint64_t hash = 0;
+    // Non-internal globals that are used directly or through internal
+    // functions and variables
+    std::unordered_set<llvm::GlobalValue *> external_references;
+  };
+
+  content_hasher(llvm::Module &M) : _module{M}, _slot_tracker{&M} {
+    llvm::StripDebugInfo(M);
+    for(auto &GO : M.global_objects())
+      GO.clearMetadata();
+    for(auto &F : M) {
+      for(auto &A : F.args())
+        A.setName("");
+      for(auto &BB : F) {
+        BB.setName("");
+        for(auto &I : BB) {
+          I.setName("");
+          llvm::SmallVector<std::pair<unsigned, llvm::MDNode *>, 4> MDs;
+          I.getAllMetadata(MDs);
+          for(const auto &MD : MDs)
+            I.setMetadata(MD.first, nullptr);
+        }
+      }
+    }
+  }
+
+  const global_info &get(llvm::GlobalValue *GV) {
+    auto it = _infos.find(GV);
+    // Entries that are still being computed are not valid. Their content
+    // cannot be taken into account, so recursive internal functions
+    // invalidate everything that depends on them.
+    if(it != _infos.end())
+      return it->second;
+
+    global_info &info = _infos[GV];
+    global_info result;
+    result.is_valid = true;
+
+    for(auto *R : get_direct_references(GV)) {
+      if(R->hasLocalLinkage()) {
+        const global_info &R_info = get(R);
+        if(!R_info.is_valid)
+          return info;
+        result.external_references.insert(R_info.external_references.begin(),
+                                          R_info.external_references.end());
+      } else {
+        result.external_references.insert(R);
+      }
+    }
+
+    std::string content;
+    llvm::raw_string_ostream os{content};
+    if(auto *F = llvm::dyn_cast<llvm::Function>(GV))
+      print_function(*F, os);
+    else if(auto *V = llvm::dyn_cast<llvm::GlobalVariable>(GV))
+      print_variable(*V, os);
+    else
+      return info;
+    os.flush();
+
+    common::stable_running_hash h;
+    h(content.data(), content.size());
+    result.hash = h.get_current_hash();
+
+    if(GV->hasLocalLinkage()) {
+      // Internal globals are referred to by their content from now on.
+      // Identical internal globals are merged, so that the users of either
+      // of them are printed in the same way.
+      std::string name = "__acpp_hcf_local." + std::to_string(result.hash);
+      llvm::GlobalValue *existing = _module.getNamedValue(name);
+      if(!existing)
+        GV->setName(name);
+      else if(existing != GV && existing->getType() == GV->getType())
+        GV->replaceAllUsesWith(existing);
+    }
+
+    info = std::move(result);
+    return info;
+  }
+
+private:
+  static std::vector<llvm::GlobalValue *>
+  get_direct_references(llvm::GlobalValue *GV) {
+    std::vector<llvm::GlobalValue *> references;
+    std::unordered_set<const llvm::Value *> visited;
+
+    auto visit = [&](auto &self, llvm::Value *V) -> void {
+      if(!llvm::isa<llvm::Constant>(V) || !visited.insert(V).second)
+        return;
+      if(auto *R = llvm::dyn_cast<llvm::GlobalValue>(V)) {
+        references.push_back(R);
+        return;
+      }
+      for(auto &Op : llvm::cast<llvm::Constant>(V)->operands())
+        self(self, Op.get());
+    };
+
+    if(auto *F = llvm::dyn_cast<llvm::Function>(GV)) {
+      // Personality, prefix and prologue data
+      for(auto &Op : F->operands())
+        visit(visit, Op.get());
+      for(auto &BB : *F)
+        for(auto &I : BB)
+          for(auto &Op : I.operands())
+            visit(visit, Op.get());
+    } else if(auto *V = llvm::dyn_cast<llvm::GlobalVariable>(GV)) {
+      if(V->hasInitializer())
+        visit(visit, V->getInitializer());
+    }
+    return references;
+  }
+
+  void print_function(llvm::Function &F, llvm::raw_ostream &os) {
+    const llvm::AttributeList &attrs = F.getAttributes();
+
+    os << "function ";
+    F.getFunctionType()->print(os);
+    os << " cc " << F.getCallingConv() << " addrspace " << F.getAddressSpace()
+       << " fn[" << attrs.getAsString(llvm::AttributeList::FunctionIndex)
+       << "] ret[" << attrs.getAsString(llvm::AttributeList::ReturnIndex)
+       << "]";
+    for(unsigned i = 0; i < F.arg_size(); ++i)
+      os << " arg[" << attrs.getAsString(llvm::AttributeList::FirstArgIndex + i)
+         << "]";
+    if(auto A = F.getAlign())
+      os << " align " << A->value();
+    if(F.hasSection())
+      os << " section " << F.getSection();
+    if(F.hasGC())
+      os << " gc " << F.getGC();
+    for(auto &Op : F.operands()) {
+      os << " operand ";
+      if(Op.get())
+        Op->printAsOperand(os, true, _slot_tracker);
+    }
+
+    _slot_tracker.incorporateFunction(F);
+    for(auto &BB : F) {
+      os << "\nblock:";
+      for(auto &I : BB) {
+        std::string line;
+        llvm::raw_string_ostream line_os{line};
+        I.print(line_os, _slot_tracker);
+        line_os.flush();
+        // Attribute groups of calls are numbered per module, so print
+        // the attributes themselves
+        if(auto *CB = llvm::dyn_cast<llvm::CallBase>(&I)) {
+          std::size_t pos = line.rfind(" #");
+          if(pos != std::string::npos && pos + 2 < line.size() &&
+             line.find_first_not_of("0123456789", pos + 2) ==
+                 std::string::npos) {
+            line = line.substr(0, pos) + " fn[" +
+                   CB->getAttributes().getAsString(
+                       llvm::AttributeList::FunctionIndex) +
+                   "]";
+          }
+        }
+        os << "\n" << line;
+      }
+    }
+  }
+
+  void print_variable(llvm::GlobalVariable &V, llvm::raw_ostream &os) {
+    os << "variable ";
+    V.getValueType()->print(os);
+    os << (V.isConstant() ? " constant" : " global") << " addrspace "
+       << V.getAddressSpace() << " tls " << V.getThreadLocalMode()
+       << " unnamed_addr " << static_cast<int>(V.getUnnamedAddr())
+       << " externally_initialized " << V.isExternallyInitialized();
+    if(auto A = V.getAlign())
+      os << " align " << A->value();
+    if(V.hasSection())
+      os << " section " << V.getSection();
+    if(V.hasInitializer()) {
+      os << " = ";
+      V.getInitializer()->printAsOperand(os, true, _slot_tracker);
+    }
+  }
+
+  llvm::Module &_module;
+  llvm::ModuleSlotTracker _slot_tracker;
+  std::unordered_map<llvm::GlobalValue *, global_info> _infos;
+};
+
+struct function_summary {
+  uint64_t hash;
+  bool is_odr;
+  // Non-internal functions defined in the same module that the function
+  // depends on
+  std::vector<std::string> defined_function_dependencies;
+  // Whether the function depends on variables defined in the module that
+  // are neither internal nor ODR
+  bool depends_on_variable_definitions = false;
+};
+
+struct module_summary {
+  // Non-internal function definitions for which a hash could be computed
+  std::unordered_map<std::string, function_summary> functions;
+  // All non-internal function definitions
+  std::unordered_set<std::string> definitions;
+};
+
+bool summarize_module(const std::string &bitcode, module_summary &out,
+                      std::string &error) {
+  llvm::LLVMContext ctx;
+  std::unique_ptr<llvm::Module> M = parse_bitcode(bitcode, ctx, error);
+  if(!M)
+    return false;
+
+  content_hasher hasher{*M};
+  for(auto &F : *M) {
+    if(F.isDeclaration() || F.hasLocalLinkage())
+      continue;
+    std::string name = F.getName().str();
+    out.definitions.insert(name);
+
+    const auto &info = hasher.get(&F);
+    if(!info.is_valid)
+      continue;
+
+    function_summary summary;
+    summary.hash = info.hash;
+    summary.is_odr = is_odr_definition(F);
+    for(auto *R : info.external_references) {
+      if(R == &F || R->isDeclaration())
+        continue;
+      if(llvm::isa<llvm::Function>(R))
+        summary.defined_function_dependencies.push_back(R->getName().str());
+      else if(!is_odr_definition(*R))
+        summary.depends_on_variable_definitions = true;
+    }
+    out.functions[name] = std::move(summary);
+  }
+  return true;
+}
+
+// Reduces a module to the given functions and everything they depend on.
+void extract_functions(llvm::Module &M,
+                       const std::unordered_set<std::string> &functions) {
+  for(auto &F : M) {
+    if(F.isDeclaration() || F.hasLocalLinkage())
+      continue;
+    if(functions.count(F.getName().str())) {
+      // Needs to survive GlobalDCE even though it is not used in this module
+      F.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+    } else {
+      make_declaration(F);
+    }
+  }
+
+  std::vector<llvm::GlobalVariable *> appending_variables;
+  for(auto &V : M.globals()) {
+    if(V.hasAppendingLinkage()) {
+      // llvm.used, llvm.global.annotations etc. remain in the original
+      // modules
+      appending_variables.push_back(&V);
+    } else if(!V.isDeclaration() && !V.hasLocalLinkage() &&
+              !is_odr_definition(V)) {
+      V.setInitializer(nullptr);
+      V.setLinkage(llvm::GlobalValue::ExternalLinkage);
+    }
+  }
+  for(auto *V : appending_variables)
+    V->eraseFromParent();
+
+  // Kernel annotations and similar remain in the original modules
+  std::vector<llvm::NamedMDNode *> named_metadata;
+  for(auto &MD : M.named_metadata())
+    if(MD.getName().substr(0, 5) != "llvm.")
+      named_metadata.push_back(&MD);
+  for(auto *MD : named_metadata)
+    MD->eraseFromParent();
+
+  // Comdats of the original modules may contain other members, which must
+  // not be discarded when the shared module is linked with them.
+  for(auto &GO : M.global_objects())
+    GO.setComdat(nullptr);
+
+  run_global_dce(M);
+}
+
+}
+
+bool hash_functions(const std::string &bitcode,
+                    std::unordered_map<std::string, uint64_t> &hashes,
+                    std::string &error) {
+  module_summary summary;
+  if(!summarize_module(bitcode, summary, error))
+    return false;
+  for(const auto &entry : summary.functions) {
+    // Functions are only identical if the functions they call are
+    // identical as well
+    std::set<std::string> closure;
+    std::vector<std::string> worklist{entry.first};
+    bool is_valid = true;
+    while(is_valid && !worklist.empty()) {
+      std::string name = worklist.back();
+      worklist.pop_back();
+      if(!closure.insert(name).second)
+        continue;
+      auto it = summary.functions.find(name);
+      if(it == summary.functions.end())
+        is_valid = false;
+      else
+        worklist.insert(worklist.end(),
+                        it->second.defined_function_dependencies.begin(),
+                        it->second.defined_function_dependencies.end());
+    }
+    if(!is_valid)
+      continue;
+
+    common::stable_running_hash h;
+    for(const auto &name : closure) {
+      uint64_t function_hash = summary.functions[name].hash;
+      h(name.data(), name.size());
+      h(&function_hash, sizeof(function_hash));
+    }
+    hashes[entry.first] = h.get_current_hash();
+  }
+  return true;
+}
+
+bool deduplicate_functions(std::vector<llvm_ir_image> &images,
+                           function_dedup_result &result,
+                           std::string &error) {
+  std::vector<module_summary> summaries(images.size());
+  for(std::size_t i = 0; i < images.size(); ++i) {
+    if(!summarize_module(images[i].bitcode, summaries[i], error)) {
+      error = images[i].name + ": " + error;
+      return false;
+    }
+  }
+
+  // Function name -> indices of images that define it
+  std::map<std::string, std::vector<std::size_t>> providers;
+  for(std::size_t i = 0; i < images.size(); ++i)
+    for(const auto &name : summaries[i].definitions)
+      providers[name].push_back(i);
+  for(auto &entry : providers)
+    std::sort(entry.second.begin(), entry.second.end());
+
+  std::set<std::string> shared;
+  for(const auto &entry : providers) {
+    if(entry.second.size() < 2)
+      continue;
+    bool is_shareable = true;
+    const function_summary *first = nullptr;
+    for(std::size_t i : entry.second) {
+      auto it = summaries[i].functions.find(entry.first);
+      if(it == summaries[i].functions.end() || !it->second.is_odr ||
+         it->second.depends_on_variable_definitions ||
+         (first && first->hash != it->second.hash)) {
+        is_shareable = false;
+        break;
+      }
+      first = &it->second;
+    }
+    if(is_shareable)
+      shared.insert(entry.first);
+  }
+
+  // Functions can only be shared if all functions they depend on are
+  // shared as well
+  for(bool changed = true; changed;) {
+    changed = false;
+    for(auto it = shared.begin(); it != shared.end();) {
+      bool is_shareable = true;
+      for(std::size_t i : providers[*it])
+        for(const auto &dependency :
+            summaries[i].functions[*it].defined_function_dependencies)
+          if(!shared.count(dependency))
+            is_shareable = false;
+      if(is_shareable) {
+        ++it;
+      } else {
+        it = shared.erase(it);
+        changed = true;
+      }
+    }
+  }
+
+  if(shared.empty())
+    return true;
+
+  // The definition of each shared function is taken from the first image
+  // that defines it.
+  std::map<std::size_t, std::unordered_set<std::string>> functions_by_donor;
+  for(const auto &name : shared)
+    functions_by_donor[providers[name].front()].insert(name);
+
+  llvm::LLVMContext shared_ctx;
+  std::unique_ptr<llvm::Module> shared_module;
+  for(const auto &entry : functions_by_donor) {
+    std::unique_ptr<llvm::Module> M =
+        parse_bitcode(images[entry.first].bitcode, shared_ctx, error);
+    if(!M)
+      return false;
+    extract_functions(*M, entry.second);
+    if(!shared_module) {
+      shared_module = std::move(M);
+      shared_module->setModuleIdentifier("acpp-hcf-tool.shared");
+    } else if(llvm::Linker::linkModules(*shared_module, std::move(M))) {
+      error = "Could not link shared functions of image " +
+              images[entry.first].name;
+      return false;
+    }
+  }
+
+  for(std::size_t i = 0; i < images.size(); ++i) {
+    std::vector<std::string> removed;
+    for(const auto &name : shared)
+      if(summaries[i].definitions.count(name))
+        removed.push_back(name);
+    if(removed.empty())
+      continue;
+
+    llvm::LLVMContext ctx;
+    std::unique_ptr<llvm::Module> M = parse_bitcode(images[i].bitcode, ctx, error);
+    if(!M)
+      return false;
+    for(const auto &name : removed)
+      make_declaration(*M->getFunction(name));
+    run_global_dce(*M);
+
+    auto &imported = images[i].imported_symbols;
+    for(const auto &name : removed) {
+      llvm::Function *F = M->getFunction(name);
+      if(F && !F->use_empty() &&
+         std::find(imported.begin(), imported.end(), name) == imported.end())
+        imported.push_back(name);
+    }
+
+    if(!write_bitcode(*M, images[i].bitcode, error)) {
+      error = images[i].name + ": " + error;
+      return false;
+    }
+    images[i].modified = true;
+    result.num_removed_definitions += removed.size();
+  }
+
+  // Same heuristic as in the SSCP compiler: Functions are imported if they
+  // are not defined, not intrinsics and not builtins starting with __.
+  for(auto &F : *shared_module) {
+    if(F.isDeclaration() && !F.isIntrinsic() &&
+       F.getName().substr(0, 2) != "__")
+      result.shared_imported_symbols.push_back(F.getName().str());
+  }
+  result.shared_functions.assign(shared.begin(), shared.end());
+  return write_bitcode(*shared_module, result.shared_bitcode, error);
+}
+
+}
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2024 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ACPP_HCF_TOOL_LLVM_FUNCTION_DEDUP_HPP
+#define ACPP_HCF_TOOL_LLVM_FUNCTION_DEDUP_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hipsycl {
+namespace hcf_tool {
+
+struct llvm_ir_image {
+  // Only used for diagnostics
+  std::string name;
+  std::string bitcode;
+  std::vector<std::string> imported_symbols;
+  // Set by deduplicate_functions() if bitcode and imported_symbols
+  // were rewritten
+  bool modified = false;
+};
+
+struct function_dedup_result {
+  // Module containing the one remaining definition of each shared function.
+  // Empty if no functions were shared.
+  std::string shared_bitcode;
+  std::vector<std::string> shared_functions;
+  std::vector<std::string> shared_imported_symbols;
+  // Number of definitions that were removed from the input images
+  std::size_t num_removed_definitions = 0;
+};
+
+// Computes content hashes of all externally visible function definitions
+// in the given bitcode. The hash does not depend on debug info, metadata,
+// value names or the names of internal functions and variables that the
+// function refers to, but it covers the content of all functions defined
+// in the module that the function calls. Functions whose hash cannot be
+// computed reliably (e.g. because they depend on recursive internal
+// functions) are omitted.
+bool hash_functions(const std::string &bitcode,
+                    std::unordered_map<std::string, uint64_t> &hashes,
+                    std::string &error);
+
+// Finds linkonce_odr/weak_odr functions that are defined with identical
+// content in multiple images, moves their definitions into one shared
+// module and turns the remaining definitions into declarations that are
+// resolved from the shared module when the images are linked by the JIT.
+// Functions are only shared if everything they refer to remains available,
+// i.e. if they only depend on other shared functions, internal functions
+// and variables (which are copied along), ODR variables and declarations.
+bool deduplicate_functions(std::vector<llvm_ir_image> &images,
+                           function_dedup_result &result,
+                           std::string &error);
+
+}
+}
+
+#endif
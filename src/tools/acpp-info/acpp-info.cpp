@@ -32,6 +32,7 @@
 #include "hipSYCL/runtime/runtime.hpp"
 #include "hipSYCL/runtime/hardware.hpp"
 #include "hipSYCL/runtime/executor.hpp"
+#include "hipSYCL/runtime/perf_counters.hpp"
 
 using namespace hipsycl;
 
@@ -191,12 +192,28 @@ void list_devices(rt::runtime* rt) {
   });
 }
 
+void list_perf_counters() {
+  std::cout << "***************** Performance counters *****************"
+            << std::endl;
+  for(const auto& c : rt::perf_counter_registry::get().read_all()) {
+    std::cout << c.name;
+    if(c.kind == rt::perf_counter_kind::high_water_mark)
+      std::cout << " (high-water mark)";
+    std::cout << "\n  " << c.description << std::endl;
+  }
+  std::cout << "memcpy.bytes[<source device>-><destination device>]\n"
+            << "  Bytes transferred between a pair of devices (created on "
+               "first transfer)"
+            << std::endl;
+}
+
 void print_help(const char* exe_name)
 {
     std::cout << "Usage: " << exe_name << " [options]\n\n";
     std::cout << "Options:\n";
-    std::cout << "\t-h, --help              Show this message.\n";
-    std::cout << "\t-l, --list-devices      Only list backends and devices, without detailed information.\n";
+    std::cout << "\t-h, --help                Show this message.\n";
+    std::cout << "\t-l, --list-devices        Only list backends and devices, without detailed information.\n";
+    std::cout << "\t-p, --list-perf-counters  List available runtime performance counters.\n";
 }
 
 int main(int argc, char *argv[]) {
@@ -210,6 +227,10 @@ int main(int argc, char *argv[]) {
     else if (current_arg == "-l" || current_arg == "--list-devices") {
       print_device_details = false;
     }
+    else if (current_arg == "-p" || current_arg == "--list-perf-counters") {
+      list_perf_counters();
+      return 0;
+    }
     else {
       std::cerr << "Unknown option: " << argv[arg] << std::endl;
       print_help(argv[0]);
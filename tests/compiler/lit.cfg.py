@@ -1,14 +1,42 @@
 import lit.formats
 import os
+import re
+import shutil
+import subprocess
 
 config.name = 'AdaptiveCpp Plugin'
 config.test_format = lit.formats.ShTest(True)
 
-config.suffixes = ['.c', '.cpp', '.cc']
+config.suffixes = ['.c', '.cpp', '.cc', '.ll']
 
 config.test_source_root = os.path.dirname(__file__)
 config.test_exec_root = os.path.join(config.my_obj_root)
 
+# Derive features from the configuration of the acpp compiler,
+# so that tests can declare e.g. "REQUIRES: lld, llvm-16-or-newer".
+acpp_configuration = ""
+try:
+  acpp_configuration = subprocess.run(
+    [config.acpp_compiler, "--acpp-version"], capture_output=True,
+    text=True).stdout
+except OSError:
+  pass
+
+acpp_clang_plugin = ""
+installation_root_match = re.search(r"Installation root:\s*(\S+)",
+                                    acpp_configuration)
+if installation_root_match:
+  acpp_clang_plugin = os.path.join(installation_root_match.group(1), "lib",
+                                   "libacpp-clang.so")
+if os.path.isfile(acpp_clang_plugin):
+  config.available_features.add("acpp-clang-plugin")
+
+# Must precede %acpp, which is a prefix of them
+config.substitutions.append(('%acpp-clang-plugin', acpp_clang_plugin))
+config.substitutions.append(('%acpp-hcf-tool', os.path.join(
+  os.path.dirname(config.acpp_compiler), "acpp-hcf-tool")))
+config.substitutions.append(('%acpp-dag-replay', os.path.join(
+  os.path.dirname(config.acpp_compiler), "acpp-dag-replay")))
 config.substitutions.append(('%acpp', config.acpp_compiler))
 
 if "ACPP_DEBUG_LEVEL" in os.environ:
@@ -18,3 +46,22 @@ if "ACPP_VISIBILITY_MASK" in os.environ:
 if "ACPP_HCF_DUMP_DIRECTORY" in os.environ:
   config.environment["ACPP_HCF_DUMP_DIRECTORY"] = os.environ["ACPP_HCF_DUMP_DIRECTORY"]
 
+llvm_version_match = re.search(r"plugin-llvm-version-major:\s*(\d+)",
+                               acpp_configuration)
+if llvm_version_match:
+  llvm_version = int(llvm_version_match.group(1))
+  for v in range(1, llvm_version + 1):
+    config.available_features.add("llvm-{}-or-newer".format(v))
+
+tool_search_path = os.environ.get("PATH", "")
+clang_match = re.search(r"default-clang:\s*(\S+)", acpp_configuration)
+if clang_match and os.path.isabs(clang_match.group(1)):
+  tool_search_path = os.path.dirname(clang_match.group(1)) + os.pathsep + tool_search_path
+if shutil.which("ld.lld", path=tool_search_path):
+  config.available_features.add("lld")
+
+# IR-level tests run LLVM tools from the same installation as clang
+if all(shutil.which(tool, path=tool_search_path)
+       for tool in ["opt", "llvm-link", "split-file"]):
+  config.available_features.add("llvm-tools")
+  config.environment["PATH"] = tool_search_path
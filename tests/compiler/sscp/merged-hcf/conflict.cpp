@@ -0,0 +1,47 @@
+// RUN: %acpp %s -c -o %t.a.o --acpp-targets=generic -DHELPER_TU -DOFFSET=1
+// RUN: %acpp %s -c -o %t.b.o --acpp-targets=generic -DOFFSET=2
+// RUN: %acpp %t.a.o %t.b.o -o %t --acpp-targets=generic
+// RUN: rm -rf %t.dump && mkdir -p %t.dump
+// RUN: env ACPP_HCF_DUMP_DIRECTORY=%t.dump %t
+// RUN: not %acpp-hcf-tool --merge %t.dump/*.hcf > %t.merged.hcf 2> %t.merge.log
+// RUN: FileCheck %s < %t.merge.log
+
+// Merging must refuse kernels that have the same name but different
+// definitions in different objects.
+// CHECK: Conflicting definitions of kernel {{.*}}conflicting_kernel
+
+#include <sycl/sycl.hpp>
+#include "../common.hpp"
+
+// Deliberately differs between the translation units. Kernels are only
+// launched if arguments are given, since the HCF objects are dumped when
+// they are registered at startup.
+struct conflicting_kernel {
+  int* data;
+
+  void operator()(sycl::item<1> idx) const {
+    data[idx] += OFFSET;
+  }
+};
+
+void run_helper(sycl::queue& q, int* data);
+
+#ifdef HELPER_TU
+
+void run_helper(sycl::queue& q, int* data) {
+  q.parallel_for(sycl::range{16}, conflicting_kernel{data}).wait();
+}
+
+#else
+
+int main(int argc, char** argv) {
+  if(argc > 1) {
+    sycl::queue q = get_queue();
+    int* data = sycl::malloc_shared<int>(16, q);
+    q.parallel_for(sycl::range{16}, conflicting_kernel{data}).wait();
+    run_helper(q, data);
+    sycl::free(data, q);
+  }
+}
+
+#endif
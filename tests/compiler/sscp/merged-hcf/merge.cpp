@@ -0,0 +1,79 @@
+// RUN: %acpp %s -c -o %t.helper.o --acpp-targets=generic -DHELPER_TU
+// RUN: %acpp %s -c -o %t.main.o --acpp-targets=generic
+// RUN: %acpp %t.main.o %t.helper.o -o %t --acpp-targets=generic
+// RUN: rm -rf %t.dump && mkdir -p %t.dump
+// RUN: env ACPP_HCF_DUMP_DIRECTORY=%t.dump %t | FileCheck %s
+// RUN: %acpp-hcf-tool --merge %t.dump/*.hcf > %t.merged.hcf 2> %t.merge.log
+// RUN: FileCheck %s --check-prefix=MERGE < %t.merge.log
+// RUN: %acpp-hcf-tool %t.merged.hcf -p root | FileCheck %s --check-prefix=CONTENT
+// RUN: env ACPP_RT_MERGED_HCF=%t.merged.hcf ACPP_DEBUG_LEVEL=3 %t | FileCheck %s --check-prefixes=REDIRECT,CHECK
+
+#include <iostream>
+
+#include <sycl/sycl.hpp>
+#include "../common.hpp"
+
+// Used by kernels of both translation units
+template<class T>
+T transform_value(T x) {
+  return 3 * x + 1;
+}
+
+// Kernel that is instantiated in both translation units
+struct common_kernel {
+  int* data;
+
+  void operator()(sycl::item<1> idx) const {
+    data[idx] = transform_value(data[idx]);
+  }
+};
+
+void run_helper(sycl::queue& q, int* data);
+
+#ifdef HELPER_TU
+
+void run_helper(sycl::queue& q, int* data) {
+  q.parallel_for(sycl::range{16}, common_kernel{data}).wait();
+  q.parallel_for(sycl::range{16}, [=](auto idx){
+    data[idx] = transform_value(data[idx]) + 1;
+  }).wait();
+}
+
+#else
+
+int main() {
+  sycl::queue q = get_queue();
+
+  int* data = sycl::malloc_shared<int>(16, q);
+  for(int i = 0; i < 16; ++i)
+    data[i] = i;
+
+  q.parallel_for(sycl::range{16}, common_kernel{data}).wait();
+  q.parallel_for(sycl::range{16}, [=](auto idx){
+    data[idx] = transform_value(data[idx]) - 1;
+  }).wait();
+  run_helper(q, data);
+
+  // MERGE: Moved {{[1-9][0-9]*}} definitions of {{[1-9][0-9]*}} functions into shared image llvm-ir.shared
+  // MERGE: Merged 2 HCF objects: 0 of 2 device images, 1 kernels and 0 exported symbols were duplicates
+
+  // CONTENT: llvm-ir.shared:
+  // CONTENT-NEXT: variant = global-module
+  // CONTENT-NEXT: format = llvm-ir
+  // CONTENT: exported-symbols:
+  // CONTENT: _Z15transform_valueIiET_S0_:
+  // CONTENT: merged-object-ids:
+
+  // REDIRECT: hcf_cache: Loading merged HCF object
+  // REDIRECT: is part of merged HCF object
+  // REDIRECT: Symbol _Z15transform_valueIiET_S0_ is registered as exported by object {{[0-9]+}} and image llvm-ir.shared
+
+  // CHECK: 32
+  // CHECK: 1247
+  std::cout << data[0] << std::endl;
+  std::cout << data[15] << std::endl;
+
+  sycl::free(data, q);
+}
+
+#endif
@@ -0,0 +1,73 @@
+// RUN: %acpp %s -o %t --acpp-targets=generic
+// RUN: %t | FileCheck %s
+// RUN: %acpp %s -o %t --acpp-targets=generic -O3
+// RUN: %t | FileCheck %s
+// RUN: %acpp %s -o %t --acpp-targets=generic -g
+// RUN: %t | FileCheck %s
+
+#include <iostream>
+
+#include <sycl/sycl.hpp>
+#include "common.hpp"
+
+int main()
+{
+  sycl::queue q = get_queue();
+
+  constexpr std::size_t group_size = 128;
+  constexpr std::size_t num_groups = 4;
+
+  int* data = sycl::malloc_shared<int>(group_size * num_groups, q);
+  int* group_sums = sycl::malloc_shared<int>(num_groups, q);
+
+  q.submit([&](sycl::handler& cgh){
+    cgh.parallel(sycl::range{num_groups}, sycl::range{group_size},
+      [=](auto grp){
+        sycl::memory_environment(grp, sycl::require_local_mem<int[group_size]>(),
+          [&](auto& scratch){
+            sycl::distribute_items_and_wait(grp, [&](sycl::s_item<1> idx){
+              data[idx.get_global_id(0)] = idx.get_global_id(0);
+              scratch[idx.get_innermost_local_id(0)] = 1;
+            });
+            sycl::single_item(grp, [&](){
+              int sum = 0;
+              for(int i = 0; i < group_size; ++i)
+                sum += scratch[i];
+              group_sums[grp.get_group_id(0)] = sum;
+            });
+          });
+      });
+  }).wait();
+
+  // CHECK: 0
+  // CHECK: 129
+  // CHECK: 511
+  std::cout << data[0] << std::endl;
+  std::cout << data[129] << std::endl;
+  std::cout << data[511] << std::endl;
+  for(int i = 0; i < num_groups; ++i)
+    // CHECK: 128
+    // CHECK: 128
+    // CHECK: 128
+    // CHECK: 128
+    std::cout << group_sums[i] << std::endl;
+
+  q.submit([&](sycl::handler& cgh){
+    cgh.parallel_for_work_group(sycl::range{num_groups},
+      sycl::range{group_size}, [=](sycl::group<1> grp){
+        grp.parallel_for_work_item([&](sycl::h_item<1> idx){
+          data[idx.get_global_id(0)] = 2 * idx.get_global_id(0);
+        });
+      });
+  }).wait();
+
+  // CHECK: 0
+  // CHECK: 258
+  // CHECK: 1022
+  std::cout << data[0] << std::endl;
+  std::cout << data[129] << std::endl;
+  std::cout << data[511] << std::endl;
+
+  sycl::free(data, q);
+  sycl::free(group_sums, q);
+}
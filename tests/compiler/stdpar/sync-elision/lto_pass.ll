@@ -0,0 +1,130 @@
+; REQUIRES: acpp-clang-plugin, llvm-tools, llvm-15-or-newer
+; RUN: rm -rf %t && split-file %s %t
+; RUN: opt -load-pass-plugin=%acpp-clang-plugin -passes=acpp-stdpar-sync-elision-summary %t/helper.ll -S -o %t/helper.opt.ll
+; RUN: FileCheck %s --check-prefix=SUMMARY < %t/helper.opt.ll
+; RUN: opt -load-pass-plugin=%acpp-clang-plugin -passes=acpp-stdpar-sync-elision-summary,acpp-stdpar-sync-elision %t/main.ll -S -o %t/main.opt.ll
+; RUN: FileCheck %s --check-prefix=COMPILE < %t/main.opt.ll
+; RUN: llvm-link %t/main.opt.ll %t/helper.opt.ll -S -o %t/linked.ll
+; RUN: opt -load-pass-plugin=%acpp-clang-plugin -passes=acpp-stdpar-sync-elision-summary,acpp-stdpar-sync-elision-lto %t/linked.ll -S | FileCheck %s --check-prefix=LTO
+
+; Runs the steps of a cross-TU LTO build on IR: The helper TU receives the
+; summary, the main TU synchronizes before the call to the unknown function,
+; and after merging the modules the synchronization moves beyond that call.
+
+; SUMMARY: define i32 @accumulate(i32 %n) [[ACCUMULATE_ATTRS:#[0-9]+]]
+; SUMMARY: define i32 @copy_global() [[COPY_ATTRS:#[0-9]+]]
+; SUMMARY: attributes [[ACCUMULATE_ATTRS]] = { noinline "hipsycl-stdpar-no-sync" }
+; SUMMARY: attributes [[COPY_ATTRS]] = { noinline }
+
+; COMPILE-LABEL: define i32 @main()
+; COMPILE: call void @stdpar_call()
+; COMPILE-NEXT: call void @stdpar_call()
+; COMPILE-NEXT: call void @__acpp_stdpar_optional_barrier(), !hipsycl.stdpar.sync_before_call
+; COMPILE-NEXT: call i32 @accumulate(i32 10)
+
+; LTO-LABEL: define i32 @main()
+; LTO: call void @stdpar_call()
+; LTO-NEXT: call void @stdpar_call()
+; LTO-NEXT: call i32 @accumulate(i32 10)
+; LTO-NEXT: call i32 @get_num_enqueued_ops()
+; LTO-NEXT: call void @__acpp_stdpar_optional_barrier()
+; LTO-NEXT: call i32 @copy_global()
+
+;--- helper.ll
+declare void @llvm.lifetime.start.p0(i64, ptr nocapture)
+declare void @llvm.lifetime.end.p0(i64, ptr nocapture)
+declare void @llvm.memset.p0.i64(ptr nocapture writeonly, i8, i64, i1 immarg)
+declare void @llvm.memcpy.p0.p0.i64(ptr noalias nocapture writeonly, ptr noalias nocapture readonly, i64, i1 immarg)
+declare void @llvm.dbg.value(metadata, metadata, metadata)
+
+@global_buf = global [16 x i32] zeroinitializer
+
+; Only accesses its own stack memory, through instructions and intrinsics
+; that are typically present in optimized code with local variables.
+define i32 @accumulate(i32 %n) noinline {
+entry:
+  %values = alloca [16 x i32]
+  %copy = alloca [16 x i32]
+  %acc = alloca i32
+  call void @llvm.lifetime.start.p0(i64 64, ptr %values)
+  call void @llvm.lifetime.start.p0(i64 64, ptr %copy)
+  call void @llvm.lifetime.start.p0(i64 4, ptr %acc)
+  call void @llvm.dbg.value(metadata i32 %n, metadata !10, metadata !DIExpression()), !dbg !11
+  call void @llvm.memset.p0.i64(ptr %values, i8 0, i64 64, i1 false)
+  %p = getelementptr [16 x i32], ptr %values, i64 0, i64 1
+  store i32 %n, ptr %p
+  call void @llvm.memcpy.p0.p0.i64(ptr %copy, ptr %values, i64 64, i1 false)
+  store volatile i32 0, ptr %acc
+  %q = getelementptr [16 x i32], ptr %copy, i64 0, i64 1
+  %x = load i32, ptr %q
+  %old = load volatile i32, ptr %acc
+  %new = add i32 %old, %x
+  store volatile i32 %new, ptr %acc
+  %r = load volatile i32, ptr %acc
+  call void @llvm.lifetime.end.p0(i64 4, ptr %acc)
+  call void @llvm.lifetime.end.p0(i64 64, ptr %copy)
+  call void @llvm.lifetime.end.p0(i64 64, ptr %values)
+  ret i32 %r
+}
+
+; Copies from global memory, which may be used by stdpar operations
+define i32 @copy_global() noinline {
+entry:
+  %buf = alloca [16 x i32]
+  call void @llvm.memcpy.p0.p0.i64(ptr %buf, ptr @global_buf, i64 64, i1 false)
+  %x = load i32, ptr %buf
+  ret i32 %x
+}
+
+!llvm.module.flags = !{!0}
+!llvm.dbg.cu = !{!1}
+!0 = !{i32 2, !"Debug Info Version", i32 3}
+!1 = distinct !DICompileUnit(language: DW_LANG_C_plus_plus_14, file: !2, isOptimized: true, runtimeVersion: 0, emissionKind: FullDebug)
+!2 = !DIFile(filename: "helper.cpp", directory: "/")
+!3 = distinct !DISubprogram(name: "accumulate", scope: !2, file: !2, line: 1, type: !4, scopeLine: 1, spFlags: DISPFlagDefinition | DISPFlagOptimized, unit: !1)
+!4 = !DISubroutineType(types: !5)
+!5 = !{!6, !6}
+!6 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!10 = !DILocalVariable(name: "n", arg: 1, scope: !3, file: !2, line: 1, type: !6)
+!11 = !DILocation(line: 1, scope: !3)
+
+;--- main.ll
+@num_outstanding_operations = internal global i32 0
+@.entrypoint = private unnamed_addr constant [26 x i8] c"hipsycl_stdpar_entrypoint\00", section "llvm.metadata"
+@.file = private unnamed_addr constant [9 x i8] c"main.cpp\00", section "llvm.metadata"
+@llvm.global.annotations = appending global [2 x { ptr, ptr, ptr, i32, ptr }] [
+  { ptr, ptr, ptr, i32, ptr } { ptr @stdpar_call, ptr @.entrypoint, ptr @.file, i32 1, ptr null },
+  { ptr, ptr, ptr, i32, ptr } { ptr @get_num_enqueued_ops, ptr @.entrypoint, ptr @.file, i32 1, ptr null }
+], section "llvm.metadata"
+
+define void @__acpp_stdpar_optional_barrier() noinline {
+  store i32 0, ptr @num_outstanding_operations
+  ret void
+}
+
+define internal void @stdpar_call() noinline {
+  %v = load i32, ptr @num_outstanding_operations
+  %w = add i32 %v, 1
+  store i32 %w, ptr @num_outstanding_operations
+  call void @__acpp_stdpar_optional_barrier()
+  ret void
+}
+
+define internal i32 @get_num_enqueued_ops() noinline {
+  %v = load i32, ptr @num_outstanding_operations
+  ret i32 %v
+}
+
+declare i32 @accumulate(i32)
+declare i32 @copy_global()
+
+define i32 @main() {
+  call void @stdpar_call()
+  call void @stdpar_call()
+  %r = call i32 @accumulate(i32 10)
+  %n = call i32 @get_num_enqueued_ops()
+  %g = call i32 @copy_global()
+  %s = add i32 %n, %g
+  %t = add i32 %s, %r
+  ret i32 %t
+}
@@ -0,0 +1,49 @@
+// REQUIRES: lld, llvm-16-or-newer
+// RUN: %acpp %s -c -o %t.helper.o -DHELPER_TU --acpp-targets=generic -O3 -flto --acpp-stdpar --acpp-stdpar-unconditional-offload
+// RUN: %acpp %s -c -o %t.main.o --acpp-targets=generic -O3 -flto --acpp-stdpar --acpp-stdpar-unconditional-offload
+// RUN: env ACPP_DEBUG_LEVEL=3 %acpp %t.main.o %t.helper.o -o %t --acpp-targets=generic -O3 -flto -fuse-ld=lld --acpp-stdpar --acpp-stdpar-unconditional-offload 2>&1 | FileCheck %s --check-prefix=LTO
+// RUN: %t | FileCheck %s
+
+#include <cstdio>
+
+#ifdef HELPER_TU
+
+// Only accesses its own stack memory, so the compiler can attach a summary
+// stating that no synchronization is required when calling it. The local
+// array is initialized and copied with mem intrinsics, and both locals
+// come with lifetime markers.
+__attribute__((noinline))
+int accumulate(int n) {
+  int values[16] = {};
+  int copy[16];
+  for(int i = 0; i < n && i < 16; ++i)
+    values[i] = i;
+  __builtin_memcpy(copy, values, sizeof(values));
+
+  volatile int acc = 0;
+  for(int i = 0; i < 16; ++i)
+    acc += copy[i];
+  return acc;
+}
+
+#else
+
+#include "common.hpp"
+
+int accumulate(int n);
+
+int main() {
+  stdpar_call();
+  stdpar_call();
+  // accumulate() is defined in another TU. During LTO, its summary should
+  // allow moving the synchronization beyond this call.
+  // LTO: Moving synchronization beyond call to {{.*}}accumulate{{.*}} in function main
+  int result = accumulate(10);
+
+  // CHECK: 2
+  printf("%d\n", get_num_enqueued_ops());
+  // CHECK: 45
+  printf("%d\n", result);
+}
+
+#endif
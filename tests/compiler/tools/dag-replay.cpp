@@ -0,0 +1,52 @@
+// RUN: %acpp %s -o %t --acpp-targets=omp
+// RUN: rm -f %t.trace
+// RUN: env ACPP_RT_DAG_TRACE_FILE=%t.trace %t | FileCheck %s
+// RUN: %acpp-dag-replay %t.trace | FileCheck %s --check-prefix=REPLAY
+// RUN: %acpp-dag-replay %t.trace --batch-size 1 | FileCheck %s --check-prefix=BATCH
+// RUN: not %acpp-dag-replay %t.missing.trace | FileCheck %s --check-prefix=MISSING
+
+#include <iostream>
+
+#include <sycl/sycl.hpp>
+
+int main() {
+  sycl::queue q;
+  constexpr std::size_t size = 1024;
+
+  sycl::buffer<int> a{sycl::range{size}};
+  sycl::buffer<int> b{sycl::range{size}};
+
+  q.submit([&](sycl::handler& cgh) {
+    sycl::accessor acc{a, cgh, sycl::write_only, sycl::no_init};
+    cgh.parallel_for<class init_kernel>(sycl::range{size}, [=](sycl::id<1> idx) {
+      acc[idx] = static_cast<int>(idx[0]);
+    });
+  });
+  for(int i = 0; i < 2; ++i) {
+    q.submit([&](sycl::handler& cgh) {
+      sycl::accessor in{a, cgh, sycl::read_only};
+      sycl::accessor out{b, cgh, sycl::write_only, sycl::no_init};
+      cgh.parallel_for<class scale_kernel>(sycl::range{size}, [=](sycl::id<1> idx) {
+        out[idx] = 2 * in[idx];
+      });
+    });
+  }
+
+  sycl::host_accessor result{b, sycl::read_only};
+  // CHECK: 2046
+  std::cout << result[size - 1] << std::endl;
+}
+
+// REPLAY: Trace: {{.*}}.trace
+// REPLAY: Operations: {{[1-9][0-9]*}} ({{[1-9][0-9]*}} with measured duration)
+// REPLAY: Scheduling:
+// REPLAY: DAG flushes: {{[1-9][0-9]*}}
+// REPLAY: Simulation (
+// REPLAY: Critical path:
+// REPLAY: Operations by total time
+// REPLAY-DAG: {{^ +}}2, {{[0-9.]+}}, {{[0-9.]+}}: {{.+}}
+// REPLAY-DAG: {{^ +}}1, {{[0-9.]+}}, {{[0-9.]+}}: {{.+}}
+
+// BATCH: DAG flushes: {{[1-9][0-9]*}} (batch size 1)
+
+// MISSING: Could not read DAG trace: {{.*}}.missing.trace
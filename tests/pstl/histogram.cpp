@@ -0,0 +1,108 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2023 Aksel Alpay
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <numeric>
+#include <execution>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "pstl_test_suite.hpp"
+
+BOOST_FIXTURE_TEST_SUITE(pstl_histogram, enable_unified_shared_memory)
+
+template<class T>
+std::vector<T> make_data(std::size_t size) {
+  std::vector<T> data(size);
+  for(std::size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<T>((i * 7919) % 130) - T{10};
+  return data;
+}
+
+template<class T>
+void test_even_width(std::size_t size, std::size_t num_bins) {
+  std::vector<T> data = make_data<T>(size);
+  const T lower = 0;
+  const T upper = 100;
+
+  std::vector<unsigned> reference(num_bins, 0);
+  for(T x : data) {
+    if(x >= lower && x < upper) {
+      T bin = (x - lower) * static_cast<T>(num_bins) / (upper - lower);
+      ++reference[static_cast<std::size_t>(bin)];
+    }
+  }
+
+  std::vector<unsigned> bins(num_bins, 42);
+  auto ret = hipsycl::stdpar::histogram(std::execution::par_unseq,
+                                        data.begin(), data.end(), num_bins,
+                                        lower, upper, bins.begin());
+  BOOST_CHECK(ret == bins.end());
+  BOOST_CHECK(bins == reference);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_empty) {
+  test_even_width<int>(0, 16);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_single_element) {
+  test_even_width<int>(1, 16);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_even_width_few_bins) {
+  test_even_width<int>(1000, 7);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_even_width_many_bins) {
+  test_even_width<int>(100000, 100);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_even_width_float) {
+  test_even_width<float>(100000, 10);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_custom_edges) {
+  std::vector<int> data = make_data<int>(100000);
+  std::vector<int> edges{-5, 0, 3, 50, 51, 119};
+
+  std::vector<unsigned> reference(edges.size() - 1, 0);
+  for(int x : data)
+    for(std::size_t i = 0; i + 1 < edges.size(); ++i)
+      if(x >= edges[i] && x < edges[i + 1])
+        ++reference[i];
+
+  std::vector<unsigned> bins(edges.size() - 1, 42);
+  auto ret = hipsycl::stdpar::histogram(std::execution::par_unseq,
+                                        data.begin(), data.end(),
+                                        edges.begin(), edges.end(),
+                                        bins.begin());
+  BOOST_CHECK(ret == bins.end());
+  BOOST_CHECK(bins == reference);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
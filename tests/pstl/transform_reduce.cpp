@@ -27,6 +27,7 @@
 
 #include <numeric>
 #include <execution>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -144,5 +145,50 @@ BOOST_AUTO_TEST_CASE(par_unseq_aggregate_4_double) {
   BOOST_CHECK_EQUAL(res.d,  reference_result.d);
 }
 
+void test_fused_reduction(std::size_t size) {
+  std::vector<int> data(size);
+  for(std::size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<int>((i * 7919) % 1000) - 300;
+
+  auto identity = [](int x) { return x; };
+  auto min_op = [](int a, int b) { return a < b ? a : b; };
+  auto max_op = [](int a, int b) { return a > b ? a : b; };
+  auto square = [](int x) { return static_cast<long long>(x) * x; };
+
+  auto descriptors = std::make_tuple(
+      hipsycl::algorithms::make_transform_reduce_descriptor(1000, min_op,
+                                                            identity),
+      hipsycl::algorithms::make_transform_reduce_descriptor(-1000, max_op,
+                                                            identity),
+      hipsycl::algorithms::make_transform_reduce_descriptor(
+          0ll, std::plus<>{}, [](int x) { return static_cast<long long>(x); }),
+      hipsycl::algorithms::make_transform_reduce_descriptor(
+          0ll, std::plus<>{}, square));
+
+  auto res = hipsycl::stdpar::transform_reduce(
+      std::execution::par_unseq, data.begin(), data.end(), descriptors);
+
+  BOOST_CHECK_EQUAL(std::get<0>(res), std::transform_reduce(
+      data.begin(), data.end(), 1000, min_op, identity));
+  BOOST_CHECK_EQUAL(std::get<1>(res), std::transform_reduce(
+      data.begin(), data.end(), -1000, max_op, identity));
+  BOOST_CHECK_EQUAL(std::get<2>(res), std::transform_reduce(
+      data.begin(), data.end(), 0ll, std::plus<>{},
+      [](int x) { return static_cast<long long>(x); }));
+  BOOST_CHECK_EQUAL(std::get<3>(res), std::transform_reduce(
+      data.begin(), data.end(), 0ll, std::plus<>{}, square));
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_fused_empty) {
+  test_fused_reduction(0);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_fused_single_element) {
+  test_fused_reduction(1);
+}
+
+BOOST_AUTO_TEST_CASE(par_unseq_fused_large) {
+  test_fused_reduction(1000*1000);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
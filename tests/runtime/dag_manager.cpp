@@ -0,0 +1,160 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "runtime_test_suite.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <hipSYCL/runtime/application.hpp>
+#include <hipSYCL/runtime/dag_builder.hpp>
+#include <hipSYCL/runtime/dag_manager.hpp>
+#include <hipSYCL/runtime/perf_counters.hpp>
+
+using namespace hipsycl;
+
+namespace {
+
+// Creates a node that remains incomplete until it is cancelled
+rt::dag_node_ptr make_pending_node(rt::runtime *rt,
+                                   rt::dag_builder &builder) {
+  rt::execution_hints hints;
+  rt::device_id id{rt::backend_descriptor{rt::hardware_platform::cpu,
+                                          rt::api_platform::omp},
+                   12345};
+  hints.set_hint(rt::hints::bind_to_device{id});
+  auto reqs = rt::requirements_list{rt};
+  auto op = rt::make_operation<rt::kernel_operation>(
+      "test_kernel",
+      common::auto_small_vector<std::unique_ptr<rt::backend_kernel_launcher>>{},
+      reqs);
+  return builder.add_command_group(std::move(op), reqs, hints);
+}
+
+uint64_t read_counter(rt::perf_counter_id id) {
+  return rt::perf_counter_registry::get().get(id).read();
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(dag_manager, reset_device_fixture)
+
+BOOST_AUTO_TEST_CASE(adaptive_flush_decisions) {
+  using namespace std::chrono_literals;
+  rt::runtime_keep_alive_token rt;
+  rt::dag_builder builder{rt.get()};
+
+  // Without a flush callback, no timer is running, so that all
+  // decisions are made by should_flush().
+  rt::adaptive_flush_policy policy{4, 50ms, {}};
+  rt::perf_counter_registry::get().reset_all();
+
+  BOOST_CHECK(!policy.should_flush(0));
+
+  // Nothing has been flushed yet, so executors are idle
+  BOOST_CHECK(policy.should_flush(1));
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flushes_idle) == 1);
+
+  rt::dag_node_ptr pending_node = make_pending_node(rt.get(), builder);
+  policy.notify_flush_begin();
+  policy.notify_flushed({pending_node});
+
+  // While the last flush is pending, nodes are collected into batches
+  // whose size doubles with each full batch, up to the maximum.
+  BOOST_CHECK(policy.get_batch_size() == 1);
+  BOOST_CHECK(policy.should_flush(1));
+  BOOST_CHECK(policy.get_batch_size() == 2);
+  policy.notify_flush_begin();
+  BOOST_CHECK(!policy.should_flush(1));
+  BOOST_CHECK(policy.should_flush(2));
+  BOOST_CHECK(policy.get_batch_size() == 4);
+  policy.notify_flush_begin();
+  BOOST_CHECK(policy.should_flush(4));
+  BOOST_CHECK(policy.get_batch_size() == 4);
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flushes_batch_full) == 3);
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flush_batch_size_max) ==
+              4);
+
+  // Incomplete batches are flushed once the oldest unflushed node
+  // exceeds the maximum latency.
+  policy.notify_flush_begin();
+  BOOST_CHECK(!policy.should_flush(1));
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flushes_latency_bound) ==
+              0);
+  std::this_thread::sleep_for(60ms);
+  BOOST_CHECK(policy.should_flush(1));
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flushes_latency_bound) ==
+              1);
+
+  // Once the last flush has completed, the batch size shrinks again
+  pending_node->cancel();
+  policy.notify_flush_begin();
+  BOOST_CHECK(policy.should_flush(1));
+  BOOST_CHECK(policy.get_batch_size() == 2);
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flushes_idle) == 2);
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flushes_batch_full) == 3);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_flush_timer) {
+  using namespace std::chrono_literals;
+  rt::runtime_keep_alive_token rt;
+  rt::dag_builder builder{rt.get()};
+
+  std::atomic<int> num_timer_flushes = 0;
+  rt::adaptive_flush_policy* policy_ptr = nullptr;
+  rt::adaptive_flush_policy policy{4, 100ms, [&]() {
+                                     policy_ptr->notify_flush_begin();
+                                     ++num_timer_flushes;
+                                   }};
+  policy_ptr = &policy;
+
+  rt::dag_node_ptr pending_node = make_pending_node(rt.get(), builder);
+  policy.notify_flushed({pending_node});
+  // Grow the batch, so that a single node is not flushed immediately
+  BOOST_CHECK(policy.should_flush(1));
+  policy.notify_flush_begin();
+  num_timer_flushes = 0;
+  rt::perf_counter_registry::get().reset_all();
+
+  BOOST_CHECK(!policy.should_flush(1));
+  auto deadline = std::chrono::steady_clock::now() + 10s;
+  while(num_timer_flushes == 0 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(1ms);
+  BOOST_CHECK(num_timer_flushes == 1);
+  BOOST_CHECK(read_counter(rt::perf_counter_id::dag_flushes_latency_bound) ==
+              1);
+
+  // Without unflushed nodes, the timer does not flush again
+  std::this_thread::sleep_for(200ms);
+  BOOST_CHECK(num_timer_flushes == 1);
+
+  pending_node->cancel();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
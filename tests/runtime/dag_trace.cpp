@@ -0,0 +1,172 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "runtime_test_suite.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <hipSYCL/runtime/dag_trace.hpp>
+
+using namespace hipsycl;
+
+namespace {
+
+std::string get_trace_file() {
+  return (std::filesystem::temp_directory_path() / "acpp_dag_trace_test.trace")
+      .string();
+}
+
+rt::dag_trace_access make_access(uint64_t region_id, sycl::access::mode mode,
+                                 sycl::access::target target) {
+  rt::dag_trace_access access;
+  access.region_id = region_id;
+  access.element_size = 8;
+  for(int i = 0; i < 3; ++i) {
+    access.num_elements[i] = 16 * (i + 1);
+    access.page_size[i] = 4 * (i + 1);
+    access.offset[i] = i;
+    access.range[i] = 8 + i;
+  }
+  access.mode = mode;
+  access.target = target;
+  return access;
+}
+
+void check_equal(const rt::dag_trace_access &a,
+                 const rt::dag_trace_access &b) {
+  BOOST_CHECK_EQUAL(a.region_id, b.region_id);
+  BOOST_CHECK_EQUAL(a.element_size, b.element_size);
+  for(int i = 0; i < 3; ++i) {
+    BOOST_CHECK_EQUAL(a.num_elements[i], b.num_elements[i]);
+    BOOST_CHECK_EQUAL(a.page_size[i], b.page_size[i]);
+    BOOST_CHECK_EQUAL(a.offset[i], b.offset[i]);
+    BOOST_CHECK_EQUAL(a.range[i], b.range[i]);
+  }
+  BOOST_CHECK(a.mode == b.mode);
+  BOOST_CHECK(a.target == b.target);
+}
+
+void check_equal(const rt::dag_trace_record &a,
+                 const rt::dag_trace_record &b) {
+  BOOST_CHECK_EQUAL(a.node_id, b.node_id);
+  BOOST_CHECK(a.kind == b.kind);
+  BOOST_CHECK_EQUAL(a.name, b.name);
+  BOOST_CHECK_EQUAL(a.backend, b.backend);
+  BOOST_CHECK_EQUAL(a.device, b.device);
+  BOOST_CHECK_EQUAL(a.node_group, b.node_group);
+  BOOST_CHECK_EQUAL(a.preferred_lane, b.preferred_lane);
+  BOOST_CHECK_EQUAL(a.submission_time, b.submission_time);
+  BOOST_CHECK_EQUAL(a.start_time, b.start_time);
+  BOOST_CHECK_EQUAL(a.duration, b.duration);
+  BOOST_CHECK(a.dependencies == b.dependencies);
+  BOOST_REQUIRE_EQUAL(a.accesses.size(), b.accesses.size());
+  for(std::size_t i = 0; i < a.accesses.size(); ++i)
+    check_equal(a.accesses[i], b.accesses[i]);
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(dag_trace, reset_device_fixture)
+
+BOOST_AUTO_TEST_CASE(writer_reader_round_trip) {
+  std::vector<rt::dag_trace_record> records;
+
+  rt::dag_trace_record kernel;
+  kernel.node_id = 1;
+  kernel.kind = rt::dag_trace_operation_kind::kernel;
+  kernel.name = "my_kernel";
+  kernel.backend = 2;
+  kernel.device = 1;
+  kernel.node_group = 7;
+  kernel.preferred_lane = 3;
+  kernel.submission_time = 100;
+  kernel.start_time = 250;
+  kernel.duration = 1000;
+  kernel.accesses.push_back(make_access(1, sycl::access::mode::read,
+                                        sycl::access::target::device));
+  kernel.accesses.push_back(make_access(2, sycl::access::mode::discard_write,
+                                        sycl::access::target::device));
+  records.push_back(kernel);
+
+  // Repeated names are stored only once in the trace
+  rt::dag_trace_record second_kernel = kernel;
+  second_kernel.node_id = 2;
+  second_kernel.dependencies = {1};
+  second_kernel.submission_time = 150;
+  records.push_back(second_kernel);
+
+  rt::dag_trace_record requirement;
+  requirement.node_id = 3;
+  requirement.kind = rt::dag_trace_operation_kind::requirement;
+  requirement.dependencies = {1, 2};
+  requirement.accesses.push_back(make_access(
+      2, sycl::access::mode::read, sycl::access::target::host_buffer));
+  records.push_back(requirement);
+
+  // Defaults: no device, no lane preference, no measured duration
+  rt::dag_trace_record other;
+  other.node_id = 4;
+  records.push_back(other);
+
+  {
+    rt::dag_trace_writer writer{get_trace_file()};
+    BOOST_REQUIRE(writer.is_open());
+    for(const auto& record : records)
+      writer.write(record);
+  }
+
+  rt::dag_trace_reader reader{get_trace_file()};
+  BOOST_REQUIRE(reader.is_valid());
+  for(const auto& expected : records) {
+    rt::dag_trace_record read;
+    BOOST_REQUIRE(reader.read(read));
+    check_equal(read, expected);
+  }
+  rt::dag_trace_record end;
+  BOOST_CHECK(!reader.read(end));
+
+  std::filesystem::remove(get_trace_file());
+}
+
+BOOST_AUTO_TEST_CASE(reader_rejects_invalid_files) {
+  std::filesystem::remove(get_trace_file());
+  BOOST_CHECK(!rt::dag_trace_reader{get_trace_file()}.is_valid());
+
+  {
+    std::ofstream file{get_trace_file(), std::ios::binary};
+    file << "not a DAG trace";
+  }
+  BOOST_CHECK(!rt::dag_trace_reader{get_trace_file()}.is_valid());
+
+  std::filesystem::remove(get_trace_file());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -96,4 +96,59 @@ BOOST_AUTO_TEST_CASE(page_table) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(retained_resources) {
+  auto resource = std::make_shared<int>(42);
+  std::weak_ptr<int> weak_resource = resource;
+  {
+    auto region = std::make_shared<rt::buffer_data_region>(
+        rt::range<3>{16, 1, 1}, sizeof(int), rt::range<3>{16, 1, 1});
+    region->retain_resource(resource);
+    resource.reset();
+    BOOST_CHECK(!weak_resource.expired());
+  }
+  BOOST_CHECK(weak_resource.expired());
+}
+
+BOOST_AUTO_TEST_CASE(try_mark_range_accessed) {
+  rt::device_id host{rt::backend_descriptor{rt::hardware_platform::cpu,
+                                            rt::api_platform::omp},
+                     0};
+  rt::device_id other{rt::backend_descriptor{rt::hardware_platform::cpu,
+                                             rt::api_platform::omp},
+                      1};
+  int host_data[16];
+  int other_data[16];
+
+  rt::buffer_data_region region{rt::range<3>{1, 1, 16}, sizeof(int),
+                                rt::range<3>{1, 1, 4}};
+  region.add_nonempty_allocation(host, host_data, nullptr, false);
+  region.add_empty_allocation(other, other_data, nullptr, false);
+
+  const rt::id<3> first{0, 0, 0};
+  const rt::id<3> second{0, 0, 8};
+  const rt::range<3> size{1, 1, 8};
+
+  // Reading valid data does not change the data state
+  BOOST_CHECK(region.try_mark_range_accessed(host, first, size, true, false));
+  std::vector<rt::range_store::rect> outdated;
+  region.get_outdated_regions(other, first, size, outdated);
+  BOOST_CHECK(!outdated.empty());
+
+  // Writing outdated data is refused without modifying the data state
+  region.mark_range_current(other, second, size);
+  BOOST_CHECK(
+      !region.try_mark_range_accessed(host, second, size, true, true));
+  outdated.clear();
+  region.get_outdated_regions(host, second, size, outdated);
+  BOOST_CHECK(!outdated.empty());
+
+  // Discard accesses do not require valid data and make the host current
+  BOOST_CHECK(region.try_mark_range_accessed(host, second, size, false, true));
+  outdated.clear();
+  region.get_outdated_regions(host, second, size, outdated);
+  BOOST_CHECK(outdated.empty());
+  region.get_outdated_regions(other, second, size, outdated);
+  BOOST_CHECK(!outdated.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,204 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "runtime_test_suite.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+#include <hipSYCL/common/hcf_container.hpp>
+#include <hipSYCL/common/lz_compression.hpp>
+
+using namespace hipsycl;
+
+namespace {
+
+std::string make_random_data(std::size_t size) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> dist{0, 255};
+  std::string result(size, '\0');
+  for(char& c : result)
+    c = static_cast<char>(dist(gen));
+  return result;
+}
+
+std::string make_text_data(std::size_t size) {
+  const std::string words[] = {"kernel ", "device ", "queue ", "buffer ",
+                               "accessor ", "range "};
+  std::mt19937 gen{7};
+  std::uniform_int_distribution<std::size_t> dist{0, std::size(words) - 1};
+  std::string result;
+  while(result.size() < size)
+    result += words[dist(gen)];
+  result.resize(size);
+  return result;
+}
+
+void check_round_trip(const std::string& data) {
+  std::string compressed = common::lz::compress(data);
+  std::string decompressed;
+  BOOST_CHECK(common::lz::decompress(compressed.data(), compressed.size(),
+                                     data.size(), decompressed));
+  BOOST_CHECK(decompressed == data);
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(hcf_container, reset_device_fixture)
+BOOST_AUTO_TEST_CASE(lz_empty_input) {
+  check_round_trip(std::string{});
+
+  std::string decompressed = "x";
+  BOOST_CHECK(common::lz::decompress(nullptr, 0, 0, decompressed));
+  BOOST_CHECK(decompressed.empty());
+}
+
+BOOST_AUTO_TEST_CASE(lz_short_inputs) {
+  std::string data = make_text_data(32);
+  for(std::size_t size = 1; size <= data.size(); ++size)
+    check_round_trip(data.substr(0, size));
+}
+
+BOOST_AUTO_TEST_CASE(lz_incompressible_data) {
+  // Includes literal runs longer than 255 bytes, which need
+  // several length bytes.
+  std::string data = make_random_data(100000);
+  check_round_trip(data);
+}
+
+BOOST_AUTO_TEST_CASE(lz_long_matches) {
+  std::string data(1 << 20, 'a');
+  std::string compressed = common::lz::compress(data);
+  BOOST_CHECK(compressed.size() < data.size() / 100);
+  check_round_trip(data);
+
+  // Matches of the maximum offset and beyond
+  std::string block = make_random_data(70000);
+  check_round_trip(block + block);
+  check_round_trip(block.substr(0, 65535) + block.substr(0, 65535));
+
+  check_round_trip(make_text_data(300000));
+}
+
+BOOST_AUTO_TEST_CASE(lz_overlapping_copies) {
+  // Matches with offsets shorter than their length copy
+  // output that they produce themselves.
+  for(std::size_t period : {1, 2, 3, 5, 17}) {
+    std::string pattern = make_random_data(period);
+    std::string data;
+    for(int i = 0; i < 1000; ++i)
+      data += pattern;
+    data += "tail";
+    std::string compressed = common::lz::compress(data);
+    BOOST_CHECK(compressed.size() < data.size() / 10);
+    check_round_trip(data);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lz_corrupted_input) {
+  std::string data = make_text_data(10000);
+  std::string compressed = common::lz::compress(data);
+  std::string decompressed;
+  BOOST_CHECK(!common::lz::decompress(compressed.data(), compressed.size(),
+                                      data.size() - 1, decompressed));
+  BOOST_CHECK(!common::lz::decompress(compressed.data(), compressed.size(),
+                                      data.size() + 1, decompressed));
+  BOOST_CHECK(!common::lz::decompress(compressed.data(), compressed.size() / 2,
+                                      data.size(), decompressed));
+}
+
+BOOST_AUTO_TEST_CASE(compressed_attachments) {
+  const std::string compressible = make_text_data(50000);
+  const std::string incompressible = make_random_data(5000);
+  const std::string uncompressed = make_text_data(1000);
+
+  common::hcf_container hcf;
+  auto* images = hcf.root_node()->add_subnode("images");
+  BOOST_REQUIRE(images);
+  // Adding subnodes invalidates pointers to their siblings
+  BOOST_REQUIRE(images->add_subnode("a"));
+  BOOST_REQUIRE(images->add_subnode("b"));
+  BOOST_REQUIRE(images->add_subnode("c"));
+  auto* a = images->get_subnode("a");
+  auto* b = images->get_subnode("b");
+  auto* c = images->get_subnode("c");
+  a->set("format", "text");
+  BOOST_CHECK(hcf.attach_binary_content(a, compressible, true));
+  BOOST_CHECK(hcf.attach_binary_content(b, incompressible, true));
+  BOOST_CHECK(hcf.attach_binary_content(c, uncompressed));
+
+  // Incompressible content is stored as is.
+  BOOST_CHECK(a->get_subnode("__binary")->has_key("compression"));
+  BOOST_CHECK(!b->get_subnode("__binary")->has_key("compression"));
+  BOOST_CHECK(!c->get_subnode("__binary")->has_key("compression"));
+
+  const std::string serialized = hcf.serialize();
+  BOOST_CHECK(serialized.size() < compressible.size());
+
+  auto check_attachments = [&](const common::hcf_container& container) {
+    const auto* loaded_images = container.root_node()->get_subnode("images");
+    BOOST_REQUIRE(loaded_images);
+    const auto* loaded_a = loaded_images->get_subnode("a");
+    BOOST_REQUIRE(loaded_a);
+    BOOST_REQUIRE(loaded_a->get_value("format"));
+    BOOST_CHECK_EQUAL(*loaded_a->get_value("format"), "text");
+
+    std::string out;
+    BOOST_CHECK(container.get_binary_attachment(loaded_a, out));
+    BOOST_CHECK(out == compressible);
+    BOOST_CHECK(container.get_binary_attachment(
+        loaded_images->get_subnode("b"), out));
+    BOOST_CHECK(out == incompressible);
+    BOOST_CHECK(container.get_binary_attachment(
+        loaded_images->get_subnode("c"), out));
+    BOOST_CHECK(out == uncompressed);
+  };
+
+  check_attachments(common::hcf_container{serialized});
+
+  // The non-owning constructor refers to the binary appendix in place
+  common::hcf_container in_place{serialized.data(), serialized.size()};
+  check_attachments(in_place);
+  BOOST_CHECK(in_place.serialize() == serialized);
+
+  // Attaching content to a non-owning container copies the appendix
+  const std::string additional = make_text_data(20000);
+  auto* d = in_place.root_node()->get_subnode("images")->add_subnode("d");
+  BOOST_REQUIRE(d);
+  BOOST_CHECK(in_place.attach_binary_content(d, additional, true));
+  check_attachments(in_place);
+
+  const std::string reserialized = in_place.serialize();
+  common::hcf_container reloaded{reserialized.data(), reserialized.size()};
+  check_attachments(reloaded);
+  std::string out;
+  BOOST_CHECK(reloaded.get_binary_attachment(
+      reloaded.root_node()->get_subnode("images")->get_subnode("d"), out));
+  BOOST_CHECK(out == additional);
+}
+BOOST_AUTO_TEST_SUITE_END()
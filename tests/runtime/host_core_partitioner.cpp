@@ -0,0 +1,116 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "runtime_test_suite.hpp"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+#include <hipSYCL/runtime/generic/host_core_partitioner.hpp>
+
+using namespace hipsycl;
+
+namespace {
+
+constexpr std::size_t num_groups = 1024;
+constexpr std::size_t group_size = 1024;
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(host_core_partitioner, reset_device_fixture)
+BOOST_AUTO_TEST_CASE(disabled_partitioner) {
+  rt::host_core_partitioner partitioner{{0, 1, 2, 3}, false};
+  BOOST_CHECK(!partitioner.is_enabled());
+  BOOST_CHECK_EQUAL(partitioner.get_max_concurrent_kernels(), 1);
+
+  rt::host_core_partition first{partitioner, num_groups, group_size};
+  std::thread{[&]() {
+    rt::host_core_partition second{partitioner, num_groups, group_size};
+    BOOST_CHECK(!partitioner.is_partitioning());
+    BOOST_CHECK(!second.is_active());
+  }}.join();
+  BOOST_CHECK(!first.is_active());
+  BOOST_CHECK(!rt::host_core_partition::is_current_kernel_resizable());
+}
+
+BOOST_AUTO_TEST_CASE(partitioning_ends_with_concurrent_kernel) {
+  rt::host_core_partitioner partitioner{{0, 1, 2, 3}, true};
+  BOOST_CHECK(partitioner.is_enabled());
+  BOOST_CHECK_EQUAL(partitioner.get_max_concurrent_kernels(), 2);
+
+  // A kernel on its own uses all cores
+  rt::host_core_partition first{partitioner, num_groups, group_size};
+  BOOST_CHECK(!partitioner.is_partitioning());
+  BOOST_CHECK(!first.is_active());
+  // ... but needs to be able to give up cores once another kernel starts
+  BOOST_CHECK(rt::host_core_partition::is_current_kernel_resizable());
+
+  std::promise<void> second_started;
+  std::promise<void> first_resized;
+  std::vector<int> second_cores;
+  std::thread second_kernel{[&]() {
+    rt::host_core_partition second{partitioner, num_groups, group_size};
+    BOOST_CHECK(second.is_active());
+    for(int i = 0; i < second.get_num_threads(); ++i)
+      second_cores.push_back(second.get_core(i));
+    BOOST_CHECK(rt::host_core_partition::is_current_kernel_resizable());
+    second_started.set_value();
+    first_resized.get_future().wait();
+  }};
+
+  second_started.get_future().wait();
+  BOOST_CHECK(partitioner.is_partitioning());
+  BOOST_CHECK(rt::host_core_partition::is_current_kernel_resizable());
+  rt::host_core_partition::resize_point();
+  BOOST_CHECK(first.is_active());
+  BOOST_CHECK_EQUAL(first.get_num_threads() + second_cores.size(), 4);
+  for(int i = 0; i < first.get_num_threads(); ++i)
+    BOOST_CHECK(std::find(second_cores.begin(), second_cores.end(),
+                          first.get_core(i)) == second_cores.end());
+  first_resized.set_value();
+  second_kernel.join();
+
+  // Once the other kernel has finished, the remaining kernel
+  // returns to using all cores.
+  BOOST_CHECK(!partitioner.is_partitioning());
+  rt::host_core_partition::resize_point();
+  BOOST_CHECK(!first.is_active());
+}
+
+BOOST_AUTO_TEST_CASE(nested_kernels_are_not_registered) {
+  rt::host_core_partitioner partitioner{{0, 1, 2, 3}, true};
+  rt::host_core_partition outer{partitioner, num_groups, group_size};
+  {
+    rt::host_core_partition inner{partitioner, num_groups, group_size};
+    BOOST_CHECK(!partitioner.is_partitioning());
+    BOOST_CHECK(rt::host_core_partition::current() == &inner);
+  }
+  BOOST_CHECK(rt::host_core_partition::current() == &outer);
+}
+BOOST_AUTO_TEST_SUITE_END()
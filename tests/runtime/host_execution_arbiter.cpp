@@ -0,0 +1,142 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "runtime_test_suite.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <hipSYCL/runtime/generic/host_execution_arbiter.hpp>
+
+using namespace hipsycl;
+
+namespace {
+
+// Starts a thread that acquires the arbiter with the given priority and
+// appends the priority to the admission order once admitted.
+std::thread start_waiting_kernel(rt::host_execution_arbiter &arbiter,
+                                 int priority, std::mutex &order_mutex,
+                                 std::vector<int> &admission_order) {
+  return std::thread{[&arbiter, priority, &order_mutex, &admission_order]() {
+    arbiter.acquire(priority);
+    {
+      std::lock_guard<std::mutex> lock{order_mutex};
+      admission_order.push_back(priority);
+    }
+    arbiter.release();
+  }};
+}
+
+void wait_until_highest_waiting(rt::host_execution_arbiter &arbiter,
+                                int priority) {
+  // should_yield(p) is true once a kernel with priority higher than p waits
+  while(!arbiter.should_yield(priority + 1))
+    std::this_thread::yield();
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(host_execution_arbiter, reset_device_fixture)
+BOOST_AUTO_TEST_CASE(concurrent_kernels_of_any_priority) {
+  rt::host_execution_arbiter arbiter{2};
+  arbiter.register_priority(-1);
+
+  // Kernels of different priorities share the available slots
+  arbiter.acquire(rt::host_execution_arbiter::default_priority);
+  arbiter.acquire(-1);
+  BOOST_CHECK(!arbiter.should_yield(rt::host_execution_arbiter::default_priority));
+  arbiter.release();
+  arbiter.acquire(rt::host_execution_arbiter::default_priority);
+  arbiter.release();
+  arbiter.release();
+}
+
+BOOST_AUTO_TEST_CASE(highest_priority_first) {
+  rt::host_execution_arbiter arbiter{1};
+  arbiter.register_priority(-2);
+  BOOST_CHECK(arbiter.is_enabled());
+  BOOST_CHECK(arbiter.is_preemptible(rt::host_execution_arbiter::default_priority));
+  BOOST_CHECK(!arbiter.is_preemptible(-2));
+
+  std::mutex order_mutex;
+  std::vector<int> admission_order;
+
+  arbiter.acquire(rt::host_execution_arbiter::default_priority);
+  std::thread low = start_waiting_kernel(arbiter, 1, order_mutex,
+                                         admission_order);
+  wait_until_highest_waiting(arbiter, 1);
+  std::thread high = start_waiting_kernel(arbiter, -2, order_mutex,
+                                          admission_order);
+  wait_until_highest_waiting(arbiter, -2);
+
+  // The running kernel blocks the waiting kernel of higher priority
+  BOOST_CHECK(arbiter.should_yield(rt::host_execution_arbiter::default_priority));
+  arbiter.release();
+  low.join();
+  high.join();
+
+  BOOST_REQUIRE_EQUAL(admission_order.size(), 2);
+  BOOST_CHECK_EQUAL(admission_order[0], -2);
+  BOOST_CHECK_EQUAL(admission_order[1], 1);
+  BOOST_CHECK(!arbiter.should_yield(rt::host_execution_arbiter::default_priority));
+}
+
+BOOST_AUTO_TEST_CASE(waiting_kernels_run_concurrently) {
+  rt::host_execution_arbiter arbiter{2};
+  arbiter.register_priority(-1);
+
+  arbiter.acquire(-1);
+  arbiter.acquire(-1);
+
+  // Both waiting kernels are admitted once the slots become free, and hold
+  // them at the same time.
+  std::atomic<int> num_admitted{0};
+  std::atomic<bool> may_release{false};
+  auto kernel = [&]() {
+    arbiter.acquire(rt::host_execution_arbiter::default_priority);
+    ++num_admitted;
+    while(!may_release.load())
+      std::this_thread::yield();
+    arbiter.release();
+  };
+  std::thread first{kernel};
+  std::thread second{kernel};
+  wait_until_highest_waiting(arbiter,
+                             rt::host_execution_arbiter::default_priority);
+  arbiter.release();
+  arbiter.release();
+
+  while(num_admitted.load() < 2)
+    std::this_thread::yield();
+  may_release = true;
+  first.join();
+  second.join();
+  BOOST_CHECK_EQUAL(num_admitted.load(), 2);
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "runtime_test_suite.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <hipSYCL/runtime/jit_compile_broker.hpp>
+
+using namespace hipsycl;
+
+#ifndef _WIN32
+
+namespace {
+
+std::string get_lock_dir() {
+  return (std::filesystem::temp_directory_path() / "acpp_jit_broker_test")
+      .string();
+}
+
+bool is_lock_dir_empty() {
+  return std::filesystem::is_empty(get_lock_dir());
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(jit_compile_broker, reset_device_fixture)
+BOOST_AUTO_TEST_CASE(concurrent_compiles) {
+  std::filesystem::remove_all(get_lock_dir());
+  rt::jit_compile_broker broker{get_lock_dir()};
+  BOOST_REQUIRE(broker.is_enabled());
+
+  const rt::kernel_configuration::id_type id{1, 2};
+
+  // Stands in for the persistent kernel cache
+  std::mutex cache_mutex;
+  std::string cache;
+  auto lookup = [&](std::string& out) {
+    std::lock_guard<std::mutex> lock{cache_mutex};
+    out = cache;
+    return !out.empty();
+  };
+
+  std::atomic<int> num_missed{0};
+  std::atomic<int> num_compilations{0};
+  auto compile = [&](std::string& binary) {
+    if(lookup(binary))
+      return;
+    // Make sure that both compilers missed the cache before
+    // either of them obtains the lock.
+    ++num_missed;
+    while(num_missed.load() < 2)
+      std::this_thread::yield();
+
+    auto broker_lock = broker.lock(id);
+    BOOST_CHECK(broker_lock.is_locked());
+    if(!lookup(binary)) {
+      ++num_compilations;
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+      binary = "binary";
+      std::lock_guard<std::mutex> lock{cache_mutex};
+      cache = binary;
+    }
+  };
+
+  // Each thread opens its own lock file description, so the flock()
+  // based locks exclude each other as if they were held by two processes.
+  std::string first_binary, second_binary;
+  std::thread first{[&]() { compile(first_binary); }};
+  std::thread second{[&]() { compile(second_binary); }};
+  first.join();
+  second.join();
+
+  BOOST_CHECK_EQUAL(num_compilations.load(), 1);
+  BOOST_CHECK_EQUAL(first_binary, "binary");
+  BOOST_CHECK_EQUAL(second_binary, "binary");
+  BOOST_CHECK(is_lock_dir_empty());
+
+  std::filesystem::remove_all(get_lock_dir());
+}
+
+BOOST_AUTO_TEST_CASE(lock_file_removed_on_release) {
+  std::filesystem::remove_all(get_lock_dir());
+  rt::jit_compile_broker broker{get_lock_dir()};
+  BOOST_REQUIRE(broker.is_enabled());
+
+  const rt::kernel_configuration::id_type id{3, 4};
+  {
+    auto broker_lock = broker.lock(id);
+    BOOST_CHECK(broker_lock.is_locked());
+    BOOST_CHECK(!broker_lock.has_waited());
+    BOOST_CHECK(!is_lock_dir_empty());
+  }
+  BOOST_CHECK(is_lock_dir_empty());
+  {
+    auto broker_lock = broker.lock(id);
+    BOOST_CHECK(broker_lock.is_locked());
+    BOOST_CHECK(!broker_lock.has_waited());
+  }
+  BOOST_CHECK(is_lock_dir_empty());
+
+  std::filesystem::remove_all(get_lock_dir());
+}
+
+BOOST_AUTO_TEST_CASE(disabled_broker) {
+  rt::jit_compile_broker broker{std::string{}};
+  BOOST_CHECK(!broker.is_enabled());
+  BOOST_CHECK(!broker.lock(rt::kernel_configuration::id_type{1, 2}).is_locked());
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay and contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "runtime_test_suite.hpp"
+
+#include <string>
+#include <vector>
+#include <hipSYCL/runtime/generic/thread_affinity.hpp>
+
+using namespace hipsycl;
+
+BOOST_FIXTURE_TEST_SUITE(thread_affinity, reset_device_fixture)
+
+BOOST_AUTO_TEST_CASE(parse_core_list_ranges) {
+  std::vector<int> cores;
+  BOOST_CHECK(rt::thread_affinity::parse_core_list("3", cores));
+  BOOST_CHECK(cores == std::vector<int>{3});
+
+  BOOST_CHECK(rt::thread_affinity::parse_core_list("0,2,4-7", cores));
+  BOOST_CHECK((cores == std::vector<int>{0, 2, 4, 5, 6, 7}));
+
+  // Entries may be given in any order and contain whitespace
+  BOOST_CHECK(rt::thread_affinity::parse_core_list(" 8 - 9 , 1", cores));
+  BOOST_CHECK((cores == std::vector<int>{1, 8, 9}));
+
+  BOOST_CHECK(rt::thread_affinity::parse_core_list("5-5", cores));
+  BOOST_CHECK(cores == std::vector<int>{5});
+}
+
+BOOST_AUTO_TEST_CASE(parse_core_list_duplicates) {
+  std::vector<int> cores;
+  BOOST_CHECK(rt::thread_affinity::parse_core_list("1,1,1", cores));
+  BOOST_CHECK(cores == std::vector<int>{1});
+
+  BOOST_CHECK(rt::thread_affinity::parse_core_list("2-4,3,0-2", cores));
+  BOOST_CHECK((cores == std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(parse_core_list_malformed) {
+  for(const std::string &list :
+      {"", " ", ",", "1,", ",1", "1,,2", "a", "1a", "1-", "-1", "3-1",
+       "1-2-3", "1.5", "0x1", "99999999999"}) {
+    std::vector<int> cores{42};
+    BOOST_CHECK_MESSAGE(!rt::thread_affinity::parse_core_list(list, cores),
+                        "Accepted malformed core list \"" << list << "\"");
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
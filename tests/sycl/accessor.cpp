@@ -886,4 +886,83 @@ BOOST_AUTO_TEST_CASE(zero_dim_accessor) {
   BOOST_CHECK(val == 123);
 }
 
+BOOST_AUTO_TEST_CASE(repeated_host_accessors) {
+  namespace s = cl::sycl;
+
+  constexpr std::size_t N = 1024;
+  s::queue q;
+  s::buffer<int> buf{s::range{N}};
+
+  {
+    s::host_accessor acc{buf, s::write_only, s::no_init};
+    for(std::size_t i = 0; i < N; ++i)
+      acc[i] = static_cast<int>(i);
+  }
+
+  for(int iteration = 0; iteration < 3; ++iteration) {
+    // Consecutive host accesses without intermediate device work
+    for(int j = 0; j < 10; ++j) {
+      s::host_accessor acc{buf, s::range{N / 2}, s::id{N / 2}};
+      acc[0] += 1;
+    }
+    {
+      s::host_accessor acc{buf, s::read_only};
+      BOOST_CHECK(acc[N / 2] ==
+                  static_cast<int>(N / 2) + 11 * iteration + 10);
+    }
+
+    // Host writes must be visible to kernels, and kernel writes
+    // to subsequent host accesses.
+    q.submit([&](s::handler& cgh){
+      s::accessor acc{buf, cgh, s::read_write};
+      cgh.parallel_for(s::range{N}, [=](s::id<1> idx){
+        acc[idx] += 1;
+      });
+    });
+    s::host_accessor acc{buf, s::read_only};
+    BOOST_CHECK(acc[0] == iteration + 1);
+    BOOST_CHECK(acc[N / 2] ==
+                static_cast<int>(N / 2) + 11 * (iteration + 1));
+    BOOST_CHECK(acc[N - 1] == static_cast<int>(N - 1) + iteration + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(host_accessor_during_pending_host_transfer) {
+  namespace s = cl::sycl;
+
+  constexpr std::size_t N = 4 * 1024 * 1024;
+  s::queue q;
+  s::queue host_q{s::cpu_selector_v};
+  s::buffer<int> buf{s::range{N}};
+
+  for(int iteration = 0; iteration < 3; ++iteration) {
+    q.submit([&](s::handler& cgh){
+      s::accessor acc{buf, cgh, s::write_only, s::no_init};
+      cgh.parallel_for(s::range{N}, [=](s::id<1> idx){
+        acc[idx] = static_cast<int>(idx[0]) + iteration;
+      });
+    });
+    q.wait();
+
+    // The requirement of this kernel transfers the data to the host, which
+    // marks it as current on the host before the transfer has completed.
+    s::buffer<int> out{s::range{1}};
+    host_q.submit([&](s::handler& cgh){
+      s::accessor acc{buf, cgh, s::read_only};
+      s::accessor out_acc{out, cgh, s::write_only, s::no_init};
+      cgh.single_task([=](){
+        out_acc[0] = acc[0];
+      });
+    });
+
+    // Read-read access, but must still wait for the pending transfer
+    s::host_accessor acc{buf, s::read_only};
+    std::size_t num_mismatches = 0;
+    for(std::size_t i = 0; i < N; ++i)
+      if(acc[i] != static_cast<int>(i) + iteration)
+        ++num_mismatches;
+    BOOST_CHECK(num_mismatches == 0);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,362 @@
+/*
+ * This file is part of hipSYCL, a SYCL implementation based on CUDA/HIP
+ *
+ * Copyright (c) 2020 Aksel Alpay
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "hipSYCL/algorithms/numeric.hpp"
+#include "sycl_test_suite.hpp"
+using namespace cl;
+
+BOOST_FIXTURE_TEST_SUITE(algorithm_tests, reset_device_fixture)
+
+namespace algorithms = hipsycl::algorithms;
+
+namespace {
+
+// Segment lengths covering empty segments at the beginning, in the middle
+// and at the end, as well as segments that span many small tiles.
+const std::vector<std::vector<std::size_t>> segment_configurations{
+    {100},
+    {0, 0, 5, 0, 1, 0, 20, 0},
+    {1, 50, 2, 0, 30},
+    {3, 3, 3, 3, 3, 3, 3},
+    {0, 64, 0, 0, 1, 63, 0}};
+
+// Tile sizes for the tile path; 0 uses the default decomposition
+const std::vector<std::size_t> tile_sizes{0, 1, 3, 7, 16, 64};
+
+std::vector<std::size_t>
+make_offsets(const std::vector<std::size_t> &segment_lengths) {
+  std::vector<std::size_t> offsets{0};
+  for(std::size_t length : segment_lengths)
+    offsets.push_back(offsets.back() + length);
+  return offsets;
+}
+
+algorithms::detail::tile_decomposition
+get_tiling(sycl::queue &q, std::size_t problem_size, std::size_t tile_size) {
+  if(tile_size == 0)
+    return algorithms::detail::decompose_into_tiles(q, problem_size);
+  return algorithms::detail::make_tile_decomposition(problem_size, tile_size);
+}
+
+class segmented_test_data {
+public:
+  segmented_test_data(sycl::queue &q,
+                      const std::vector<std::size_t> &segment_lengths)
+      : _q{q}, _host_offsets{make_offsets(segment_lengths)} {
+    _num_elements = _host_offsets.back();
+    _num_segments = segment_lengths.size();
+    data = sycl::malloc_shared<int>(_num_elements, q);
+    offsets = sycl::malloc_shared<std::size_t>(_host_offsets.size(), q);
+    out = sycl::malloc_shared<int>(std::max(_num_elements, _num_segments), q);
+    for(std::size_t i = 0; i < _host_offsets.size(); ++i)
+      offsets[i] = _host_offsets[i];
+    reset();
+  }
+
+  ~segmented_test_data() {
+    sycl::free(data, _q);
+    sycl::free(offsets, _q);
+    sycl::free(out, _q);
+  }
+
+  void reset() {
+    for(std::size_t i = 0; i < _num_elements; ++i)
+      data[i] = static_cast<int>(i % 7) + 1;
+    for(std::size_t i = 0; i < std::max(_num_elements, _num_segments); ++i)
+      out[i] = -1;
+  }
+
+  std::size_t get_num_elements() const { return _num_elements; }
+  std::size_t get_num_segments() const { return _num_segments; }
+
+  std::vector<int> get_expected_reduction(int init) const {
+    std::vector<int> result;
+    for(std::size_t s = 0; s < _num_segments; ++s)
+      result.push_back(std::accumulate(data + _host_offsets[s],
+                                       data + _host_offsets[s + 1], init));
+    return result;
+  }
+
+  std::vector<int> get_expected_scan(bool is_inclusive, int init) const {
+    std::vector<int> result(_num_elements);
+    for(std::size_t s = 0; s < _num_segments; ++s) {
+      int state = init;
+      for(std::size_t i = _host_offsets[s]; i < _host_offsets[s + 1]; ++i) {
+        if(is_inclusive) {
+          state += data[i];
+          result[i] = state;
+        } else {
+          result[i] = state;
+          state += data[i];
+        }
+      }
+    }
+    return result;
+  }
+
+  int *data;
+  std::size_t *offsets;
+  int *out;
+
+private:
+  sycl::queue &_q;
+  std::vector<std::size_t> _host_offsets;
+  std::size_t _num_elements;
+  std::size_t _num_segments;
+};
+
+template<class T>
+void check_equal(const T* result, const std::vector<T>& expected) {
+  for(std::size_t i = 0; i < expected.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], expected[i]);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(segmented_reduce_tiles) {
+  sycl::queue q{sycl::property::queue::in_order{}};
+  algorithms::util::allocation_cache cache{
+      algorithms::util::allocation_type::device};
+
+  for(const auto& segment_lengths : segment_configurations) {
+    segmented_test_data test_data{q, segment_lengths};
+    const std::vector<int> expected = test_data.get_expected_reduction(10);
+
+    for(std::size_t tile_size : tile_sizes) {
+      test_data.reset();
+      algorithms::util::allocation_group scratch{&cache, q.get_device()};
+      algorithms::detail::segmented_reduce_by_tiles(
+          q, scratch, get_tiling(q, test_data.get_num_elements(), tile_size),
+          test_data.data, test_data.offsets, test_data.get_num_segments(),
+          test_data.out, 10, std::plus<int>{});
+      q.wait();
+      check_equal(test_data.out, expected);
+    }
+
+    test_data.reset();
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::segmented_reduce(
+        q, scratch, test_data.data,
+        test_data.data + test_data.get_num_elements(), test_data.offsets,
+        test_data.offsets + test_data.get_num_segments() + 1, test_data.out,
+        10);
+    q.wait();
+    check_equal(test_data.out, expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(segmented_reduce_groups) {
+  sycl::queue q{sycl::property::queue::in_order{}};
+
+  for(const auto& segment_lengths : segment_configurations) {
+    segmented_test_data test_data{q, segment_lengths};
+    const std::vector<int> expected = test_data.get_expected_reduction(10);
+
+    for(std::size_t group_size : {1, 16, 128}) {
+      test_data.reset();
+      algorithms::detail::segmented_reduce_by_groups(
+          q, test_data.data, test_data.offsets, test_data.get_num_segments(),
+          test_data.out, 10, std::plus<int>{}, group_size);
+      q.wait();
+      check_equal(test_data.out, expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(segmented_scans) {
+  sycl::queue q{sycl::property::queue::in_order{}};
+  algorithms::util::allocation_cache cache{
+      algorithms::util::allocation_type::device};
+
+  for(const auto& segment_lengths : segment_configurations) {
+    segmented_test_data test_data{q, segment_lengths};
+    const std::vector<int> expected_inclusive =
+        test_data.get_expected_scan(true, 0);
+    const std::vector<int> expected_exclusive =
+        test_data.get_expected_scan(false, 3);
+
+    for(std::size_t tile_size : tile_sizes) {
+      auto tiling = get_tiling(q, test_data.get_num_elements(), tile_size);
+      for(bool is_in_place : {false, true}) {
+        for(bool is_inclusive : {false, true}) {
+          test_data.reset();
+          int *output = is_in_place ? test_data.data : test_data.out;
+          algorithms::util::allocation_group scratch{&cache, q.get_device()};
+          if(is_inclusive)
+            algorithms::detail::segmented_scan(
+                q, scratch, tiling, test_data.data, test_data.offsets,
+                test_data.get_num_segments(), output, 0, std::plus<int>{},
+                std::true_type{});
+          else
+            algorithms::detail::segmented_scan(
+                q, scratch, tiling, test_data.data, test_data.offsets,
+                test_data.get_num_segments(), output, 3, std::plus<int>{},
+                std::false_type{});
+          q.wait();
+          check_equal(output,
+                      is_inclusive ? expected_inclusive : expected_exclusive);
+        }
+      }
+    }
+
+    test_data.reset();
+    {
+      algorithms::util::allocation_group scratch{&cache, q.get_device()};
+      algorithms::segmented_inclusive_scan(
+          q, scratch, test_data.data,
+          test_data.data + test_data.get_num_elements(), test_data.offsets,
+          test_data.offsets + test_data.get_num_segments() + 1,
+          test_data.out);
+      q.wait();
+      check_equal(test_data.out, expected_inclusive);
+    }
+    {
+      algorithms::util::allocation_group scratch{&cache, q.get_device()};
+      algorithms::segmented_exclusive_scan(
+          q, scratch, test_data.data,
+          test_data.data + test_data.get_num_elements(), test_data.offsets,
+          test_data.offsets + test_data.get_num_segments() + 1,
+          test_data.data, 3);
+      q.wait();
+      check_equal(test_data.data, expected_exclusive);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reduce_by_key) {
+  sycl::queue q{sycl::property::queue::in_order{}};
+  algorithms::util::allocation_cache cache{
+      algorithms::util::allocation_type::device};
+
+  // Runs of equal keys of different lengths, such that runs cross
+  // the boundaries of small tiles
+  const std::vector<std::size_t> run_lengths{1, 9, 3, 12, 1, 1, 4, 40, 2};
+  std::vector<int> host_keys;
+  std::vector<int> expected_keys;
+  for(std::size_t r = 0; r < run_lengths.size(); ++r) {
+    // Alternate between two keys, so that equal keys in different runs
+    // are treated as different groups.
+    expected_keys.push_back(static_cast<int>(r % 2));
+    for(std::size_t i = 0; i < run_lengths[r]; ++i)
+      host_keys.push_back(static_cast<int>(r % 2));
+  }
+  const std::size_t n = host_keys.size();
+
+  int *keys = sycl::malloc_shared<int>(n, q);
+  int *values = sycl::malloc_shared<int>(n, q);
+  int *keys_out = sycl::malloc_shared<int>(n, q);
+  int *values_out = sycl::malloc_shared<int>(n, q);
+  std::size_t *num_keys = sycl::malloc_shared<std::size_t>(1, q);
+
+  std::vector<int> expected_values;
+  std::size_t offset = 0;
+  for(std::size_t length : run_lengths) {
+    int sum = 0;
+    for(std::size_t i = offset; i < offset + length; ++i) {
+      keys[i] = host_keys[i];
+      values[i] = static_cast<int>(i % 5) + 1;
+      sum += values[i];
+    }
+    expected_values.push_back(sum);
+    offset += length;
+  }
+
+  auto check = [&]() {
+    BOOST_CHECK_EQUAL(*num_keys, expected_keys.size());
+    check_equal(keys_out, expected_keys);
+    check_equal(values_out, expected_values);
+  };
+
+  for(std::size_t tile_size : tile_sizes) {
+    *num_keys = 0;
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::detail::reduce_by_key_by_tiles(
+        q, scratch, get_tiling(q, n, tile_size), keys, values, keys_out,
+        values_out, num_keys, std::equal_to<int>{}, std::plus<int>{});
+    q.wait();
+    check();
+  }
+
+  *num_keys = 0;
+  {
+    algorithms::util::allocation_group scratch{&cache, q.get_device()};
+    algorithms::reduce_by_key(q, scratch, keys, keys + n, values, keys_out,
+                              values_out, num_keys);
+    q.wait();
+    check();
+  }
+
+  sycl::free(keys, q);
+  sycl::free(values, q);
+  sycl::free(keys_out, q);
+  sycl::free(values_out, q);
+  sycl::free(num_keys, q);
+}
+
+BOOST_AUTO_TEST_CASE(even_width_binning_limits) {
+  std::size_t bin = 0;
+
+  // The width of the range does not fit into int
+  algorithms::even_width_binning<int> full_int_range{
+      4, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
+  BOOST_CHECK(full_int_range.get_bin(std::numeric_limits<int>::min(), bin));
+  BOOST_CHECK(bin == 0);
+  BOOST_CHECK(full_int_range.get_bin(-1, bin));
+  BOOST_CHECK(bin == 1);
+  BOOST_CHECK(full_int_range.get_bin(0, bin));
+  BOOST_CHECK(bin == 2);
+  BOOST_CHECK(full_int_range.get_bin(std::numeric_limits<int>::max() - 1, bin));
+  BOOST_CHECK(bin == 3);
+  BOOST_CHECK(!full_int_range.get_bin(std::numeric_limits<int>::max(), bin));
+
+  // offset * num_bins does not fit into 64 bits
+  using ull = unsigned long long;
+  const ull upper = std::numeric_limits<ull>::max();
+  const std::size_t num_bins = 1000;
+  algorithms::even_width_binning<ull> full_ull_range{num_bins, 0, upper};
+  for(ull x : {ull{0}, ull{1}, upper / num_bins, upper / num_bins * 3 + 1,
+               upper / 2, upper - 1}) {
+    BOOST_CHECK(full_ull_range.get_bin(x, bin));
+    BOOST_CHECK(bin == static_cast<std::size_t>(
+                           static_cast<unsigned __int128>(x) * num_bins / upper));
+  }
+
+  algorithms::even_width_binning<long long> full_ll_range{
+      2, std::numeric_limits<long long>::min(),
+      std::numeric_limits<long long>::max()};
+  BOOST_CHECK(full_ll_range.get_bin(-1LL, bin));
+  BOOST_CHECK(bin == 0);
+  BOOST_CHECK(full_ll_range.get_bin(0LL, bin));
+  BOOST_CHECK(bin == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -41,6 +41,11 @@
 #include "sycl_test_suite.hpp"
 #include <boost/test/tools/old/interface.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(extension_tests, reset_device_fixture)
 
 #ifdef ACPP_EXT_AUTO_PLACEHOLDER_REQUIRE
@@ -1230,4 +1235,573 @@ BOOST_AUTO_TEST_CASE(sycl_specialized) {
 }
 #endif
 
+#ifdef ACPP_EXT_USM_ASYNC_ALLOCATION
+BOOST_AUTO_TEST_CASE(usm_async_allocation) {
+  using namespace cl;
+  sycl::queue q{sycl::property_list{sycl::property::queue::in_order{}}};
+
+  constexpr std::size_t num_elements = 1024;
+  int* result = sycl::malloc_shared<int>(num_elements, q);
+
+  auto initial_stats = sycl::get_usm_pool_statistics(q, sycl::usm::alloc::device);
+
+  for(int iteration = 0; iteration < 10; ++iteration) {
+    int* tmp = sycl::malloc_async<int>(num_elements, q);
+    BOOST_REQUIRE(tmp != nullptr);
+    q.parallel_for(sycl::range{num_elements}, [=](sycl::id<1> idx){
+      tmp[idx] = static_cast<int>(idx[0]) + iteration;
+    });
+    q.parallel_for(sycl::range{num_elements}, [=](sycl::id<1> idx){
+      result[idx] = tmp[idx];
+    });
+    sycl::free_async(tmp, q);
+  }
+  q.wait();
+
+  for(std::size_t i = 0; i < num_elements; ++i)
+    BOOST_CHECK(result[i] == static_cast<int>(i) + 9);
+
+  auto stats = sycl::get_usm_pool_statistics(q, sycl::usm::alloc::device);
+  // Memory freed on an in-order queue can be reused immediately
+  // by the same queue.
+  BOOST_CHECK(stats.num_allocations - initial_stats.num_allocations == 10);
+  BOOST_CHECK(stats.num_backend_allocations -
+                  initial_stats.num_backend_allocations <= 1);
+  BOOST_CHECK(stats.bytes_in_use == initial_stats.bytes_in_use);
+
+  // Out-of-order queue: Memory is reused once the freeing
+  // operation's dependencies have completed.
+  sycl::queue ooo_q{q.get_context(), q.get_device()};
+  int* shared_tmp = sycl::malloc_async<int>(num_elements, ooo_q,
+                                            sycl::usm::alloc::shared);
+  BOOST_REQUIRE(shared_tmp != nullptr);
+  ooo_q.parallel_for(sycl::range{num_elements}, [=](sycl::id<1> idx){
+    shared_tmp[idx] = 1;
+  });
+  sycl::free_async(shared_tmp, ooo_q);
+  ooo_q.wait();
+  int* reused = sycl::malloc_async<int>(num_elements, ooo_q,
+                                        sycl::usm::alloc::shared);
+  BOOST_CHECK(reused == shared_tmp);
+  sycl::free_async(reused, ooo_q);
+  ooo_q.wait();
+
+  sycl::trim_usm_pool(q);
+  BOOST_CHECK(
+      sycl::get_usm_pool_statistics(q, sycl::usm::alloc::shared).bytes_cached ==
+      0);
+
+  sycl::free(result, q);
+}
+#endif
+
+#ifdef ACPP_EXT_BUFFER_MAPPED_FILE
+BOOST_AUTO_TEST_CASE(buffer_mapped_file) {
+  using namespace cl;
+  sycl::queue q;
+
+  constexpr std::size_t num_elements = 4096;
+  constexpr std::size_t header_size = 16;
+
+  std::string path = (std::filesystem::temp_directory_path() /
+                      "acpp_buffer_mapped_file_test.bin")
+                         .string();
+  {
+    std::ofstream file{path, std::ios::binary};
+    std::vector<char> header(header_size, 0);
+    file.write(header.data(), header.size());
+    for(int i = 0; i < static_cast<int>(num_elements); ++i)
+      file.write(reinterpret_cast<const char*>(&i), sizeof(int));
+  }
+
+  std::vector<int> result(num_elements);
+  {
+    sycl::buffer<int> input{
+        sycl::range{num_elements},
+        sycl::property_list{sycl::property::buffer::AdaptiveCpp_mapped_file{
+            path, header_size}}};
+    sycl::buffer<int> output{result.data(), sycl::range{num_elements}};
+
+    q.submit([&](sycl::handler& cgh){
+      sycl::accessor in_acc{input, cgh, sycl::read_only};
+      sycl::accessor out_acc{output, cgh, sycl::write_only, sycl::no_init};
+      cgh.parallel_for(sycl::range{num_elements}, [=](sycl::id<1> idx){
+        out_acc[idx] = 2 * in_acc[idx];
+      });
+    });
+
+    // Writing to a buffer mapped in read-only mode is not allowed
+    BOOST_CHECK_THROW(sycl::host_accessor<int>{input}, sycl::exception);
+  }
+  for(std::size_t i = 0; i < num_elements; ++i)
+    BOOST_CHECK(result[i] == 2 * static_cast<int>(i));
+
+  // The mapping must outlive buffers whose destructor does not wait
+  // for the kernels using them.
+  {
+    int* usm_result = sycl::malloc_shared<int>(num_elements, q);
+    {
+      sycl::buffer<int> input{
+          sycl::range{num_elements},
+          sycl::property_list{
+              sycl::property::buffer::AdaptiveCpp_mapped_file{path,
+                                                              header_size},
+              sycl::property::buffer::AdaptiveCpp_buffer_destructor_blocks{
+                  false}}};
+      q.submit([&](sycl::handler& cgh){
+        sycl::accessor in_acc{input, cgh, sycl::read_only};
+        cgh.parallel_for(sycl::range{num_elements}, [=](sycl::id<1> idx){
+          usm_result[idx] = in_acc[idx] + 1;
+        });
+      });
+    }
+    q.wait();
+    for(std::size_t i = 0; i < num_elements; ++i)
+      BOOST_CHECK(usm_result[i] == static_cast<int>(i) + 1);
+    sycl::free(usm_result, q);
+  }
+
+  {
+    sycl::buffer<int> cow{
+        sycl::range{num_elements},
+        sycl::property_list{sycl::property::buffer::AdaptiveCpp_mapped_file{
+            path, header_size,
+            sycl::property::buffer::AdaptiveCpp_mapped_file::mode::
+                copy_on_write}}};
+    q.submit([&](sycl::handler& cgh){
+      sycl::accessor acc{cow, cgh, sycl::read_write};
+      cgh.parallel_for(sycl::range{num_elements}, [=](sycl::id<1> idx){
+        acc[idx] += 1;
+      });
+    });
+    sycl::host_accessor<int> acc{cow, sycl::read_only};
+    for(std::size_t i = 0; i < num_elements; ++i)
+      BOOST_CHECK(acc[i] == static_cast<int>(i) + 1);
+  }
+  // Modifications must not have been written to the file
+  {
+    std::ifstream file{path, std::ios::binary};
+    file.seekg(header_size + 10 * sizeof(int));
+    int value = 0;
+    file.read(reinterpret_cast<char*>(&value), sizeof(int));
+    BOOST_CHECK(value == 10);
+  }
+  std::filesystem::remove(path);
+}
+#endif
+
+#ifdef ACPP_EXT_FILE_IO
+BOOST_AUTO_TEST_CASE(file_io) {
+  using namespace cl;
+  sycl::queue q;
+
+  constexpr std::size_t size_x = 64;
+  constexpr std::size_t size_y = 32;
+  constexpr std::size_t header_size = 8;
+
+  std::string path = (std::filesystem::temp_directory_path() /
+                      "acpp_file_io_test.bin")
+                         .string();
+  std::filesystem::remove(path);
+
+  sycl::buffer<int, 2> buff{sycl::range{size_x, size_y}};
+  q.submit([&](sycl::handler& cgh){
+    sycl::accessor acc{buff, cgh, sycl::write_only, sycl::no_init};
+    cgh.parallel_for(buff.get_range(), [=](sycl::id<2> idx){
+      acc[idx] = static_cast<int>(idx[0] * size_y + idx[1]);
+    });
+  });
+  // Write full buffer, and a 2D subrange behind it
+  q.submit([&](sycl::handler& cgh){
+    sycl::accessor acc{buff, cgh, sycl::read_only};
+    cgh.AdaptiveCpp_write_to_file(acc, path, header_size);
+  });
+  q.submit([&](sycl::handler& cgh){
+    sycl::accessor acc{buff, cgh, sycl::range{2, 4}, sycl::id{3, 5},
+                       sycl::read_only};
+    cgh.AdaptiveCpp_write_to_file(acc, path,
+                                  header_size + size_x * size_y * sizeof(int));
+  });
+  // Must wait for the file writes reading the buffer
+  q.submit([&](sycl::handler& cgh){
+    sycl::accessor acc{buff, cgh, sycl::write_only, sycl::no_init};
+    cgh.parallel_for(buff.get_range(), [=](sycl::id<2> idx){
+      acc[idx] = 0;
+    });
+  });
+  q.wait_and_throw();
+
+  {
+    std::ifstream file{path, std::ios::binary};
+    std::vector<int> contents(size_x * size_y + 8);
+    file.seekg(header_size);
+    file.read(reinterpret_cast<char*>(contents.data()),
+              contents.size() * sizeof(int));
+    BOOST_REQUIRE(file.good());
+    for(std::size_t i = 0; i < size_x * size_y; ++i)
+      BOOST_CHECK(contents[i] == static_cast<int>(i));
+    for(std::size_t i = 0; i < 2; ++i)
+      for(std::size_t j = 0; j < 4; ++j)
+        BOOST_CHECK(contents[size_x * size_y + i * 4 + j] ==
+                    static_cast<int>((i + 3) * size_y + j + 5));
+  }
+
+  // Read back into buffer and USM memory
+  sycl::buffer<int, 2> input{sycl::range{size_x, size_y}};
+  q.submit([&](sycl::handler& cgh){
+    sycl::accessor acc{input, cgh, sycl::write_only, sycl::no_init};
+    cgh.AdaptiveCpp_read_from_file(path, header_size, acc);
+  });
+  int* usm_data = sycl::malloc_shared<int>(8, q);
+  sycl::event read_evt = q.AdaptiveCpp_read_from_file(
+      path, header_size + size_x * size_y * sizeof(int), usm_data,
+      8 * sizeof(int));
+  read_evt.wait_and_throw();
+  for(std::size_t i = 0; i < 4; ++i)
+    BOOST_CHECK(usm_data[i] == static_cast<int>(3 * size_y + i + 5));
+
+  {
+    sycl::host_accessor<int, 2> acc{input, sycl::read_only};
+    for(std::size_t i = 0; i < size_x; ++i)
+      for(std::size_t j = 0; j < size_y; ++j)
+        BOOST_CHECK(acc[i][j] == static_cast<int>(i * size_y + j));
+  }
+
+  // USM writes respect dependencies
+  sycl::event kernel_evt = q.parallel_for(sycl::range{8}, [=](sycl::id<1> idx){
+    usm_data[idx] = 42;
+  });
+  q.AdaptiveCpp_write_to_file(usm_data, 8 * sizeof(int), path, 0, {kernel_evt})
+      .wait_and_throw();
+  {
+    std::ifstream file{path, std::ios::binary};
+    int value = 0;
+    file.read(reinterpret_cast<char*>(&value), sizeof(int));
+    BOOST_CHECK(value == 42);
+  }
+
+  sycl::free(usm_data, q);
+  std::filesystem::remove(path);
+}
+#endif
+
+#ifdef ACPP_EXT_QUEUE_PRIORITY
+BOOST_AUTO_TEST_CASE(queue_priority) {
+  namespace s = cl::sycl;
+  s::queue high_priority_q{s::property_list{
+      s::property::queue::in_order{},
+      s::property::queue::AdaptiveCpp_priority{-1}}};
+  s::queue low_priority_q{s::property_list{
+      s::property::queue::in_order{},
+      s::property::queue::AdaptiveCpp_priority{1}}};
+
+  // Large enough that kernels on the low priority queue
+  // may be split into multiple chunks
+  const std::size_t size = 1024 * 1024;
+  int* low_data = s::malloc_shared<int>(size, low_priority_q);
+  int* high_data = s::malloc_shared<int>(size, high_priority_q);
+  low_priority_q.fill(low_data, 0, size);
+  high_priority_q.fill(high_data, 0, size);
+
+  for(int i = 0; i < 4; ++i) {
+    low_priority_q.parallel_for(s::range<2>{1024, 1024}, [=](s::item<2> idx){
+      low_data[idx.get_linear_id()] += 1;
+    });
+    low_priority_q.parallel_for(s::range<1>{size / 2}, s::id<1>{size / 2},
+                                [=](s::item<1> idx) {
+      low_data[idx.get_linear_id()] += 2;
+    });
+    low_priority_q.submit([&](s::handler& cgh){
+      cgh.parallel_for_work_group(s::range<1>{size / 128}, s::range<1>{128},
+        [=](s::group<1> grp){
+          grp.parallel_for_work_item([&](s::h_item<1> idx){
+            low_data[idx.get_global_id(0)] += 4;
+          });
+        });
+    });
+    high_priority_q.parallel_for(s::range<1>{size}, [=](s::id<1> idx){
+      high_data[idx] += 1;
+    });
+  }
+  low_priority_q.wait();
+  high_priority_q.wait();
+
+  for(std::size_t i = 0; i < size; ++i) {
+    int expected = (i < size / 2) ? 4 * 5 : 4 * 7;
+    BOOST_REQUIRE(low_data[i] == expected);
+    BOOST_REQUIRE(high_data[i] == 4);
+  }
+
+  s::free(low_data, low_priority_q);
+  s::free(high_data, high_priority_q);
+}
+#endif
+
+#ifdef ACPP_EXT_PERF_COUNTERS
+BOOST_AUTO_TEST_CASE(perf_counters) {
+  namespace s = cl::sycl;
+  s::queue q;
+
+  s::reset_perf_counters();
+  BOOST_CHECK(s::get_perf_counter("dag.nodes_submitted") == 0);
+
+  const std::size_t size = 1024;
+  std::vector<int> data(size, 0);
+  s::buffer<int> buff{data.data(), s::range<1>{size}};
+  for(int i = 0; i < 4; ++i) {
+    q.submit([&](s::handler& cgh){
+      s::accessor acc{buff, cgh, s::read_write};
+      cgh.parallel_for(s::range<1>{size}, [=](s::id<1> idx){
+        acc[idx] += 1;
+      });
+    });
+  }
+  q.wait();
+  {
+    s::host_accessor hacc{buff};
+    BOOST_CHECK(hacc[0] == 4);
+  }
+
+  std::vector<s::perf_counter> counters = s::get_perf_counters();
+  auto get_counter = [&](const std::string& name) -> const s::perf_counter* {
+    for(const auto& c : counters)
+      if(c.name == name)
+        return &c;
+    return nullptr;
+  };
+
+  const s::perf_counter* nodes = get_counter("dag.nodes_submitted");
+  BOOST_REQUIRE(nodes);
+  BOOST_CHECK(!nodes->is_high_water_mark);
+  BOOST_CHECK(nodes->value >= 4);
+  // Each read_write access replaces the previous kernel as data user
+  BOOST_REQUIRE(get_counter("dag.nodes_coalesced"));
+  BOOST_CHECK(get_counter("dag.nodes_coalesced")->value >= 3);
+  BOOST_REQUIRE(get_counter("dag.flushes"));
+  BOOST_CHECK(get_counter("dag.flushes")->value >= 1);
+  BOOST_REQUIRE(get_counter("data.users_max"));
+  BOOST_CHECK(get_counter("data.users_max")->is_high_water_mark);
+  BOOST_CHECK(get_counter("data.users_max")->value >= 1);
+  BOOST_CHECK(get_counter("kernel_cache.jit_compilations"));
+
+  s::reset_perf_counters();
+  BOOST_CHECK(s::get_perf_counter("dag.nodes_submitted") == 0);
+  BOOST_CHECK(s::get_perf_counter("this.counter.does.not.exist") == 0);
+}
+#endif
+
+#ifdef ACPP_EXT_HOST_ITERATION_ORDER
+BOOST_AUTO_TEST_CASE(host_iteration_order) {
+  namespace s = cl::sycl;
+  s::queue q;
+
+  const s::range<2> range2{37, 53};
+  const s::range<3> range3{5, 7, 9};
+  const s::id<3> offset3{1, 2, 3};
+  int* data2 = s::malloc_shared<int>(range2.size(), q);
+  int* data3 = s::malloc_shared<int>(range3.size(), q);
+
+  for(auto order : {s::host_iteration_order::automatic,
+                    s::host_iteration_order::row_major,
+                    s::host_iteration_order::tiled,
+                    s::host_iteration_order::morton,
+                    s::host_iteration_order::hilbert}) {
+    // Small tiles, such that some tiles are only partially inside the range
+    for(std::size_t tile_edge : {std::size_t{0}, std::size_t{4}}) {
+      s::property_list props{
+          s::property::command_group::AdaptiveCpp_host_iteration_order{
+              order, tile_edge}};
+      q.fill(data2, 0, range2.size());
+      q.fill(data3, 0, range3.size());
+      q.wait();
+
+      q.submit(props, [&](s::handler& cgh){
+        cgh.parallel_for(range2, [=](s::item<2> idx){
+          data2[idx.get_linear_id()] += static_cast<int>(idx.get_linear_id()) + 1;
+        });
+      });
+      q.submit(props, [&](s::handler& cgh){
+        cgh.parallel_for(range3, offset3, [=](s::item<3> idx){
+          s::id<3> relative = idx.get_id() - idx.get_offset();
+          std::size_t linear_id =
+              (relative[0] * range3[1] + relative[1]) * range3[2] + relative[2];
+          data3[linear_id] += static_cast<int>(linear_id) + 1;
+        });
+      });
+      q.wait();
+
+      for(std::size_t i = 0; i < range2.size(); ++i)
+        BOOST_REQUIRE(data2[i] == static_cast<int>(i) + 1);
+      for(std::size_t i = 0; i < range3.size(); ++i)
+        BOOST_REQUIRE(data3[i] == static_cast<int>(i) + 1);
+    }
+  }
+
+  s::free(data2, q);
+  s::free(data3, q);
+}
+
+BOOST_AUTO_TEST_CASE(host_iteration_order_elongated_range) {
+  namespace s = cl::sycl;
+  s::queue q;
+
+  // With one index per tile, the power-of-two cubes enclosing these grids
+  // are far larger than the grids themselves.
+  const s::range<2> range2{3, 1 << 18};
+  const s::range<3> range3{1, 2, 1 << 16};
+  int* data2 = s::malloc_shared<int>(range2.size(), q);
+  int* data3 = s::malloc_shared<int>(range3.size(), q);
+
+  for(auto order : {s::host_iteration_order::morton,
+                    s::host_iteration_order::hilbert}) {
+    s::property_list props{
+        s::property::command_group::AdaptiveCpp_host_iteration_order{order,
+                                                                     1}};
+    q.fill(data2, 0, range2.size());
+    q.fill(data3, 0, range3.size());
+    q.wait();
+
+    q.submit(props, [&](s::handler& cgh){
+      cgh.parallel_for(range2, [=](s::item<2> idx){
+        data2[idx.get_linear_id()] += 1;
+      });
+    });
+    q.submit(props, [&](s::handler& cgh){
+      cgh.parallel_for(range3, [=](s::item<3> idx){
+        data3[idx.get_linear_id()] += 1;
+      });
+    });
+    q.wait();
+
+    for(std::size_t i = 0; i < range2.size(); ++i)
+      BOOST_REQUIRE(data2[i] == 1);
+    for(std::size_t i = 0; i < range3.size(); ++i)
+      BOOST_REQUIRE(data3[i] == 1);
+  }
+
+  s::free(data2, q);
+  s::free(data3, q);
+}
+#endif
+
+#ifdef ACPP_EXT_USM_HAZARD_TRACKING
+BOOST_AUTO_TEST_CASE(usm_hazard_tracking) {
+  namespace s = cl::sycl;
+  s::queue q{s::property_list{
+      s::property::queue::AdaptiveCpp_usm_hazard_tracking{}}};
+
+  const std::size_t size = 4096;
+  int* a = s::malloc_shared<int>(size, q);
+  int* b = s::malloc_shared<int>(size, q);
+  int* c = s::malloc_shared<int>(size, q);
+  std::vector<int> host_result(size);
+
+  auto num_hazards = [](){
+    return s::get_perf_counter("dag.usm_hazard_dependencies");
+  };
+
+  s::reset_perf_counters();
+  // memset/memcpy/fill register their accesses automatically
+  q.memset(a, 0, size * sizeof(int));
+  q.submit([&](s::handler& cgh){
+    cgh.AdaptiveCpp_declare_usm_access(a, s::access_mode::read_write);
+    cgh.parallel_for(s::range<1>{size}, [=](s::id<1> idx){
+      for(int i = 0; i < 100; ++i)
+        a[idx] += 1;
+    });
+  });
+  q.submit([&](s::handler& cgh){
+    // Pointer into the middle of the allocation
+    cgh.AdaptiveCpp_declare_usm_access(a + 1, s::access_mode::read);
+    cgh.AdaptiveCpp_declare_usm_access(b, s::access_mode::write);
+    cgh.parallel_for(s::range<1>{size}, [=](s::id<1> idx){
+      b[idx] = a[idx] + 1;
+    });
+  });
+  q.memcpy(host_result.data(), b, size * sizeof(int));
+  q.wait();
+
+  // memset -> kernel -> kernel -> memcpy
+  BOOST_CHECK(num_hazards() == 3);
+  for(std::size_t i = 0; i < size; ++i)
+    BOOST_REQUIRE(host_result[i] == 101);
+
+  // Operations on independent allocations or disjoint ranges of the
+  // same allocation do not depend on each other, and neither do reads.
+  s::reset_perf_counters();
+  q.fill(b, 1, size / 2);
+  q.fill(b + size / 2, 2, size / 2);
+  q.fill(c, 3, size);
+  for(int i = 0; i < 2; ++i) {
+    q.submit([&](s::handler& cgh){
+      cgh.AdaptiveCpp_declare_usm_access(a, s::access_mode::read);
+      cgh.single_task([=](){});
+    });
+  }
+  q.wait();
+  BOOST_CHECK(num_hazards() == 0);
+  BOOST_CHECK(b[0] == 1 && b[size - 1] == 2 && c[0] == 3);
+
+  // Declarations without known extent conservatively conflict with
+  // everything.
+  s::reset_perf_counters();
+  q.fill(c, 4, size);
+  q.submit([&](s::handler& cgh){
+    cgh.AdaptiveCpp_declare_usm_access(host_result.data(),
+                                       s::access_mode::write);
+    cgh.single_task([=](){});
+  });
+  q.wait();
+  BOOST_CHECK(num_hazards() == 1);
+
+  // Operations depending on a reduction result must wait for the last
+  // kernel of the reduction, not only for the main kernel.
+  q.fill(c, 1, size).wait();
+  int* sum = s::malloc_shared<int>(2, q);
+  sum[0] = 0;
+  q.submit([&](s::handler& cgh){
+    cgh.AdaptiveCpp_declare_usm_access(c, s::access_mode::read);
+    cgh.AdaptiveCpp_declare_usm_access(sum, sizeof(int),
+                                       s::access_mode::read_write);
+    cgh.parallel_for(s::range<1>{size}, s::reduction(sum, s::plus<int>{}),
+                     [=](s::id<1> idx, auto &red) { red += c[idx]; });
+  });
+  q.submit([&](s::handler& cgh){
+    cgh.AdaptiveCpp_declare_usm_access(sum, s::access_mode::read_write);
+    cgh.single_task([=](){ sum[1] = sum[0]; });
+  });
+  q.wait();
+  BOOST_CHECK(sum[1] == static_cast<int>(size));
+  s::free(sum, q);
+
+  // Concurrent submissions from multiple threads must still see each other's
+  // accesses, otherwise the non-atomic increments below would race.
+  q.fill(a, 0, size).wait();
+  const int num_threads = 4;
+  const int num_kernels_per_thread = 50;
+  std::vector<std::thread> threads;
+  for(int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&](){
+      for(int i = 0; i < num_kernels_per_thread; ++i) {
+        q.submit([&](s::handler& cgh){
+          cgh.AdaptiveCpp_declare_usm_access(a, s::access_mode::read_write);
+          cgh.parallel_for(s::range<1>{size}, [=](s::id<1> idx){
+            a[idx] += 1;
+          });
+        });
+      }
+    });
+  }
+  for(auto& t : threads)
+    t.join();
+  q.wait();
+  BOOST_CHECK(a[0] == num_threads * num_kernels_per_thread);
+  BOOST_CHECK(a[size - 1] == num_threads * num_kernels_per_thread);
+
+  s::free(a, q);
+  s::free(b, q);
+  s::free(c, q);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -363,4 +363,72 @@ BOOST_AUTO_TEST_CASE(incremental_reduction) {
   sycl::free(result, q);
 }
 
+BOOST_AUTO_TEST_CASE(concurrent_independent_reductions) {
+  // Large enough to require scratch memory for intermediate results
+  const int size = 128 * 1024;
+  const int num_reductions = 16;
+  sycl::queue q;
+  int* data = sycl::malloc_shared<int>(size * num_reductions, q);
+  int* results = sycl::malloc_shared<int>(num_reductions, q);
+  for(int i = 0; i < size * num_reductions; ++i)
+    data[i] = i % 7;
+
+  for(int r = 0; r < num_reductions; ++r) {
+    results[r] = r;
+    int* input = data + r * size;
+    // No waits in between, so that the reductions may run concurrently
+    q.parallel_for(sycl::range<1>{size},
+                   sycl::reduction(results + r, sycl::plus<int>()),
+                   [=](sycl::id<1> idx, auto &redu) { redu += input[idx]; });
+  }
+  q.wait();
+
+  for(int r = 0; r < num_reductions; ++r) {
+    int expected_result =
+        std::accumulate(data + r * size, data + (r + 1) * size, r);
+    BOOST_CHECK(results[r] == expected_result);
+  }
+
+  sycl::free(data, q);
+  sycl::free(results, q);
+}
+
+BOOST_AUTO_TEST_CASE(repeated_single_pass_reduction) {
+  // Few enough groups that the last group can finalize the reduction
+  // within the main kernel.
+  const int size = 128 * 256;
+  sycl::queue q;
+  int* data = sycl::malloc_shared<int>(size, q);
+  int* results = sycl::malloc_shared<int>(2, q);
+  for(int i = 0; i < size; ++i)
+    data[i] = (i * 7) % 1013;
+
+  const int expected_sum = std::accumulate(data, data + size, 0);
+  const int expected_max = *std::max_element(data, data + size);
+
+  // Repeat to verify that the completion counters are correctly
+  // reset for subsequent reductions reusing the scratch memory.
+  for(int run = 0; run < 4; ++run) {
+    results[0] = 0;
+    results[1] = 0;
+    q.parallel_for(
+        sycl::nd_range<1>{size, 128},
+        sycl::reduction(results, sycl::plus<int>()),
+        // No known identity for this operator
+        sycl::reduction(results + 1,
+                        [](int a, int b) { return a > b ? a : b; }),
+        [=](sycl::nd_item<1> idx, auto &sum, auto &max) {
+          sum += data[idx.get_global_linear_id()];
+          max.combine(data[idx.get_global_linear_id()]);
+        });
+    q.wait();
+
+    BOOST_CHECK(results[0] == expected_sum);
+    BOOST_CHECK(results[1] == expected_max);
+  }
+
+  sycl::free(data, q);
+  sycl::free(results, q);
+}
+
 BOOST_AUTO_TEST_SUITE_END()